@@ -0,0 +1,553 @@
+#ifndef ADAPTIVE_RADIX_TREE_H
+#define ADAPTIVE_RADIX_TREE_H
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Árbol radix adaptativo (ART) en memoria
+ *
+ * Cada nivel consume un byte de la clave. Los nodos internos crecen de 4 a
+ * 16, 48 y 256 hijos según los necesitan, así que un nodo poco poblado no
+ * paga 256 punteros. Las cadenas de nodos con un solo hijo se comprimen en
+ * el prefijo del nodo y las hojas guardan la clave completa. Las claves deben
+ * estar libres de prefijos (ninguna es prefijo de otra): las codifica
+ * RadixIndex. Una clave puede tener varios valores. Al borrar no se reducen
+ * los nodos.
+ */
+template <typename Value>
+class AdaptiveRadixTree {
+public:
+    using Key = std::vector<uint8_t>;
+
+private:
+    enum class NodeType : uint8_t { LEAF, NODE4, NODE16, NODE48, NODE256 };
+
+    struct Node {
+        NodeType type;
+        explicit Node(NodeType t) : type(t) {}
+        virtual ~Node() = default;
+    };
+
+    struct Leaf : Node {
+        Key key;
+        std::vector<Value> values;
+        Leaf(Key k, const Value& value) : Node(NodeType::LEAF), key(std::move(k)), values{value} {}
+    };
+
+    struct Inner : Node {
+        Key prefix;
+        uint16_t count = 0;
+        explicit Inner(NodeType t) : Node(t) {}
+    };
+
+    struct Node4 : Inner {
+        std::array<uint8_t, 4> keys{};
+        std::array<std::unique_ptr<Node>, 4> children;
+        Node4() : Inner(NodeType::NODE4) {}
+    };
+
+    struct Node16 : Inner {
+        alignas(16) std::array<uint8_t, 16> keys{};
+        std::array<std::unique_ptr<Node>, 16> children;
+        Node16() : Inner(NodeType::NODE16) {}
+    };
+
+    struct Node48 : Inner {
+        std::array<uint8_t, 256> child_index{};     // 0 = sin hijo, si no posición + 1
+        std::array<std::unique_ptr<Node>, 48> children;
+        Node48() : Inner(NodeType::NODE48) {}
+    };
+
+    struct Node256 : Inner {
+        std::array<std::unique_ptr<Node>, 256> children;
+        Node256() : Inner(NodeType::NODE256) {}
+    };
+
+    std::unique_ptr<Node> root;
+    size_t key_count = 0;
+    size_t node_counts[5] = {0, 0, 0, 0, 0};
+
+public:
+    /**
+     * @brief Añade un valor a la clave (la crea si no existe)
+     */
+    void insert(const Key& key, const Value& value) {
+        insertAt(root, key, 0, value);
+    }
+
+    /**
+     * @brief Quita un valor de la clave; la hoja desaparece con su último valor
+     */
+    bool erase(const Key& key, const Value& value) {
+        if (!root) return false;
+        if (root->type == NodeType::LEAF) {
+            Leaf* leaf = static_cast<Leaf*>(root.get());
+            if (leaf->key != key || !removeValue(*leaf, value)) return false;
+            if (leaf->values.empty()) {
+                root.reset();
+                dropLeaf();
+            }
+            return true;
+        }
+        return eraseAt(root.get(), key, 0, value);
+    }
+
+    /**
+     * @brief Valores de una clave exacta (nullptr si no está)
+     */
+    const std::vector<Value>* find(const Key& key) const {
+        const Node* node = root.get();
+        size_t depth = 0;
+        while (node) {
+            if (node->type == NodeType::LEAF) {
+                const Leaf* leaf = static_cast<const Leaf*>(node);
+                return leaf->key == key ? &leaf->values : nullptr;
+            }
+            const Inner* inner = static_cast<const Inner*>(node);
+            if (matchingPrefix(*inner, key, depth) != inner->prefix.size()) return nullptr;
+            depth += inner->prefix.size();
+            if (depth >= key.size()) return nullptr;
+            node = findChild(node, key[depth]);
+            depth++;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Recorre en orden las claves que empiezan por `prefix`
+     * @param visit bool(const Key&, const std::vector<Value>&); false detiene el recorrido
+     */
+    template <typename Visitor>
+    void prefixScan(const Key& prefix, Visitor visit) const {
+        const Node* node = root.get();
+        size_t depth = 0;
+        while (node && depth < prefix.size()) {
+            if (node->type == NodeType::LEAF) {
+                const Leaf* leaf = static_cast<const Leaf*>(node);
+                if (leaf->key.size() >= prefix.size() &&
+                    std::equal(prefix.begin(), prefix.end(), leaf->key.begin())) {
+                    visit(leaf->key, leaf->values);
+                }
+                return;
+            }
+            const Inner* inner = static_cast<const Inner*>(node);
+            size_t compared = std::min(inner->prefix.size(), prefix.size() - depth);
+            if (!std::equal(inner->prefix.begin(), inner->prefix.begin() + compared, prefix.begin() + depth)) {
+                return;
+            }
+            depth += inner->prefix.size();
+            if (depth >= prefix.size()) break;      // El prefijo termina dentro de este nodo
+            node = findChild(node, prefix[depth]);
+            depth++;
+        }
+        if (node) walk(node, visit);
+    }
+
+    /**
+     * @brief Recorre en orden las claves de [low, high]
+     */
+    template <typename Visitor>
+    void rangeScan(const Key& low, const Key& high, Visitor visit) const {
+        if (root) walkRange(root.get(), 0, low, high, true, true, visit);
+    }
+
+    size_t size() const { return key_count; }
+    bool empty() const { return key_count == 0; }
+
+    void clear() {
+        root.reset();
+        key_count = 0;
+        std::fill(std::begin(node_counts), std::end(node_counts), 0);
+    }
+
+    /**
+     * @brief Nodos internos de 4, 16, 48 y 256 hijos
+     */
+    std::array<size_t, 4> getNodeCounts() const {
+        return {node_counts[1], node_counts[2], node_counts[3], node_counts[4]};
+    }
+
+    size_t getMemoryBytes() const {
+        return node_counts[0] * sizeof(Leaf) + node_counts[1] * sizeof(Node4) + node_counts[2] * sizeof(Node16) +
+               node_counts[3] * sizeof(Node48) + node_counts[4] * sizeof(Node256);
+    }
+
+private:
+    std::unique_ptr<Node> makeLeaf(const Key& key, const Value& value) {
+        key_count++;
+        node_counts[0]++;
+        return std::make_unique<Leaf>(key, value);
+    }
+
+    void dropLeaf() {
+        key_count--;
+        node_counts[0]--;
+    }
+
+    static bool removeValue(Leaf& leaf, const Value& value) {
+        auto it = std::find(leaf.values.begin(), leaf.values.end(), value);
+        if (it == leaf.values.end()) return false;
+        leaf.values.erase(it);
+        return true;
+    }
+
+    static size_t matchingPrefix(const Inner& inner, const Key& key, size_t depth) {
+        size_t i = 0;
+        while (i < inner.prefix.size() && depth + i < key.size() && inner.prefix[i] == key[depth + i]) ++i;
+        return i;
+    }
+
+    void insertAt(std::unique_ptr<Node>& ref, const Key& key, size_t depth, const Value& value) {
+        if (!ref) {
+            ref = makeLeaf(key, value);
+            return;
+        }
+
+        if (ref->type == NodeType::LEAF) {
+            Leaf* leaf = static_cast<Leaf*>(ref.get());
+            if (leaf->key == key) {
+                leaf->values.push_back(value);
+                return;
+            }
+            // Dos claves distintas: un Node4 con su prefijo común
+            auto split = std::make_unique<Node4>();
+            node_counts[1]++;
+            size_t common = 0;
+            while (depth + common < key.size() && depth + common < leaf->key.size() &&
+                   key[depth + common] == leaf->key[depth + common]) {
+                common++;
+            }
+            split->prefix.assign(key.begin() + depth, key.begin() + depth + common);
+            size_t next = depth + common;
+            uint8_t old_byte = leaf->key[next];
+            std::unique_ptr<Node> old_leaf = std::move(ref);
+            ref = std::move(split);
+            addChild(ref, old_byte, std::move(old_leaf));
+            addChild(ref, key[next], makeLeaf(key, value));
+            return;
+        }
+
+        Inner* inner = static_cast<Inner*>(ref.get());
+        size_t matched = matchingPrefix(*inner, key, depth);
+        if (matched < inner->prefix.size()) {
+            // La clave diverge dentro del prefijo comprimido: partirlo
+            auto split = std::make_unique<Node4>();
+            node_counts[1]++;
+            split->prefix.assign(inner->prefix.begin(), inner->prefix.begin() + matched);
+            uint8_t old_byte = inner->prefix[matched];
+            inner->prefix.erase(inner->prefix.begin(), inner->prefix.begin() + matched + 1);
+            std::unique_ptr<Node> old_node = std::move(ref);
+            ref = std::move(split);
+            addChild(ref, old_byte, std::move(old_node));
+            addChild(ref, key[depth + matched], makeLeaf(key, value));
+            return;
+        }
+
+        depth += inner->prefix.size();
+        std::unique_ptr<Node>* child = findChildSlot(ref.get(), key[depth]);
+        if (child) {
+            insertAt(*child, key, depth + 1, value);
+        } else {
+            addChild(ref, key[depth], makeLeaf(key, value));
+        }
+    }
+
+    bool eraseAt(Node* node, const Key& key, size_t depth, const Value& value) {
+        Inner* inner = static_cast<Inner*>(node);
+        if (matchingPrefix(*inner, key, depth) != inner->prefix.size()) return false;
+        depth += inner->prefix.size();
+        if (depth >= key.size()) return false;
+
+        std::unique_ptr<Node>* child = findChildSlot(node, key[depth]);
+        if (!child || !*child) return false;
+        if ((*child)->type != NodeType::LEAF) {
+            return eraseAt(child->get(), key, depth + 1, value);
+        }
+
+        Leaf* leaf = static_cast<Leaf*>(child->get());
+        if (leaf->key != key || !removeValue(*leaf, value)) return false;
+        if (leaf->values.empty()) {
+            removeChild(node, key[depth]);
+            dropLeaf();
+        }
+        return true;
+    }
+
+    static const Node* findChild(const Node* node, uint8_t byte) {
+        std::unique_ptr<Node>* slot = findChildSlot(const_cast<Node*>(node), byte);
+        return slot ? slot->get() : nullptr;
+    }
+
+    static std::unique_ptr<Node>* findChildSlot(Node* node, uint8_t byte) {
+        switch (node->type) {
+            case NodeType::NODE4: {
+                Node4* n = static_cast<Node4*>(node);
+                for (uint16_t i = 0; i < n->count; ++i) {
+                    if (n->keys[i] == byte) return &n->children[i];
+                }
+                return nullptr;
+            }
+            case NodeType::NODE16: {
+                Node16* n = static_cast<Node16*>(node);
+#if defined(__SSE2__)
+                // Comparar los 16 bytes de clave a la vez
+                __m128i probe = _mm_set1_epi8(static_cast<char>(byte));
+                __m128i keys = _mm_load_si128(reinterpret_cast<const __m128i*>(n->keys.data()));
+                int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(probe, keys)) & ((1 << n->count) - 1);
+                return mask ? &n->children[__builtin_ctz(mask)] : nullptr;
+#else
+                for (uint16_t i = 0; i < n->count; ++i) {
+                    if (n->keys[i] == byte) return &n->children[i];
+                }
+                return nullptr;
+#endif
+            }
+            case NodeType::NODE48: {
+                Node48* n = static_cast<Node48*>(node);
+                uint8_t index = n->child_index[byte];
+                return index ? &n->children[index - 1] : nullptr;
+            }
+            case NodeType::NODE256: {
+                Node256* n = static_cast<Node256*>(node);
+                return n->children[byte] ? &n->children[byte] : nullptr;
+            }
+            default:
+                return nullptr;
+        }
+    }
+
+    /**
+     * @brief Inserta un hijo, cambiando el nodo por el siguiente tamaño si está lleno
+     */
+    void addChild(std::unique_ptr<Node>& ref, uint8_t byte, std::unique_ptr<Node> child) {
+        switch (ref->type) {
+            case NodeType::NODE4: {
+                Node4* n = static_cast<Node4*>(ref.get());
+                if (n->count < 4) {
+                    insertSorted(n->keys.data(), n->children.data(), n->count, byte, std::move(child));
+                    return;
+                }
+                auto grown = std::make_unique<Node16>();
+                grown->prefix = std::move(n->prefix);
+                for (uint16_t i = 0; i < n->count; ++i) {
+                    grown->keys[i] = n->keys[i];
+                    grown->children[i] = std::move(n->children[i]);
+                }
+                grown->count = n->count;
+                replaceNode(ref, std::move(grown), 1, 2);
+                break;
+            }
+            case NodeType::NODE16: {
+                Node16* n = static_cast<Node16*>(ref.get());
+                if (n->count < 16) {
+                    insertSorted(n->keys.data(), n->children.data(), n->count, byte, std::move(child));
+                    return;
+                }
+                auto grown = std::make_unique<Node48>();
+                grown->prefix = std::move(n->prefix);
+                for (uint16_t i = 0; i < n->count; ++i) {
+                    grown->children[i] = std::move(n->children[i]);
+                    grown->child_index[n->keys[i]] = static_cast<uint8_t>(i + 1);
+                }
+                grown->count = n->count;
+                replaceNode(ref, std::move(grown), 2, 3);
+                break;
+            }
+            case NodeType::NODE48: {
+                Node48* n = static_cast<Node48*>(ref.get());
+                if (n->count < 48) {
+                    uint8_t slot = 0;
+                    while (n->children[slot]) ++slot;
+                    n->children[slot] = std::move(child);
+                    n->child_index[byte] = static_cast<uint8_t>(slot + 1);
+                    n->count++;
+                    return;
+                }
+                auto grown = std::make_unique<Node256>();
+                grown->prefix = std::move(n->prefix);
+                for (int b = 0; b < 256; ++b) {
+                    if (n->child_index[b]) grown->children[b] = std::move(n->children[n->child_index[b] - 1]);
+                }
+                grown->count = n->count;
+                replaceNode(ref, std::move(grown), 3, 4);
+                break;
+            }
+            case NodeType::NODE256: {
+                Node256* n = static_cast<Node256*>(ref.get());
+                n->children[byte] = std::move(child);
+                n->count++;
+                return;
+            }
+            default:
+                return;
+        }
+        addChild(ref, byte, std::move(child));
+    }
+
+    void replaceNode(std::unique_ptr<Node>& ref, std::unique_ptr<Node> grown, int old_kind, int new_kind) {
+        ref = std::move(grown);
+        node_counts[old_kind]--;
+        node_counts[new_kind]++;
+    }
+
+    static void insertSorted(uint8_t* keys, std::unique_ptr<Node>* children, uint16_t& count,
+                             uint8_t byte, std::unique_ptr<Node> child) {
+        uint16_t pos = 0;
+        while (pos < count && keys[pos] < byte) ++pos;
+        for (uint16_t i = count; i > pos; --i) {
+            keys[i] = keys[i - 1];
+            children[i] = std::move(children[i - 1]);
+        }
+        keys[pos] = byte;
+        children[pos] = std::move(child);
+        count++;
+    }
+
+    static void removeChild(Node* node, uint8_t byte) {
+        Inner* inner = static_cast<Inner*>(node);
+        if (node->type == NodeType::NODE4 || node->type == NodeType::NODE16) {
+            uint8_t* keys = node->type == NodeType::NODE4 ? static_cast<Node4*>(node)->keys.data()
+                                                          : static_cast<Node16*>(node)->keys.data();
+            std::unique_ptr<Node>* children = node->type == NodeType::NODE4
+                                                  ? static_cast<Node4*>(node)->children.data()
+                                                  : static_cast<Node16*>(node)->children.data();
+            uint16_t pos = 0;
+            while (pos < inner->count && keys[pos] != byte) ++pos;
+            if (pos == inner->count) return;
+            for (uint16_t i = pos; i + 1 < inner->count; ++i) {
+                keys[i] = keys[i + 1];
+                children[i] = std::move(children[i + 1]);
+            }
+            inner->count--;
+            keys[inner->count] = 0;
+            children[inner->count].reset();
+        } else if (node->type == NodeType::NODE48) {
+            Node48* n = static_cast<Node48*>(node);
+            if (!n->child_index[byte]) return;
+            n->children[n->child_index[byte] - 1].reset();
+            n->child_index[byte] = 0;
+            inner->count--;
+        } else if (node->type == NodeType::NODE256) {
+            Node256* n = static_cast<Node256*>(node);
+            if (!n->children[byte]) return;
+            n->children[byte].reset();
+            inner->count--;
+        }
+    }
+
+    /**
+     * @brief Hijos de un nodo interno en orden de byte
+     */
+    template <typename Visitor>
+    static bool forEachChild(const Node* node, Visitor visit) {
+        switch (node->type) {
+            case NodeType::NODE4: {
+                const Node4* n = static_cast<const Node4*>(node);
+                for (uint16_t i = 0; i < n->count; ++i) {
+                    if (!visit(n->keys[i], n->children[i].get())) return false;
+                }
+                return true;
+            }
+            case NodeType::NODE16: {
+                const Node16* n = static_cast<const Node16*>(node);
+                for (uint16_t i = 0; i < n->count; ++i) {
+                    if (!visit(n->keys[i], n->children[i].get())) return false;
+                }
+                return true;
+            }
+            case NodeType::NODE48: {
+                const Node48* n = static_cast<const Node48*>(node);
+                for (int b = 0; b < 256; ++b) {
+                    if (n->child_index[b] && !visit(static_cast<uint8_t>(b), n->children[n->child_index[b] - 1].get())) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case NodeType::NODE256: {
+                const Node256* n = static_cast<const Node256*>(node);
+                for (int b = 0; b < 256; ++b) {
+                    if (n->children[b] && !visit(static_cast<uint8_t>(b), n->children[b].get())) return false;
+                }
+                return true;
+            }
+            default:
+                return true;
+        }
+    }
+
+    template <typename Visitor>
+    static bool walk(const Node* node, Visitor& visit) {
+        if (node->type == NodeType::LEAF) {
+            const Leaf* leaf = static_cast<const Leaf*>(node);
+            return visit(leaf->key, leaf->values);
+        }
+        return forEachChild(node, [&visit](uint8_t, const Node* child) { return walk(child, visit); });
+    }
+
+    /**
+     * @brief Recorrido en orden podando los subárboles fuera de [low, high]
+     *
+     * `low_tight`/`high_tight` indican que el camino recorrido coincide con
+     * el límite hasta `depth`; en cuanto se separa, el límite deja de podar.
+     * @return false cuando ya se ha pasado de `high` o el visitante se detuvo
+     */
+    template <typename Visitor>
+    static bool walkRange(const Node* node, size_t depth, const Key& low, const Key& high,
+                          bool low_tight, bool high_tight, Visitor& visit) {
+        if (node->type == NodeType::LEAF) {
+            const Leaf* leaf = static_cast<const Leaf*>(node);
+            if (leaf->key > high) return false;
+            return leaf->key < low || visit(leaf->key, leaf->values);
+        }
+
+        const Inner* inner = static_cast<const Inner*>(node);
+        for (uint8_t byte : inner->prefix) {
+            if (!stepBounds(byte, depth, low, high, low_tight, high_tight)) return !high_tight;
+            depth++;
+        }
+        return forEachChild(node, [&](uint8_t byte, const Node* child) {
+            bool child_low = low_tight, child_high = high_tight;
+            if (!stepBounds(byte, depth, low, high, child_low, child_high)) {
+                return !child_high;     // Por debajo de low: seguir; por encima de high: parar
+            }
+            return walkRange(child, depth + 1, low, high, child_low, child_high, visit);
+        });
+    }
+
+    /**
+     * @brief Aplica un byte del camino a los límites
+     * @return false si el subárbol queda fuera; entonces high_tight indica que
+     *         está por encima de high (true) o por debajo de low (false)
+     */
+    static bool stepBounds(uint8_t byte, size_t depth, const Key& low, const Key& high,
+                           bool& low_tight, bool& high_tight) {
+        if (high_tight) {
+            if (depth >= high.size() || byte > high[depth]) return false;   // Por encima de high
+            if (byte < high[depth]) high_tight = false;
+        }
+        if (low_tight) {
+            if (depth >= low.size()) {
+                low_tight = false;
+            } else if (byte < low[depth]) {
+                high_tight = false;
+                return false;                                               // Por debajo de low
+            } else if (byte > low[depth]) {
+                low_tight = false;
+            }
+        }
+        return true;
+    }
+};
+
+#endif // ADAPTIVE_RADIX_TREE_H
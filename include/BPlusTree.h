@@ -0,0 +1,592 @@
+#ifndef BPLUS_TREE_H
+#define BPLUS_TREE_H
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * @brief Árbol B+ en memoria de entradas (clave, RID) con acoplamiento optimista de bloqueos
+ *
+ * Las claves tienen un ancho fijo en bytes y ordenan como memcmp; la
+ * codificación que conserva el orden la hace BTreeIndex. Dentro del árbol
+ * se guardan en palabras de 64 bits big-endian, que se comparan enteras. El RID desempata,
+ * así que una clave repetida ocupa varias entradas distintas y el borrado es
+ * exacto. Cada nodo guarda hasta NODE_CAPACITY claves contiguas; un nodo
+ * interno con n separadores tiene n + 1 hijos y el separador i es la primera
+ * entrada del hijo i + 1. Las hojas se enlazan en orden para los recorridos
+ * por rango. Las inserciones dividen los nodos llenos al bajar, así que
+ * nunca hay que volver a subir. Al borrar no se fusionan nodos.
+ *
+ * Concurrencia (insert, erase y scan desde varios hilos): cada nodo tiene
+ * un contador de versión cuyo bit LOCKED hace de cerrojo. Un lector no
+ * escribe nada compartido: anota la versión de un nodo, lo lee y comprueba
+ * que la versión no cambió. Al bajar comprueba el padre después de anotar
+ * la del hijo, así que el hijo era el correcto cuando lo alcanzó. Si una
+ * comprobación falla, la operación vuelve a empezar desde la raíz. Un
+ * escritor convierte en cerrojo la versión que leyó (CAS) solo en los nodos
+ * que modifica: la hoja, o el nodo lleno y su padre al dividir. Las
+ * lecturas pueden ver un nodo a medio escribir, pero sus índices nunca
+ * pasan de NODE_CAPACITY y ningún nodo se libera mientras el árbol existe,
+ * así que basta con descartar lo leído. Los campos que se leen así
+ * (contador, claves, RIDs, hijos y hoja siguiente) son atómicos con orden
+ * relajado, de modo que esas lecturas no son carreras de datos. clear y
+ * bulkLoad requieren acceso exclusivo.
+ */
+class BPlusTree {
+public:
+    static constexpr size_t NODE_CAPACITY = 64;
+
+private:
+    static constexpr uint64_t LOCKED = 2;
+    static constexpr size_t INLINE_WORDS = 8;           // Claves de hasta 64 bytes sin memoria dinámica
+
+    static size_t wordsFor(size_t width) { return (width + 7) / 8; }
+
+    /**
+     * @brief Clave en palabras big-endian rellenas con ceros: comparar palabras sin signo es memcmp
+     */
+    static void pack(const uint8_t* key, size_t width, uint64_t* words) {
+        for (size_t w = 0; w < wordsFor(width); ++w) {
+            uint64_t value = 0;
+            for (size_t b = 0; b < 8; ++b) {
+                size_t i = w * 8 + b;
+                value = (value << 8) | (i < width ? key[i] : 0);
+            }
+            words[w] = value;
+        }
+    }
+
+    static void unpack(const uint64_t* words, size_t width, uint8_t* key) {
+        for (size_t i = 0; i < width; ++i) key[i] = static_cast<uint8_t>(words[i / 8] >> (8 * (7 - i % 8)));
+    }
+
+    /**
+     * @brief Clave de una operación ya empaquetada; solo las muy anchas piden memoria
+     */
+    class PackedKey {
+        std::array<uint64_t, INLINE_WORDS> local{};
+        std::vector<uint64_t> spill;
+        uint64_t* words;
+
+    public:
+        PackedKey(const uint8_t* key, size_t width) : words(local.data()) {
+            if (wordsFor(width) > INLINE_WORDS) {
+                spill.resize(wordsFor(width));
+                words = spill.data();
+            }
+            pack(key, width, words);
+        }
+        PackedKey(const PackedKey&) = delete;
+        PackedKey& operator=(const PackedKey&) = delete;
+
+        uint64_t* data() { return words; }
+        const uint64_t* data() const { return words; }
+    };
+
+    /**
+     * @brief Nodo del árbol
+     *
+     * Todo lo que un lector optimista puede leer mientras un escritor lo
+     * cambia es atómico y se accede con orden relajado: la versión (con
+     * acquire/release) es quien ordena esas lecturas, como en un seqlock.
+     */
+    struct Node {
+        std::atomic<uint64_t> version{0};              // Bit LOCKED: cerrojo; el resto cuenta modificaciones
+        const bool leaf;
+        std::atomic<uint16_t> count{0};                 // Entradas (hoja) o separadores (interno)
+        std::unique_ptr<std::atomic<uint64_t>[]> keys;  // NODE_CAPACITY claves de wordsFor(key_width) palabras
+        std::array<std::atomic<uint32_t>, NODE_CAPACITY> rids{};
+        std::array<std::atomic<Node*>, NODE_CAPACITY + 1> children{};
+        std::atomic<Node*> next{nullptr};               // Hoja siguiente
+
+        Node(bool is_leaf, size_t words)
+            : leaf(is_leaf), keys(new std::atomic<uint64_t>[NODE_CAPACITY * words]()) {}
+
+        size_t size() const { return count.load(std::memory_order_relaxed); }
+        void resize(size_t n) { count.store(static_cast<uint16_t>(n), std::memory_order_relaxed); }
+        uint32_t rid(size_t i) const { return rids[i].load(std::memory_order_relaxed); }
+        void setRid(size_t i, uint32_t value) { rids[i].store(value, std::memory_order_relaxed); }
+        Node* child(size_t i) const { return children[i].load(std::memory_order_relaxed); }
+        void setChild(size_t i, Node* node) { children[i].store(node, std::memory_order_relaxed); }
+        Node* following() const { return next.load(std::memory_order_relaxed); }
+        void setFollowing(Node* node) { next.store(node, std::memory_order_relaxed); }
+        uint64_t word(size_t i) const { return keys[i].load(std::memory_order_relaxed); }
+        void setWord(size_t i, uint64_t value) { keys[i].store(value, std::memory_order_relaxed); }
+    };
+
+    size_t key_width;
+    size_t key_words;
+    std::atomic<Node*> root{nullptr};
+    std::vector<std::unique_ptr<Node>> nodes;           // Propietario de todos los nodos
+    mutable std::mutex nodes_mutex;                     // Solo para añadir nodos
+    std::atomic<size_t> entry_count{0};
+    std::atomic<size_t> height{0};
+    mutable std::atomic<uint64_t> restarts{0};
+
+public:
+    /**
+     * @brief Llena hojas consecutivas con entradas que llegan ya ordenadas
+     *
+     * Cada hoja se llena hasta `fill` de su capacidad para dejar sitio a las
+     * inserciones posteriores. En una construcción paralela cada hilo
+     * escribe con el suyo las hojas de su tramo de claves y bulkLoad las
+     * encadena.
+     */
+    class LeafWriter {
+        friend class BPlusTree;
+
+        size_t key_width;
+        size_t key_words;
+        size_t per_leaf;
+        std::vector<std::unique_ptr<Node>> leaves;
+        size_t entries = 0;
+
+    public:
+        LeafWriter(size_t width, double fill)
+            : key_width(width),
+              key_words(wordsFor(width)),
+              per_leaf(std::min(NODE_CAPACITY, std::max<size_t>(2, static_cast<size_t>(NODE_CAPACITY * fill)))) {}
+
+        void append(const uint8_t* key, uint32_t rid) {
+            if (leaves.empty() || leaves.back()->size() == per_leaf) {
+                leaves.emplace_back(new Node(true, key_words));
+            }
+            Node& leaf = *leaves.back();
+            size_t position = leaf.size();
+            PackedKey packed(key, key_width);
+            for (size_t w = 0; w < key_words; ++w) leaf.setWord(position * key_words + w, packed.data()[w]);
+            leaf.setRid(position, rid);
+            leaf.resize(position + 1);
+            entries++;
+        }
+
+        size_t getEntryCount() const { return entries; }
+    };
+
+    explicit BPlusTree(size_t width = 8) : key_width(std::max<size_t>(width, 1)), key_words(wordsFor(key_width)) {
+        clear();
+    }
+
+    /**
+     * @brief Mover un árbol también requiere que nadie lo esté usando
+     *
+     * No es noexcept: el origen queda como un árbol vacío válido, y eso
+     * reserva su hoja raíz.
+     */
+    BPlusTree(BPlusTree&& other) : key_width(other.key_width), key_words(other.key_words) { *this = std::move(other); }
+
+    BPlusTree& operator=(BPlusTree&& other) {
+        key_width = other.key_width;
+        key_words = other.key_words;
+        nodes = std::move(other.nodes);
+        root.store(other.root.load());
+        entry_count.store(other.entry_count.load());
+        height.store(other.height.load());
+        restarts.store(other.restarts.load());
+        other.clear();
+        return *this;
+    }
+
+    size_t getKeyWidth() const { return key_width; }
+    size_t size() const { return entry_count.load(std::memory_order_relaxed); }
+    size_t getHeight() const { return height.load(std::memory_order_relaxed); }
+    uint64_t getRestartCount() const { return restarts.load(std::memory_order_relaxed); }
+
+    size_t getNodeCount() const {
+        std::lock_guard<std::mutex> lock(nodes_mutex);
+        return nodes.size();
+    }
+
+    size_t getMemoryBytes() const {
+        std::lock_guard<std::mutex> lock(nodes_mutex);
+        return nodes.size() * (sizeof(Node) + NODE_CAPACITY * key_words * sizeof(uint64_t)) +
+               nodes.capacity() * sizeof(Node*);
+    }
+
+    void clear() {
+        nodes.clear();
+        nodes.emplace_back(new Node(true, key_words));
+        root.store(nodes.back().get());
+        entry_count = 0;
+        height = 1;
+    }
+
+    /**
+     * @brief Sustituye el contenido por las hojas de los escritores, en orden
+     *
+     * Los escritores deben cubrir tramos de claves crecientes y disjuntos.
+     * Los niveles internos se construyen de abajo arriba con la misma
+     * ocupación que las hojas.
+     */
+    void bulkLoad(std::vector<LeafWriter>& writers) {
+        std::vector<Node*> level;
+        size_t per_node = NODE_CAPACITY + 1;
+        size_t entries = 0;
+        std::vector<std::unique_ptr<Node>> built;
+        for (auto& writer : writers) {
+            per_node = std::min(per_node, writer.per_leaf + 1);
+            entries += writer.entries;
+            for (auto& leaf : writer.leaves) {
+                if (!level.empty()) level.back()->setFollowing(leaf.get());
+                level.push_back(leaf.get());
+                built.push_back(std::move(leaf));
+            }
+            writer.leaves.clear();
+            writer.entries = 0;
+        }
+        clear();
+        if (level.empty()) return;
+        nodes = std::move(built);
+        entry_count = entries;
+
+        // Hoja cuya primera entrada es la menor de cada subárbol: el separador que lo precede en el padre
+        std::vector<const Node*> lows(level.begin(), level.end());
+        size_t levels = 1;
+        while (level.size() > 1) {
+            std::vector<Node*> parents;
+            std::vector<const Node*> parent_lows;
+            for (size_t first = 0; first < level.size(); first += per_node) {
+                size_t last = std::min(level.size(), first + per_node);
+                // Un último hijo suelto se cuelga del padre anterior si le cabe
+                if (last - first == 1 && !parents.empty() && parents.back()->size() < NODE_CAPACITY) {
+                    appendChild(*parents.back(), level[first], *lows[first]);
+                    break;
+                }
+                nodes.emplace_back(new Node(false, key_words));
+                Node* parent = nodes.back().get();
+                parent->setChild(0, level[first]);
+                for (size_t i = first + 1; i < last; ++i) appendChild(*parent, level[i], *lows[i]);
+                parents.push_back(parent);
+                parent_lows.push_back(lows[first]);
+            }
+            level = std::move(parents);
+            lows = std::move(parent_lows);
+            levels++;
+        }
+        height = levels;
+        root.store(level.front(), std::memory_order_release);
+    }
+
+    void insert(const uint8_t* key, uint32_t rid) {
+        PackedKey packed(key, key_width);
+        bool split = false;
+        for (unsigned attempt = 0; !tryInsert(packed.data(), rid, split); split = false) {
+            if (!split) backoff(attempt++);
+        }
+    }
+
+    bool erase(const uint8_t* key, uint32_t rid) {
+        PackedKey packed(key, key_width);
+        for (unsigned attempt = 0;; ++attempt) {
+            Node* leaf = nullptr;
+            uint64_t version = 0;
+            if (findLeaf(packed.data(), rid, leaf, version) && upgrade(leaf, version)) {
+                size_t position = lowerBound(*leaf, packed.data(), rid);
+                bool found = position < leaf->size() && compare(*leaf, position, packed.data(), rid) == 0;
+                if (found) {
+                    removeAt(*leaf, position);
+                    entry_count.fetch_sub(1, std::memory_order_relaxed);
+                }
+                unlock(leaf);
+                return found;
+            }
+            backoff(attempt);
+        }
+    }
+
+    /**
+     * @brief Visita en orden las entradas con low <= clave <= high hasta que `visit` devuelve false
+     *
+     * Las entradas de cada hoja se copian y solo se entregan si la hoja no
+     * cambió mientras se leía. Tras un conflicto el recorrido sigue después
+     * de la última entrada entregada, así que ninguna se repite.
+     */
+    template <typename Visit>
+    void scan(const uint8_t* low, const uint8_t* high, Visit visit) const {
+        PackedKey from(low, key_width);
+        PackedKey last(high, key_width);
+        uint32_t from_rid = 0;
+        bool after = false;                             // Empezar después de (from, from_rid)
+        std::vector<uint64_t> keys(NODE_CAPACITY * key_words);
+        std::array<uint32_t, NODE_CAPACITY> rids;
+        std::vector<uint8_t> key(key_width);
+
+        for (unsigned attempt = 0;; ++attempt) {
+            if (attempt > 0) backoff(attempt);
+            Node* leaf = nullptr;
+            uint64_t version = 0;
+            if (!findLeaf(from.data(), from_rid, leaf, version)) continue;
+            size_t position = lowerBound(*leaf, from.data(), from_rid);
+            if (after && position < leaf->size() && compare(*leaf, position, from.data(), from_rid) == 0) position++;
+
+            while (true) {
+                size_t copied = 0;
+                bool finished = false;
+                for (size_t count = std::min<size_t>(leaf->size(), NODE_CAPACITY); position < count;
+                     ++position, ++copied) {
+                    if (compareKey(*leaf, position, last.data()) > 0) {
+                        finished = true;
+                        break;
+                    }
+                    for (size_t w = 0; w < key_words; ++w) {
+                        keys[copied * key_words + w] = leaf->word(position * key_words + w);
+                    }
+                    rids[copied] = leaf->rid(position);
+                }
+                Node* next = leaf->following();
+                if (!validate(leaf, version)) break;
+
+                for (size_t i = 0; i < copied; ++i) {
+                    unpack(keys.data() + i * key_words, key_width, key.data());
+                    if (!visit(key.data(), rids[i])) return;
+                }
+                if (copied > 0) {
+                    std::copy(keys.begin() + (copied - 1) * key_words, keys.begin() + copied * key_words, from.data());
+                    from_rid = rids[copied - 1];
+                    after = true;
+                }
+                if (finished || !next) return;
+                if (!readVersion(next, version)) break;
+                leaf = next;
+                position = 0;
+            }
+        }
+    }
+
+private:
+    // --- Versiones: lectura optimista, comprobación y cerrojo ---
+
+    static bool readVersion(const Node* node, uint64_t& version) {
+        version = node->version.load(std::memory_order_acquire);
+        return (version & LOCKED) == 0;
+    }
+
+    /**
+     * @brief ¿Sigue el nodo en la versión anotada? La barrera impide adelantar la comprobación a las lecturas
+     */
+    static bool validate(const Node* node, uint64_t version) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return node->version.load(std::memory_order_relaxed) == version;
+    }
+
+    static bool upgrade(Node* node, uint64_t version) {
+        return node->version.compare_exchange_strong(version, version + LOCKED, std::memory_order_acquire);
+    }
+
+    static void unlock(Node* node) { node->version.fetch_add(LOCKED, std::memory_order_release); }
+
+    /**
+     * @brief Tras un conflicto: ceder la CPU al hilo que tiene el cerrojo
+     */
+    void backoff(unsigned attempt) const {
+        restarts.fetch_add(1, std::memory_order_relaxed);
+        if (attempt > 2) std::this_thread::yield();
+    }
+
+    Node* allocate(bool leaf) {
+        std::lock_guard<std::mutex> lock(nodes_mutex);
+        nodes.emplace_back(new Node(leaf, key_words));
+        return nodes.back().get();
+    }
+
+    /**
+     * @brief Baja de forma optimista hasta la hoja de (key, rid) y anota su versión
+     * @return false si hubo un conflicto y hay que volver a empezar
+     */
+    bool findLeaf(const uint64_t* key, uint32_t rid, Node*& leaf, uint64_t& version) const {
+        Node* node = root.load(std::memory_order_acquire);
+        if (!readVersion(node, version) || node != root.load(std::memory_order_acquire)) return false;
+        while (!node->leaf) {
+            Node* child = node->child(childFor(*node, key, rid));
+            uint64_t child_version = 0;
+            if (!validate(node, version) || !child) return false;
+            if (!readVersion(child, child_version) || !validate(node, version)) return false;
+            node = child;
+            version = child_version;
+        }
+        leaf = node;
+        return true;
+    }
+
+    /**
+     * @brief Un intento de inserción; false si hubo conflicto o si dividió un nodo (`split`) y hay que volver a bajar
+     */
+    bool tryInsert(const uint64_t* key, uint32_t rid, bool& split) {
+        Node* node = root.load(std::memory_order_acquire);
+        uint64_t version = 0;
+        if (!readVersion(node, version) || node != root.load(std::memory_order_acquire)) return false;
+        Node* parent = nullptr;
+        uint64_t parent_version = 0;
+        size_t parent_slot = 0;
+
+        while (true) {
+            if (node->size() == NODE_CAPACITY) {
+                // El padre no está lleno: si lo estuviera se habría dividido al pasar por él
+                if (parent && !upgrade(parent, parent_version)) return false;
+                if (!upgrade(node, version)) {
+                    if (parent) unlock(parent);
+                    return false;
+                }
+                if (!parent) {
+                    if (node != root.load(std::memory_order_acquire)) {
+                        unlock(node);
+                        return false;
+                    }
+                    Node* new_root = allocate(false);
+                    new_root->setChild(0, node);
+                    splitChild(*new_root, 0);
+                    root.store(new_root, std::memory_order_release);
+                    height.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    splitChild(*parent, parent_slot);
+                    unlock(parent);
+                }
+                unlock(node);
+                split = true;
+                return false;
+            }
+
+            if (node->leaf) {
+                if (!upgrade(node, version)) return false;
+                size_t position = lowerBound(*node, key, rid);
+                if (position >= node->size() || compare(*node, position, key, rid) != 0) {
+                    insertAt(*node, position, key, rid, nullptr);
+                    entry_count.fetch_add(1, std::memory_order_relaxed);
+                }
+                unlock(node);
+                return true;
+            }
+
+            size_t slot = childFor(*node, key, rid);
+            Node* child = node->child(slot);
+            uint64_t child_version = 0;
+            if (!validate(node, version) || !child) return false;
+            if (!readVersion(child, child_version) || !validate(node, version)) return false;
+            parent = node;
+            parent_version = version;
+            parent_slot = slot;
+            node = child;
+            version = child_version;
+        }
+    }
+
+    /**
+     * @brief Orden de la clave i del nodo frente a `key` (sin desempatar por RID)
+     */
+    int compareKey(const Node& node, size_t i, const uint64_t* key) const {
+        for (size_t w = 0; w < key_words; ++w) {
+            uint64_t value = node.word(i * key_words + w);
+            if (value != key[w]) return value < key[w] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    int compare(const Node& node, size_t i, const uint64_t* key, uint32_t rid) const {
+        int cmp = compareKey(node, i, key);
+        if (cmp != 0) return cmp;
+        uint32_t own = node.rid(i);
+        return own < rid ? -1 : (own > rid ? 1 : 0);
+    }
+
+    /**
+     * @brief Primera posición cuya entrada no es menor que (key, rid)
+     */
+    size_t lowerBound(const Node& node, const uint64_t* key, uint32_t rid) const {
+        size_t low = 0, high = std::min<size_t>(node.size(), NODE_CAPACITY);
+        while (low < high) {
+            size_t mid = (low + high) / 2;
+            if (compare(node, mid, key, rid) < 0) low = mid + 1;
+            else high = mid;
+        }
+        return low;
+    }
+
+    /**
+     * @brief Hijo que cubre (key, rid): tantos como separadores <= la entrada
+     */
+    size_t childFor(const Node& node, const uint64_t* key, uint32_t rid) const {
+        size_t low = 0, high = std::min<size_t>(node.size(), NODE_CAPACITY);
+        while (low < high) {
+            size_t mid = (low + high) / 2;
+            if (compare(node, mid, key, rid) <= 0) low = mid + 1;
+            else high = mid;
+        }
+        return low;
+    }
+
+    /**
+     * @brief Copia la entrada `from` de `source` a la posición `to` de `target`
+     */
+    void copyEntry(const Node& source, size_t from, Node& target, size_t to) const {
+        for (size_t w = 0; w < key_words; ++w) target.setWord(to * key_words + w, source.word(from * key_words + w));
+        target.setRid(to, source.rid(from));
+    }
+
+    void appendChild(Node& parent, Node* child, const Node& low_leaf) {
+        size_t count = parent.size();
+        copyEntry(low_leaf, 0, parent, count);
+        parent.setChild(count + 1, child);
+        parent.resize(count + 1);
+    }
+
+    /**
+     * @brief Inserta una entrada (y en un nodo interno el hijo a su derecha) en `position`
+     */
+    void insertAt(Node& node, size_t position, const uint64_t* key, uint32_t rid, Node* right_child) {
+        size_t count = node.size();
+        for (size_t i = count; i > position; --i) copyEntry(node, i - 1, node, i);
+        for (size_t w = 0; w < key_words; ++w) node.setWord(position * key_words + w, key[w]);
+        node.setRid(position, rid);
+        if (!node.leaf) {
+            for (size_t i = count + 1; i > position + 1; --i) node.setChild(i, node.child(i - 1));
+            node.setChild(position + 1, right_child);
+        }
+        node.resize(count + 1);
+    }
+
+    void removeAt(Node& node, size_t position) {
+        size_t count = node.size();
+        for (size_t i = position + 1; i < count; ++i) copyEntry(node, i, node, i - 1);
+        node.resize(count - 1);
+    }
+
+    /**
+     * @brief Divide el hijo lleno `index` de `parent` y sube su separador (ambos con cerrojo)
+     *
+     * En una hoja el separador es la primera entrada de la mitad derecha y se
+     * queda también en ella; en un nodo interno sube la entrada central. El
+     * nodo nuevo se rellena antes de enlazarlo, así que quien lo alcance a
+     * través del padre o de la hoja anterior ya lo ve completo.
+     */
+    void splitChild(Node& parent, size_t index) {
+        Node& child = *parent.child(index);
+        Node& right = *allocate(child.leaf);
+        size_t count = child.size();
+        size_t mid = count / 2;
+        size_t separator = child.leaf ? mid : mid + 1;  // Primera entrada que pasa al nodo nuevo
+
+        for (size_t i = separator; i < count; ++i) copyEntry(child, i, right, i - separator);
+        right.resize(count - separator);
+        std::vector<uint64_t> key(key_words);
+        for (size_t w = 0; w < key_words; ++w) key[w] = child.word(mid * key_words + w);
+        uint32_t rid = child.rid(mid);
+
+        if (child.leaf) {
+            right.setFollowing(child.following());
+            child.setFollowing(&right);
+        } else {
+            for (size_t i = separator; i <= count; ++i) right.setChild(i - separator, child.child(i));
+        }
+        child.resize(mid);
+        insertAt(parent, index, key.data(), rid, &right);
+    }
+};
+
+#endif // BPLUS_TREE_H
@@ -0,0 +1,147 @@
+#ifndef BTREE_INDEX_H
+#define BTREE_INDEX_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include "Record.h"
+#include "RadixIndex.h"
+#include "BPlusTree.h"
+
+/**
+ * @brief Índice secundario B+ sobre una columna de una tabla heap
+ *
+ * Las claves tienen ancho fijo: los números ocupan 8 bytes big-endian que
+ * ordenan como el valor, y las cadenas `max_length` bytes (32 si el esquema
+ * no lo fija) rellenos con ceros. Una cadena más larga se trunca, así que
+ * el índice da candidatos que quien consulta debe comprobar con el valor
+ * completo. Los valores del árbol son RIDs con el formato de BitmapIndex.
+ * Vive en memoria y se reconstruye al cargar; `metadata/btree_<tabla>.txt`
+ * solo guarda las columnas indexadas. Admite inserciones, borrados y
+ * búsquedas concurrentes (ver BPlusTree).
+ */
+class BTreeIndex {
+public:
+    static constexpr size_t DEFAULT_STRING_WIDTH = 32;
+
+    /**
+     * @brief Entrada (clave codificada, RID) de una construcción por ordenación
+     */
+    struct Entry {
+        std::string key;
+        uint32_t rid;
+
+        bool operator<(const Entry& other) const {
+            int cmp = key.compare(other.key);
+            return cmp != 0 ? cmp < 0 : rid < other.rid;
+        }
+    };
+
+private:
+    std::string column;
+    size_t field;
+    FieldType type;
+    BPlusTree tree;
+
+public:
+    BTreeIndex() : field(0), type(FieldType::INTEGER) {}
+
+    bool configure(const std::vector<FieldDefinition>& schema, const std::string& name) {
+        for (size_t i = 0; i < schema.size(); ++i) {
+            if (schema[i].name == name) {
+                column = name;
+                field = i;
+                type = schema[i].type;
+                size_t width = isStringKey() ? (schema[i].max_length > 0 ? schema[i].max_length : DEFAULT_STRING_WIDTH)
+                                             : sizeof(uint64_t);
+                tree = BPlusTree(width);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const std::string& getColumn() const { return column; }
+    size_t getField() const { return field; }
+    bool isStringKey() const { return type == FieldType::STRING || type == FieldType::DATE; }
+
+    /**
+     * @brief Clave de ancho fijo de un valor
+     */
+    std::string encode(const std::string& value) const {
+        size_t width = tree.getKeyWidth();
+        if (isStringKey()) {
+            std::string key = value.substr(0, width);
+            key.resize(width, '\0');
+            return key;
+        }
+        uint64_t bits = orderedNumberBits(type, value);
+        std::string key(width, '\0');
+        for (size_t i = 0; i < width; ++i) {
+            key[i] = static_cast<char>(bits >> (8 * (width - 1 - i)));
+        }
+        return key;
+    }
+
+    Entry entryOf(uint32_t rid, const Record& record) const { return Entry{encode(record.getField(field)), rid}; }
+
+    void addRow(uint32_t rid, const Record& record) { addValue(rid, record.getField(field)); }
+    void addValue(uint32_t rid, const std::string& value) { tree.insert(keyBytes(encode(value)), rid); }
+    void removeRow(uint32_t rid, const Record& record) { tree.erase(keyBytes(encode(record.getField(field))), rid); }
+    void clearRows() { tree.clear(); }
+
+    BPlusTree::LeafWriter makeLeafWriter(double fill) const { return BPlusTree::LeafWriter(tree.getKeyWidth(), fill); }
+    void bulkLoad(std::vector<BPlusTree::LeafWriter>& writers) { tree.bulkLoad(writers); }
+
+    static const uint8_t* keyBytes(const std::string& key) { return reinterpret_cast<const uint8_t*>(key.data()); }
+
+    /**
+     * @brief RIDs candidatos de [low, high] en orden de clave
+     */
+    std::vector<uint32_t> rangeLookup(const std::string& low, const std::string& high) const {
+        std::vector<uint32_t> rids;
+        std::string low_key = encode(low), high_key = encode(high);
+        tree.scan(keyBytes(low_key), keyBytes(high_key), [&rids](const uint8_t*, uint32_t rid) {
+            rids.push_back(rid);
+            return true;
+        });
+        return rids;
+    }
+
+    std::vector<uint32_t> lookup(const std::string& value) const { return rangeLookup(value, value); }
+
+    size_t getEntryCount() const { return tree.size(); }
+    size_t getHeight() const { return tree.getHeight(); }
+    size_t getNodeCount() const { return tree.getNodeCount(); }
+    size_t getMemoryBytes() const { return tree.getMemoryBytes(); }
+    uint64_t getRestartCount() const { return tree.getRestartCount(); }
+};
+
+/**
+ * @brief Guarda las columnas con índice B+ de una tabla
+ */
+inline bool saveBTreeColumns(const std::string& path, const std::vector<std::string>& columns) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error escribiendo los índices B+: " << path << std::endl;
+        return false;
+    }
+    for (const auto& column : columns) {
+        file << column << std::endl;
+    }
+    return static_cast<bool>(file);
+}
+
+inline std::vector<std::string> loadBTreeColumns(const std::string& path) {
+    std::vector<std::string> columns;
+    std::ifstream file(path);
+    std::string column;
+    while (std::getline(file, column)) {
+        if (!column.empty()) columns.push_back(column);
+    }
+    return columns;
+}
+
+#endif // BTREE_INDEX_H
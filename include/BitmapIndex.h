@@ -0,0 +1,181 @@
+#ifndef BITMAP_INDEX_H
+#define BITMAP_INDEX_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include "Record.h"
+#include "RoaringBitmap.h"
+
+/**
+ * @brief Término de una consulta por mapas de bits
+ *
+ * Selecciona las filas cuya columna vale alguno de `values`; con `negated`
+ * selecciona las demás. Una consulta es la conjunción de sus términos.
+ */
+struct BitmapTerm {
+    std::string column;
+    std::vector<std::string> values;
+    bool negated = false;
+
+    BitmapTerm(const std::string& col, const std::vector<std::string>& vals, bool neg = false)
+        : column(col), values(vals), negated(neg) {}
+};
+
+/**
+ * @brief Índices de mapas de bits de las columnas de una tabla heap
+ *
+ * Cada fila se identifica por su RID: los 16 bits altos son la posición del
+ * bloque en la relación y los 16 bajos la ranura dentro del bloque, de modo
+ * que cada contenedor del mapa corresponde exactamente a un bloque de datos.
+ * Hay un mapa por valor distinto y otro con todas las filas vivas, que
+ * sirve de universo para la negación. Los mapas viven en memoria; en
+ * `metadata/bitmap_<tabla>.txt` solo se guardan las columnas indexadas y el
+ * índice se reconstruye al cargar el disco.
+ */
+class BitmapIndex {
+public:
+    static constexpr size_t MAX_BLOCKS = 65536;
+    static constexpr size_t MAX_SLOTS = 65536;
+
+private:
+    std::vector<std::string> columns;
+    std::vector<size_t> fields;
+    std::map<std::string, std::map<std::string, RoaringBitmap>> bitmaps;   // columna -> valor -> filas
+    RoaringBitmap live;
+
+public:
+    static uint32_t makeRowId(size_t block_position, size_t slot) {
+        return static_cast<uint32_t>((block_position << 16) | slot);
+    }
+    static size_t blockOf(uint32_t rid) { return rid >> 16; }
+    static size_t slotOf(uint32_t rid) { return rid & 0xFFFF; }
+
+    /**
+     * @brief Añade una columna del esquema al índice (vacía hasta reconstruir)
+     */
+    bool addColumn(const std::vector<FieldDefinition>& schema, const std::string& column) {
+        if (hasColumn(column)) return true;
+        for (size_t i = 0; i < schema.size(); ++i) {
+            if (schema[i].name == column) {
+                columns.push_back(column);
+                fields.push_back(i);
+                bitmaps[column];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Quita una columna del índice junto con sus mapas
+     */
+    void removeColumn(const std::string& column) {
+        auto it = std::find(columns.begin(), columns.end(), column);
+        if (it == columns.end()) return;
+        fields.erase(fields.begin() + (it - columns.begin()));
+        columns.erase(it);
+        bitmaps.erase(column);
+    }
+
+    bool hasColumn(const std::string& column) const {
+        return std::find(columns.begin(), columns.end(), column) != columns.end();
+    }
+
+    const std::vector<std::string>& getColumns() const { return columns; }
+
+    void addRow(uint32_t rid, const Record& record) {
+        live.add(rid);
+        for (size_t c = 0; c < columns.size(); ++c) {
+            bitmaps[columns[c]][record.getField(fields[c])].add(rid);
+        }
+    }
+
+    void removeRow(uint32_t rid, const Record& record) {
+        live.remove(rid);
+        for (size_t c = 0; c < columns.size(); ++c) {
+            auto& by_value = bitmaps[columns[c]];
+            auto it = by_value.find(record.getField(fields[c]));
+            if (it == by_value.end()) continue;
+            it->second.remove(rid);
+            if (it->second.isEmpty()) by_value.erase(it);
+        }
+    }
+
+    void clearRows() {
+        live.clear();
+        for (auto& column : bitmaps) column.second.clear();
+    }
+
+    /**
+     * @brief Filas que cumplen todos los términos, sin leer bloques de datos
+     *
+     * Los valores de un término se combinan con OR; cada término se aplica
+     * al resultado con AND, o con AND NOT si está negado.
+     * @return false si algún término usa una columna no indexada
+     */
+    bool evaluate(const std::vector<BitmapTerm>& terms, RoaringBitmap& result) const {
+        result = live;
+        for (const auto& term : terms) {
+            auto column = bitmaps.find(term.column);
+            if (column == bitmaps.end()) {
+                std::cout << "Error: la columna '" << term.column << "' no tiene índice de mapa de bits." << std::endl;
+                return false;
+            }
+            RoaringBitmap matches;
+            for (const auto& value : term.values) {
+                auto it = column->second.find(value);
+                if (it != column->second.end()) matches = RoaringBitmap::orOf(matches, it->second);
+            }
+            result = term.negated ? RoaringBitmap::andNotOf(result, matches)
+                                  : RoaringBitmap::andOf(result, matches);
+        }
+        return true;
+    }
+
+    size_t getRowCount() const { return live.cardinality(); }
+
+    size_t getDistinctValues(const std::string& column) const {
+        auto it = bitmaps.find(column);
+        return it != bitmaps.end() ? it->second.size() : 0;
+    }
+
+    size_t getSizeInBytes(const std::string& column) const {
+        size_t bytes = 0;
+        auto it = bitmaps.find(column);
+        if (it == bitmaps.end()) return 0;
+        for (const auto& value : it->second) bytes += value.first.size() + value.second.sizeInBytes();
+        return bytes;
+    }
+
+    bool save(const std::string& path) const {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Error escribiendo el índice de mapas de bits: " << path << std::endl;
+            return false;
+        }
+        for (const auto& column : columns) {
+            file << column << std::endl;
+        }
+        return static_cast<bool>(file);
+    }
+
+    bool load(const std::string& path, const std::vector<FieldDefinition>& schema) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::string column;
+        while (std::getline(file, column)) {
+            if (!column.empty() && !addColumn(schema, column)) {
+                std::cerr << "Advertencia: columna indexada desconocida '" << column << "'" << std::endl;
+            }
+        }
+        return true;
+    }
+};
+
+#endif // BITMAP_INDEX_H
@@ -20,6 +20,7 @@ private:
     std::vector<size_t> offset_table;                    // Tabla de offsets (Fig 13.19)
     size_t used_space;                                   // Espacio utilizado
     int next_record_id;                                  // ID del próximo registro
+    long long page_lsn;                                  // Última modificación persistida
     
     // Metadatos del bloque
     std::string relation_name;                           // Relación a la que pertenece
@@ -35,6 +36,7 @@ public:
         , header_size(64)  // Header fijo de 64 bytes
         , used_space(header_size)
         , next_record_id(1)
+        , page_lsn(0)
         , is_dirty(false)
     {
     }
@@ -49,6 +51,20 @@ public:
     void markDirty() { is_dirty = true; }
     void markClean() { is_dirty = false; }
 
+    /**
+     * @brief Mueve el bloque a otra dirección (paginación en sombra)
+     */
+    void relocate(const PhysicalAddress& new_address) {
+        address = new_address;
+        for (auto& record : records) {
+            record->setPhysicalAddress(address);
+        }
+        markDirty();
+    }
+
+    long long getPageLSN() const { return page_lsn; }
+    void setPageLSN(long long lsn) { page_lsn = lsn; }
+
     const std::string& getRelationName() const { return relation_name; }
     void setRelationName(const std::string& name) { relation_name = name; }
 
@@ -97,12 +113,62 @@ public:
         return true;
     }
 
+    /**
+     * @brief Inserta un registro en una posición concreta (hojas ordenadas)
+     */
+    bool insertRecordAt(size_t position, std::shared_ptr<Record> record) {
+        if (!canFit(record)) {
+            return false;
+        }
+        if (record->getId() == -1) {
+            record->setId(next_record_id++);
+        }
+        record->setPhysicalAddress(address);
+        
+        position = std::min(position, records.size());
+        records.insert(records.begin() + static_cast<std::ptrdiff_t>(position), record);
+        recalculateOffsets();
+        markDirty();
+        return true;
+    }
+
+    /**
+     * @brief Sustituye el registro de una ranura si la nueva versión cabe
+     */
+    bool replaceRecordAt(size_t position, std::shared_ptr<Record> record) {
+        if (position >= records.size()) {
+            return false;
+        }
+        size_t old_size = records[position]->getSize();
+        if (used_space - old_size + record->getSize() > block_size) {
+            return false;
+        }
+        record->setPhysicalAddress(address);
+        records[position] = record;
+        recalculateOffsets();
+        markDirty();
+        return true;
+    }
+
+    /**
+     * @brief Extrae los registros desde `position` (división de página)
+     */
+    std::vector<std::shared_ptr<Record>> splitOff(size_t position) {
+        position = std::min(position, records.size());
+        std::vector<std::shared_ptr<Record>> moved(records.begin() + static_cast<std::ptrdiff_t>(position),
+                                                   records.end());
+        records.erase(records.begin() + static_cast<std::ptrdiff_t>(position), records.end());
+        recalculateOffsets();
+        markDirty();
+        return moved;
+    }
+
     /**
      * @brief Elimina un registro lógicamente (tombstone)
      */
     bool deleteRecord(int record_id) {
         for (auto& record : records) {
-            if (record->getId() == record_id) {
+            if (record->getId() == record_id && !record->isDeleted()) {
                 record->markAsDeleted();
                 markDirty();
                 return true;
@@ -168,7 +234,8 @@ public:
         
         // Header del bloque
         oss << "BLOCK_HEADER|" << address.toString() << "|" << block_size 
-            << "|" << used_space << "|" << relation_name << "|" << records.size() << std::endl;
+            << "|" << used_space << "|" << relation_name << "|" << records.size()
+            << "|" << page_lsn << std::endl;
         
         // Tabla de offsets
         oss << "OFFSET_TABLE|";
@@ -205,16 +272,18 @@ public:
             
             if (type == "BLOCK_HEADER") {
                 // Parsear header del bloque
-                std::string addr_str, size_str, used_str, rel_str, count_str;
+                std::string addr_str, size_str, used_str, rel_str, count_str, lsn_str;
                 std::getline(line_stream, addr_str, '|');
                 std::getline(line_stream, size_str, '|');
                 std::getline(line_stream, used_str, '|');
                 std::getline(line_stream, rel_str, '|');
                 std::getline(line_stream, count_str, '|');
+                std::getline(line_stream, lsn_str, '|');
                 
                 block_size = std::stoull(size_str);
                 used_space = std::stoull(used_str);
                 relation_name = rel_str;
+                page_lsn = lsn_str.empty() ? 0 : std::stoll(lsn_str);  // Bloques anteriores sin LSN
                 
             } else if (type == "OFFSET_TABLE") {
                 // Parsear tabla de offsets
@@ -0,0 +1,142 @@
+#ifndef BLOCK_COMPRESSOR_H
+#define BLOCK_COMPRESSOR_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Compresor LZSS para las imágenes de bloque del nivel frío
+ *
+ * Los bloques serializados son texto muy repetitivo (prefijos RECORD|,
+ * direcciones, separadores), así que una ventana deslizante pequeña basta.
+ * Formato: un byte de banderas cada 8 elementos; bandera 0 = literal de un
+ * byte, bandera 1 = referencia (desplazamiento de 12 bits, longitud de 4 bits
+ * + MIN_MATCH). Los primeros 4 bytes guardan el tamaño original.
+ */
+class BlockCompressor {
+private:
+    static constexpr size_t WINDOW_SIZE = 4096;
+    static constexpr size_t MIN_MATCH = 3;
+    static constexpr size_t MAX_MATCH = MIN_MATCH + 15;
+    static constexpr size_t HASH_SIZE = 4096;
+
+public:
+    /**
+     * @brief Comprime una cadena arbitraria
+     */
+    static std::string compress(const std::string& input) {
+        std::string output;
+        uint32_t size = static_cast<uint32_t>(input.size());
+        for (int i = 0; i < 4; ++i) {
+            output.push_back(static_cast<char>((size >> (8 * i)) & 0xFF));
+        }
+
+        std::vector<long> head(HASH_SIZE, -1);   // Última posición con cada hash
+        size_t pos = 0;
+
+        while (pos < input.size()) {
+            size_t flag_index = output.size();
+            output.push_back(0);
+            unsigned char flags = 0;
+
+            for (int bit = 0; bit < 8 && pos < input.size(); ++bit) {
+                size_t best_length = 0;
+                size_t best_offset = 0;
+
+                if (pos + MIN_MATCH <= input.size()) {
+                    size_t h = hash(input, pos);
+                    long candidate = head[h];
+                    head[h] = static_cast<long>(pos);
+
+                    if (candidate >= 0 && pos - candidate <= WINDOW_SIZE - 1) {
+                        size_t length = 0;
+                        while (length < MAX_MATCH && pos + length < input.size() &&
+                               input[candidate + length] == input[pos + length]) {
+                            length++;
+                        }
+                        if (length >= MIN_MATCH) {
+                            best_length = length;
+                            best_offset = pos - candidate;
+                        }
+                    }
+                }
+
+                if (best_length > 0) {
+                    flags |= static_cast<unsigned char>(1 << bit);
+                    uint16_t token = static_cast<uint16_t>((best_offset << 4) | (best_length - MIN_MATCH));
+                    output.push_back(static_cast<char>(token & 0xFF));
+                    output.push_back(static_cast<char>(token >> 8));
+
+                    // Registrar las posiciones cubiertas para encontrar coincidencias futuras
+                    for (size_t k = 1; k < best_length && pos + k + MIN_MATCH <= input.size(); ++k) {
+                        head[hash(input, pos + k)] = static_cast<long>(pos + k);
+                    }
+                    pos += best_length;
+                } else {
+                    output.push_back(input[pos]);
+                    pos++;
+                }
+            }
+
+            output[flag_index] = static_cast<char>(flags);
+        }
+
+        return output;
+    }
+
+    /**
+     * @brief Descomprime lo generado por compress
+     * @return false si los datos están corruptos
+     */
+    static bool decompress(const std::string& input, std::string& output) {
+        output.clear();
+        if (input.size() < 4) {
+            return false;
+        }
+
+        uint32_t size = 0;
+        for (int i = 0; i < 4; ++i) {
+            size |= static_cast<uint32_t>(static_cast<unsigned char>(input[i])) << (8 * i);
+        }
+        output.reserve(size);
+
+        size_t pos = 4;
+        while (output.size() < size && pos < input.size()) {
+            unsigned char flags = static_cast<unsigned char>(input[pos++]);
+
+            for (int bit = 0; bit < 8 && output.size() < size; ++bit) {
+                if (flags & (1 << bit)) {
+                    if (pos + 1 >= input.size()) return false;
+                    uint16_t token = static_cast<uint16_t>(static_cast<unsigned char>(input[pos]) |
+                                                           (static_cast<unsigned char>(input[pos + 1]) << 8));
+                    pos += 2;
+
+                    size_t offset = token >> 4;
+                    size_t length = (token & 0x0F) + MIN_MATCH;
+                    if (offset == 0 || offset > output.size()) return false;
+
+                    size_t start = output.size() - offset;
+                    for (size_t k = 0; k < length; ++k) {
+                        output.push_back(output[start + k]);
+                    }
+                } else {
+                    if (pos >= input.size()) return false;
+                    output.push_back(input[pos++]);
+                }
+            }
+        }
+
+        return output.size() == size;
+    }
+
+private:
+    static size_t hash(const std::string& data, size_t pos) {
+        uint32_t value = static_cast<unsigned char>(data[pos]) |
+                         (static_cast<unsigned char>(data[pos + 1]) << 8) |
+                         (static_cast<unsigned char>(data[pos + 2]) << 16);
+        return (value * 2654435761u >> 20) % HASH_SIZE;
+    }
+};
+
+#endif // BLOCK_COMPRESSOR_H
@@ -0,0 +1,115 @@
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * @brief Filtro de Bloom sobre claves enteras
+ *
+ * Responde "seguro que no está" o "puede estar". Usa doble hash
+ * (h1 + i·h2) sobre una mezcla de 64 bits de la clave, así que k
+ * sondas cuestan dos multiplicaciones.
+ */
+class BloomFilter {
+private:
+    std::vector<uint64_t> bits;
+    int hash_count;
+
+public:
+    BloomFilter() : hash_count(0) {}
+
+    /**
+     * @brief Dimensiona el filtro para `expected` claves
+     * @param bits_per_key 10 bits por clave dan ~1% de falsos positivos
+     */
+    BloomFilter(size_t expected, int bits_per_key = 10) {
+        size_t bit_count = std::max<size_t>(64, expected * bits_per_key);
+        bits.assign((bit_count + 63) / 64, 0);
+        // k óptimo = ln2 · bits por clave
+        hash_count = std::max(1, std::min(16, static_cast<int>(bits_per_key * 0.69)));
+    }
+
+    void add(long long key) {
+        if (bits.empty()) return;
+        uint64_t h = mix(static_cast<uint64_t>(key));
+        uint64_t delta = (h >> 33) | 1;
+        uint64_t bit_count = bits.size() * 64;
+        for (int i = 0; i < hash_count; ++i) {
+            uint64_t bit = h % bit_count;
+            bits[bit / 64] |= (1ULL << (bit % 64));
+            h += delta;
+        }
+    }
+
+    bool mayContain(long long key) const {
+        if (bits.empty()) return true;
+        uint64_t h = mix(static_cast<uint64_t>(key));
+        uint64_t delta = (h >> 33) | 1;
+        uint64_t bit_count = bits.size() * 64;
+        for (int i = 0; i < hash_count; ++i) {
+            uint64_t bit = h % bit_count;
+            if ((bits[bit / 64] & (1ULL << (bit % 64))) == 0) {
+                return false;
+            }
+            h += delta;
+        }
+        return true;
+    }
+
+    size_t getBitCount() const { return bits.size() * 64; }
+    int getHashCount() const { return hash_count; }
+
+    /**
+     * @brief Representación `k:hex` para los archivos de metadatos
+     */
+    std::string toString() const {
+        static const char* digits = "0123456789abcdef";
+        std::string text = std::to_string(hash_count) + ":";
+        text.reserve(text.size() + bits.size() * 16);
+        for (uint64_t word : bits) {
+            for (int shift = 60; shift >= 0; shift -= 4) {
+                text += digits[(word >> shift) & 0xF];
+            }
+        }
+        return text;
+    }
+
+    bool fromString(const std::string& text) {
+        size_t colon = text.find(':');
+        if (colon == std::string::npos || (text.size() - colon - 1) % 16 != 0) {
+            return false;
+        }
+        try {
+            hash_count = std::stoi(text.substr(0, colon));
+        } catch (const std::exception&) {
+            return false;
+        }
+
+        bits.assign((text.size() - colon - 1) / 16, 0);
+        for (size_t w = 0; w < bits.size(); ++w) {
+            uint64_t word = 0;
+            for (size_t c = 0; c < 16; ++c) {
+                char digit = text[colon + 1 + w * 16 + c];
+                int value = (digit >= 'a') ? digit - 'a' + 10 : digit - '0';
+                if (value < 0 || value > 15) return false;
+                word = (word << 4) | static_cast<uint64_t>(value);
+            }
+            bits[w] = word;
+        }
+        return true;
+    }
+
+private:
+    static uint64_t mix(uint64_t x) {
+        // splitmix64
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+};
+
+#endif // BLOOM_FILTER_H
@@ -0,0 +1,183 @@
+#ifndef CLUSTERED_INDEX_H
+#define CLUSTERED_INDEX_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include "Record.h"
+#include "PhysicalAddress.h"
+
+/**
+ * @brief Compara dos valores de un campo según su tipo
+ * @return <0, 0 o >0 como strcmp (numérico para INTEGER y FLOAT)
+ */
+inline int compareFieldValues(FieldType type, const std::string& a, const std::string& b) {
+    if (type == FieldType::INTEGER || type == FieldType::FLOAT) {
+        double x = 0.0, y = 0.0;
+        try {
+            x = std::stod(a);
+            y = std::stod(b);
+        } catch (const std::exception&) {
+            return a.compare(b);  // Valores no numéricos: orden de texto
+        }
+        return (x < y) ? -1 : (x > y ? 1 : 0);
+    }
+    return a.compare(b);  // STRING y DATE (AAAA-MM-DD) ordenan como texto
+}
+
+/**
+ * @brief Índice de una tabla agrupada (organizada por índice)
+ *
+ * Las hojas son los propios bloques de datos, ordenados por la clave y con
+ * rangos disjuntos; el nivel interno es un índice disperso en memoria con la
+ * clave mínima de cada hoja, que se reconstruye leyendo las hojas al cargar.
+ * La tabla reserva cilindros completos (la misma pista en todas las
+ * superficies) para que sus hojas queden juntas y un recorrido por rango
+ * apenas mueva el brazo. Solo la clave y los cilindros se guardan en
+ * `metadata/clustered_<tabla>.txt`.
+ */
+class ClusteredIndex {
+public:
+    struct Leaf {
+        std::string low_key;        // Clave mínima (la primera hoja acepta cualquier clave menor)
+        PhysicalAddress address;
+    };
+
+private:
+    std::string key_name;
+    size_t key_field;
+    FieldType key_type;
+    std::vector<Leaf> leaves;       // En orden de clave
+    std::vector<int> cylinders;     // Pistas reservadas, en orden de reserva
+    size_t splits;                  // Divisiones de hoja desde que se cargó
+
+public:
+    ClusteredIndex() : key_field(0), key_type(FieldType::INTEGER), splits(0) {}
+
+    /**
+     * @brief Localiza el campo clave en el esquema
+     */
+    bool configure(const std::vector<FieldDefinition>& schema, const std::string& key) {
+        for (size_t i = 0; i < schema.size(); ++i) {
+            if (schema[i].name == key) {
+                key_name = key;
+                key_field = i;
+                key_type = schema[i].type;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const std::string& getKeyName() const { return key_name; }
+    size_t getKeyField() const { return key_field; }
+    FieldType getKeyType() const { return key_type; }
+
+    std::string keyOf(const Record& record) const { return record.getField(key_field); }
+
+    int compare(const std::string& a, const std::string& b) const {
+        return compareFieldValues(key_type, a, b);
+    }
+
+    /**
+     * @brief Hoja cuyo rango contiene la clave
+     */
+    size_t findLeaf(const std::string& key) const {
+        if (leaves.size() <= 1) return 0;
+        auto it = std::upper_bound(leaves.begin() + 1, leaves.end(), key,
+                                   [this](const std::string& k, const Leaf& leaf) {
+                                       return compare(k, leaf.low_key) < 0;
+                                   });
+        return static_cast<size_t>(it - leaves.begin()) - 1;
+    }
+
+    /**
+     * @brief Posición de la clave dentro de una hoja ordenada
+     */
+    size_t positionInLeaf(const std::vector<std::shared_ptr<Record>>& records, const std::string& key) const {
+        auto it = std::lower_bound(records.begin(), records.end(), key,
+                                   [this](const std::shared_ptr<Record>& record, const std::string& k) {
+                                       return compare(keyOf(*record), k) < 0;
+                                   });
+        return static_cast<size_t>(it - records.begin());
+    }
+
+    const std::vector<Leaf>& getLeaves() const { return leaves; }
+    size_t getLeafCount() const { return leaves.size(); }
+
+    void setLeaves(std::vector<Leaf> ordered) {
+        leaves = std::move(ordered);
+        if (!leaves.empty()) leaves.front().low_key.clear();
+    }
+
+    /**
+     * @brief Registra la hoja creada al dividir `position`
+     */
+    void insertLeafAfter(size_t position, const std::string& low_key, const PhysicalAddress& address) {
+        leaves.insert(leaves.begin() + static_cast<std::ptrdiff_t>(position) + 1, Leaf{low_key, address});
+        splits++;
+    }
+
+    size_t getSplitCount() const { return splits; }
+
+    /**
+     * @brief Actualiza la dirección de una hoja reubicada
+     */
+    void relocateLeaf(const PhysicalAddress& old_address, const PhysicalAddress& new_address) {
+        for (auto& leaf : leaves) {
+            if (leaf.address == old_address) {
+                leaf.address = new_address;
+            }
+        }
+    }
+
+    const std::vector<int>& getCylinders() const { return cylinders; }
+    void addCylinder(int track) { cylinders.push_back(track); }
+    bool ownsCylinder(int track) const {
+        return std::find(cylinders.begin(), cylinders.end(), track) != cylinders.end();
+    }
+
+    bool save(const std::string& path) const {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Error escribiendo el índice agrupado: " << path << std::endl;
+            return false;
+        }
+        file << "key=" << key_name << std::endl;
+        file << "cylinders=";
+        for (size_t i = 0; i < cylinders.size(); ++i) {
+            if (i > 0) file << ",";
+            file << cylinders[i];
+        }
+        file << std::endl;
+        return static_cast<bool>(file);
+    }
+
+    bool load(const std::string& path, const std::vector<FieldDefinition>& schema) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string line;
+        bool configured = false;
+        cylinders.clear();
+        while (std::getline(file, line)) {
+            if (line.find("key=") == 0) {
+                configured = configure(schema, line.substr(4));
+            } else if (line.find("cylinders=") == 0) {
+                std::istringstream tracks(line.substr(10));
+                std::string track;
+                while (std::getline(tracks, track, ',')) {
+                    if (!track.empty()) cylinders.push_back(std::stoi(track));
+                }
+            }
+        }
+        return configured;
+    }
+};
+
+#endif // CLUSTERED_INDEX_H
@@ -0,0 +1,161 @@
+#ifndef DEVICE_MODEL_H
+#define DEVICE_MODEL_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include "DiskConfig.h"
+#include "PhysicalAddress.h"
+
+/**
+ * @brief Tipo de operación de E/S
+ */
+enum class IOType {
+    READ,
+    WRITE
+};
+
+/**
+ * @brief Modelo de tiempos de un dispositivo de almacenamiento
+ *
+ * El reloj de simulación delega en el modelo cuántas unidades independientes
+ * tiene el dispositivo (cada una con su cola), qué unidad atiende cada
+ * petición y cuánto tarda el servicio según el estado interno del dispositivo.
+ */
+class DeviceModel {
+public:
+    virtual ~DeviceModel() = default;
+
+    /**
+     * @brief Nombre legible del modelo
+     */
+    virtual std::string getName() const = 0;
+
+    /**
+     * @brief Número de unidades que atienden peticiones en paralelo
+     */
+    virtual int getParallelUnits() const = 0;
+
+    /**
+     * @brief Bytes transferidos por petición
+     */
+    virtual size_t getRequestSize() const = 0;
+
+    /**
+     * @brief Unidad que atenderá la petición (se decide al llegar)
+     */
+    virtual int unitFor(IOType type, const PhysicalAddress& address) = 0;
+
+    /**
+     * @brief Tiempo de servicio de la petición al empezar a atenderla (ms)
+     *
+     * Puede modificar el estado interno (posición del brazo, mapa de páginas).
+     */
+    virtual double service(int unit, IOType type, const PhysicalAddress& address) = 0;
+
+    /**
+     * @brief Coste relativo de atender `address` a continuación (para SSTF)
+     */
+    virtual long long positioningCost(int unit, const PhysicalAddress& address) const {
+        (void)unit;
+        (void)address;
+        return 0;
+    }
+
+    /**
+     * @brief Devuelve el dispositivo a su estado inicial
+     */
+    virtual void reset() = 0;
+
+    /**
+     * @brief Copia el modelo con su configuración y estado inicial
+     */
+    virtual std::unique_ptr<DeviceModel> clone() const = 0;
+
+    /**
+     * @brief Muestra parámetros y contadores propios del modelo
+     */
+    virtual void displayModel() const = 0;
+};
+
+/**
+ * @brief Disco magnético: búsqueda + latencia rotacional + transferencia
+ *
+ * Usa los tiempos de DiskConfig. Con actuadores independientes cada
+ * superficie es una unidad con su propio brazo; si no, un único brazo.
+ */
+class MagneticDiskModel : public DeviceModel {
+private:
+    struct Head {
+        PhysicalAddress position;
+        bool valid = false;
+    };
+
+    DiskConfig config;
+    bool per_surface;
+    std::vector<Head> heads;
+
+public:
+    explicit MagneticDiskModel(const DiskConfig& disk_config = DiskConfig(),
+                               bool surface_actuators = false)
+        : config(disk_config)
+        , per_surface(surface_actuators)
+    {
+        reset();
+    }
+
+    std::string getName() const override {
+        return per_surface ? "HDD (un actuador por superficie)" : "HDD";
+    }
+
+    int getParallelUnits() const override {
+        return per_surface ? std::max(1, config.getTotalSurfaces()) : 1;
+    }
+
+    size_t getRequestSize() const override {
+        return static_cast<size_t>(config.getBytesPerSector());
+    }
+
+    int unitFor(IOType type, const PhysicalAddress& address) override {
+        (void)type;
+        if (!per_surface) return 0;
+        int surface = address.getPlatter() * config.getSurfacesPerPlatter() + address.getSurface();
+        return std::min(std::max(surface, 0), getParallelUnits() - 1);
+    }
+
+    double service(int unit, IOType type, const PhysicalAddress& address) override {
+        (void)type;
+        Head& head = heads[unit];
+        double time = config.getAccessTime(head.valid ? &head.position : nullptr, address);
+        head.position = address;
+        head.valid = true;
+        return time;
+    }
+
+    long long positioningCost(int unit, const PhysicalAddress& address) const override {
+        const Head& head = heads[unit];
+        if (!head.valid) return 0;
+        return std::abs(address.getTrack() - head.position.getTrack());
+    }
+
+    void reset() override {
+        heads.assign(getParallelUnits(), Head());
+    }
+
+    std::unique_ptr<DeviceModel> clone() const override {
+        return std::make_unique<MagneticDiskModel>(config, per_surface);
+    }
+
+    void displayModel() const override {
+        std::cout << "Modelo: " << getName() << " | Búsqueda media: " << config.getSeekTime()
+                  << " ms | Latencia rotacional: " << config.getRotationalLatency()
+                  << " ms | Transferencia: " << config.getTransferTime() << " ms/sector" << std::endl;
+    }
+
+    const DiskConfig& getDiskConfig() const { return config; }
+};
+
+#endif // DEVICE_MODEL_H
@@ -4,6 +4,36 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include "PhysicalAddress.h"
+
+/**
+ * @brief Zona de grabación (zoned bit recording)
+ *
+ * Rango contiguo de pistas con la misma densidad. Las zonas exteriores
+ * (pistas bajas) tienen más sectores por pista y transfieren más rápido.
+ */
+struct DiskZone {
+    int first_track;            // Primera pista de la zona (inclusive)
+    int last_track;             // Última pista de la zona (inclusive)
+    int sectors_per_track;      // Sectores por pista dentro de la zona
+    double transfer_time_ms;    // Tiempo de transferencia por sector
+
+    DiskZone(int first = 0, int last = 0, int sectors = 1, double transfer = 0.13)
+        : first_track(first), last_track(last), sectors_per_track(sectors), transfer_time_ms(transfer) {}
+
+    int getTrackCount() const { return last_track - first_track + 1; }
+
+    /**
+     * @brief Sectores de la zona en una superficie
+     */
+    long long getSectorsPerSurface() const {
+        return static_cast<long long>(getTrackCount()) * sectors_per_track;
+    }
+};
 
 /**
  * @brief Configuración física del disco simulado
@@ -24,6 +54,12 @@ private:
     double rotational_latency_ms;  // Latencia rotacional promedio
     double transfer_time_ms;    // Tiempo de transferencia por sector
 
+    // Modelo de actuadores: uno compartido o uno independiente por superficie
+    bool independent_actuators;
+
+    // Zonas de grabación; vacío = densidad constante (sectors_per_track)
+    std::vector<DiskZone> zones;
+
 public:
     /**
      * @brief Constructor por defecto - Configuración tipo Megatron 747
@@ -37,6 +73,7 @@ public:
         , seek_time_ms(6.46)
         , rotational_latency_ms(4.17)
         , transfer_time_ms(0.13)
+        , independent_actuators(false)
     {
     }
 
@@ -52,6 +89,7 @@ public:
         , seek_time_ms(6.46)
         , rotational_latency_ms(4.17)
         , transfer_time_ms(0.13)
+        , independent_actuators(false)
     {
     }
 
@@ -64,26 +102,153 @@ public:
     double getSeekTime() const { return seek_time_ms; }
     double getRotationalLatency() const { return rotational_latency_ms; }
     double getTransferTime() const { return transfer_time_ms; }
+    bool hasIndependentActuators() const { return independent_actuators; }
+    bool hasZones() const { return !zones.empty(); }
+
+    /**
+     * @brief Activa un actuador (y una cola) independiente por superficie
+     *
+     * Con actuadores independientes la asignación reparte los bloques
+     * consecutivos entre superficies para que se puedan leer en paralelo.
+     */
+    void setIndependentActuators(bool enabled) { independent_actuators = enabled; }
+
+    /**
+     * @brief Define las zonas de grabación del disco
+     *
+     * Deben cubrir todas las pistas, ser contiguas y estar ordenadas desde la
+     * exterior; sectors_per_track pasa a ser el máximo de las zonas.
+     */
+    bool setZones(const std::vector<DiskZone>& new_zones) {
+        if (!zonesCoverTracks(new_zones)) {
+            return false;
+        }
+
+        zones = new_zones;
+        sectors_per_track = 0;
+        for (const auto& zone : zones) {
+            sectors_per_track = std::max(sectors_per_track, zone.sectors_per_track);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Divide las pistas en `count` zonas con densidad decreciente
+     *
+     * La zona exterior conserva sectors_per_track y la interior tiene
+     * aproximadamente `inner_ratio` veces esos sectores. Como la rotación es
+     * constante, la transferencia por sector es inversa a la densidad.
+     */
+    bool setLinearZones(int count, double inner_ratio = 0.5) {
+        if (count <= 0 || count > tracks_per_surface || inner_ratio <= 0.0 || inner_ratio > 1.0) {
+            return false;
+        }
+
+        int outer_sectors = getMaxSectorsPerTrack();
+        double outer_transfer = getZone(0).transfer_time_ms;
+        std::vector<DiskZone> new_zones;
+
+        for (int z = 0; z < count; ++z) {
+            double ratio = (count == 1) ? 1.0 : 1.0 - (1.0 - inner_ratio) * z / (count - 1);
+            int sectors = std::max(1, static_cast<int>(outer_sectors * ratio));
+            int first = static_cast<int>(static_cast<long long>(tracks_per_surface) * z / count);
+            int last = static_cast<int>(static_cast<long long>(tracks_per_surface) * (z + 1) / count) - 1;
+            new_zones.emplace_back(first, last, sectors,
+                                   outer_transfer * outer_sectors / sectors);
+        }
+        return setZones(new_zones);
+    }
+
+    /**
+     * @brief Número de zonas (1 si la densidad es constante)
+     */
+    int getZoneCount() const {
+        return zones.empty() ? 1 : static_cast<int>(zones.size());
+    }
+
+    /**
+     * @brief Zona `index`; sin zonas definidas devuelve una única zona uniforme
+     */
+    DiskZone getZone(int index) const {
+        if (zones.empty()) {
+            return DiskZone(0, tracks_per_surface - 1, sectors_per_track, transfer_time_ms);
+        }
+        return zones[index];
+    }
+
+    /**
+     * @brief Zona a la que pertenece una pista
+     */
+    int getZoneForTrack(int track) const {
+        for (size_t z = 0; z < zones.size(); ++z) {
+            if (track >= zones[z].first_track && track <= zones[z].last_track) {
+                return static_cast<int>(z);
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Sectores de una pista concreta
+     */
+    int getSectorsPerTrack(int track) const {
+        return zones.empty() ? sectors_per_track : zones[getZoneForTrack(track)].sectors_per_track;
+    }
+
+    /**
+     * @brief Tiempo de transferencia por sector en una pista concreta
+     */
+    double getTransferTime(int track) const {
+        return zones.empty() ? transfer_time_ms : zones[getZoneForTrack(track)].transfer_time_ms;
+    }
+
+    /**
+     * @brief Máximo de sectores por pista (zona exterior)
+     */
+    int getMaxSectorsPerTrack() const {
+        return sectors_per_track;
+    }
+
+    /**
+     * @brief Sectores de una superficie completa
+     */
+    long long getSectorsPerSurface() const {
+        long long total = 0;
+        for (int z = 0; z < getZoneCount(); ++z) {
+            total += getZone(z).getSectorsPerSurface();
+        }
+        return total;
+    }
+
+    /**
+     * @brief Bloques de una zona sumando todas las superficies
+     */
+    long long getZoneCapacity(int zone) const {
+        return getZone(zone).getSectorsPerSurface() * getTotalSurfaces();
+    }
+
+    /**
+     * @brief Valida una dirección contra la geometría (incluidas las zonas)
+     */
+    bool isValidAddress(const PhysicalAddress& address) const {
+        return address.getPlatter() >= 0 && address.getPlatter() < num_platters &&
+               address.getSurface() >= 0 && address.getSurface() < surfaces_per_platter &&
+               address.getTrack() >= 0 && address.getTrack() < tracks_per_surface &&
+               address.getSector() >= 0 && address.getSector() < getSectorsPerTrack(address.getTrack());
+    }
 
     /**
      * @brief Calcula la capacidad total del disco en bytes
      */
     long long getTotalCapacity() const {
-        return static_cast<long long>(num_platters) * 
-               surfaces_per_platter * 
-               tracks_per_surface * 
-               sectors_per_track * 
-               bytes_per_sector;
+        return getTotalSectors() * bytes_per_sector;
     }
 
     /**
      * @brief Calcula el número total de sectores
      */
     long long getTotalSectors() const {
-        return static_cast<long long>(num_platters) * 
-               surfaces_per_platter * 
-               tracks_per_surface * 
-               sectors_per_track;
+        return getSectorsPerSurface() * getTotalSurfaces();
     }
 
     /**
@@ -93,6 +258,124 @@ public:
         return num_platters * surfaces_per_platter;
     }
 
+    /**
+     * @brief Convierte un número de bloque lineal en dirección física
+     *
+     * Con un solo actuador el orden es secuencial (sector -> pista -> superficie
+     * -> plato). Con actuadores independientes, los bloques consecutivos se
+     * reparten entre superficies y dentro de cada una avanzan secuencialmente.
+     */
+    PhysicalAddress blockToAddress(long long block_number) const {
+        long long surface_index;
+        long long offset;
+
+        if (independent_actuators) {
+            surface_index = block_number % getTotalSurfaces();
+            offset = block_number / getTotalSurfaces();
+        } else {
+            long long per_surface = getSectorsPerSurface();
+            surface_index = block_number / per_surface;
+            offset = block_number % per_surface;
+        }
+
+        return surfaceOffsetToAddress(surface_index, offset);
+    }
+
+    /**
+     * @brief Inversa de blockToAddress
+     */
+    long long addressToBlock(const PhysicalAddress& address) const {
+        long long surface_index = static_cast<long long>(address.getPlatter()) * surfaces_per_platter +
+                                  address.getSurface();
+        long long offset = addressToSurfaceOffset(address);
+
+        if (independent_actuators) {
+            return offset * getTotalSurfaces() + surface_index;
+        }
+        return surface_index * getSectorsPerSurface() + offset;
+    }
+
+    /**
+     * @brief Dirección del bloque `index` dentro de una zona
+     *
+     * Mismo criterio que blockToAddress pero restringido a las pistas de la
+     * zona, para que el asignador pueda elegir en qué zona coloca cada tabla.
+     */
+    PhysicalAddress zoneBlockToAddress(int zone, long long index) const {
+        DiskZone z = getZone(zone);
+        long long per_surface = z.getSectorsPerSurface();
+        long long surface_index;
+        long long offset;
+
+        if (independent_actuators) {
+            surface_index = index % getTotalSurfaces();
+            offset = index / getTotalSurfaces();
+        } else {
+            surface_index = index / per_surface;
+            offset = index % per_surface;
+        }
+
+        return PhysicalAddress(static_cast<int>(surface_index / surfaces_per_platter),
+                               static_cast<int>(surface_index % surfaces_per_platter),
+                               z.first_track + static_cast<int>(offset / z.sectors_per_track),
+                               static_cast<int>(offset % z.sectors_per_track));
+    }
+
+    /**
+     * @brief Inversa de zoneBlockToAddress (la zona se deduce de la pista)
+     */
+    long long addressToZoneBlock(const PhysicalAddress& address) const {
+        DiskZone z = getZone(getZoneForTrack(address.getTrack()));
+        long long surface_index = static_cast<long long>(address.getPlatter()) * surfaces_per_platter +
+                                  address.getSurface();
+        long long offset = static_cast<long long>(address.getTrack() - z.first_track) * z.sectors_per_track +
+                           address.getSector();
+
+        if (independent_actuators) {
+            return offset * getTotalSurfaces() + surface_index;
+        }
+        return surface_index * z.getSectorsPerSurface() + offset;
+    }
+
+    /**
+     * @brief Tiempo de búsqueda para desplazar el brazo `distance` cilindros
+     *
+     * Crece linealmente con la distancia y vale seek_time_ms para la distancia
+     * media (un tercio de las pistas); el mínimo es el 20% del promedio.
+     */
+    double getSeekTime(int distance) const {
+        if (distance <= 0) return 0.0;
+        double average_distance = std::max(1.0, tracks_per_surface / 3.0);
+        return seek_time_ms * (0.2 + 0.8 * distance / average_distance);
+    }
+
+    /**
+     * @brief Tiempo de servicio de un sector según la posición previa del brazo
+     *
+     * Se paga búsqueda al cambiar de cilindro (promedio si no se conoce la
+     * posición), latencia rotacional salvo que el sector sea el siguiente en la
+     * misma superficie, y siempre transferencia.
+     * @param previous Última dirección servida por el actuador (nullptr si se desconoce)
+     */
+    double getAccessTime(const PhysicalAddress* previous, const PhysicalAddress& target) const {
+        double time = getTransferTime(target.getTrack());
+
+        if (!previous) {
+            return time + seek_time_ms + rotational_latency_ms;
+        }
+        if (previous->getTrack() != target.getTrack()) {
+            return time + getSeekTime(std::abs(previous->getTrack() - target.getTrack())) +
+                   rotational_latency_ms;
+        }
+
+        bool same_surface = previous->getPlatter() == target.getPlatter() &&
+                            previous->getSurface() == target.getSurface();
+        if (!same_surface || target.getSector() != previous->getSector() + 1) {
+            time += rotational_latency_ms;
+        }
+        return time;
+    }
+
     /**
      * @brief Formatea la capacidad en unidades legibles
      */
@@ -127,6 +410,14 @@ public:
         std::cout << "Tiempo de búsqueda promedio: " << seek_time_ms << " ms" << std::endl;
         std::cout << "Latencia rotacional promedio: " << rotational_latency_ms << " ms" << std::endl;
         std::cout << "Tiempo de transferencia: " << transfer_time_ms << " ms/sector" << std::endl;
+        std::cout << "Actuadores: "
+                  << (independent_actuators ? "uno por superficie" : "uno compartido") << std::endl;
+
+        for (size_t z = 0; z < zones.size(); ++z) {
+            std::cout << "Zona " << z << ": pistas " << zones[z].first_track << "-"
+                      << zones[z].last_track << ", " << zones[z].sectors_per_track
+                      << " sectores/pista, " << zones[z].transfer_time_ms << " ms/sector" << std::endl;
+        }
     }
 
     /**
@@ -147,11 +438,103 @@ public:
         file << "seek_time_ms=" << seek_time_ms << std::endl;
         file << "rotational_latency_ms=" << rotational_latency_ms << std::endl;
         file << "transfer_time_ms=" << transfer_time_ms << std::endl;
+        file << "independent_actuators=" << (independent_actuators ? 1 : 0) << std::endl;
+        for (const auto& zone : zones) {
+            file << "zone=" << zone.first_track << "," << zone.last_track << ","
+                 << zone.sectors_per_track << "," << zone.transfer_time_ms << std::endl;
+        }
         
         file.close();
         return true;
     }
 
+    /**
+     * @brief Carga la configuración guardada por saveToFile
+     *
+     * Solo reemplaza la configuración actual si el archivo tiene todos los
+     * parámetros de geometría y el resultado es válido.
+     */
+    bool loadFromFile(const std::string& filepath) {
+        std::ifstream file(filepath);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        DiskConfig loaded;
+        std::vector<DiskZone> loaded_zones;
+        int geometry_keys = 0;
+        std::string line;
+
+        try {
+            while (std::getline(file, line)) {
+                if (line.empty() || line[0] == '#') continue;
+
+                size_t eq = line.find('=');
+                if (eq == std::string::npos) {
+                    std::cerr << "Línea inválida en " << filepath << ": " << line << std::endl;
+                    return false;
+                }
+                std::string key = line.substr(0, eq);
+                std::string value = line.substr(eq + 1);
+
+                if (key == "num_platters") {
+                    loaded.num_platters = std::stoi(value); geometry_keys++;
+                } else if (key == "surfaces_per_platter") {
+                    loaded.surfaces_per_platter = std::stoi(value); geometry_keys++;
+                } else if (key == "tracks_per_surface") {
+                    loaded.tracks_per_surface = std::stoi(value); geometry_keys++;
+                } else if (key == "sectors_per_track") {
+                    loaded.sectors_per_track = std::stoi(value); geometry_keys++;
+                } else if (key == "bytes_per_sector") {
+                    loaded.bytes_per_sector = std::stoi(value); geometry_keys++;
+                } else if (key == "seek_time_ms") {
+                    loaded.seek_time_ms = std::stod(value);
+                } else if (key == "rotational_latency_ms") {
+                    loaded.rotational_latency_ms = std::stod(value);
+                } else if (key == "transfer_time_ms") {
+                    loaded.transfer_time_ms = std::stod(value);
+                } else if (key == "independent_actuators") {
+                    loaded.independent_actuators = (value == "1");
+                } else if (key == "zone") {
+                    std::istringstream iss(value);
+                    std::string first, last, sectors, transfer;
+                    std::getline(iss, first, ',');
+                    std::getline(iss, last, ',');
+                    std::getline(iss, sectors, ',');
+                    std::getline(iss, transfer);
+                    loaded_zones.emplace_back(std::stoi(first), std::stoi(last),
+                                              std::stoi(sectors), std::stod(transfer));
+                } else {
+                    std::cerr << "Parámetro desconocido en " << filepath << ": " << key << std::endl;
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Valor inválido en " << filepath << ": " << line << std::endl;
+            return false;
+        }
+
+        if (geometry_keys < 5) {
+            std::cerr << "Faltan parámetros de geometría en " << filepath << std::endl;
+            return false;
+        }
+        if (loaded.seek_time_ms < 0.0 || loaded.rotational_latency_ms < 0.0 ||
+            loaded.transfer_time_ms <= 0.0) {
+            std::cerr << "Parámetros de tiempo inválidos en " << filepath << std::endl;
+            return false;
+        }
+        if (!loaded_zones.empty() && !loaded.setZones(loaded_zones)) {
+            std::cerr << "Zonas de grabación inválidas en " << filepath << std::endl;
+            return false;
+        }
+        if (!loaded.isValid()) {
+            std::cerr << "Geometría inválida en " << filepath << std::endl;
+            return false;
+        }
+
+        *this = loaded;
+        return true;
+    }
+
     /**
      * @brief Valida que la configuración sea consistente
      */
@@ -160,7 +543,59 @@ public:
                surfaces_per_platter > 0 && 
                tracks_per_surface > 0 && 
                sectors_per_track > 0 && 
-               bytes_per_sector > 0;
+               bytes_per_sector > 0 &&
+               (zones.empty() || zonesCoverTracks(zones));
+    }
+
+private:
+    /**
+     * @brief Traduce un desplazamiento dentro de una superficie a dirección
+     */
+    PhysicalAddress surfaceOffsetToAddress(long long surface_index, long long offset) const {
+        int platter = static_cast<int>(surface_index / surfaces_per_platter);
+        int surface = static_cast<int>(surface_index % surfaces_per_platter);
+
+        for (int z = 0; z < getZoneCount(); ++z) {
+            DiskZone zone = getZone(z);
+            if (offset < zone.getSectorsPerSurface() || z == getZoneCount() - 1) {
+                return PhysicalAddress(platter, surface,
+                                       zone.first_track + static_cast<int>(offset / zone.sectors_per_track),
+                                       static_cast<int>(offset % zone.sectors_per_track));
+            }
+            offset -= zone.getSectorsPerSurface();
+        }
+        return PhysicalAddress(platter, surface, 0, 0);
+    }
+
+    /**
+     * @brief Desplazamiento de una dirección dentro de su superficie
+     */
+    long long addressToSurfaceOffset(const PhysicalAddress& address) const {
+        long long offset = 0;
+        for (int z = 0; z < getZoneCount(); ++z) {
+            DiskZone zone = getZone(z);
+            if (address.getTrack() <= zone.last_track) {
+                return offset + static_cast<long long>(address.getTrack() - zone.first_track) *
+                                zone.sectors_per_track + address.getSector();
+            }
+            offset += zone.getSectorsPerSurface();
+        }
+        return offset;
+    }
+
+    /**
+     * @brief Comprueba que las zonas sean contiguas y cubran todas las pistas
+     */
+    bool zonesCoverTracks(const std::vector<DiskZone>& candidate) const {
+        int expected = 0;
+        for (const auto& zone : candidate) {
+            if (zone.first_track != expected || zone.last_track < zone.first_track ||
+                zone.sectors_per_track <= 0 || zone.transfer_time_ms <= 0.0) {
+                return false;
+            }
+            expected = zone.last_track + 1;
+        }
+        return !candidate.empty() && expected == tracks_per_surface;
     }
 };
 
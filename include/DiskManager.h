@@ -2,19 +2,315 @@
 #define DISK_MANAGER_H
 
 #include <map>
+#include <algorithm>
+#include <set>
 #include <memory>
 #include <vector>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <functional>
 #include <random>
+#include <cmath>
 #include "DiskConfig.h"
+#include "DiskSimulationClock.h"
+#include "SSDModel.h"
 #include "FileSystemSimulator.h"
+#include "WriteAheadLog.h"
+#include "SnapshotArchive.h"
+#include "ShippingLog.h"
+#include "LSMTree.h"
+#include "ClusteredIndex.h"
+#include "BitmapIndex.h"
+#include "RadixIndex.h"
+#include "BTreeIndex.h"
+#include "FreeSpaceMap.h"
+#include "TrigramIndex.h"
+#include "MaterializedView.h"
+#include "QueryResultCache.h"
+#include "SampleEstimator.h"
+#include "Sketches.h"
+#include "WindowFunction.h"
+#include "PipelineKernels.h"
+#include "VectorExpression.h"
 #include "Block.h"
 #include "Record.h"
 #include "PhysicalAddress.h"
 
+/**
+ * @brief Tiempos simulados de un recorrido completo de una relación
+ */
+struct ScanTimingReport {
+    size_t blocks = 0;                  // Bloques recorridos
+    double single_actuator_ms = 0.0;    // Un brazo atiende todas las peticiones
+    double per_surface_ms = 0.0;        // Makespan con un brazo por superficie
+    int surfaces_used = 0;              // Superficies que contienen bloques de la relación
+    std::map<int, size_t> blocks_per_zone;  // Reparto de los bloques entre zonas
+};
+
+/**
+ * @brief Resultado de una instantánea en línea
+ */
+struct SnapshotReport {
+    std::string archive_path;
+    bool ok = false;
+    bool incremental = false;
+    long long base_lsn = 0;             // LSN del respaldo anterior (0 = completo)
+    long long lsn = 0;                  // LSN de página más alto incluido
+    size_t blocks = 0;                  // Bloques congelados copiados al archivo
+    size_t total_blocks = 0;            // Bloques vivos al congelar
+    size_t redirected_writes = 0;       // Escrituras desviadas a bloques en sombra
+    long long copied_bytes = 0;         // Bytes de bloque copiados
+    long long total_bytes = 0;          // Bytes de bloque de todo el disco
+    long long raw_bytes = 0;            // Bytes de las imágenes sin comprimir
+    long long archive_bytes = 0;        // Tamaño del archivo de respaldo
+    double elapsed_ms = 0.0;            // Duración del volcado en segundo plano
+};
+
+/**
+ * @brief Nivel de almacenamiento de una relación
+ *
+ * MEMORY: todos los bloques residen en memoria y cada modificación se registra
+ * en el WAL; DISK: archivos de sector normales; COLD: bloques comprimidos.
+ */
+enum class StorageTier {
+    MEMORY,
+    DISK,
+    COLD
+};
+
+inline std::string storageTierToString(StorageTier tier) {
+    switch (tier) {
+        case StorageTier::MEMORY: return "MEMORY";
+        case StorageTier::COLD: return "COLD";
+        default: return "DISK";
+    }
+}
+
+inline StorageTier storageTierFromString(const std::string& text) {
+    if (text == "MEMORY") return StorageTier::MEMORY;
+    if (text == "COLD") return StorageTier::COLD;
+    return StorageTier::DISK;
+}
+
+/**
+ * @brief Organización de los registros de una relación
+ *
+ * HEAP: cada registro va al primer bloque con espacio y se modifica en su
+ * sitio; LSM: memtable y secuencias ordenadas inmutables (ver LSMTree);
+ * CLUSTERED: hojas ordenadas por una clave en cilindros propios (ver
+ * ClusteredIndex).
+ */
+enum class TableOrganization {
+    HEAP,
+    LSM,
+    CLUSTERED
+};
+
+inline std::string tableOrganizationToString(TableOrganization organization) {
+    switch (organization) {
+        case TableOrganization::LSM: return "LSM";
+        case TableOrganization::CLUSTERED: return "CLUSTERED";
+        default: return "HEAP";
+    }
+}
+
+inline TableOrganization tableOrganizationFromString(const std::string& text) {
+    if (text == "LSM") return TableOrganization::LSM;
+    if (text == "CLUSTERED") return TableOrganization::CLUSTERED;
+    return TableOrganization::HEAP;
+}
+
+/**
+ * @brief Resultado de una consulta por rango sobre un campo
+ */
+struct RangeScanReport {
+    std::vector<std::shared_ptr<Record>> records;
+    size_t blocks_read = 0;
+    size_t cylinder_changes = 0;        // Lecturas consecutivas en cilindros distintos
+    double simulated_ms = 0.0;
+    bool from_cache = false;            // Servida por la caché de resultados sin leer bloques
+};
+
+/**
+ * @brief Resultado de un recorrido heap guiado por mapas de bits
+ */
+struct BitmapScanReport {
+    std::vector<std::shared_ptr<Record>> records;
+    size_t candidate_rows = 0;          // Filas que dejaron los mapas de bits
+    size_t blocks_read = 0;             // Bloques de datos leídos en la recogida final
+    size_t table_blocks = 0;            // Bloques de la tabla (coste de un recorrido completo)
+    double bitmap_ms = 0.0;             // Tiempo real de combinar los mapas
+    double simulated_ms = 0.0;          // E/S simulada de la recogida
+    bool from_cache = false;
+};
+
+/**
+ * @brief Resultado de una búsqueda LIKE
+ */
+struct LikeSearchReport {
+    std::vector<std::shared_ptr<Record>> records;
+    bool used_index = false;            // false: patrón sin trigramas, recorrido completo
+    size_t trigrams = 0;                // Trigramas del patrón
+    size_t candidates = 0;              // Filas tras intersecar las listas
+    size_t index_blocks_read = 0;
+    size_t data_blocks_read = 0;
+    size_t table_blocks = 0;
+    double simulated_ms = 0.0;
+    bool from_cache = false;
+};
+
+/**
+ * @brief Resultado de un agregado aproximado sobre una muestra
+ */
+struct ApproximateAggregateReport {
+    Estimate estimate;
+    bool valid = false;                 // false: tabla, columna o agregado no admitidos
+    bool exact = false;                 // Se leyeron todos los bloques y todas las filas
+    size_t blocks_read = 0;
+    size_t table_blocks = 0;
+    size_t rows_seen = 0;               // Filas vivas de los bloques leídos
+    size_t rows_sampled = 0;            // Filas elegidas por el muestreo de filas
+    double simulated_ms = 0.0;
+};
+
+/**
+ * @brief Resultado de APPROX_COUNT_DISTINCT / APPROX_PERCENTILE sobre una columna
+ */
+struct SketchAggregateReport {
+    ColumnSketch sketch;
+    bool valid = false;                 // false: tabla o columna no admitidas
+    size_t workers = 1;                 // Trabajadores que recorrieron los bloques leídos
+    size_t blocks_read = 0;             // Bloques de datos leídos (sin resumen vigente)
+    size_t summaries_used = 0;          // Bloques respondidos con su resumen guardado
+    size_t rows_seen = 0;
+    double simulated_ms = 0.0;          // E/S simulada
+    double compute_ms = 0.0;            // Tiempo real de construir y combinar los sketches
+};
+
+/**
+ * @brief Resultado de una consulta con funciones de ventana
+ */
+struct WindowReport {
+    std::vector<std::string> header;    // Columnas de la tabla y una por llamada
+    bool valid = false;
+    size_t rows = 0;
+    size_t partitions = 0;
+    size_t largest_partition = 0;
+    size_t sort_runs = 0;               // Tramos ordenados volcados a disco (0: orden en memoria)
+    size_t spilled_partitions = 0;      // Particiones cuyas filas no cabían en memoria
+    size_t spill_blocks_written = 0;
+    size_t spill_blocks_read = 0;
+    size_t peak_rows = 0;               // Filas completas en memoria a la vez, como máximo
+    size_t workers = 1;
+    double simulated_ms = 0.0;          // E/S simulada: lectura de la tabla y volcados
+    double compute_ms = 0.0;            // Tiempo real de evaluar las particiones
+};
+
+/**
+ * @brief Camino de ejecución de una consulta de filtro y agregado
+ */
+enum class ExecutionMode {
+    INTERPRETED,                        // Árbol de operadores con llamadas virtuales por tupla
+    FUSED                               // Núcleo de plantilla elegido en tiempo de plan
+};
+
+/**
+ * @brief Resultado de filterAggregate
+ */
+struct FilterAggregateReport {
+    bool valid = false;
+    double value = 0.0;                 // NaN si es NULL (ninguna fila pasó el filtro)
+    std::string kernel;                 // Instancia elegida o "interpretado"
+    size_t rows_scanned = 0;
+    size_t rows_matched = 0;
+    double simulated_ms = 0.0;          // E/S simulada del recorrido
+    double decode_ms = 0.0;             // Tiempo real de decodificar las columnas
+    double execute_ms = 0.0;            // Tiempo real del pipeline (suma del mejor de cada lote)
+};
+
+/**
+ * @brief Resultado de vectorQuery
+ */
+struct VectorQueryReport {
+    bool valid = false;
+    std::vector<std::string> header;
+    std::vector<std::vector<std::string>> rows;
+    size_t rows_scanned = 0;
+    size_t rows_selected = 0;           // Filas que pasaron el WHERE
+    size_t batches = 0;
+    size_t groups = 0;                  // 0 si la consulta no agrega
+    double simulated_ms = 0.0;          // E/S simulada del recorrido
+    double execute_ms = 0.0;            // Tiempo real de decodificar, evaluar, agrupar y ordenar
+};
+
+/**
+ * @brief Avance de una construcción de índice: fase, unidades hechas y total
+ */
+using IndexBuildProgress = std::function<void(const std::string& phase, size_t done, size_t total)>;
+
+/**
+ * @brief Resultado de createBTreeIndex
+ */
+struct IndexBuildReport {
+    bool valid = false;
+    size_t rows = 0;
+    size_t blocks = 0;
+    size_t workers = 1;
+    size_t height = 0;
+    size_t nodes = 0;
+    double simulated_ms = 0.0;          // E/S simulada de la lectura de la tabla
+    double scan_ms = 0.0;               // Lectura por lotes de bloques y ordenación de los tramos
+    double sort_ms = 0.0;               // Parte de scan_ms del hilo que más tardó en ordenar
+    double merge_ms = 0.0;              // Mezcla por particiones de claves y llenado de hojas
+    double load_ms = 0.0;               // Enlace de las hojas y niveles internos
+    double total_ms = 0.0;
+};
+
+/**
+ * @brief Cómo se sincronizan los hilos de benchmarkBTreeConcurrency
+ */
+enum class IndexLatching {
+    GLOBAL,                             // Un mutex alrededor de cada operación
+    OPTIMISTIC                          // Versiones por nodo del propio árbol
+};
+
+/**
+ * @brief Resultado de benchmarkBTreeConcurrency
+ */
+struct IndexConcurrencyReport {
+    bool valid = false;
+    size_t threads = 0;
+    size_t operations = 0;
+    size_t lookups = 0;
+    size_t inserts = 0;
+    double elapsed_ms = 0.0;
+    double ops_per_second = 0.0;
+    uint64_t restarts = 0;              // Operaciones repetidas por conflicto de versión
+    size_t entries_after = 0;
+};
+
+/**
+ * @brief Resultado de insertRecordsParallel
+ */
+struct InsertBatchReport {
+    bool valid = false;
+    size_t rows = 0;
+    size_t workers = 1;
+    size_t new_blocks = 0;
+    size_t reused_blocks = 0;           // Bloques que ya existían y recibieron filas
+    double insert_ms = 0.0;             // Fase paralela: construir los registros y colocarlos
+    double finish_ms = 0.0;             // Persistencia, índices y vistas (en serie)
+    double simulated_ms = 0.0;          // E/S simulada de escribir los bloques tocados
+    double total_ms = 0.0;
+    double rows_per_second = 0.0;       // Sobre total_ms: lo que ve quien llama
+    double placement_rows_per_second = 0.0;   // Sobre insert_ms: solo la fase paralela
+};
+
 /**
  * @brief Gestor principal del SGBD físico
  * 
@@ -30,13 +326,108 @@ private:
     FileSystemSimulator filesystem;
     std::map<PhysicalAddress, std::shared_ptr<Block>> block_cache;  // Cache de bloques
     std::map<std::string, std::vector<PhysicalAddress>> relation_blocks;  // Bloques por relación
-    PhysicalAddress next_free_address;
+    std::vector<long long> zone_next_block;  // Próximo bloque libre de cada zona
+    std::vector<std::vector<PhysicalAddress>> zone_free_blocks;  // Huecos por debajo del cursor de cada zona
     int next_record_id;
     
-    // Estadísticas
-    size_t total_reads;
-    size_t total_writes;
-    double total_access_time;
+    // Simulación de tiempos de E/S (eventos discretos)
+    DiskSimulationClock io_clock;
+
+    // Niveles de almacenamiento
+    using SteadyClock = std::chrono::steady_clock;
+    static constexpr size_t WAL_CHECKPOINT_BYTES = 4 << 20;  // Crecimiento del WAL tolerado entre checkpoints
+    WriteAheadLog wal;                                   // Durabilidad del nivel en memoria
+    size_t wal_checkpoint_bytes = 0;                     // Tamaño del WAL tras el último checkpoint
+    std::map<std::string, StorageTier> table_tiers;      // Nivel de cada relación (DISK si no figura)
+    std::set<PhysicalAddress> cold_blocks;               // Bloques guardados comprimidos
+    std::map<PhysicalAddress, SteadyClock::time_point> last_access;
+    std::chrono::milliseconds demotion_period{0};        // 0 = sin degradación automática
+    SteadyClock::time_point last_demotion_sweep;
+
+    // LSN de página: contador global que se sella en cada bloque al persistirlo
+    long long last_page_lsn;
+    std::map<PhysicalAddress, long long> block_lsns;
+
+    // Envío de log a réplicas (inactivo si no se abrió un directorio)
+    ShippingLog ship_log;
+
+    // Relaciones con organización LSM (sus bloques también figuran en relation_blocks)
+    std::map<std::string, std::unique_ptr<LSMTree>> lsm_trees;
+
+    // Tablas agrupadas y cilindros reservados para ellas (pista -> tabla)
+    static constexpr double CLUSTERED_FILL_FACTOR = 0.9;  // Ocupación al reorganizar
+    std::map<std::string, ClusteredIndex> clustered_tables;
+    std::map<int, std::string> claimed_cylinders;
+
+    // Índices de mapas de bits de las tablas heap
+    std::map<std::string, BitmapIndex> bitmap_indexes;
+
+    // Índices ART en memoria de las tablas heap (tabla -> columna -> índice)
+    std::map<std::string, std::map<std::string, RadixIndex>> radix_indexes;
+
+    // Índices B+ secundarios de las tablas heap (tabla -> columna -> índice)
+    static constexpr double BTREE_FILL_FACTOR = 0.9;        // Ocupación de las hojas al construir
+    static constexpr size_t INDEX_BUILD_MORSEL_BLOCKS = 8;  // Bloques que toma un hilo de una vez
+    std::map<std::string, std::map<std::string, BTreeIndex>> btree_indexes;
+
+    // Índices de trigramas de las tablas heap (tabla -> columna -> índice)
+    std::map<std::string, std::map<std::string, TrigramIndex>> trigram_indexes;
+
+    // Réplica: tablas cuyos índices de filas quedaron atrás al aplicar bloques del primario
+    std::set<std::string> stale_row_indexes;
+
+    // Espacio libre de las tablas heap, construido al primer uso (ver FreeSpaceMap)
+    static constexpr size_t INSERT_EXTENT_BLOCKS = 8;       // Direcciones que se piden de una vez
+    static constexpr size_t INSERT_MORSEL_ROWS = 256;       // Filas que toma un hilo de una vez
+    std::map<std::string, std::unique_ptr<FreeSpaceMap>> free_space_maps;
+
+    /**
+     * @brief Esquema ya leído de metadata/schema_<tabla>.txt
+     */
+    struct CachedSchema {
+        std::vector<FieldDefinition> fields;
+        bool fixed_record = true;
+        bool hot = false;
+        TableOrganization organization = TableOrganization::HEAP;
+    };
+    std::map<std::string, CachedSchema> schema_cache;       // Se descarta al reescribir el archivo
+
+    // Vistas materializadas de agregados (vista -> definición y directorio de grupos)
+    std::map<std::string, MaterializedView> materialized_views;
+
+    // Caché de resultados de rangeScan, bitmapHeapScan y likeSearch (desactivada por defecto)
+    QueryResultCache result_cache;
+
+    /**
+     * @brief Resumen de una columna en un bloque, vigente mientras el LSN del bloque no cambie
+     */
+    struct BlockSketch {
+        long long lsn = 0;
+        ColumnSketch sketch;
+    };
+    
+    // Resúmenes por bloque para agregados aproximados (tabla -> columna -> bloque)
+    std::map<std::string, std::map<std::string, std::map<PhysicalAddress, BlockSketch>>> column_sketches;
+
+    /**
+     * @brief Bloque congelado que la instantánea debe copiar
+     */
+    struct FrozenBlock {
+        std::string relation;
+        PhysicalAddress address;
+        StorageTier tier;
+        bool cold;
+        std::string image;      // Imagen capturada al congelar (solo nivel en memoria)
+    };
+
+    // Instantánea en línea (paginación en sombra)
+    std::set<PhysicalAddress> frozen_blocks;             // Sectores que el volcado todavía lee
+    std::vector<PhysicalAddress> shadowed_blocks;        // Versiones congeladas ya sustituidas
+    std::thread snapshot_thread;
+    std::atomic<bool> snapshot_running{false};
+    std::atomic<size_t> snapshot_progress{0};
+    size_t snapshot_total;
+    SnapshotReport snapshot_report;
 
 public:
     /**
@@ -44,14 +435,23 @@ public:
      */
     DiskManager(const std::string& disk_path = "./disk_simulation") 
         : filesystem(disk_path)
-        , next_free_address(0, 0, 0, 0)
         , next_record_id(1)
-        , total_reads(0)
-        , total_writes(0)
-        , total_access_time(0.0)
+        , last_page_lsn(0)
+        , snapshot_total(0)
     {
     }
 
+    /**
+     * @brief Espera a las compactaciones LSM y a la instantánea en curso
+     */
+    ~DiskManager() {
+        pollLSMCompactions(true);
+        finishSnapshot();
+    }
+
+    DiskManager(const DiskManager&) = delete;
+    DiskManager& operator=(const DiskManager&) = delete;
+
     /**
      * @brief Inicializa el disco con configuración personalizada
      */
@@ -61,6 +461,21 @@ public:
         if (!filesystem.initialize(config)) {
             return false;
         }
+        io_clock.configure(config, config.hasIndependentActuators());
+        zone_next_block.assign(config.getZoneCount(), 0);
+        zone_free_blocks.assign(config.getZoneCount(), {});
+        result_cache.clear();
+        free_space_maps.clear();
+        stale_row_indexes.clear();
+        schema_cache.clear();
+        
+        // Un disco nuevo empieza con el log vacío
+        if (!wal.open(getWalPath()) || !wal.rewrite({})) {
+            std::cerr << "Error: no se pudo crear el log de escritura anticipada." << std::endl;
+            return false;
+        }
+        wal_checkpoint_bytes = 0;
+        last_demotion_sweep = SteadyClock::now();
         
         std::cout << "Disco inicializado correctamente." << std::endl;
         config.displayConfig();
@@ -77,399 +492,5242 @@ public:
         }
         
         config = filesystem.getDiskConfig();
+        io_clock.configure(config, config.hasIndependentActuators());
+        zone_next_block.assign(config.getZoneCount(), 0);
+        zone_free_blocks.assign(config.getZoneCount(), {});
+        result_cache.clear();
+        free_space_maps.clear();
+        stale_row_indexes.clear();
+        schema_cache.clear();
+        if (!wal.open(getWalPath())) {
+            std::cerr << "Error: no se pudo abrir el log de escritura anticipada." << std::endl;
+            return false;
+        }
         loadBlockIndex();
+        wal_checkpoint_bytes = wal.getByteCount();
+        last_demotion_sweep = SteadyClock::now();
         
         std::cout << "Disco cargado correctamente." << std::endl;
         return true;
     }
 
+    /**
+     * @brief Relaciones que el gestor crea para sí (listas de trigramas, temporales) y no son tablas
+     *
+     * Las listas de trigramas viven en relation_blocks como cualquier otra,
+     * pero no se listan ni se pueden consultar, y ninguna tabla puede tomar
+     * su prefijo ni el nombre de los bloques temporales.
+     */
+    static bool isInternalRelation(const std::string& name) {
+        return name.rfind("trgm_", 0) == 0 || name == SPILL_RELATION;
+    }
+
     /**
      * @brief Crea una nueva tabla/relación
+     * @param hot_table Tabla muy consultada: sus bloques van a las zonas exteriores
      */
     bool createTable(const std::string& table_name, 
                      const std::vector<FieldDefinition>& schema,
-                     bool use_fixed_records = true) {
+                     bool use_fixed_records = true,
+                     bool hot_table = false) {
         
-        if (relation_blocks.find(table_name) != relation_blocks.end()) {
-            std::cout << "La tabla '" << table_name << "' ya existe." << std::endl;
+        if (!checkNewTableName(table_name)) {
             return false;
         }
         
         // Crear primer bloque para la tabla
-        PhysicalAddress addr = allocateNewBlock();
+        PhysicalAddress addr;
+        if (!allocateNewBlock(addr, hot_table)) {
+            std::cout << "Error: no se pudo crear la tabla '" << table_name << "'." << std::endl;
+            return false;
+        }
         auto block = std::make_shared<Block>(addr, config.getBytesPerSector());
         block->setRelationName(table_name);
         
         // Guardar información del esquema en metadatos
-        saveTableSchema(table_name, schema, use_fixed_records);
+        saveTableSchema(table_name, schema, use_fixed_records, hot_table);
         
         // Registrar el bloque
         block_cache[addr] = block;
         relation_blocks[table_name].push_back(addr);
         
         // Escribir bloque vacío al disco
-        filesystem.writeBlock(addr, *block);
+        persistBlock(block);
         
         std::cout << "Tabla '" << table_name << "' creada exitosamente." << std::endl;
         return true;
     }
 
     /**
-     * @brief Inserta un registro en una tabla
+     * @brief Crea una tabla con organización LSM
+     *
+     * No reserva ningún bloque: el primero llega con el primer volcado de la
+     * memtable. Los bloques de cada volcado se asignan consecutivos.
      */
-    bool insertRecord(const std::string& table_name, 
-                      const std::vector<std::string>& values) {
+    bool createLSMTable(const std::string& table_name,
+                        const std::vector<FieldDefinition>& schema,
+                        bool use_fixed_records = true,
+                        const LSMOptions& options = LSMOptions(),
+                        bool hot_table = false) {
         
-        auto schema = loadTableSchema(table_name);
-        if (schema.empty()) {
-            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+        if (!checkNewTableName(table_name)) {
             return false;
         }
         
-        // Crear el registro apropiado
-        std::shared_ptr<Record> record;
-        bool use_fixed = isTableFixedRecord(table_name);
-        
-        if (use_fixed) {
-            auto fixed_record = std::make_shared<FixedRecord>(next_record_id++);
-            fixed_record->setSchema(schema);
-            fixed_record->setFieldValues(values);
-            fixed_record->calculateFixedSize();
-            record = fixed_record;
-        } else {
-            auto variable_record = std::make_shared<VariableRecord>(next_record_id++);
-            variable_record->setSchema(schema);
-            variable_record->setFieldValues(values);
-            variable_record->calculateOffsets();
-            record = variable_record;
-        }
-        
-        // Encontrar bloque con espacio disponible
-        auto block = findBlockWithSpace(table_name, record->getSize());
-        if (!block) {
-            // Crear nuevo bloque
-            PhysicalAddress addr = allocateNewBlock();
-            block = std::make_shared<Block>(addr, config.getBytesPerSector());
-            block->setRelationName(table_name);
-            block_cache[addr] = block;
-            relation_blocks[table_name].push_back(addr);
+        auto tree = std::make_unique<LSMTree>(table_name, filesystem.getBasePath() + "/metadata",
+                                              filesystem, config.getBytesPerSector(),
+                                              schema, use_fixed_records);
+        if (!tree->create(options)) {
+            std::cout << "Error: no se pudo crear el árbol LSM de '" << table_name << "'." << std::endl;
+            return false;
         }
         
-        // Insertar el registro
-        if (block->addRecord(record)) {
-            // Simular tiempo de escritura
-            double access_time = simulateAccessTime(block->getAddress());
-            total_access_time += access_time;
-            total_writes++;
-            
-            // Escribir bloque al disco
-            filesystem.writeBlock(block->getAddress(), *block);
-            
-            std::cout << "Registro insertado en tabla '" << table_name 
-                      << "' (ID: " << record->getId() << ", Tiempo: " 
-                      << access_time << " ms)" << std::endl;
-            return true;
-        }
+        saveTableSchema(table_name, schema, use_fixed_records, hot_table, TableOrganization::LSM);
+        lsm_trees[table_name] = std::move(tree);
+        relation_blocks[table_name];
         
-        std::cout << "Error: No se pudo insertar el registro." << std::endl;
-        return false;
+        std::cout << "Tabla LSM '" << table_name << "' creada (" 
+                  << compactionPolicyToString(options.policy) << ", memtable de "
+                  << options.memtable_limit << " entradas)." << std::endl;
+        return true;
     }
 
     /**
-     * @brief Carga registros desde un archivo CSV
+     * @brief Crea una tabla agrupada por `key_field` (clave única)
+     *
+     * Reserva un cilindro completo para la tabla; las hojas nuevas se colocan
+     * en sus cilindros, cerca de la hoja que se divide, y se reservan
+     * cilindros contiguos a medida que crece.
      */
-    bool loadFromCSV(const std::string& table_name, const std::string& csv_file) {
-        std::ifstream file(csv_file);
-        if (!file.is_open()) {
-            std::cout << "Error: No se pudo abrir el archivo " << csv_file << std::endl;
+    bool createClusteredTable(const std::string& table_name,
+                              const std::vector<FieldDefinition>& schema,
+                              const std::string& key_field,
+                              bool use_fixed_records = true,
+                              bool hot_table = false) {
+        
+        if (!checkNewTableName(table_name)) {
             return false;
         }
         
-        std::string line;
-        int records_loaded = 0;
-        
-        // Saltar header si existe
-        if (std::getline(file, line)) {
-            // Procesar primera línea como datos
+        ClusteredIndex index;
+        if (!index.configure(schema, key_field)) {
+            std::cout << "Error: el campo clave '" << key_field << "' no está en el esquema." << std::endl;
+            return false;
         }
         
-        // Procesar cada línea
-        do {
-            std::vector<std::string> values = parseCSVLine(line);
-            if (!values.empty()) {
-                if (insertRecord(table_name, values)) {
-                    records_loaded++;
-                }
-            }
-        } while (std::getline(file, line));
+        saveTableSchema(table_name, schema, use_fixed_records, hot_table, TableOrganization::CLUSTERED);
+        clustered_tables[table_name] = index;
+        relation_blocks[table_name];
         
-        file.close();
+        PhysicalAddress addr;
+        if (!allocateClusteredSlot(table_name, nullptr, addr)) {
+            std::cout << "Error: no quedan cilindros libres para la tabla." << std::endl;
+            return false;
+        }
         
-        std::cout << "Cargados " << records_loaded << " registros desde " 
-                  << csv_file << std::endl;
-        return records_loaded > 0;
+        auto block = std::make_shared<Block>(addr, config.getBytesPerSector());
+        block->setRelationName(table_name);
+        block_cache[addr] = block;
+        relation_blocks[table_name].push_back(addr);
+        clustered_tables[table_name].setLeaves({ClusteredIndex::Leaf{"", addr}});
+        persistLeaf(table_name, block);
+        
+        std::cout << "Tabla agrupada '" << table_name << "' creada (clave: " << key_field
+                  << ", cilindro " << addr.getTrack() << ")." << std::endl;
+        return true;
+    }
+
+    TableOrganization getTableOrganization(const std::string& table_name) const {
+        if (lsm_trees.count(table_name) > 0) return TableOrganization::LSM;
+        if (clustered_tables.count(table_name) > 0) return TableOrganization::CLUSTERED;
+        return TableOrganization::HEAP;
     }
 
     /**
-     * @brief Busca un registro por ID
+     * @brief Fija el presupuesto de la caché de resultados (0 la desactiva)
      */
-    std::shared_ptr<Record> findRecord(const std::string& table_name, int record_id) {
-        auto it = relation_blocks.find(table_name);
-        if (it == relation_blocks.end()) {
-            return nullptr;
+    void setResultCacheBudget(size_t bytes) {
+        result_cache.setBudget(bytes);
+        if (bytes == 0) result_cache.clear();
+    }
+
+    const QueryResultCache& getResultCache() const { return result_cache; }
+
+    /**
+     * @brief Registros con `low <= field <= high`
+     *
+     * Sobre la clave de una tabla agrupada solo lee las hojas del rango, que
+     * están en cilindros contiguos; en cualquier otro caso recorre la tabla.
+     */
+    RangeScanReport rangeScan(const std::string& table_name, const std::string& field,
+                              const std::string& low, const std::string& high) {
+        RangeScanReport report;
+        auto schema = loadTableSchema(table_name);
+        auto field_it = std::find_if(schema.begin(), schema.end(),
+                                     [&field](const FieldDefinition& def) { return def.name == field; });
+        if (field_it == schema.end()) {
+            std::cout << "Campo '" << field << "' no encontrado en '" << table_name << "'." << std::endl;
+            return report;
         }
+        size_t field_index = static_cast<size_t>(field_it - schema.begin());
+        FieldType type = field_it->type;
         
-        // Buscar en todos los bloques de la tabla
-        for (const auto& addr : it->second) {
+        std::string cache_key = QueryResultCache::rangeKey(table_name, field, type, low, high);
+        if (result_cache.lookup(cache_key, report.records)) {
+            report.from_cache = true;
+            return report;
+        }
+        
+        auto inRange = [&](const Record& record) {
+            std::string value = record.getField(field_index);
+            return compareFieldValues(type, value, low) >= 0 && compareFieldValues(type, value, high) <= 0;
+        };
+        
+        int last_track = -1;
+        auto readBlock = [&](const PhysicalAddress& addr) {
             auto block = getBlock(addr);
-            if (block) {
-                auto record = block->findRecord(record_id);
-                if (record) {
-                    // Simular tiempo de lectura
-                    double access_time = simulateAccessTime(addr);
-                    total_access_time += access_time;
-                    total_reads++;
-                    
-                    return record;
+            if (!block) return block;
+            report.blocks_read++;
+            report.simulated_ms += chargeAccess(table_name, IOType::READ, addr);
+            if (last_track >= 0 && addr.getTrack() != last_track) report.cylinder_changes++;
+            last_track = addr.getTrack();
+            return block;
+        };
+        
+        auto clustered = clustered_tables.find(table_name);
+        if (clustered != clustered_tables.end() && clustered->second.getKeyName() == field) {
+            const ClusteredIndex& index = clustered->second;
+            const auto leaves = index.getLeaves();
+            for (size_t i = index.findLeaf(low); i < leaves.size(); ++i) {
+                if (i > 0 && index.compare(leaves[i].low_key, high) > 0) break;
+                auto block = readBlock(leaves[i].address);
+                if (!block) continue;
+                for (const auto& record : block->getAllRecords()) {
+                    if (!record->isDeleted() && inRange(*record)) report.records.push_back(record);
+                }
+            }
+        } else if (lsm_trees.count(table_name) > 0) {
+            size_t versions = 0;
+            for (const auto& row : collectLSMRows(table_name, versions)) {
+                if (!row.second->isDeleted() && inRange(*row.second)) report.records.push_back(row.second);
+            }
+            LSMTree& tree = *lsm_trees.at(table_name);
+            for (const auto& run : tree.getRuns()) report.blocks_read += run.blocks.size();
+        } else {
+            auto it = relation_blocks.find(table_name);
+            if (it == relation_blocks.end()) return report;
+            for (const auto& addr : std::vector<PhysicalAddress>(it->second)) {
+                auto block = readBlock(addr);
+                if (!block) continue;
+                for (const auto& record : block->getAllRecords()) {
+                    if (!record->isDeleted() && inRange(*record)) report.records.push_back(record);
                 }
             }
         }
         
-        return nullptr;
+        result_cache.store(cache_key, {table_name}, report.records);
+        runDemotionSweep();
+        return report;
     }
 
     /**
-     * @brief Elimina un registro lógicamente
+     * @brief Crea (o amplía) el índice de mapas de bits de una columna
+     *
+     * Solo para tablas heap: en ellas un registro no cambia de bloque ni de
+     * ranura hasta que se compacta, y entonces el índice se reconstruye.
      */
-    bool deleteRecord(const std::string& table_name, int record_id) {
-        auto it = relation_blocks.find(table_name);
-        if (it == relation_blocks.end()) {
+    bool createBitmapIndex(const std::string& table_name, const std::string& column) {
+        if (relation_blocks.find(table_name) == relation_blocks.end()) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return false;
+        }
+        if (getTableOrganization(table_name) != TableOrganization::HEAP) {
+            std::cout << "Error: los índices de mapas de bits solo admiten tablas heap." << std::endl;
             return false;
         }
         
-        // Buscar en todos los bloques de la tabla
-        for (const auto& addr : it->second) {
-            auto block = getBlock(addr);
-            if (block && block->deleteRecord(record_id)) {
-                // Simular tiempo de escritura
-                double access_time = simulateAccessTime(addr);
-                total_access_time += access_time;
-                total_writes++;
-                
-                // Escribir bloque modificado
-                filesystem.writeBlock(addr, *block);
-                
-                std::cout << "Registro " << record_id << " eliminado lógicamente." << std::endl;
-                return true;
-            }
+        BitmapIndex& index = bitmap_indexes[table_name];
+        bool added = !index.hasColumn(column);
+        if (!index.addColumn(loadTableSchema(table_name), column)) {
+            std::cout << "Error: la columna '" << column << "' no está en el esquema." << std::endl;
+            if (index.getColumns().empty()) bitmap_indexes.erase(table_name);
+            return false;
+        }
+        if (!rebuildRowIndexes(table_name)) {
+            // Sin filas no se puede consultar: la columna no queda a medias en el índice
+            if (added) index.removeColumn(column);
+            if (index.getColumns().empty()) bitmap_indexes.erase(table_name);
+            return false;
         }
+        index.save(getBitmapIndexPath(table_name));
         
-        return false;
+        std::cout << "Índice de mapas de bits sobre " << table_name << "." << column << ": "
+                  << index.getDistinctValues(column) << " valores, "
+                  << index.getSizeInBytes(column) << " bytes." << std::endl;
+        return true;
+    }
+
+    bool hasBitmapIndex(const std::string& table_name, const std::string& column) const {
+        auto it = bitmap_indexes.find(table_name);
+        return it != bitmap_indexes.end() && it->second.hasColumn(column);
     }
 
     /**
-     * @brief Compacta una tabla eliminando registros marcados como eliminados
+     * @brief Conjunción de términos resuelta con los mapas de bits
+     *
+     * Los mapas se combinan sin tocar páginas de datos; después cada bloque
+     * con filas candidatas se lee una sola vez, en orden físico.
      */
-    void compactTable(const std::string& table_name) {
-        auto it = relation_blocks.find(table_name);
-        if (it == relation_blocks.end()) {
-            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
-            return;
+    BitmapScanReport bitmapHeapScan(const std::string& table_name, const std::vector<BitmapTerm>& terms) {
+        BitmapScanReport report;
+        refreshStaleRowIndexes(table_name);
+        auto index = bitmap_indexes.find(table_name);
+        if (index == bitmap_indexes.end()) {
+            std::cout << "Error: la tabla '" << table_name << "' no tiene índices de mapas de bits." << std::endl;
+            return report;
         }
+        const auto& addresses = relation_blocks[table_name];
+        report.table_blocks = addresses.size();
         
-        int compacted_blocks = 0;
-        for (const auto& addr : it->second) {
+        std::string cache_key = QueryResultCache::bitmapKey(table_name, terms);
+        if (result_cache.lookup(cache_key, report.records)) {
+            report.from_cache = true;
+            return report;
+        }
+        
+        auto start = SteadyClock::now();
+        RoaringBitmap rows;
+        if (!index->second.evaluate(terms, rows)) {
+            return report;
+        }
+        report.bitmap_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+        report.candidate_rows = rows.cardinality();
+        
+        // Un contenedor por bloque: su clave es la posición del bloque en la relación
+        for (const auto& container : rows.getContainers()) {
+            if (container.key >= addresses.size()) continue;
+            PhysicalAddress addr = addresses[container.key];
             auto block = getBlock(addr);
-            if (block) {
-                size_t old_count = block->getRecordCount();
-                block->compactBlock();
-                size_t new_count = block->getRecordCount();
-                
+            if (!block) continue;
+            report.blocks_read++;
+            report.simulated_ms += chargeAccess(table_name, IOType::READ, addr);
+            
+            const auto& records = block->getAllRecords();
+            container.forEach([&](uint32_t rid) {
+                size_t slot = BitmapIndex::slotOf(rid);
+                if (slot < records.size() && !records[slot]->isDeleted()) {
+                    report.records.push_back(records[slot]);
+                }
+            });
+        }
+        
+        result_cache.store(cache_key, {table_name}, report.records);
+        runDemotionSweep();
+        return report;
+    }
+
+    /**
+     * @brief Crea un índice ART en memoria sobre una columna o RadixIndex::RECORD_ID
+     *
+     * Pensado para tablas que caben en caché (nivel MEMORY): una búsqueda
+     * recorre unos pocos nodos por byte de clave y lee solo el bloque de la
+     * fila. Igual que los mapas de bits, solo admite tablas heap.
+     */
+    bool createRadixIndex(const std::string& table_name, const std::string& column) {
+        if (relation_blocks.find(table_name) == relation_blocks.end()) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return false;
+        }
+        if (getTableOrganization(table_name) != TableOrganization::HEAP) {
+            std::cout << "Error: los índices ART solo admiten tablas heap." << std::endl;
+            return false;
+        }
+        
+        RadixIndex index;
+        if (!index.configure(loadTableSchema(table_name), column)) {
+            std::cout << "Error: la columna '" << column << "' no está en el esquema." << std::endl;
+            return false;
+        }
+        radix_indexes[table_name][column] = std::move(index);
+        if (!rebuildRowIndexes(table_name)) {
+            radix_indexes[table_name].erase(column);
+            if (radix_indexes[table_name].empty()) radix_indexes.erase(table_name);
+            return false;
+        }
+        
+        std::vector<std::string> columns;
+        for (const auto& entry : radix_indexes[table_name]) columns.push_back(entry.first);
+        saveRadixColumns(getRadixIndexPath(table_name), columns);
+        
+        const RadixIndex& built = radix_indexes[table_name][column];
+        auto nodes = built.getNodeCounts();
+        std::cout << "Índice ART sobre " << table_name << "." << column << ": " << built.getKeyCount()
+                  << " claves, nodos 4/16/48/256 = " << nodes[0] << "/" << nodes[1] << "/" << nodes[2]
+                  << "/" << nodes[3] << ", " << built.getMemoryBytes() << " bytes." << std::endl;
+        return true;
+    }
+
+    bool hasRadixIndex(const std::string& table_name, const std::string& column) const {
+        auto it = radix_indexes.find(table_name);
+        return it != radix_indexes.end() && it->second.count(column) > 0;
+    }
+
+    /**
+     * @brief Filas con `column == value` a través del índice ART
+     */
+    std::vector<std::shared_ptr<Record>> radixLookup(const std::string& table_name, const std::string& column,
+                                                     const std::string& value) {
+        if (!hasRadixIndex(table_name, column)) {
+            std::cout << "Error: " << table_name << "." << column << " no tiene índice ART." << std::endl;
+            return {};
+        }
+        refreshStaleRowIndexes(table_name);
+        return fetchRows(table_name, radix_indexes.at(table_name).at(column).lookup(value));
+    }
+
+    /**
+     * @brief Filas cuya columna de texto empieza por `prefix`, en orden de clave
+     */
+    std::vector<std::shared_ptr<Record>> radixPrefixLookup(const std::string& table_name,
+                                                           const std::string& column,
+                                                           const std::string& prefix) {
+        if (!hasRadixIndex(table_name, column)) {
+            std::cout << "Error: " << table_name << "." << column << " no tiene índice ART." << std::endl;
+            return {};
+        }
+        refreshStaleRowIndexes(table_name);
+        return fetchRows(table_name, radix_indexes.at(table_name).at(column).prefixLookup(prefix));
+    }
+
+    /**
+     * @brief Filas con `low <= column <= high`, en orden de clave
+     */
+    std::vector<std::shared_ptr<Record>> radixRangeLookup(const std::string& table_name,
+                                                          const std::string& column,
+                                                          const std::string& low, const std::string& high) {
+        if (!hasRadixIndex(table_name, column)) {
+            std::cout << "Error: " << table_name << "." << column << " no tiene índice ART." << std::endl;
+            return {};
+        }
+        refreshStaleRowIndexes(table_name);
+        return fetchRows(table_name, radix_indexes.at(table_name).at(column).rangeLookup(low, high));
+    }
+
+    /**
+     * @brief Crea (o reconstruye) un índice B+ secundario sobre una columna de una tabla heap
+     *
+     * La construcción es paralela con `workers` hilos (0 = uno por núcleo);
+     * ver buildBTreeIndex. `progress` recibe el avance de cada fase.
+     */
+    IndexBuildReport createBTreeIndex(const std::string& table_name, const std::string& column, size_t workers = 0,
+                                      const IndexBuildProgress& progress = nullptr) {
+        IndexBuildReport report;
+        if (relation_blocks.find(table_name) == relation_blocks.end()) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return report;
+        }
+        if (getTableOrganization(table_name) != TableOrganization::HEAP) {
+            std::cout << "Error: los índices B+ solo admiten tablas heap." << std::endl;
+            return report;
+        }
+        if (relation_blocks[table_name].size() > BitmapIndex::MAX_BLOCKS) {
+            std::cout << "Error: " << table_name << " supera el rango de RID de sus índices." << std::endl;
+            return report;
+        }
+        
+        BTreeIndex index;
+        if (!index.configure(loadTableSchema(table_name), column)) {
+            std::cout << "Error: la columna '" << column << "' no está en el esquema." << std::endl;
+            return report;
+        }
+        report = buildBTreeIndex(table_name, index, workers, progress);
+        if (!report.valid) {
+            return report;
+        }
+        btree_indexes[table_name][column] = std::move(index);
+        
+        std::vector<std::string> columns;
+        for (const auto& entry : btree_indexes[table_name]) columns.push_back(entry.first);
+        saveBTreeColumns(getBTreeIndexPath(table_name), columns);
+        runDemotionSweep();
+        return report;
+    }
+
+    bool hasBTreeIndex(const std::string& table_name, const std::string& column) const {
+        auto it = btree_indexes.find(table_name);
+        return it != btree_indexes.end() && it->second.count(column) > 0;
+    }
+
+    /**
+     * @brief Filas con `low <= column <= high` a través del índice B+, en orden de clave
+     */
+    std::vector<std::shared_ptr<Record>> btreeRangeLookup(const std::string& table_name, const std::string& column,
+                                                          const std::string& low, const std::string& high) {
+        if (!hasBTreeIndex(table_name, column)) {
+            std::cout << "Error: " << table_name << "." << column << " no tiene índice B+." << std::endl;
+            return {};
+        }
+        refreshStaleRowIndexes(table_name);
+        const BTreeIndex& index = btree_indexes.at(table_name).at(column);
+        auto rows = fetchRows(table_name, index.rangeLookup(low, high));
+        // Se comprueba siempre el valor completo: las claves de texto truncadas dan candidatos,
+        // y un RID que apunte a otra fila no debe devolverla aunque la clave sea numérica
+        FieldType type = loadTableSchema(table_name)[index.getField()].type;
+        rows.erase(std::remove_if(rows.begin(), rows.end(), [&](const std::shared_ptr<Record>& row) {
+            const std::string& value = row->getField(index.getField());
+            return compareFieldValues(type, value, low) < 0 || compareFieldValues(type, value, high) > 0;
+        }), rows.end());
+        return rows;
+    }
+
+    std::vector<std::shared_ptr<Record>> btreeLookup(const std::string& table_name, const std::string& column,
+                                                     const std::string& value) {
+        return btreeRangeLookup(table_name, column, value, value);
+    }
+
+    /**
+     * @brief Mide búsquedas e inserciones concurrentes sobre un índice B+ de prueba
+     *
+     * Construye una copia del índice de la columna, y `threads` hilos hacen
+     * `ops_per_thread` operaciones cada uno: búsquedas puntuales de valores
+     * de la tabla con probabilidad `lookup_percent` e inserciones de esos
+     * mismos valores con RIDs sintéticos fuera del rango de la tabla. La
+     * tabla y sus índices no cambian. Con GLOBAL cada operación toma un mutex
+     * común; con OPTIMISTIC las búsquedas no escriben nada compartido.
+     */
+    IndexConcurrencyReport benchmarkBTreeConcurrency(const std::string& table_name, const std::string& column,
+                                                     size_t threads, unsigned lookup_percent, size_t ops_per_thread,
+                                                     IndexLatching latching) {
+        IndexConcurrencyReport report;
+        if (relation_blocks.find(table_name) == relation_blocks.end()) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return report;
+        }
+        if (getTableOrganization(table_name) != TableOrganization::HEAP) {
+            std::cout << "Error: los índices B+ solo admiten tablas heap." << std::endl;
+            return report;
+        }
+        BTreeIndex index;
+        if (!index.configure(loadTableSchema(table_name), column)) {
+            std::cout << "Error: la columna '" << column << "' no está en el esquema." << std::endl;
+            return report;
+        }
+        if (!buildBTreeIndex(table_name, index, 0, nullptr).valid) return report;
+        
+        std::vector<std::string> values;
+        forEachLiveRecord(table_name, [&](const Record& record) { values.push_back(record.getField(index.getField())); });
+        if (values.empty()) {
+            std::cout << "Error: " << table_name << " no tiene filas." << std::endl;
+            return report;
+        }
+        
+        report.threads = std::max<size_t>(1, threads);
+        std::atomic<uint32_t> next_rid(0);
+        std::atomic<size_t> lookups(0), inserts(0);
+        std::mutex global;
+        auto work = [&](size_t worker) {
+            std::mt19937 rng(static_cast<unsigned>(worker * 7919 + 17));
+            size_t local_lookups = 0, local_inserts = 0;
+            for (size_t op = 0; op < ops_per_thread; ++op) {
+                const std::string& value = values[rng() % values.size()];
+                bool lookup = rng() % 100 < lookup_percent;
+                std::unique_lock<std::mutex> lock(global, std::defer_lock);
+                if (latching == IndexLatching::GLOBAL) lock.lock();
+                if (lookup) {
+                    index.lookup(value);
+                    local_lookups++;
+                } else {
+                    index.addValue(0xFFFFFFFFu - next_rid.fetch_add(1, std::memory_order_relaxed), value);
+                    local_inserts++;
+                }
+            }
+            lookups += local_lookups;
+            inserts += local_inserts;
+        };
+        
+        uint64_t restarts_before = index.getRestartCount();
+        auto start = SteadyClock::now();
+        std::vector<std::thread> workers;
+        for (size_t worker = 1; worker < report.threads; ++worker) workers.emplace_back(work, worker);
+        work(0);
+        for (auto& thread : workers) thread.join();
+        report.elapsed_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+        
+        report.lookups = lookups;
+        report.inserts = inserts;
+        report.operations = report.lookups + report.inserts;
+        report.ops_per_second = report.elapsed_ms > 0 ? report.operations * 1000.0 / report.elapsed_ms : 0.0;
+        report.restarts = index.getRestartCount() - restarts_before;
+        report.entries_after = index.getEntryCount();
+        report.valid = true;
+        runDemotionSweep();
+        return report;
+    }
+
+    /**
+     * @brief Crea un índice de trigramas sobre una columna STRING de una tabla heap
+     */
+    bool createTrigramIndex(const std::string& table_name, const std::string& column) {
+        if (relation_blocks.find(table_name) == relation_blocks.end()) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return false;
+        }
+        if (getTableOrganization(table_name) != TableOrganization::HEAP) {
+            std::cout << "Error: los índices de trigramas solo admiten tablas heap." << std::endl;
+            return false;
+        }
+        if (trigram_indexes.count(table_name) > 0 && trigram_indexes[table_name].count(column) > 0) {
+            return true;
+        }
+        
+        TrigramIndex index;
+        if (!index.configure(loadTableSchema(table_name), column)) {
+            std::cout << "Error: '" << column << "' no es una columna STRING de " << table_name << "." << std::endl;
+            return false;
+        }
+        trigram_indexes[table_name][column] = std::move(index);
+        if (!rebuildRowIndexes(table_name)) {
+            trigram_indexes[table_name].erase(column);
+            if (trigram_indexes[table_name].empty()) trigram_indexes.erase(table_name);
+            return false;
+        }
+        
+        TrigramIndex& built = trigram_indexes[table_name][column];
+        double elapsed = flushTrigramPostings(table_name, built);
+        std::cout << "Índice de trigramas sobre " << table_name << "." << column << ": "
+                  << built.getTrigramCount() << " trigramas, " << built.getChunkCount() << " tramos en "
+                  << relation_blocks[built.getRelationName(table_name)].size() << " bloques ("
+                  << elapsed << " ms)." << std::endl;
+        return true;
+    }
+
+    /**
+     * @brief Filas cuya columna cumple un patrón LIKE (`%x%`, `x%`, `_`...)
+     *
+     * Interseca las listas de los trigramas del patrón empezando por la más
+     * corta, y solo lee y verifica las filas candidatas. Deja de intersecar
+     * cuando la lista siguiente ocupa más tramos que candidatas quedan. Un patrón sin
+     * fragmentos de 3 caracteres, o una columna sin índice, recorre la tabla.
+     */
+    LikeSearchReport likeSearch(const std::string& table_name, const std::string& column,
+                                const std::string& pattern) {
+        LikeSearchReport report;
+        auto schema = loadTableSchema(table_name);
+        auto field_it = std::find_if(schema.begin(), schema.end(),
+                                     [&column](const FieldDefinition& def) { return def.name == column; });
+        if (field_it == schema.end()) {
+            std::cout << "Campo '" << column << "' no encontrado en '" << table_name << "'." << std::endl;
+            return report;
+        }
+        size_t field_index = static_cast<size_t>(field_it - schema.begin());
+        report.table_blocks = relation_blocks[table_name].size();
+        
+        std::string cache_key = QueryResultCache::likeKey(table_name, column, pattern);
+        if (result_cache.lookup(cache_key, report.records)) {
+            report.from_cache = true;
+            return report;
+        }
+        
+        refreshStaleRowIndexes(table_name);
+        std::vector<uint32_t> trigrams = TrigramIndex::trigramsOfPattern(pattern);
+        report.trigrams = trigrams.size();
+        TrigramIndex* index = nullptr;
+        if (trigram_indexes.count(table_name) > 0 && trigram_indexes[table_name].count(column) > 0) {
+            index = &trigram_indexes[table_name][column];
+        }
+        
+        if (!index || trigrams.empty()) {
+            for (const auto& addr : std::vector<PhysicalAddress>(relation_blocks[table_name])) {
+                auto block = getBlock(addr);
+                if (!block) continue;
+                report.data_blocks_read++;
+                report.simulated_ms += chargeAccess(table_name, IOType::READ, addr);
+                for (const auto& record : block->getAllRecords()) {
+                    if (!record->isDeleted() && likeMatch(record->getField(field_index), pattern)) {
+                        report.records.push_back(record);
+                    }
+                }
+            }
+            result_cache.store(cache_key, {table_name}, report.records);
+            runDemotionSweep();
+            return report;
+        }
+        report.used_index = true;
+        
+        // Listas más cortas primero: la intersección se vacía antes
+        std::sort(trigrams.begin(), trigrams.end(), [index](uint32_t a, uint32_t b) {
+            return index->estimateCount(a) < index->estimateCount(b);
+        });
+        
+        std::string relation = index->getRelationName(table_name);
+        const auto& postings = relation_blocks[relation];
+        std::map<size_t, std::shared_ptr<Block>> loaded;
+        std::vector<int> candidates;
+        for (size_t t = 0; t < trigrams.size(); ++t) {
+            // Con pocas candidatas, verificarlas sale más barato que leer otra lista larga
+            const auto* next_chunks = index->chunksOf(trigrams[t]);
+            if (t > 0 && next_chunks && next_chunks->size() >= candidates.size()) break;
+            
+            std::vector<int> ids = index->pendingOf(trigrams[t]);
+            if (next_chunks) {
+                for (const auto& chunk : *next_chunks) {
+                    if (chunk.block >= postings.size()) continue;
+                    auto& block = loaded[chunk.block];
+                    if (!block) {
+                        block = getBlock(postings[chunk.block]);
+                        if (!block) continue;
+                        report.index_blocks_read++;
+                        report.simulated_ms += chargeAccess(relation, IOType::READ, postings[chunk.block]);
+                    }
+                    uint32_t trigram = 0;
+                    if (chunk.slot < block->getRecordCount()) {
+                        TrigramIndex::parseChunk(*block->getAllRecords()[chunk.slot], trigram, ids);
+                    }
+                }
+            }
+            std::sort(ids.begin(), ids.end());
+            ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+            
+            if (t == 0) {
+                candidates = std::move(ids);
+            } else {
+                std::vector<int> both;
+                std::set_intersection(candidates.begin(), candidates.end(), ids.begin(), ids.end(),
+                                      std::back_inserter(both));
+                candidates = std::move(both);
+            }
+            if (candidates.empty()) break;
+        }
+        
+        std::vector<uint32_t> rids;
+        for (int id : candidates) {
+            uint32_t rid = 0;
+            if (index->locate(id, rid)) rids.push_back(rid);
+        }
+        std::sort(rids.begin(), rids.end());
+        report.candidates = rids.size();
+        
+        std::set<size_t> data_blocks;
+        for (uint32_t rid : rids) data_blocks.insert(BitmapIndex::blockOf(rid));
+        for (const auto& record : fetchRows(table_name, rids, &report.simulated_ms)) {
+            if (likeMatch(record->getField(field_index), pattern)) report.records.push_back(record);
+        }
+        report.data_blocks_read = data_blocks.size();
+        
+        result_cache.store(cache_key, {table_name}, report.records);
+        runDemotionSweep();
+        return report;
+    }
+
+    /**
+     * @brief COUNT, SUM o AVG aproximados sobre una muestra de la tabla
+     *
+     * Lee solo los bloques elegidos, en orden físico, y devuelve la
+     * estimación con su intervalo de confianza. Con todos los bloques y todas
+     * las filas el resultado es exacto y el intervalo se reduce a un punto.
+     * Un filtro opcional `low <= filter_field <= high` se aplica a las filas
+     * de la muestra. Las tablas LSM no se admiten: sus bloques guardan
+     * versiones, no filas.
+     */
+    ApproximateAggregateReport approximateAggregate(const std::string& table_name, const AggregateSpec& aggregate,
+                                                    const SampleSpec& sample, const std::string& filter_field = "",
+                                                    const std::string& low = "", const std::string& high = "") {
+        ApproximateAggregateReport report;
+        auto it = relation_blocks.find(table_name);
+        if (it == relation_blocks.end() || isInternalRelation(table_name)) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return report;
+        }
+        if (lsm_trees.count(table_name) > 0) {
+            std::cout << "Error: el muestreo por bloques no admite tablas LSM." << std::endl;
+            return report;
+        }
+        if (aggregate.function == AggregateFunction::MIN || aggregate.function == AggregateFunction::MAX) {
+            std::cout << "Error: " << aggregate.toString() << " no tiene estimador con intervalo de confianza."
+                      << std::endl;
+            return report;
+        }
+        
+        auto schema = loadTableSchema(table_name);
+        auto fieldIndex = [&schema](const std::string& name, size_t& index) {
+            for (index = 0; index < schema.size(); ++index) {
+                if (schema[index].name == name) return true;
+            }
+            return false;
+        };
+        size_t value_field = 0, filter_index = 0;
+        if (aggregate.function != AggregateFunction::COUNT) {
+            if (!fieldIndex(aggregate.column, value_field) ||
+                (schema[value_field].type != FieldType::INTEGER && schema[value_field].type != FieldType::FLOAT)) {
+                std::cout << "Error: " << aggregate.toString() << " necesita una columna numérica." << std::endl;
+                return report;
+            }
+        }
+        if (!filter_field.empty() && !fieldIndex(filter_field, filter_index)) {
+            std::cout << "Campo '" << filter_field << "' no encontrado en '" << table_name << "'." << std::endl;
+            return report;
+        }
+        
+        // Unidades de muestreo: tramos de bloques consecutivos en orden físico
+        std::vector<PhysicalAddress> addresses = it->second;
+        std::sort(addresses.begin(), addresses.end());
+        report.table_blocks = addresses.size();
+        size_t run = std::max<size_t>(sample.run_blocks, 1);
+        if (sample.max_blocks > 0 && run > sample.max_blocks) {
+            // Un tramo no puede pasar del presupuesto: el presupuesto manda
+            std::cout << "Aviso: tramos de " << run << " bloques recortados al presupuesto de "
+                      << sample.max_blocks << "." << std::endl;
+            run = sample.max_blocks;
+        }
+        size_t population = (addresses.size() + run - 1) / run;
+        size_t wanted = static_cast<size_t>(std::ceil(population * std::min(sample.block_percent, 100.0) / 100.0));
+        wanted = std::max(wanted, std::min<size_t>(2, population));
+        if (sample.max_blocks > 0) wanted = std::min(wanted, sample.max_blocks / run);
+        wanted = std::min(wanted, population);
+        
+        // Elección sin reemplazo; las unidades se leen en orden físico
+        std::mt19937 rng(sample.seed);
+        std::vector<size_t> units(population);
+        for (size_t i = 0; i < population; ++i) units[i] = i;
+        for (size_t i = 0; i < wanted; ++i) {
+            std::uniform_int_distribution<size_t> pick(i, population - 1);
+            std::swap(units[i], units[pick(rng)]);
+        }
+        units.resize(wanted);
+        std::sort(units.begin(), units.end());
+        
+        double row_rate = std::min(std::max(sample.row_percent, 0.0), 100.0) / 100.0;
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        SampleEstimator estimator(population, row_rate);
+        FieldType filter_type = filter_field.empty() ? FieldType::STRING : schema[filter_index].type;
+        for (size_t unit : units) {
+            estimator.beginUnit();  // Un bloque ilegible cuenta como vacío
+            for (size_t position = unit * run; position < std::min(addresses.size(), (unit + 1) * run); ++position) {
+                auto block = getBlock(addresses[position]);
+                if (!block) continue;
+                report.blocks_read++;
+                report.simulated_ms += chargeAccess(table_name, IOType::READ, addresses[position]);
+            
+                for (const auto& record : block->getAllRecords()) {
+                    if (record->isDeleted()) continue;
+                    report.rows_seen++;
+                    if (row_rate < 1.0 && coin(rng) >= row_rate) continue;
+                    report.rows_sampled++;
+                
+                    bool matches = filter_field.empty() ||
+                                   (compareFieldValues(filter_type, record->getField(filter_index), low) >= 0 &&
+                                    compareFieldValues(filter_type, record->getField(filter_index), high) <= 0);
+                    if (!matches) {
+                        estimator.addRow(0.0, 0.0);
+                        continue;
+                    }
+                    double value = 1.0;
+                    if (aggregate.function != AggregateFunction::COUNT) {
+                        try {
+                            value = std::stod(record->getField(value_field));
+                        } catch (const std::exception&) {
+                            value = 0.0;
+                        }
+                    }
+                    estimator.addRow(value, 1.0);
+                }
+            }
+        }
+        
+        switch (aggregate.function) {
+            case AggregateFunction::COUNT:
+                report.estimate = estimator.total(false, sample.confidence);
+                break;
+            case AggregateFunction::SUM:
+                report.estimate = estimator.total(true, sample.confidence);
+                break;
+            default:
+                report.estimate = estimator.ratio(sample.confidence);
+                break;
+        }
+        report.valid = true;
+        report.exact = wanted == population && row_rate >= 1.0;
+        
+        runDemotionSweep();
+        return report;
+    }
+
+    /**
+     * @brief Guarda resúmenes por bloque (HyperLogLog y KLL) de una columna
+     *
+     * Cada bloque de datos conserva el sketch de sus filas junto con su LSN
+     * de página. Un agregado aproximado combina los resúmenes vigentes sin
+     * leer sus bloques y solo recorre los que cambiaron desde entonces.
+     */
+    bool createColumnSketches(const std::string& table_name, const std::string& column) {
+        if (!checkSketchColumn(table_name, column)) {
+            return false;
+        }
+        if (hasColumnSketches(table_name, column)) {
+            std::cout << "La columna '" << column << "' ya tiene resúmenes." << std::endl;
+            return false;
+        }
+        column_sketches[table_name][column];
+        SketchAggregateReport report = sketchAggregate(table_name, column);
+        std::cout << "Resúmenes de " << table_name << "." << column << " creados: "
+                  << column_sketches[table_name][column].size() << " bloques (" << report.simulated_ms
+                  << " ms)." << std::endl;
+        return true;
+    }
+
+    bool hasColumnSketches(const std::string& table_name, const std::string& column) const {
+        auto it = column_sketches.find(table_name);
+        return it != column_sketches.end() && it->second.count(column) > 0;
+    }
+
+    /**
+     * @brief APPROX_COUNT_DISTINCT y APPROX_PERCENTILE de una columna en una pasada
+     *
+     * Los bloques sin resumen vigente se leen en orden físico y se reparten
+     * en tramos contiguos entre `workers` hilos; cada hilo construye su
+     * propio sketch y al final se combinan todos con los resúmenes guardados.
+     * La memoria por agregado es fija (unos 4 KB el HyperLogLog y 5 KB el KLL).
+     * Con `use_summaries = false` se recorre la tabla entera.
+     */
+    SketchAggregateReport sketchAggregate(const std::string& table_name, const std::string& column,
+                                          size_t workers = 1, bool use_summaries = true) {
+        SketchAggregateReport report;
+        if (!checkSketchColumn(table_name, column)) {
+            return report;
+        }
+        auto schema = loadTableSchema(table_name);
+        size_t field_index = 0;
+        while (schema[field_index].name != column) ++field_index;
+        bool numeric = schema[field_index].type == FieldType::INTEGER || schema[field_index].type == FieldType::FLOAT;
+        
+        std::map<PhysicalAddress, BlockSketch>* summaries = nullptr;
+        if (use_summaries && hasColumnSketches(table_name, column)) {
+            summaries = &column_sketches[table_name][column];
+        }
+        
+        std::vector<PhysicalAddress> addresses = relation_blocks[table_name];
+        std::sort(addresses.begin(), addresses.end());
+        std::vector<std::shared_ptr<Block>> pending;
+        for (const auto& addr : addresses) {
+            if (summaries) {
+                auto summary = summaries->find(addr);
+                auto lsn = block_lsns.find(addr);
+                if (summary != summaries->end() && lsn != block_lsns.end() && summary->second.lsn == lsn->second) {
+                    report.sketch.merge(summary->second.sketch);
+                    report.summaries_used++;
+                    continue;
+                }
+            }
+            auto block = getBlock(addr);
+            if (!block) continue;
+            report.blocks_read++;
+            report.simulated_ms += chargeAccess(table_name, IOType::READ, addr);
+            pending.push_back(block);
+        }
+        
+        // Cada trabajador resume un tramo contiguo de los bloques leídos
+        auto start = SteadyClock::now();
+        report.workers = std::max<size_t>(1, std::min(workers, pending.size()));
+        std::vector<ColumnSketch> partial(report.workers);
+        std::vector<ColumnSketch> block_sketches(summaries ? pending.size() : 0);
+        std::vector<size_t> rows(report.workers, 0);
+        auto work = [&](size_t worker) {
+            size_t begin = pending.size() * worker / report.workers;
+            size_t end = pending.size() * (worker + 1) / report.workers;
+            for (size_t i = begin; i < end; ++i) {
+                ColumnSketch block_sketch;
+                for (const auto& record : pending[i]->getAllRecords()) {
+                    if (record->isDeleted()) continue;
+                    block_sketch.add(record->getField(field_index), numeric);
+                    rows[worker]++;
+                }
+                partial[worker].merge(block_sketch);
+                if (summaries) block_sketches[i] = std::move(block_sketch);
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t worker = 1; worker < report.workers; ++worker) {
+            threads.emplace_back(work, worker);
+        }
+        work(0);
+        for (auto& thread : threads) thread.join();
+        for (size_t worker = 0; worker < report.workers; ++worker) {
+            report.sketch.merge(partial[worker]);
+            report.rows_seen += rows[worker];
+        }
+        report.compute_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+        
+        if (summaries) {
+            for (size_t i = 0; i < pending.size(); ++i) {
+                const PhysicalAddress& addr = pending[i]->getAddress();
+                (*summaries)[addr] = BlockSketch{block_lsns[addr], std::move(block_sketches[i])};
+            }
+            // Los bloques liberados o reubicados ya no pertenecen a la tabla
+            std::set<PhysicalAddress> live(addresses.begin(), addresses.end());
+            for (auto it = summaries->begin(); it != summaries->end();) {
+                it = live.count(it->first) > 0 ? std::next(it) : summaries->erase(it);
+            }
+            saveColumnSketches(table_name);
+        }
+        report.valid = true;
+        
+        runDemotionSweep();
+        return report;
+    }
+
+    /**
+     * @brief `SELECT *, llamadas OVER (PARTITION BY ... ORDER BY ...) FROM tabla`
+     *
+     * Las filas se ordenan por partición y orden con un ordenamiento externo:
+     * tramos de `memory_rows` filas ordenados en memoria y volcados a bloques
+     * temporales, que después se mezclan de una vez con un bloque por tramo.
+     * La mezcla entrega las particiones una tras otra. Las que caben en
+     * memoria se acumulan en lotes que se evalúan repartidos entre `workers`
+     * hilos. Las filas de una partición mayor que la memoria se vuelcan a
+     * bloques temporales mientras llegan; solo sus columnas agregadas se
+     * quedan en memoria y, una vez evaluada, las filas se releen para
+     * emitirlas. `emit` recibe cada fila seguida de sus valores de ventana,
+     * en el orden de la ventana. Con `memory_rows = 0` todo se hace en memoria.
+     *
+     * Memoria: como mucho `memory_rows` filas a la vez entre el lote y la
+     * partición en curso (el lote se evalúa antes de pasarse), más un bloque
+     * por tramo durante la mezcla y las columnas agregadas, como double, de
+     * la partición volcada. Los bloques temporales son de la relación
+     * SPILL_RELATION; los de una consulta interrumpida se borran al cargar.
+     */
+    WindowReport windowQuery(const std::string& table_name, const WindowSpec& spec, size_t memory_rows,
+                             size_t workers, const std::function<void(const std::vector<std::string>&)>& emit) {
+        using Tuple = std::vector<std::string>;
+        WindowReport report;
+        auto schema = loadTableSchema(table_name);
+        if (schema.empty() || relation_blocks.count(table_name) == 0) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return report;
+        }
+        auto fieldIndex = [&schema](const std::string& name, size_t& index) {
+            for (index = 0; index < schema.size(); ++index) {
+                if (schema[index].name == name) return true;
+            }
+            std::cout << "Campo '" << name << "' no encontrado." << std::endl;
+            return false;
+        };
+        std::vector<size_t> partition_fields(spec.partition_by.size()), order_fields(spec.order_by.size());
+        for (size_t i = 0; i < spec.partition_by.size(); ++i) {
+            if (!fieldIndex(spec.partition_by[i], partition_fields[i])) return report;
+        }
+        for (size_t i = 0; i < spec.order_by.size(); ++i) {
+            if (!fieldIndex(spec.order_by[i], order_fields[i])) return report;
+        }
+        std::vector<size_t> value_fields(spec.calls.size(), SIZE_MAX);
+        for (size_t c = 0; c < spec.calls.size(); ++c) {
+            const WindowCall& call = spec.calls[c];
+            if (call.function != WindowFunction::AGGREGATE || call.aggregate.function == AggregateFunction::COUNT) {
+                continue;
+            }
+            if (!fieldIndex(call.aggregate.column, value_fields[c])) return report;
+            if (schema[value_fields[c]].type != FieldType::INTEGER && schema[value_fields[c]].type != FieldType::FLOAT) {
+                std::cout << "Error: " << call.aggregate.toString() << " necesita una columna numérica." << std::endl;
+                return report;
+            }
+        }
+        for (const auto& field : schema) report.header.push_back(field.name);
+        for (const auto& call : spec.calls) report.header.push_back(call.toString());
+        
+        auto compareKeys = [&schema](const Tuple& a, const Tuple& b, const std::vector<size_t>& fields) {
+            for (size_t field : fields) {
+                int cmp = compareFieldValues(schema[field].type, a[field], b[field]);
+                if (cmp != 0) return cmp;
+            }
+            return 0;
+        };
+        auto before = [&](const Tuple& a, const Tuple& b) {
+            int cmp = compareKeys(a, b, partition_fields);
+            return cmp != 0 ? cmp < 0 : compareKeys(a, b, order_fields) < 0;
+        };
+        
+        // Fase 1: tramos ordenados de memory_rows filas
+        std::vector<PhysicalAddress> temp_blocks;
+        std::vector<std::vector<PhysicalAddress>> runs;
+        std::vector<Tuple> buffer;
+        bool spill_failed = false;
+        auto discardSpill = [&]() {
+            for (const auto& addr : temp_blocks) filesystem.deleteBlock(addr);
+            releaseReservedAddresses(temp_blocks);
+            if (spill_failed) std::cout << "Error: no queda espacio en disco para los bloques temporales." << std::endl;
+        };
+        auto spillBuffer = [&]() {
+            std::stable_sort(buffer.begin(), buffer.end(), before);
+            SpillRun run;
+            for (const auto& tuple : buffer) {
+                if (!spillTuple(run, table_name, schema, tuple, temp_blocks, report)) {
+                    spill_failed = true;
+                    break;
+                }
+            }
+            closeSpill(run, report);
+            runs.push_back(run.blocks);
+            buffer.clear();
+        };
+        forEachLiveRecord(table_name, [&](const Record& record) {
+            if (spill_failed) return;
+            buffer.push_back(record.getFieldValues());
+            buffer.back().resize(schema.size());  // Los campos vacíos finales no se serializan
+            report.peak_rows = std::max(report.peak_rows, buffer.size());
+            if (memory_rows > 0 && buffer.size() >= memory_rows) spillBuffer();
+        }, &report.simulated_ms);
+        if (runs.empty()) {
+            std::stable_sort(buffer.begin(), buffer.end(), before);
+        } else if (!buffer.empty()) {
+            spillBuffer();
+        }
+        if (spill_failed) {
+            discardSpill();
+            return report;
+        }
+        report.sort_runs = runs.size();
+        
+        // Fase 2: mezcla de los tramos con un bloque de cada uno en memoria
+        struct RunCursor {
+            std::vector<PhysicalAddress> blocks;
+            size_t next_block = 0;
+            std::vector<Tuple> rows;
+            size_t position = 0;
+        };
+        std::vector<RunCursor> cursors;
+        if (runs.empty()) {
+            cursors.emplace_back();
+            cursors.back().rows = std::move(buffer);
+        }
+        for (auto& run : runs) {
+            cursors.emplace_back();
+            cursors.back().blocks = std::move(run);
+        }
+        auto advance = [&](RunCursor& cursor) {
+            while (cursor.position >= cursor.rows.size() && cursor.next_block < cursor.blocks.size()) {
+                cursor.rows = readSpillBlock(cursor.blocks[cursor.next_block++], schema.size(), report);
+                cursor.position = 0;
+            }
+            return cursor.position < cursor.rows.size();
+        };
+        auto later = [&](size_t a, size_t b) {
+            const Tuple& x = cursors[a].rows[cursors[a].position];
+            const Tuple& y = cursors[b].rows[cursors[b].position];
+            if (before(y, x)) return true;
+            return !before(x, y) && a > b;  // A igualdad de clave, primero el tramo anterior
+        };
+        std::vector<size_t> heap;
+        for (size_t i = 0; i < cursors.size(); ++i) {
+            if (advance(cursors[i])) heap.push_back(i);
+        }
+        std::make_heap(heap.begin(), heap.end(), later);
+        auto next = [&](Tuple& tuple) {
+            if (heap.empty()) return false;
+            std::pop_heap(heap.begin(), heap.end(), later);
+            size_t i = heap.back();
+            tuple = std::move(cursors[i].rows[cursors[i].position++]);
+            if (advance(cursors[i])) {
+                std::push_heap(heap.begin(), heap.end(), later);
+            } else {
+                heap.pop_back();
+            }
+            return true;
+        };
+        
+        // Fase 3: particiones en orden; las pequeñas se evalúan por lotes en paralelo
+        struct PendingPartition {
+            std::vector<Tuple> tuples;          // Filas en memoria...
+            SpillRun spilled;                   // ...o volcadas a bloques temporales
+            WindowPartition input;
+        };
+        auto emitRows = [&](const std::vector<Tuple>& tuples, const std::vector<std::vector<double>>& outputs,
+                            size_t first_row) {
+            for (size_t r = 0; r < tuples.size(); ++r) {
+                Tuple row = tuples[r];
+                for (size_t c = 0; c < spec.calls.size(); ++c) {
+                    row.push_back(WindowEvaluator::format(spec.calls[c], outputs[c][first_row + r]));
+                }
+                emit(row);
+                report.rows++;
+            }
+        };
+        std::vector<PendingPartition> batch;
+        size_t batch_rows = 0;
+        report.workers = std::max<size_t>(workers, 1);
+        auto flushBatch = [&]() {
+            auto start = SteadyClock::now();
+            std::vector<std::vector<std::vector<double>>> outputs(batch.size());
+            std::atomic<size_t> next_partition{0};
+            auto work = [&]() {
+                for (size_t i = next_partition++; i < batch.size(); i = next_partition++) {
+                    outputs[i] = WindowEvaluator::evaluate(spec.calls, batch[i].input);
+                }
+            };
+            std::vector<std::thread> threads;
+            for (size_t worker = 1; worker < std::min(report.workers, batch.size()); ++worker) {
+                threads.emplace_back(work);
+            }
+            work();
+            for (auto& thread : threads) thread.join();
+            report.compute_ms += std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+            
+            for (size_t i = 0; i < batch.size(); ++i) emitRows(batch[i].tuples, outputs[i], 0);
+            batch.clear();
+            batch_rows = 0;
+        };
+        auto finishPartition = [&](PendingPartition& partition) {
+            report.partitions++;
+            report.largest_partition = std::max(report.largest_partition, partition.input.rows);
+            if (partition.spilled.blocks.empty() && !partition.spilled.current) {
+                if (memory_rows > 0 && batch_rows + partition.input.rows > memory_rows) flushBatch();
+                batch_rows += partition.input.rows;
+                batch.push_back(std::move(partition));
+                return;
+            }
+            // Partición volcada: se evalúa sola y sus filas se releen en orden
+            closeSpill(partition.spilled, report);
+            flushBatch();
+            report.spilled_partitions++;
+            auto start = SteadyClock::now();
+            auto outputs = WindowEvaluator::evaluate(spec.calls, partition.input);
+            report.compute_ms += std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+            size_t first_row = 0;
+            for (const auto& addr : partition.spilled.blocks) {
+                auto tuples = readSpillBlock(addr, schema.size(), report);
+                emitRows(tuples, outputs, first_row);
+                first_row += tuples.size();
+            }
+        };
+        
+        PendingPartition current;
+        current.input.values.resize(spec.calls.size());
+        Tuple tuple, previous;
+        while (next(tuple)) {
+            if (current.input.rows > 0 && compareKeys(previous, tuple, partition_fields) != 0) {
+                finishPartition(current);
+                current = PendingPartition();
+                current.input.values.resize(spec.calls.size());
+            }
+            bool peer_start = current.input.rows == 0 || compareKeys(previous, tuple, order_fields) != 0;
+            current.input.peer_start.push_back(peer_start ? 1 : 0);
+            for (size_t c = 0; c < spec.calls.size(); ++c) {
+                if (value_fields[c] == SIZE_MAX) continue;
+                double value = 0.0;
+                try {
+                    value = std::stod(tuple[value_fields[c]]);
+                } catch (const std::exception&) {
+                    value = 0.0;
+                }
+                current.input.values[c].push_back(value);
+            }
+            current.input.rows++;
+            
+            bool spilling = !current.spilled.blocks.empty() || current.spilled.current;
+            if (!spilling && memory_rows > 0 && !batch.empty() && batch_rows + current.input.rows > memory_rows) {
+                flushBatch();  // El lote y la partición en curso no pasan juntos de memory_rows
+            }
+            if (!spilling && memory_rows > 0 && current.input.rows > memory_rows) {
+                // La partición ya no cabe: sus filas pasan a bloques temporales
+                flushBatch();
+                for (const auto& held : current.tuples) {
+                    if (!spillTuple(current.spilled, table_name, schema, held, temp_blocks, report)) {
+                        spill_failed = true;
+                        break;
+                    }
+                }
+                current.tuples.clear();
+                current.tuples.shrink_to_fit();
+                spilling = true;
+            }
+            if (spill_failed ||
+                (spilling && !spillTuple(current.spilled, table_name, schema, tuple, temp_blocks, report))) {
+                spill_failed = true;
+                break;
+            }
+            if (!spilling) {
+                current.tuples.push_back(tuple);
+                report.peak_rows = std::max(report.peak_rows, batch_rows + current.tuples.size());
+            }
+            previous = std::move(tuple);
+        }
+        if (spill_failed) {
+            discardSpill();
+            return report;
+        }
+        if (current.input.rows > 0) finishPartition(current);
+        flushBatch();
+        
+        discardSpill();
+        report.valid = true;
+        
+        runDemotionSweep();
+        return report;
+    }
+
+    /**
+     * @brief `SELECT agregado FROM tabla WHERE columna op constante` por uno de los dos caminos
+     *
+     * El recorrido decodifica las dos columnas en lotes tipados, igual para
+     * ambos caminos, y ejecuta cada lote en cuanto se llena: en memoria solo
+     * hay un lote de PIPELINE_BATCH_ROWS filas. El camino interpretado
+     * ejecuta sobre él un árbol scan -> filtro -> proyección -> agregado con
+     * una llamada virtual y una decisión de tipo por tupla y operador. El
+     * fusionado elige en tiempo de plan la instancia de fusedFilterAggregate
+     * para esos tipos, ese operador y ese agregado. Cada lote se ejecuta
+     * `repetitions` veces y se suma la más rápida de cada uno.
+     */
+    FilterAggregateReport filterAggregate(const std::string& table_name, const FilterAggregateQuery& query,
+                                          ExecutionMode mode, size_t repetitions = 1) {
+        FilterAggregateReport report;
+        auto schema = loadTableSchema(table_name);
+        if (schema.empty() || relation_blocks.count(table_name) == 0) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return report;
+        }
+        auto fieldIndex = [&schema](const std::string& name, size_t& index) {
+            for (index = 0; index < schema.size(); ++index) {
+                if (schema[index].name == name) return true;
+            }
+            std::cout << "Campo '" << name << "' no encontrado." << std::endl;
+            return false;
+        };
+        AggregateFunction function = query.aggregate.function;
+        size_t filter_field = 0, value_field = 0;
+        if (!fieldIndex(query.filter_column, filter_field)) return report;
+        if (function != AggregateFunction::COUNT && !fieldIndex(query.aggregate.column, value_field)) return report;
+        FieldType filter_type = schema[filter_field].type;
+        FieldType value_type = function == AggregateFunction::COUNT ? FieldType::INTEGER : schema[value_field].type;
+        if (function != AggregateFunction::COUNT && value_type != FieldType::INTEGER && value_type != FieldType::FLOAT) {
+            std::cout << "Error: " << query.aggregate.toString() << " necesita una columna numérica." << std::endl;
+            return report;
+        }
+        
+        // Plan: la constante se convierte una vez al tipo de la comparación
+        PredicateConstant constant;
+        constant.text = query.constant;
+        if (filter_type == FieldType::INTEGER || filter_type == FieldType::FLOAT) {
+            try {
+                constant.number = std::stod(query.constant);
+            } catch (const std::exception&) {
+                std::cout << "Error: '" << query.constant << "' no es un número." << std::endl;
+                return report;
+            }
+        }
+        FusedKernel kernel = mode == ExecutionMode::FUSED ? selectFusedKernel(filter_type, value_type, query.op, function)
+                                                          : nullptr;
+        auto typeName = [](FieldType type) {
+            return type == FieldType::INTEGER ? "int64_t" : (type == FieldType::FLOAT ? "double" : "string");
+        };
+        report.kernel = kernel ? std::string("fusedFilterAggregate<") + typeName(filter_type) + ", " +
+                                     typeName(value_type) + ", " + compareOpToString(query.op) + ", " +
+                                     aggregateFunctionToString(function) + ">"
+                               : "interpretado";
+        
+        // Scan: un lote tipado de PIPELINE_BATCH_ROWS filas, ejecutado al llenarse
+        AggregateState state;
+        ColumnBatch batch;
+        batch.filter.type = filter_type;
+        batch.value.type = value_type;
+        auto resetBatch = [&]() {
+            batch.rows = 0;
+            batch.filter.clear();
+            batch.value.clear();
+        };
+        double executing_ms = 0.0;                  // Todas las repeticiones, para descontarlas del scan
+        auto executeBatch = [&]() {
+            double best = 0.0;
+            AggregateState before = state;
+            for (size_t run = 0; run < std::max<size_t>(repetitions, 1); ++run) {
+                AggregateState trial = before;
+                auto run_start = SteadyClock::now();
+                if (kernel) {
+                    kernel(batch, constant, trial);
+                } else {
+                    runInterpretedPipeline(batch, filter_type, query.op, constant, function, trial);
+                }
+                double elapsed = std::chrono::duration<double, std::milli>(SteadyClock::now() - run_start).count();
+                best = run == 0 ? elapsed : std::min(best, elapsed);
+                executing_ms += elapsed;
+                if (run == 0) state = trial;
+            }
+            report.execute_ms += best;
+            resetBatch();
+        };
+        auto start = SteadyClock::now();
+        forEachLiveRecord(table_name, [&](const Record& record) {
+            batch.filter.append(record.getField(filter_field));
+            if (function != AggregateFunction::COUNT) batch.value.append(record.getField(value_field));
+            batch.rows++;
+            report.rows_scanned++;
+            if (batch.rows >= PIPELINE_BATCH_ROWS) executeBatch();
+        }, &report.simulated_ms);
+        if (batch.rows > 0) executeBatch();
+        double scan_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+        report.decode_ms = std::max(0.0, scan_ms - executing_ms);
+        report.rows_matched = static_cast<size_t>(state.count);
+        report.value = state.result(query.aggregate, value_type);
+        report.valid = true;
+        
+        runDemotionSweep();
+        return report;
+    }
+
+    /**
+     * @brief `SELECT expresiones FROM tabla WHERE ... ORDER BY ... LIMIT n` evaluada por lotes
+     *
+     * El recorrido decodifica solo las columnas que nombran las expresiones,
+     * en vectores tipados de PIPELINE_BATCH_ROWS filas. El WHERE de cada lote
+     * produce un vector de selección, y la lista SELECT se evalúa solo sobre
+     * esas filas. Sin agregados, las filas seleccionadas se copian a la
+     * salida. Con agregados, los elementos escalares forman la clave del grupo
+     * y los agregados acumulan sus valores no NULL. ORDER BY ordena una
+     * permutación comparando los vectores tipados de salida; con LIMIT basta
+     * un orden parcial de los n primeros. Los NULL van después de cualquier
+     * valor.
+     */
+    VectorQueryReport vectorQuery(const std::string& table_name, const VectorQuery& query) {
+        VectorQueryReport report;
+        auto schema = loadTableSchema(table_name);
+        if (schema.empty() || relation_blocks.count(table_name) == 0) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return report;
+        }
+        if (query.select.empty()) {
+            std::cout << "Error: la lista SELECT está vacía." << std::endl;
+            return report;
+        }
+        
+        // Plan: resolver columnas y tipos, y decidir qué columnas decodificar
+        std::vector<bool> used(schema.size(), false);
+        std::vector<FieldType> output_types;
+        bool grouped = false;
+        for (const auto& item : query.select) {
+            if (!item.expression) {
+                if (!item.is_aggregate || item.function != AggregateFunction::COUNT) {
+                    std::cout << "Error: '" << item.alias << "' no tiene expresión." << std::endl;
+                    return report;
+                }
+            } else if (!item.expression->bind(schema, used)) {
+                return report;
+            }
+            FieldType type = item.expression ? item.expression->getType() : FieldType::INTEGER;
+            if (item.is_aggregate) {
+                grouped = true;
+                if (item.function != AggregateFunction::COUNT && !isNumericType(type)) {
+                    std::cout << "Error: " << aggregateFunctionToString(item.function) << "("
+                              << item.expression->toString() << ") necesita una expresión numérica." << std::endl;
+                    return report;
+                }
+                if (item.function == AggregateFunction::COUNT) type = FieldType::INTEGER;
+                if (item.function == AggregateFunction::AVG) type = FieldType::FLOAT;
+            }
+            output_types.push_back(type);
+            std::string label = item.expression ? item.expression->toString() : "*";
+            if (item.is_aggregate) label = aggregateFunctionToString(item.function) + "(" + label + ")";
+            report.header.push_back(item.alias.empty() ? label : item.alias);
+        }
+        if (query.where && !query.where->bind(schema, used)) return report;
+        for (const auto& key : query.order_by) {
+            if (key.first >= query.select.size()) {
+                std::cout << "Error: ORDER BY " << key.first + 1 << " fuera de la lista SELECT." << std::endl;
+                return report;
+            }
+        }
+        
+        std::vector<ColumnVector> output;
+        for (FieldType type : output_types) output.push_back(ColumnVector::make(type, 0));
+        std::map<std::string, size_t> groups;
+        std::vector<std::vector<AggregateState>> states;
+        
+        VectorExpression::Columns columns(schema.size());
+        size_t batch_rows = 0;
+        auto resetBatch = [&]() {
+            for (size_t i = 0; i < schema.size(); ++i) {
+                if (used[i]) columns[i] = std::make_shared<ColumnVector>(ColumnVector::make(schema[i].type, 0));
+            }
+            batch_rows = 0;
+        };
+        auto processBatch = [&]() {
+            if (batch_rows == 0) return;
+            report.batches++;
+            SelectionVector selection;
+            if (query.where) selection = query.where->select(columns, batch_rows, selection);
+            size_t selected = selection.count(batch_rows);
+            report.rows_selected += selected;
+            if (selected == 0) return;
+            
+            std::vector<std::shared_ptr<ColumnVector>> values(query.select.size());
+            for (size_t c = 0; c < query.select.size(); ++c) {
+                if (query.select[c].expression) values[c] = query.select[c].expression->evaluate(columns, batch_rows, selection);
+            }
+            if (!grouped) {
+                selection.forEach(batch_rows, [&](size_t row) {
+                    for (size_t c = 0; c < output.size(); ++c) output[c].append(*values[c], row);
+                });
+                return;
+            }
+            selection.forEach(batch_rows, [&](size_t row) {
+                std::string key;
+                for (size_t c = 0; c < query.select.size(); ++c) {
+                    if (query.select[c].is_aggregate) continue;
+                    key += values[c]->isNull(row) ? "\x1e" : values[c]->text(row);  // NULL distinto del texto "NULL"
+                    key += '\x1f';
+                }
+                auto found = groups.find(key);
+                size_t group = found == groups.end() ? states.size() : found->second;
+                if (found == groups.end()) {
+                    groups.emplace(key, group);
+                    states.emplace_back(query.select.size());
+                    for (size_t c = 0; c < query.select.size(); ++c) {
+                        if (!query.select[c].is_aggregate) output[c].append(*values[c], row);
+                    }
+                }
+                for (size_t c = 0; c < query.select.size(); ++c) {
+                    if (!query.select[c].is_aggregate) continue;
+                    AggregateState& state = states[group][c];
+                    if (values[c] && values[c]->isNull(row)) continue;
+                    state.count++;
+                    if (!values[c] || query.select[c].function == AggregateFunction::COUNT) continue;
+                    double value = values[c]->number(row);
+                    if (values[c]->type == FieldType::INTEGER) {
+                        state.int_sum += values[c]->ints[row];
+                    } else {
+                        state.float_sum += value;
+                    }
+                    state.min = std::min(state.min, value);
+                    state.max = std::max(state.max, value);
+                }
+            });
+        };
+        
+        auto start = SteadyClock::now();
+        resetBatch();
+        forEachLiveRecord(table_name, [&](const Record& record) {
+            for (size_t i = 0; i < schema.size(); ++i) {
+                if (used[i]) columns[i]->appendText(record.getField(i));
+            }
+            batch_rows++;
+            report.rows_scanned++;
+            if (batch_rows == PIPELINE_BATCH_ROWS) {
+                processBatch();
+                resetBatch();
+            }
+        }, &report.simulated_ms);
+        processBatch();
+        
+        size_t result_rows = output[0].size;
+        if (grouped) {
+            // Sin claves de grupo hay una fila aunque ninguna pase el filtro
+            bool has_keys = std::any_of(query.select.begin(), query.select.end(),
+                                        [](const VectorSelectItem& item) { return !item.is_aggregate; });
+            if (states.empty() && !has_keys) {
+                states.emplace_back(query.select.size());
+            }
+            result_rows = states.size();
+            report.groups = states.size();
+            for (size_t c = 0; c < query.select.size(); ++c) {
+                if (!query.select[c].is_aggregate) continue;
+                output[c] = ColumnVector::make(output_types[c], result_rows);
+                AggregateSpec spec(query.select[c].function);
+                FieldType value_type = query.select[c].expression ? query.select[c].expression->getType()
+                                                                  : FieldType::INTEGER;
+                for (size_t g = 0; g < result_rows; ++g) {
+                    const AggregateState& state = states[g][c];
+                    double value = state.result(spec, value_type);
+                    if (std::isnan(value)) {
+                        output[c].setNull(g);
+                    } else if (output_types[c] == FieldType::FLOAT) {
+                        output[c].floats[g] = value;
+                    } else if (spec.function == AggregateFunction::SUM) {
+                        output[c].ints[g] = state.int_sum;  // Exacto aunque pase de 2^53
+                    } else {
+                        output[c].ints[g] = static_cast<int64_t>(value);
+                    }
+                }
+            }
+        }
+        
+        // Sort: permutación sobre los vectores de salida
+        std::vector<size_t> order(result_rows);
+        for (size_t i = 0; i < result_rows; ++i) order[i] = i;
+        if (!query.order_by.empty()) {
+            auto before = [&](size_t a, size_t b) {
+                for (const auto& key : query.order_by) {
+                    const ColumnVector& column = output[key.first];
+                    bool null_a = column.isNull(a), null_b = column.isNull(b);
+                    int cmp = 0;
+                    if (null_a || null_b) {
+                        cmp = null_a == null_b ? 0 : (null_a ? 1 : -1);
+                    } else if (column.type == FieldType::INTEGER) {
+                        cmp = column.ints[a] < column.ints[b] ? -1 : (column.ints[a] > column.ints[b] ? 1 : 0);
+                    } else if (column.type == FieldType::FLOAT) {
+                        cmp = column.floats[a] < column.floats[b] ? -1 : (column.floats[a] > column.floats[b] ? 1 : 0);
+                    } else {
+                        cmp = column.strings[a].compare(column.strings[b]);
+                    }
+                    if (cmp != 0) return key.second ? cmp > 0 : cmp < 0;
+                }
+                return a < b;  // Empates en el orden de llegada
+            };
+            if (query.limit > 0 && query.limit < result_rows) {
+                std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(query.limit), order.end(),
+                                  before);
+            } else {
+                std::sort(order.begin(), order.end(), before);
+            }
+        }
+        if (query.limit > 0 && query.limit < result_rows) order.resize(query.limit);
+        for (size_t row : order) {
+            std::vector<std::string> values;
+            for (const auto& column : output) values.push_back(column.text(row));
+            report.rows.push_back(values);
+        }
+        report.execute_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+        report.valid = true;
+        
+        runDemotionSweep();
+        return report;
+    }
+
+    /**
+     * @brief Inserta un registro en una tabla
+     */
+    bool insertRecord(const std::string& table_name, 
+                      const std::vector<std::string>& values) {
+        
+        auto schema = loadTableSchema(table_name);
+        if (schema.empty()) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return false;
+        }
+        if (rejectViewWrite(table_name)) {
+            return false;
+        }
+        
+        std::shared_ptr<Record> record = buildRecord(table_name, schema, next_record_id++, values);
+        
+        bool inserted;
+        if (lsm_trees.count(table_name) > 0) {
+            inserted = insertLSMRecord(table_name, record);
+        } else if (clustered_tables.count(table_name) > 0) {
+            inserted = insertClusteredRecord(table_name, record);
+        } else {
+            inserted = insertHeapRecord(table_name, record);
+        }
+        if (inserted) {
+            applyViewDeltas(table_name, *record, 1);
+        }
+        return inserted;
+    }
+
+    /**
+     * @brief Inserta un lote de filas en una tabla heap con `workers` hilos (0 = uno por núcleo)
+     *
+     * Los hilos construyen primero los registros por tandas; si alguno no
+     * cabe ni en un bloque vacío se rechaza el lote entero antes de reservar
+     * bloques, y los IDs vuelven a quedar libres. Después cada hilo coloca
+     * sus tandas según el mapa de espacio libre: primero en su bloque
+     * preferido y, si no cabe, en otro bloque sin dueño con hueco o en uno
+     * nuevo cuya dirección saca de una BlockExtentQueue. Un bloque solo lo
+     * escribe su dueño, así que colocar una fila no toma cerrojos. Los
+     * bloques existentes con hueco se cargan antes y los nuevos se registran
+     * al terminar, en orden; la persistencia, los índices y las vistas se
+     * actualizan después en serie.
+     */
+    InsertBatchReport insertRecordsParallel(const std::string& table_name,
+                                            const std::vector<std::vector<std::string>>& rows, size_t workers = 0) {
+        InsertBatchReport report;
+        auto total_start = SteadyClock::now();
+        auto schema = loadTableSchema(table_name);
+        if (schema.empty()) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return report;
+        }
+        if (rejectViewWrite(table_name)) {
+            return report;
+        }
+        if (getTableOrganization(table_name) != TableOrganization::HEAP) {
+            std::cout << "Error: la inserción paralela solo admite tablas heap." << std::endl;
+            return report;
+        }
+        if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+        report.workers = std::max<size_t>(1, std::min({workers, FreeSpaceMap::SLOTS, std::max<size_t>(rows.size(), 1)}));
+        
+        bool fixed_record = isTableFixedRecord(table_name);
+        bool hot = isTableHot(table_name);
+        
+        FreeSpaceMap& map = freeSpaceMapFor(table_name);
+        const std::vector<PhysicalAddress>& addresses = relation_blocks[table_name];
+        size_t base = addresses.size();
+        if (base + rows.size() > FreeSpaceMap::CAPACITY) {
+            std::cout << "Error: la tabla '" << table_name << "' superaría los " << FreeSpaceMap::CAPACITY
+                      << " bloques del mapa de espacio libre." << std::endl;
+            return report;
+        }
+        int first_id = next_record_id;
+        next_record_id += static_cast<int>(rows.size());
+        
+        // Reparte las filas en tandas de INSERT_MORSEL_ROWS entre los hilos
+        auto runWorkers = [&](auto work) {
+            std::atomic<size_t> next_row(0);
+            auto loop = [&](size_t worker) {
+                while (true) {
+                    size_t first = next_row.fetch_add(INSERT_MORSEL_ROWS);
+                    if (first >= rows.size()) break;
+                    work(worker, first, std::min(rows.size(), first + INSERT_MORSEL_ROWS));
+                }
+            };
+            std::vector<std::thread> threads;
+            for (size_t worker = 1; worker < report.workers; ++worker) threads.emplace_back(loop, worker);
+            loop(0);
+            for (auto& thread : threads) thread.join();
+        };
+        
+        // 1. Registros en paralelo; una fila mayor que un bloque vacío rechaza el lote
+        auto start = SteadyClock::now();
+        const size_t block_capacity = Block(PhysicalAddress(), config.getBytesPerSector()).getFreeSpace();
+        std::vector<std::shared_ptr<Record>> records(rows.size());
+        std::atomic<size_t> oversized(rows.size());     // Primera fila que no cabe (rows.size() si ninguna)
+        runWorkers([&](size_t, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                records[i] = makeRecord(schema, fixed_record, first_id + static_cast<int>(i), rows[i]);
+                if (records[i]->getSize() + sizeof(size_t) > block_capacity) {
+                    size_t seen = oversized.load();
+                    while (i < seen && !oversized.compare_exchange_weak(seen, i)) {
+                    }
+                }
+            }
+        });
+        if (oversized.load() < rows.size()) {
+            next_record_id = first_id;
+            std::cout << "Error: la fila " << oversized.load() + 1 << " no cabe en un bloque de "
+                      << config.getBytesPerSector() << " bytes; no se insertó ninguna fila del lote." << std::endl;
+            return report;
+        }
+        
+        std::vector<std::shared_ptr<Block>> existing(base);
+        for (size_t position = 0; position < base; ++position) {
+            if (map.getFree(position) > 0) existing[position] = getBlock(addresses[position]);
+        }
+        
+        // 2. Colocación paralela: (posición, ranura) de cada fila
+        BlockExtentQueue extents(rows.size(), INSERT_EXTENT_BLOCKS);
+        std::vector<std::shared_ptr<Block>> created(rows.size());
+        std::vector<std::pair<size_t, size_t>> placed(rows.size(), {FreeSpaceMap::NONE, 0});
+        auto allocate = [&](PhysicalAddress& addr) { return allocateNewBlock(addr, hot); };
+        runWorkers([&](size_t worker, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                const auto& record = records[i];
+                uint32_t bytes = static_cast<uint32_t>(record->getSize() + sizeof(size_t));
+                while (true) {
+                    size_t position = map.reserve(bytes, worker);
+                    if (position == FreeSpaceMap::NONE) {
+                        size_t index = extents.take(allocate);
+                        if (index == BlockExtentQueue::NONE) break;
+                        auto block = std::make_shared<Block>(extents.address(index), config.getBytesPerSector());
+                        block->setRelationName(table_name);
+                        created[index] = block;
+                        block->addRecord(record);       // Cabe: el lote ya se comprobó
+                        map.publish(base + index, static_cast<uint32_t>(block->getFreeSpace()), worker);
+                        placed[i] = {base + index, 0};
+                        break;
+                    }
+                    auto& block = position < base ? existing[position] : created[position - base];
+                    if (block && block->addRecord(record)) {
+                        placed[i] = {position, block->getRecordCount() - 1};
+                        break;
+                    }
+                    map.setFree(position, block ? static_cast<uint32_t>(block->getFreeSpace()) : 0);
+                }
+            }
+        });
+        map.releaseSlots();
+        releaseReservedAddresses(extents.unusedAddresses());
+        report.insert_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+        
+        // 3. Registro de los bloques nuevos, escritura de los tocados, índices y vistas
+        start = SteadyClock::now();
+        report.new_blocks = extents.getTakenCount();
+        for (size_t index = 0; index < report.new_blocks; ++index) {
+            const PhysicalAddress& addr = created[index]->getAddress();
+            block_cache[addr] = created[index];
+            relation_blocks[table_name].push_back(addr);
+        }
+        std::vector<bool> touched(base + report.new_blocks, false);
+        for (const auto& place : placed) {
+            if (place.first != FreeSpaceMap::NONE) touched[place.first] = true;
+        }
+        for (size_t index = 0; index < report.new_blocks; ++index) touched[base + index] = true;
+        const std::vector<PhysicalAddress>& all = relation_blocks[table_name];
+        for (size_t position = 0; position < touched.size(); ++position) {
+            if (!touched[position]) continue;
+            if (position < base) report.reused_blocks++;
+            report.simulated_ms += chargeAccess(table_name, IOType::WRITE, all[position]);
+            persistBlock(position < base ? existing[position] : created[position - base]);
+        }
+        result_cache.invalidate(table_name);
+        for (const auto& place : placed) {
+            if (place.first == FreeSpaceMap::NONE) continue;
+            const auto& block = place.first < base ? existing[place.first] : created[place.first - base];
+            indexRowAt(table_name, place.first, block, place.second);
+            applyViewDeltas(table_name, *block->getAllRecords()[place.second], 1);
+            report.rows++;
+        }
+        if (trigram_indexes.count(table_name) > 0) {
+            for (auto& index : trigram_indexes.at(table_name)) {
+                if (index.second.needsFlush()) flushTrigramPostings(table_name, index.second);
+            }
+        }
+        report.finish_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+        
+        report.total_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - total_start).count();
+        report.rows_per_second = report.total_ms > 0 ? report.rows * 1000.0 / report.total_ms : 0.0;
+        report.placement_rows_per_second = report.insert_ms > 0 ? report.rows * 1000.0 / report.insert_ms : 0.0;
+        if (extents.isExhausted() && report.rows < rows.size()) {
+            // Como una serie de insertRecord que se detiene: las filas colocadas quedan
+            std::cout << "Error: disco lleno; se insertaron " << report.rows << " de " << rows.size()
+                      << " filas." << std::endl;
+            runDemotionSweep();
+            return report;
+        }
+        report.valid = true;
+        runDemotionSweep();
+        return report;
+    }
+
+    /**
+     * @brief Sustituye los valores de un registro conservando su ID
+     *
+     * En una tabla heap la nueva versión ocupa la misma ranura si cabe en el
+     * bloque, así que los RIDs de los índices siguen valiendo; si no, se
+     * borra y se vuelve a insertar. En una tabla LSM se añade una versión y en
+     * una agrupada se borra y se inserta en la hoja de la nueva clave.
+     */
+    bool updateRecord(const std::string& table_name, int record_id, const std::vector<std::string>& values) {
+        auto schema = loadTableSchema(table_name);
+        if (schema.empty()) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return false;
+        }
+        if (rejectViewWrite(table_name)) {
+            return false;
+        }
+        auto old_record = findRecord(table_name, record_id);
+        if (!old_record) {
+            std::cout << "Registro " << record_id << " no encontrado en '" << table_name << "'." << std::endl;
+            return false;
+        }
+        std::shared_ptr<Record> record = buildRecord(table_name, schema, record_id, values);
+        
+        bool updated = false;
+        if (lsm_trees.count(table_name) > 0) {
+            updated = insertLSMRecord(table_name, record);
+        } else {
+            size_t position = 0, slot = 0;
+            auto block = locateStoredRecord(table_name, record_id, position, slot);
+            if (!block) {
+                return false;
+            }
+            
+            if (clustered_tables.count(table_name) > 0) {
+                old_record->markAsDeleted();
+                updated = insertClusteredRecord(table_name, record);
+                if (!updated) old_record->unmarkAsDeleted();
+                persistBlock(block);
+            } else {
+                if (hasRowIndexes(table_name)) unindexRow(table_name, position, slot, *old_record);
+                if (block->replaceRecordAt(slot, record)) {
+                    chargeAccess(table_name, IOType::WRITE, block->getAddress());
+                    persistBlock(block);
+                    refreshFreeSpace(table_name, position, *block);
+                    indexRowAt(table_name, position, block, slot);
+                    updated = true;
+                } else {
+                    old_record->markAsDeleted();
+                    persistBlock(block);
+                    updated = insertHeapRecord(table_name, record);
+                    if (!updated) {
+                        // Sin sitio para la nueva versión: la antigua vuelve a su ranura
+                        old_record->unmarkAsDeleted();
+                        persistBlock(block);
+                        indexRowAt(table_name, position, block, slot);
+                    }
+                }
+                // Las listas en disco no tienen los trigramas nuevos si el ID ya estaba volcado
+                if (updated && trigram_indexes.count(table_name) > 0) {
+                    for (auto& index : trigram_indexes.at(table_name)) {
+                        index.second.queueRow(record_id, *record);
+                        flushTrigramPostings(table_name, index.second);
+                    }
+                }
+            }
+        }
+        
+        if (updated) {
+            result_cache.invalidate(table_name);
+            applyViewDeltas(table_name, *old_record, -1);
+            applyViewDeltas(table_name, *record, 1);
+            std::cout << "Registro " << record_id << " actualizado en '" << table_name << "'." << std::endl;
+        }
+        return updated;
+    }
+
+    /**
+     * @brief Crea una vista materializada `SELECT grupo..., agregados... GROUP BY grupo...`
+     *
+     * La vista se guarda como una relación propia con un registro por grupo y
+     * se calcula una vez recorriendo la tabla base. Desde ahí, cada inserción,
+     * borrado o actualización de la tabla base reescribe solo el registro de su
+     * grupo, así que leer un grupo cuesta un bloque sea cual sea el tamaño de la tabla.
+     */
+    bool createMaterializedView(const std::string& view_name, const std::string& table_name,
+                                const std::vector<std::string>& group_by,
+                                const std::vector<AggregateSpec>& aggregates) {
+        if (relation_blocks.count(view_name) > 0 || materialized_views.count(view_name) > 0) {
+            std::cout << "La relación '" << view_name << "' ya existe." << std::endl;
+            return false;
+        }
+        if (isInternalRelation(view_name)) {
+            std::cout << "Error: el nombre '" << view_name << "' está reservado para relaciones internas." << std::endl;
+            return false;
+        }
+        if (relation_blocks.find(table_name) == relation_blocks.end()) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return false;
+        }
+        if (materialized_views.count(table_name) > 0) {
+            std::cout << "Error: no se admiten vistas sobre otra vista materializada." << std::endl;
+            return false;
+        }
+        
+        MaterializedView view(view_name, table_name, group_by, aggregates);
+        if (!view.configure(loadTableSchema(table_name))) {
+            return false;
+        }
+        saveTableSchema(view_name, view.storageSchema(), false);
+        if (!view.save(getViewPath(view_name))) {
+            return false;
+        }
+        materialized_views[view_name] = std::move(view);
+        relation_blocks[view_name];
+        
+        double elapsed = refreshMaterializedView(view_name);
+        std::cout << "Vista materializada '" << view_name << "' creada: "
+                  << materialized_views[view_name].getGroupCount() << " grupos en "
+                  << relation_blocks[view_name].size() << " bloques (" << elapsed << " ms)." << std::endl;
+        return true;
+    }
+
+    bool hasMaterializedView(const std::string& view_name) const {
+        return materialized_views.count(view_name) > 0;
+    }
+
+    /**
+     * @brief Rechaza escribir en una vista: solo la escribe el gestor al propagar su tabla base
+     */
+    bool rejectViewWrite(const std::string& table_name) const {
+        if (materialized_views.count(table_name) == 0) return false;
+        std::cout << "Error: '" << table_name << "' es una vista materializada; modifique su tabla base." << std::endl;
+        return true;
+    }
+
+    /**
+     * @brief Recalcula la vista desde cero recorriendo la tabla base
+     * @return Tiempo simulado de lectura y escritura (ms)
+     */
+    double refreshMaterializedView(const std::string& view_name) {
+        auto it = materialized_views.find(view_name);
+        if (it == materialized_views.end()) {
+            std::cout << "Vista '" << view_name << "' no encontrada." << std::endl;
+            return 0.0;
+        }
+        MaterializedView& view = it->second;
+        
+        double elapsed = 0.0;
+        std::map<std::string, MaterializedView::GroupState> groups;
+        forEachLiveRecord(view.getBaseTable(), [&view, &groups](const Record& record) {
+            auto group_values = view.groupValuesOf(record);
+            auto inserted = groups.emplace(MaterializedView::groupKey(group_values), view.emptyGroup(group_values));
+            view.apply(inserted.first->second, record, 1);
+        }, &elapsed);
+        
+        for (const auto& addr : std::vector<PhysicalAddress>(relation_blocks[view_name])) {
+            releaseBlock(view_name, addr);
+        }
+        view.clearDirectory();
+        result_cache.invalidate(view_name);
+        
+        std::set<size_t> touched;
+        for (const auto& group : groups) {
+            size_t position = 0;
+            if (!placeViewGroup(view, group.first, group.second, position)) {
+                std::cerr << "Error: sin espacio para la vista " << view_name << "; quedan "
+                          << groups.size() - view.getGroupCount() << " grupos sin guardar." << std::endl;
+                break;
+            }
+            touched.insert(position);
+        }
+        for (size_t position : touched) {
+            auto block = getBlock(relation_blocks[view_name][position]);
+            if (!block) continue;
+            elapsed += chargeAccess(view_name, IOType::WRITE, block->getAddress());
+            persistBlock(block);
+        }
+        runDemotionSweep();
+        return elapsed;
+    }
+
+    /**
+     * @brief Lee un grupo de la vista: una búsqueda en el directorio y un bloque
+     * @param row Columnas de agrupación seguidas del valor de cada agregado
+     * @return false si el grupo no existe (ninguna fila de la tabla base)
+     */
+    bool readMaterializedView(const std::string& view_name, const std::vector<std::string>& group_values,
+                              std::vector<std::string>& row, double* elapsed = nullptr) {
+        auto it = materialized_views.find(view_name);
+        if (it == materialized_views.end()) {
+            std::cout << "Vista '" << view_name << "' no encontrada." << std::endl;
+            return false;
+        }
+        MaterializedView::GroupState state;
+        if (!readViewGroup(it->second, MaterializedView::groupKey(group_values), state, elapsed)) {
+            return false;
+        }
+        row = it->second.resultRow(state);
+        return true;
+    }
+
+    /**
+     * @brief Todas las filas de la vista, en orden de bloque
+     */
+    std::vector<std::vector<std::string>> materializedViewRows(const std::string& view_name) {
+        std::vector<std::vector<std::string>> rows;
+        auto it = materialized_views.find(view_name);
+        if (it == materialized_views.end()) {
+            return rows;
+        }
+        for (const auto& addr : relation_blocks[view_name]) {
+            auto block = getBlock(addr);
+            if (!block) continue;
+            chargeAccess(view_name, IOType::READ, addr);
+            for (const auto& record : block->getActiveRecords()) {
+                MaterializedView::GroupState state;
+                if (it->second.fromStoredValues(record->getFieldValues(), state)) {
+                    rows.push_back(it->second.resultRow(state));
+                }
+            }
+        }
+        runDemotionSweep();
+        return rows;
+    }
+
+    void displayMaterializedView(const std::string& view_name) {
+        auto it = materialized_views.find(view_name);
+        if (it == materialized_views.end()) {
+            std::cout << "Vista '" << view_name << "' no encontrada." << std::endl;
+            return;
+        }
+        std::cout << "\n=== VISTA MATERIALIZADA: " << view_name << " (tabla " << it->second.getBaseTable()
+                  << ") ===" << std::endl;
+        const auto header = it->second.resultHeader();
+        for (size_t i = 0; i < header.size(); ++i) {
+            std::cout << (i > 0 ? " | " : "") << header[i];
+        }
+        std::cout << std::endl;
+        for (const auto& row : materializedViewRows(view_name)) {
+            for (size_t i = 0; i < row.size(); ++i) {
+                std::cout << (i > 0 ? " | " : "") << row[i];
+            }
+            std::cout << std::endl;
+        }
+    }
+
+private:
+    /**
+     * @brief Inserción en una tabla heap: bloque con hueco según el mapa de espacio libre o uno nuevo
+     */
+    bool insertHeapRecord(const std::string& table_name, const std::shared_ptr<Record>& record) {
+        // Encontrar bloque con espacio disponible (el hueco queda reservado)
+        size_t position = 0;
+        auto block = findBlockWithSpace(table_name, record->getSize(), position);
+        bool fresh = !block;
+        if (fresh) {
+            if (relation_blocks[table_name].size() >= FreeSpaceMap::CAPACITY) {
+                std::cout << "Error: la tabla '" << table_name << "' ya tiene los " << FreeSpaceMap::CAPACITY
+                          << " bloques que admite el mapa de espacio libre." << std::endl;
+                return false;
+            }
+            // Crear nuevo bloque
+            PhysicalAddress addr;
+            if (!allocateNewBlock(addr, isTableHot(table_name))) {
+                std::cout << "Error: No se pudo insertar el registro." << std::endl;
+                return false;
+            }
+            block = std::make_shared<Block>(addr, config.getBytesPerSector());
+            block->setRelationName(table_name);
+            block_cache[addr] = block;
+            FreeSpaceMap& map = freeSpaceMapFor(table_name);
+            position = relation_blocks[table_name].size();
+            relation_blocks[table_name].push_back(addr);
+            map.publish(position, static_cast<uint32_t>(block->getFreeSpace()), 0);
+        }
+        
+        // Insertar el registro
+        bool added = block->addRecord(record);
+        if (fresh) refreshFreeSpace(table_name, position, *block);
+        if (added) {
+            // Simular tiempo de escritura (el nivel en memoria solo añade al WAL)
+            double access_time = chargeAccess(table_name, IOType::WRITE, block->getAddress());
+            
+            // Escribir bloque al disco
+            persistBlock(block);
+            result_cache.invalidate(table_name);
+            indexRowAt(table_name, position, block, block->getRecordCount() - 1);
+            if (trigram_indexes.count(table_name) > 0) {
+                for (auto& index : trigram_indexes.at(table_name)) {
+                    if (index.second.needsFlush()) flushTrigramPostings(table_name, index.second);
+                }
+            }
+            
+            std::cout << "Registro insertado en tabla '" << table_name 
+                      << "' (ID: " << record->getId() << ", Tiempo: " 
+                      << access_time << " ms)" << std::endl;
+            runDemotionSweep();
+            return true;
+        }
+        
+        std::cout << "Error: No se pudo insertar el registro." << std::endl;
+        return false;
+    }
+
+public:
+    /**
+     * @brief Carga registros desde un archivo CSV
+     */
+    bool loadFromCSV(const std::string& table_name, const std::string& csv_file) {
+        std::ifstream file(csv_file);
+        if (!file.is_open()) {
+            std::cout << "Error: No se pudo abrir el archivo " << csv_file << std::endl;
+            return false;
+        }
+        
+        std::string line;
+        int records_loaded = 0;
+        
+        // Saltar header si existe
+        if (std::getline(file, line)) {
+            // Procesar primera línea como datos
+        }
+        
+        // Procesar cada línea
+        do {
+            std::vector<std::string> values = parseCSVLine(line);
+            if (!values.empty()) {
+                if (insertRecord(table_name, values)) {
+                    records_loaded++;
+                }
+            }
+        } while (std::getline(file, line));
+        
+        file.close();
+        
+        std::cout << "Cargados " << records_loaded << " registros desde " 
+                  << csv_file << std::endl;
+        return records_loaded > 0;
+    }
+
+    /**
+     * @brief Busca un registro por ID
+     */
+    std::shared_ptr<Record> findRecord(const std::string& table_name, int record_id) {
+        auto it = relation_blocks.find(table_name);
+        if (it == relation_blocks.end() || isInternalRelation(table_name)) {
+            return nullptr;
+        }
+        if (lsm_trees.count(table_name) > 0) {
+            return findLSMRecord(table_name, record_id);
+        }
+        
+        // Buscar en todos los bloques de la tabla
+        for (const auto& addr : it->second) {
+            auto block = getBlock(addr);
+            if (block) {
+                auto record = block->findRecord(record_id);
+                if (record) {
+                    // Simular tiempo de lectura
+                    chargeAccess(table_name, IOType::READ, addr);
+                    
+                    runDemotionSweep();
+                    return record;
+                }
+            }
+        }
+        
+        runDemotionSweep();
+        return nullptr;
+    }
+
+    /**
+     * @brief Elimina un registro lógicamente
+     */
+    bool deleteRecord(const std::string& table_name, int record_id) {
+        auto it = relation_blocks.find(table_name);
+        if (it == relation_blocks.end() || isInternalRelation(table_name) || rejectViewWrite(table_name)) {
+            return false;
+        }
+        if (lsm_trees.count(table_name) > 0) {
+            // El borrado ciego no lee la fila; las vistas necesitan sus valores
+            auto record = hasViews(table_name) ? findLSMRecord(table_name, record_id) : nullptr;
+            if (!deleteLSMRecord(table_name, record_id)) {
+                return false;
+            }
+            if (record) applyViewDeltas(table_name, *record, -1);
+            return true;
+        }
+        
+        // Buscar en todos los bloques de la tabla
+        for (const auto& addr : it->second) {
+            auto block = getBlock(addr);
+            auto record = block ? block->findRecord(record_id) : nullptr;
+            if (record && hasRowIndexes(table_name)) {
+                const auto& records = block->getAllRecords();
+                size_t slot = static_cast<size_t>(std::find(records.begin(), records.end(), record) - records.begin());
+                unindexRow(table_name, static_cast<size_t>(&addr - it->second.data()), slot, *record);
+            }
+            if (record && block->deleteRecord(record_id)) {
+                // Simular tiempo de escritura
+                chargeAccess(table_name, IOType::WRITE, addr);
+                
+                // Escribir bloque modificado
+                persistBlock(block);
+                result_cache.invalidate(table_name);
+                applyViewDeltas(table_name, *record, -1);
+                
+                std::cout << "Registro " << record_id << " eliminado lógicamente." << std::endl;
+                runDemotionSweep();
+                return true;
+            }
+        }
+        
+        return false;
+    }
+
+    /**
+     * @brief Compacta una tabla eliminando registros marcados como eliminados
+     */
+    void compactTable(const std::string& table_name) {
+        auto it = relation_blocks.find(table_name);
+        if (it == relation_blocks.end() || isInternalRelation(table_name)) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return;
+        }
+        if (lsm_trees.count(table_name) > 0) {
+            compactLSMTable(table_name);
+            return;
+        }
+        if (clustered_tables.count(table_name) > 0) {
+            reorganizeClusteredTable(table_name);
+            return;
+        }
+        
+        int compacted_blocks = 0;
+        for (const auto& addr : it->second) {
+            auto block = getBlock(addr);
+            if (block) {
+                size_t old_count = block->getRecordCount();
+                block->compactBlock();
+                size_t new_count = block->getRecordCount();
+                
                 if (old_count != new_count) {
-                    filesystem.writeBlock(addr, *block);
+                    persistBlock(block);
                     compacted_blocks++;
                 }
             }
         }
         
-        std::cout << "Compactación completada. " << compacted_blocks 
-                  << " bloques procesados." << std::endl;
+        if (compacted_blocks > 0) {
+            free_space_maps.erase(table_name);  // Los huecos recuperados se ven al reconstruirlo
+        }
+        if (compacted_blocks > 0 && trigram_indexes.count(table_name) > 0) {
+            rewriteTrigramIndexes(table_name);  // También reconstruye los demás índices
+        } else if (compacted_blocks > 0 && hasRowIndexes(table_name)) {
+            rebuildRowIndexes(table_name);  // Las ranuras se han desplazado
+        }
+        if (compacted_blocks > 0 && materialized_views.count(table_name) > 0) {
+            loadViewDirectory(materialized_views.at(table_name));
+        }
+        
+        std::cout << "Compactación completada. " << compacted_blocks 
+                  << " bloques procesados." << std::endl;
+    }
+
+    /**
+     * @brief Muestra todos los registros de una tabla
+     */
+    void displayTable(const std::string& table_name) {
+        auto it = relation_blocks.find(table_name);
+        if (it == relation_blocks.end() || isInternalRelation(table_name)) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return;
+        }
+        if (lsm_trees.count(table_name) > 0) {
+            displayLSMTable(table_name);
+            return;
+        }
+        
+        std::cout << "\n=== TABLA: " << table_name << " ===" << std::endl;
+        
+        int total_records = 0;
+        int active_records = 0;
+        
+        for (const auto& addr : it->second) {
+            auto block = getBlock(addr);
+            if (block) {
+                std::cout << "\n--- Bloque " << addr << " ---" << std::endl;
+                block->displayInfo();
+                
+                auto active_recs = block->getActiveRecords();
+                for (const auto& record : active_recs) {
+                    record->display();
+                    std::cout << "---" << std::endl;
+                }
+                
+                total_records += block->getRecordCount();
+                active_records += active_recs.size();
+            }
+        }
+        
+        std::cout << "\nResumen: " << active_records << " registros activos de " 
+                  << total_records << " totales." << std::endl;
+    }
+
+    /**
+     * @brief Muestra estadísticas del disco
+     */
+    void displayStatistics() {
+        std::cout << "\n=== ESTADÍSTICAS DEL DISCO ===" << std::endl;
+        
+        config.displayConfig();
+        filesystem.displayUsageStatistics();
+        
+        std::cout << "\n=== ESTADÍSTICAS DE ACCESO ===" << std::endl;
+        io_clock.displayStatistics();
+        
+        std::cout << "\n=== TABLAS ===" << std::endl;
+        for (const auto& table : relation_blocks) {
+            if (isInternalRelation(table.first)) continue;
+            std::cout << "- " << table.first << ": " << table.second.size() 
+                      << " bloques [" << storageTierToString(getTableTier(table.first))
+                      << ", " << tableOrganizationToString(getTableOrganization(table.first))
+                      << "]" << std::endl;
+        }
+        
+        displayTierStatistics();
+        for (const auto& tree : lsm_trees) {
+            tree.second->displayStatistics();
+        }
+        for (const auto& table : clustered_tables) {
+            std::cout << "\n=== TABLA AGRUPADA: " << table.first << " ===" << std::endl;
+            std::cout << "Clave: " << table.second.getKeyName() << " | Hojas: "
+                      << table.second.getLeafCount() << " | Divisiones: "
+                      << table.second.getSplitCount() << " | Cilindros:";
+            for (int track : table.second.getCylinders()) std::cout << " " << track;
+            std::cout << std::endl;
+        }
+        for (const auto& table : bitmap_indexes) {
+            std::cout << "\n=== MAPAS DE BITS: " << table.first << " (" << table.second.getRowCount()
+                      << " filas) ===" << std::endl;
+            for (const auto& column : table.second.getColumns()) {
+                std::cout << "- " << column << ": " << table.second.getDistinctValues(column)
+                          << " valores, " << table.second.getSizeInBytes(column) << " bytes" << std::endl;
+            }
+        }
+        for (const auto& table : trigram_indexes) {
+            for (const auto& index : table.second) {
+                std::cout << "\n=== TRIGRAMAS: " << table.first << "." << index.first << " ===" << std::endl;
+                std::cout << "Trigramas: " << index.second.getTrigramCount() << " | Tramos: "
+                          << index.second.getChunkCount() << " | Pendientes: "
+                          << index.second.getPendingRows() << " filas" << std::endl;
+            }
+        }
+        for (const auto& table : radix_indexes) {
+            for (const auto& index : table.second) {
+                std::cout << "\n=== ÍNDICE ART: " << table.first << "." << index.first << " ===" << std::endl;
+                std::cout << "Claves: " << index.second.getKeyCount() << " | Memoria: "
+                          << index.second.getMemoryBytes() << " bytes" << std::endl;
+            }
+        }
+        for (const auto& table : btree_indexes) {
+            for (const auto& index : table.second) {
+                std::cout << "\n=== ÍNDICE B+: " << table.first << "." << index.first << " ===" << std::endl;
+                std::cout << "Entradas: " << index.second.getEntryCount() << " | Altura: " << index.second.getHeight()
+                          << " | Nodos: " << index.second.getNodeCount() << " | Memoria: "
+                          << index.second.getMemoryBytes() << " bytes" << std::endl;
+            }
+        }
+        result_cache.displayStatistics();
+        for (const auto& entry : materialized_views) {
+            std::cout << "\n=== VISTA MATERIALIZADA: " << entry.first << " ===" << std::endl;
+            std::cout << "Tabla base: " << entry.second.getBaseTable() << " | Agregados:";
+            for (const auto& spec : entry.second.getAggregates()) std::cout << " " << spec.toString();
+            std::cout << " | Grupos: " << entry.second.getGroupCount() << std::endl;
+        }
+        for (const auto& table : column_sketches) {
+            for (const auto& column : table.second) {
+                size_t bytes = 0;
+                for (const auto& block : column.second) bytes += block.second.sketch.getMemoryBytes();
+                std::cout << "\n=== SKETCHES: " << table.first << "." << column.first << " ===" << std::endl;
+                std::cout << "Resúmenes de bloque: " << column.second.size() << " | Memoria: " << bytes
+                          << " bytes" << std::endl;
+            }
+        }
+    }
+
+    /**
+     * @brief Nivel de almacenamiento de una relación
+     */
+    StorageTier getTableTier(const std::string& table_name) const {
+        auto it = table_tiers.find(table_name);
+        return it != table_tiers.end() ? it->second : StorageTier::DISK;
+    }
+
+    /**
+     * @brief Cambia el nivel de almacenamiento de una relación y migra sus bloques
+     *
+     * El nivel se anota primero en el esquema; si el proceso cae a mitad de la
+     * migración, loadBlockIndex completa el traslado a partir del WAL.
+     */
+    bool setTableTier(const std::string& table_name, StorageTier tier) {
+        auto it = relation_blocks.find(table_name);
+        if (it == relation_blocks.end() || isInternalRelation(table_name)) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return false;
+        }
+        
+        StorageTier old_tier = getTableTier(table_name);
+        if (old_tier == tier) {
+            return true;
+        }
+        if (lsm_trees.count(table_name) > 0) {
+            // La compactación de fondo lee y escribe sectores directamente
+            std::cout << "Error: las tablas LSM solo admiten el nivel DISK." << std::endl;
+            return false;
+        }
+        if (isSnapshotActive()) {
+            std::cout << "Error: hay una instantánea en curso; reintente al terminar." << std::endl;
+            return false;
+        }
+        
+        // Traer todos los bloques a memoria antes de cambiar de nivel
+        std::vector<std::shared_ptr<Block>> blocks;
+        for (const auto& addr : it->second) {
+            auto block = getBlock(addr);
+            if (!block) {
+                std::cout << "Error: no se pudo leer el bloque " << addr << std::endl;
+                return false;
+            }
+            blocks.push_back(block);
+        }
+        
+        table_tiers[table_name] = tier;
+        saveTableTier(table_name, tier);
+        
+        for (const auto& block : blocks) {
+            const PhysicalAddress& addr = block->getAddress();
+            persistBlock(block);
+            
+            if (tier == StorageTier::MEMORY) {
+                // El WAL es ahora la única copia persistente
+                filesystem.deleteBlock(addr);
+                if (cold_blocks.erase(addr) > 0) {
+                    filesystem.deleteColdBlock(addr);
+                }
+            } else if (tier == StorageTier::COLD) {
+                block_cache.erase(addr);
+                last_access.erase(addr);
+            }
+        }
+        
+        // Las imágenes de la tabla ya no pertenecen al WAL
+        if (old_tier == StorageTier::MEMORY) {
+            checkpointWal();
+        }
+        
+        std::cout << "Tabla '" << table_name << "': " << storageTierToString(old_tier)
+                  << " -> " << storageTierToString(tier) << " (" << blocks.size()
+                  << " bloques)" << std::endl;
+        return true;
+    }
+
+    /**
+     * @brief Reescribe el WAL con la última imagen de cada bloque en memoria
+     */
+    bool checkpointWal() {
+        std::vector<WalRecord> records;
+        long long lsn = wal.getLastLSN();
+        
+        for (const auto& table : relation_blocks) {
+            if (getTableTier(table.first) != StorageTier::MEMORY) continue;
+            
+            for (const auto& addr : table.second) {
+                auto cached = block_cache.find(addr);
+                if (cached != block_cache.end()) {
+                    records.emplace_back(++lsn, table.first, addr, cached->second->serialize());
+                }
+            }
+        }
+        
+        if (!wal.rewrite(records)) {
+            std::cerr << "Error: checkpoint del WAL fallido." << std::endl;
+            return false;
+        }
+        wal_checkpoint_bytes = wal.getByteCount();
+        return true;
+    }
+
+    /**
+     * @brief Comprime los bloques en disco que no se han tocado en `idle`
+     *
+     * Los bloques degradados salen de la caché y pasan al nivel frío; el
+     * siguiente acceso los descomprime y los devuelve a su sector. Las tablas
+     * frías solo liberan su caché; las tablas en memoria y las LSM nunca se degradan.
+     * @return Número de bloques degradados
+     */
+    size_t demoteIdleBlocks(std::chrono::milliseconds idle) {
+        auto now = SteadyClock::now();
+        size_t demoted = 0;
+        
+        for (const auto& table : relation_blocks) {
+            if (getTableTier(table.first) == StorageTier::MEMORY) continue;
+            if (lsm_trees.count(table.first) > 0) continue;  // La compactación lee sus sectores
+            
+            for (const auto& addr : table.second) {
+                auto access = last_access.find(addr);
+                if (access != last_access.end() && now - access->second < idle) continue;
+                
+                if (cold_blocks.count(addr) > 0) {
+                    // Ya comprimido: solo se libera la copia descomprimida
+                    block_cache.erase(addr);
+                    last_access.erase(addr);
+                    continue;
+                }
+                
+                if (frozen_blocks.count(addr) > 0) continue;  // La instantánea lee su sector
+                
+                auto block = getCachedOrStoredBlock(addr);
+                if (block && filesystem.writeColdBlock(addr, *block)) {
+                    cold_blocks.insert(addr);
+                    block_cache.erase(addr);
+                    last_access.erase(addr);
+                    demoted++;
+                }
+            }
+        }
+        
+        last_demotion_sweep = now;
+        return demoted;
+    }
+
+    /**
+     * @brief Periodo de inactividad tras el cual se degradan los bloques (0 = nunca)
+     */
+    void setDemotionPeriod(std::chrono::milliseconds period) {
+        demotion_period = period;
+        last_demotion_sweep = SteadyClock::now();
+    }
+
+    std::chrono::milliseconds getDemotionPeriod() const { return demotion_period; }
+    IOStatistics getIOStatistics() const { return io_clock.getStatistics(); }
+    size_t getColdBlockCount() const { return cold_blocks.size(); }
+    const WriteAheadLog& getWal() const { return wal; }
+
+    /**
+     * @brief Inicia una instantánea en línea y su volcado en segundo plano
+     *
+     * Congela la lista de bloques de todas las relaciones; a partir de aquí las
+     * escrituras sobre un bloque congelado se desvían a un bloque nuevo
+     * (paginación en sombra), de modo que el hilo de volcado lee sectores que
+     * nadie modifica y las inserciones no esperan al respaldo. Los bloques del
+     * nivel en memoria se copian al congelar porque no tienen sector propio.
+     * @param since_lsn Solo se copian bloques con LSN de página mayor (0 = todos)
+     */
+    bool beginSnapshot(const std::string& archive_path, long long since_lsn = 0) {
+        if (isSnapshotActive()) {
+            std::cout << "Ya hay una instantánea en curso." << std::endl;
+            return false;
+        }
+        
+        std::vector<ArchiveSection> metadata;
+        if (!collectMetadataSections(metadata)) {
+            std::cout << "Error: no se pudieron leer los metadatos del disco." << std::endl;
+            return false;
+        }
+        
+        // El manifiesto lista todos los bloques vivos: al restaurar una cadena
+        // elimina los que se reubicaron o desaparecieron desde el respaldo base
+        ArchiveSection manifest;
+        manifest.kind = "MANIFEST";
+        std::ostringstream manifest_data;
+        
+        std::vector<FrozenBlock> frozen;
+        size_t total_blocks = 0;
+        for (const auto& table : relation_blocks) {
+            StorageTier tier = getTableTier(table.first);
+            for (const auto& addr : table.second) {
+                manifest_data << addr.toString() << "|" << table.first << "|"
+                              << storageTierToString(tier) << "\n";
+                total_blocks++;
+                
+                auto lsn = block_lsns.find(addr);
+                if (lsn != block_lsns.end() && lsn->second <= since_lsn) {
+                    continue;  // Sin cambios desde el respaldo anterior
+                }
+                
+                FrozenBlock entry{table.first, addr, tier, cold_blocks.count(addr) > 0, ""};
+                if (tier == StorageTier::MEMORY) {
+                    entry.image = block_cache.at(addr)->serialize();
+                } else {
+                    frozen_blocks.insert(addr);
+                }
+                frozen.push_back(entry);
+            }
+        }
+        manifest.data = manifest_data.str();
+        metadata.push_back(manifest);
+        
+        std::error_code ec;
+        shadowed_blocks.clear();
+        fs::remove(getShadowListPath(), ec);
+        snapshot_report = SnapshotReport();
+        snapshot_report.archive_path = archive_path;
+        snapshot_report.incremental = since_lsn > 0;
+        snapshot_report.base_lsn = since_lsn;
+        snapshot_report.lsn = last_page_lsn;
+        snapshot_report.total_blocks = total_blocks;
+        snapshot_report.total_bytes = static_cast<long long>(total_blocks) * config.getBytesPerSector();
+        snapshot_total = frozen.size();
+        snapshot_progress = 0;
+        snapshot_running = true;
+        
+        std::string label = (since_lsn > 0 ? "INCREMENTAL|" : "FULL|") +
+                            std::to_string(since_lsn) + "|" + std::to_string(last_page_lsn);
+        snapshot_thread = std::thread(&DiskManager::streamSnapshot, this, archive_path, label,
+                                      std::move(metadata), std::move(frozen));
+        
+        std::cout << "Instantánea iniciada: " << snapshot_total << " de " << total_blocks
+                  << " bloques congelados -> " << archive_path << std::endl;
+        return true;
+    }
+
+    /**
+     * @brief Inicia un respaldo incremental sobre el último respaldo completado
+     *
+     * Solo copia los bloques cuyo LSN de página avanzó desde ese respaldo.
+     */
+    bool beginIncrementalBackup(const std::string& archive_path) {
+        long long base_lsn = getLastBackupLSN();
+        if (base_lsn <= 0) {
+            std::cout << "No hay un respaldo previo; se requiere uno completo." << std::endl;
+            return false;
+        }
+        return beginSnapshot(archive_path, base_lsn);
+    }
+
+    /**
+     * @brief LSN del último respaldo completado (0 si no hay ninguno)
+     */
+    long long getLastBackupLSN() const {
+        std::ifstream file(getBackupHistoryPath());
+        std::string line;
+        long long lsn = 0;
+        
+        // Formato: tipo|lsn_base|lsn|archivo
+        while (std::getline(file, line)) {
+            std::istringstream iss(line);
+            std::string type, base, value;
+            if (std::getline(iss, type, '|') && std::getline(iss, base, '|') &&
+                std::getline(iss, value, '|')) {
+                lsn = std::stoll(value);
+            }
+        }
+        return lsn;
+    }
+
+    long long getLastPageLSN() const { return last_page_lsn; }
+
+    /**
+     * @brief Empieza a enviar cada bloque persistido al directorio compartido
+     *
+     * Una réplica arranca de un respaldo tomado después de activar el envío y
+     * reproduce las entradas con LSN posterior al del respaldo.
+     */
+    bool enableLogShipping(const std::string& directory, size_t records_per_segment = 4096) {
+        if (!ship_log.open(directory, records_per_segment)) {
+            return false;
+        }
+        std::cout << "Envío de log activo en " << directory << " (LSN " << last_page_lsn << ")" << std::endl;
+        return true;
+    }
+
+    bool isShippingLog() const { return ship_log.isOpen(); }
+
+    /**
+     * @brief Aplica en una réplica una entrada recibida del primario
+     *
+     * Conserva el LSN del primario (no se vuelve a sellar) y es idempotente,
+     * de modo que reaplicar entradas tras un reinicio no cambia el resultado.
+     */
+    bool applyShippedRecord(const WalRecord& record) {
+        const std::string schema_prefix = ShippingLog::SCHEMA_PREFIX;
+        last_page_lsn = std::max(last_page_lsn, record.lsn);
+        
+        if (record.relation.find(schema_prefix) == 0) {
+            std::string table_name = record.relation.substr(schema_prefix.size());
+            std::ofstream(filesystem.getBasePath() + "/metadata/schema_" + table_name + ".txt")
+                << record.payload;
+            schema_cache.erase(table_name);
+            result_cache.invalidate(table_name);
+            
+            std::istringstream lines(record.payload);
+            std::string line;
+            while (std::getline(lines, line)) {
+                if (line.find("tier=") == 0) {
+                    table_tiers[table_name] = storageTierFromString(line.substr(5));
+                }
+            }
+            return true;
+        }
+        
+        if (record.relation == ShippingLog::FREE_RELATION) {
+            std::vector<std::string> owners;
+            for (auto& table : relation_blocks) {
+                auto& addresses = table.second;
+                auto removed = std::remove(addresses.begin(), addresses.end(), record.address);
+                if (removed != addresses.end()) owners.push_back(table.first);
+                addresses.erase(removed, addresses.end());
+            }
+            for (const auto& owner : owners) markShippedChange(owner);
+            block_cache.erase(record.address);
+            block_lsns.erase(record.address);
+            last_access.erase(record.address);
+            filesystem.deleteBlock(record.address);
+            if (cold_blocks.erase(record.address) > 0) {
+                filesystem.deleteColdBlock(record.address);
+            }
+            return true;
+        }
+        
+        auto block = std::make_shared<Block>(record.address, config.getBytesPerSector());
+        if (!block->deserialize(record.payload)) {
+            return false;
+        }
+        
+        // Un cambio a memoria deja sin uso las copias de otros niveles
+        if (getTableTier(record.relation) == StorageTier::MEMORY) {
+            filesystem.deleteBlock(record.address);
+            if (cold_blocks.erase(record.address) > 0) {
+                filesystem.deleteColdBlock(record.address);
+            }
+        }
+        
+        block_cache[record.address] = block;
+        last_access[record.address] = SteadyClock::now();
+        indexBlock(block);
+        markShippedChange(record.relation);
+        
+        int zone = config.getZoneForTrack(record.address.getTrack());
+        zone_next_block[zone] = std::max(zone_next_block[zone], config.addressToZoneBlock(record.address) + 1);
+        return writeBlockToTier(*block);
+    }
+
+    /**
+     * @brief Deja una relación cambiada por el primario sin resultados en caché y con índices por rehacer
+     *
+     * Los bloques de las listas de trigramas cuentan como cambios de su tabla.
+     */
+    void markShippedChange(const std::string& relation) {
+        std::string table_name = relation;
+        if (isInternalRelation(relation)) {
+            for (const auto& table : trigram_indexes) {
+                for (const auto& index : table.second) {
+                    if (index.second.getRelationName(table.first) == relation) table_name = table.first;
+                }
+            }
+        }
+        result_cache.invalidate(relation);
+        result_cache.invalidate(table_name);
+        free_space_maps.erase(table_name);
+        if (hasRowIndexes(table_name)) stale_row_indexes.insert(table_name);
+    }
+
+    /**
+     * @brief Espera al volcado y libera los bloques congelados sustituidos
+     */
+    SnapshotReport finishSnapshot() {
+        if (!snapshot_thread.joinable()) {
+            return snapshot_report;
+        }
+        snapshot_thread.join();
+        
+        for (const auto& addr : shadowed_blocks) {
+            if (cold_blocks.erase(addr) > 0) {
+                filesystem.deleteColdBlock(addr);
+            } else {
+                filesystem.deleteBlock(addr);
+            }
+        }
+        std::error_code ec;
+        fs::remove(getShadowListPath(), ec);
+        
+        snapshot_report.redirected_writes = shadowed_blocks.size();
+        frozen_blocks.clear();
+        shadowed_blocks.clear();
+        
+        if (snapshot_report.ok) {
+            std::ofstream(getBackupHistoryPath(), std::ios::app)
+                << (snapshot_report.incremental ? "INCREMENTAL" : "FULL") << "|"
+                << snapshot_report.base_lsn << "|" << snapshot_report.lsn << "|"
+                << snapshot_report.archive_path << std::endl;
+        }
+        return snapshot_report;
+    }
+
+    bool isSnapshotActive() const { return snapshot_thread.joinable(); }
+
+    /**
+     * @brief Fracción del volcado completada (0..1)
+     */
+    double getSnapshotProgress() const {
+        if (snapshot_total == 0) return isSnapshotActive() ? 0.0 : 1.0;
+        return static_cast<double>(snapshot_progress) / snapshot_total;
+    }
+
+    /**
+     * @brief Muestra el resultado de la última instantánea
+     */
+    void displaySnapshotReport(const SnapshotReport& report) const {
+        std::cout << "\n=== INSTANTÁNEA ===" << std::endl;
+        std::cout << "Archivo: " << report.archive_path << " ("
+                  << (report.ok ? "completo" : "fallido") << ")" << std::endl;
+        std::cout << "Tipo: " << (report.incremental ? "incremental" : "completo")
+                  << " | LSN " << report.base_lsn << " -> " << report.lsn << std::endl;
+        std::cout << "Bloques copiados: " << report.blocks << " de " << report.total_blocks
+                  << " | Escrituras desviadas: " << report.redirected_writes << std::endl;
+        std::cout << "Bytes copiados: " << report.copied_bytes << " de " << report.total_bytes;
+        if (report.total_bytes > 0) {
+            std::cout << " (" << (100.0 * report.copied_bytes / report.total_bytes) << "%)";
+        }
+        std::cout << std::endl;
+        std::cout << "Tamaño: " << report.archive_bytes << " bytes de "
+                  << report.raw_bytes << " sin comprimir" << std::endl;
+        std::cout << "Duración del volcado: " << report.elapsed_ms << " ms" << std::endl;
+    }
+
+    /**
+     * @brief Reconstruye un disco completo a partir de un archivo de respaldo
+     * @param target_path Directorio del disco restaurado (no debe existir)
+     */
+    static bool restoreSnapshot(const std::string& archive_path, const std::string& target_path) {
+        return restoreBackupChain({archive_path}, target_path);
+    }
+
+    /**
+     * @brief Restaura un respaldo completo seguido de una cadena de incrementales
+     *
+     * Cada incremental debe partir del LSN en que terminó el anterior. Los
+     * bloques se aplican en orden y, al final, el manifiesto del último
+     * respaldo decide qué bloques siguen vivos y en qué nivel.
+     */
+    static bool restoreBackupChain(const std::vector<std::string>& archives,
+                                   const std::string& target_path) {
+        if (archives.empty()) {
+            return false;
+        }
+        if (fs::exists(target_path)) {
+            std::cout << "Error: el destino ya existe: " << target_path << std::endl;
+            return false;
+        }
+        
+        // Validar la cadena antes de escribir nada en el destino
+        long long chain_lsn = 0;
+        for (size_t i = 0; i < archives.size(); ++i) {
+            ArchiveReader reader;
+            if (!reader.open(archives[i])) {
+                std::cout << "Error: no se pudo abrir el respaldo " << archives[i] << std::endl;
+                return false;
+            }
+            
+            // Etiqueta: tipo|lsn_base|lsn
+            std::istringstream label(reader.getLabel());
+            std::string type, base_text, lsn_text;
+            std::getline(label, type, '|');
+            std::getline(label, base_text, '|');
+            std::getline(label, lsn_text, '|');
+            long long base_lsn = base_text.empty() ? 0 : std::stoll(base_text);
+            bool chained = (i == 0) ? type == "FULL" : (type == "INCREMENTAL" && base_lsn == chain_lsn);
+            if (!chained) {
+                std::cout << "Error: " << archives[i] << " no continúa la cadena (LSN base "
+                          << base_lsn << ", esperado " << chain_lsn << ")" << std::endl;
+                return false;
+            }
+            chain_lsn = lsn_text.empty() ? 0 : std::stoll(lsn_text);
+        }
+        
+        FileSystemSimulator target(target_path);
+        WriteAheadLog target_wal;
+        std::set<PhysicalAddress> written;
+        std::map<PhysicalAddress, std::pair<std::string, StorageTier>> manifest;
+        std::map<PhysicalAddress, std::string> memory_images;
+        size_t blocks = 0;
+        
+        for (size_t i = 0; i < archives.size(); ++i) {
+            ArchiveReader reader;
+            if (!reader.open(archives[i])) {
+                return false;
+            }
+            
+            ArchiveSection section;
+            while (reader.next(section)) {
+                if (section.kind == "CONFIG") {
+                    if (i > 0) continue;
+                    fs::create_directories(target_path + "/metadata");
+                    std::string config_path = target_path + "/metadata/disk_config.txt";
+                    std::ofstream(config_path) << section.data;
+                    
+                    DiskConfig restored;
+                    if (!restored.loadFromFile(config_path) || !target.initialize(restored) ||
+                        !target_wal.open(target_path + "/metadata/wal.log")) {
+                        return false;
+                    }
+                } else if (section.kind == "SCHEMA") {
+                    std::ofstream(target_path + "/metadata/" + section.name) << section.data;
+                } else if (section.kind == "MANIFEST") {
+                    manifest.clear();
+                    std::istringstream lines(section.data);
+                    std::string line;
+                    while (std::getline(lines, line)) {
+                        std::istringstream fields(line);
+                        std::string addr_text, relation, tier;
+                        PhysicalAddress addr;
+                        if (std::getline(fields, addr_text, '|') && std::getline(fields, relation, '|') &&
+                            std::getline(fields, tier) && PhysicalAddress::fromString(addr_text, addr)) {
+                            manifest[addr] = {relation, storageTierFromString(tier)};
+                        }
+                    }
+                } else if (section.kind == "BLOCK") {
+                    if (!target.isInitialized()) return false;
+                    
+                    Block block(section.address, target.getDiskConfig().getBytesPerSector());
+                    if (!block.deserialize(section.data)) {
+                        // Antes de tocar la versión que ya hay en el destino
+                        std::cout << "Error: bloque " << section.address << " ilegible en " << archives[i]
+                                  << "; se aborta la restauración." << std::endl;
+                        return false;
+                    }
+                    
+                    // Una versión anterior pudo estar en otro nivel
+                    target.deleteBlock(section.address);
+                    target.deleteColdBlock(section.address);
+                    memory_images.erase(section.address);
+                    
+                    bool ok = true;
+                    switch (storageTierFromString(section.tier)) {
+                        case StorageTier::MEMORY:
+                            memory_images[section.address] = section.data;
+                            break;
+                        case StorageTier::COLD:
+                            ok = target.writeColdBlock(section.address, block);
+                            break;
+                        default:
+                            ok = target.writeBlock(section.address, block);
+                            break;
+                    }
+                    if (!ok) return false;
+                    written.insert(section.address);
+                    blocks++;
+                }
+            }
+            
+            if (!reader.isComplete()) {
+                std::cout << "Error: respaldo incompleto o corrupto: " << archives[i] << std::endl;
+                return false;
+            }
+        }
+        
+        // Descartar bloques que ya no figuran en el último manifiesto
+        for (const auto& addr : written) {
+            if (manifest.count(addr) == 0) {
+                target.deleteBlock(addr);
+                target.deleteColdBlock(addr);
+                memory_images.erase(addr);
+            }
+        }
+        
+        std::vector<WalRecord> wal_records;
+        long long wal_lsn = 0;
+        for (const auto& image : memory_images) {
+            wal_records.emplace_back(++wal_lsn, manifest[image.first].first, image.first, image.second);
+        }
+        if (!target_wal.rewrite(wal_records)) {
+            return false;
+        }
+        
+        std::cout << "Restaurados " << blocks << " bloques de " << archives.size()
+                  << " respaldos en " << target_path << " (LSN " << chain_lsn << ")" << std::endl;
+        return true;
+    }
+
+    /**
+     * @brief Muestra el reparto de bloques entre niveles de almacenamiento
+     */
+    void displayTierStatistics() const {
+        size_t memory_blocks = 0;
+        for (const auto& table : relation_blocks) {
+            if (getTableTier(table.first) == StorageTier::MEMORY) {
+                memory_blocks += table.second.size();
+            }
+        }
+        
+        long long compressed_bytes = 0;
+        for (const auto& addr : cold_blocks) {
+            compressed_bytes += filesystem.getColdBlockSize(addr);
+        }
+        
+        std::cout << "\n=== NIVELES DE ALMACENAMIENTO ===" << std::endl;
+        std::cout << "Bloques en memoria: " << memory_blocks
+                  << " | Entradas del WAL: " << wal.getRecordCount()
+                  << " (LSN " << wal.getLastLSN() << ")" << std::endl;
+        std::cout << "Bloques fríos: " << cold_blocks.size() << " | Comprimidos: "
+                  << compressed_bytes << " bytes (capacidad sin comprimir: "
+                  << cold_blocks.size() * static_cast<size_t>(config.getBytesPerSector())
+                  << " bytes)" << std::endl;
+        std::cout << "Degradación automática: ";
+        if (demotion_period.count() > 0) {
+            std::cout << "tras " << demotion_period.count() << " ms sin acceso" << std::endl;
+        } else {
+            std::cout << "desactivada" << std::endl;
+        }
+    }
+
+    /**
+     * @brief Simula el recorrido completo de una tabla bajo ambos modelos de actuador
+     *
+     * Todas las lecturas llegan a la vez en orden lógico. Con un solo actuador
+     * se atienden en una única cola; con un actuador por superficie cada
+     * superficie atiende las suyas en paralelo y el makespan es el de la más lenta.
+     */
+    ScanTimingReport simulateTableScan(const std::string& table_name) const {
+        ScanTimingReport report;
+
+        auto it = relation_blocks.find(table_name);
+        if (it == relation_blocks.end()) {
+            return report;
+        }
+
+        DiskSimulationClock single_clock(config, false);
+        DiskSimulationClock surface_clock(config, true);
+        std::set<int> surfaces;
+
+        for (const auto& addr : it->second) {
+            single_clock.submit(IOType::READ, addr, 0.0);
+            surface_clock.submit(IOType::READ, addr, 0.0);
+            surfaces.insert(addr.getPlatter() * config.getSurfacesPerPlatter() + addr.getSurface());
+            report.blocks_per_zone[config.getZoneForTrack(addr.getTrack())]++;
+            report.blocks++;
+        }
+
+        single_clock.runUntilIdle();
+        surface_clock.runUntilIdle();
+
+        report.single_actuator_ms = single_clock.getStatistics().elapsed_ms;
+        report.per_surface_ms = surface_clock.getStatistics().elapsed_ms;
+        report.surfaces_used = static_cast<int>(surfaces.size());
+        return report;
+    }
+
+    /**
+     * @brief Muestra el makespan de un recorrido con uno o varios actuadores
+     */
+    void displayScanComparison(const std::string& table_name) const {
+        if (relation_blocks.find(table_name) == relation_blocks.end()) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return;
+        }
+
+        ScanTimingReport report = simulateTableScan(table_name);
+
+        std::cout << "\n=== RECORRIDO PARALELO: " << table_name << " ===" << std::endl;
+        std::cout << "Bloques: " << report.blocks << " en " << report.surfaces_used
+                  << " superficies" << std::endl;
+        std::cout << "Asignación: "
+                  << (config.hasIndependentActuators() ? "repartida entre superficies" : "secuencial")
+                  << std::endl;
+        if (config.hasZones()) {
+            std::cout << "Bloques por zona:";
+            for (const auto& zone : report.blocks_per_zone) {
+                std::cout << " Z" << zone.first << "=" << zone.second;
+            }
+            std::cout << std::endl;
+        }
+        std::cout << "Makespan con un actuador: " << report.single_actuator_ms << " ms" << std::endl;
+        std::cout << "Makespan con un actuador por superficie: " << report.per_surface_ms
+                  << " ms" << std::endl;
+        if (report.per_surface_ms > 0.0) {
+            std::cout << "Aceleración: " << (report.single_actuator_ms / report.per_surface_ms)
+                      << "x" << std::endl;
+        }
+    }
+
+    /**
+     * @brief Ejecuta la carga registrada sobre el disco magnético y sobre un SSD
+     *
+     * Se reutiliza la traza reciente del reloj de E/S (las últimas
+     * HISTORY_LIMIT peticiones, mismas direcciones y mismo orden) para comparar
+     * ambos dispositivos con la organización actual. El SSD se dimensiona a las
+     * páginas que toca la traza para que sus reescrituras pongan a trabajar la GC.
+     * @param queue_depth Peticiones en vuelo durante la reejecución
+     */
+    void compareDeviceModels(size_t queue_depth = 1) const {
+        std::set<long long> pages;
+        for (const auto& request : io_clock.getRequests()) {
+            pages.insert(config.addressToBlock(request.address));
+        }
+        compareDeviceModels(queue_depth, SSDConfig::sizedFor(static_cast<long long>(pages.size())));
+    }
+
+    /**
+     * @brief Igual que la anterior con un SSD de la configuración dada
+     */
+    void compareDeviceModels(size_t queue_depth, const SSDConfig& ssd_config) const {
+        const auto& trace = io_clock.getRequests();
+        if (trace.empty()) {
+            std::cout << "No hay carga registrada para comparar." << std::endl;
+            return;
+        }
+
+        DiskSimulationClock hdd_clock(io_clock.getDevice().clone());
+        DiskSimulationClock ssd_clock(std::make_unique<SSDModel>(ssd_config, config));
+        IOStatistics hdd = hdd_clock.replay(trace, queue_depth);
+        IOStatistics ssd = ssd_clock.replay(trace, queue_depth);
+
+        std::cout << "\n=== COMPARACIÓN DE DISPOSITIVOS ===" << std::endl;
+        std::cout << "Peticiones: " << trace.size() << " | Profundidad de cola: "
+                  << std::max<size_t>(1, queue_depth) << std::endl;
+
+        const std::pair<const char*, const IOStatistics*> rows[] = {{"HDD", &hdd}, {"SSD", &ssd}};
+        for (const auto& row : rows) {
+            std::cout << row.first << ": " << row.second->elapsed_ms << " ms"
+                      << " | " << row.second->throughput_iops << " IOPS"
+                      << " | respuesta media " << row.second->mean_response_ms << " ms"
+                      << " | p99 " << row.second->p99_response_ms << " ms" << std::endl;
+        }
+
+        hdd_clock.getDevice().displayModel();
+        ssd_clock.getDevice().displayModel();
+    }
+
+    /**
+     * @brief Muestra la estructura de directorios
+     */
+    void showDirectoryStructure() {
+        filesystem.displayDirectoryStructure();
+    }
+
+private:
+    /**
+     * @brief Asigna una nueva dirección de bloque
+     *
+     * Las tablas calientes se colocan en la zona más rápida con espacio y el
+     * resto empieza por las más lentas, reservando las exteriores. Dentro de
+     * cada zona el orden lo decide DiskConfig::zoneBlockToAddress: secuencial
+     * con un actuador, repartido entre superficies con actuadores independientes.
+     * Los huecos que dejaron reservas devueltas se reutilizan antes de
+     * avanzar el cursor de su zona.
+     * @return false si el disco está lleno (`addr` no se modifica)
+     */
+    bool allocateNewBlock(PhysicalAddress& addr, bool hot_table = false) {
+        if (zone_next_block.size() != static_cast<size_t>(config.getZoneCount())) {
+            zone_next_block.assign(config.getZoneCount(), 0);
+        }
+        if (zone_free_blocks.size() != static_cast<size_t>(config.getZoneCount())) {
+            zone_free_blocks.assign(config.getZoneCount(), {});
+        }
+
+        std::vector<int> order(config.getZoneCount());
+        for (int z = 0; z < config.getZoneCount(); ++z) order[z] = z;
+        std::stable_sort(order.begin(), order.end(), [this, hot_table](int a, int b) {
+            double ta = config.getZone(a).transfer_time_ms;
+            double tb = config.getZone(b).transfer_time_ms;
+            return hot_table ? ta < tb : ta > tb;
+        });
+
+        for (int z : order) {
+            auto& free_blocks = zone_free_blocks[z];
+            while (!free_blocks.empty()) {
+                PhysicalAddress candidate = free_blocks.back();
+                free_blocks.pop_back();
+                if (claimed_cylinders.count(candidate.getTrack()) == 0) {
+                    addr = candidate;
+                    return true;
+                }
+            }
+            while (zone_next_block[z] < config.getZoneCapacity(z)) {
+                PhysicalAddress candidate = config.zoneBlockToAddress(z, zone_next_block[z]++);
+                if (claimed_cylinders.count(candidate.getTrack()) == 0) {
+                    addr = candidate;  // Los cilindros de tablas agrupadas se saltan
+                    return true;
+                }
+            }
+        }
+
+        std::cerr << "Error: no quedan sectores libres en el disco." << std::endl;
+        return false;
+    }
+
+    /**
+     * @brief Encuentra un bloque con espacio suficiente y reserva el hueco en el mapa de espacio libre
+     * @param position Posición del bloque en la relación
+     */
+    std::shared_ptr<Block> findBlockWithSpace(const std::string& table_name, size_t record_size, size_t& position) {
+        if (relation_blocks.find(table_name) == relation_blocks.end()) {
+            return nullptr;
+        }
+        
+        FreeSpaceMap& map = freeSpaceMapFor(table_name);
+        uint32_t bytes = static_cast<uint32_t>(record_size + sizeof(size_t));
+        while ((position = map.reserve(bytes)) != FreeSpaceMap::NONE) {
+            auto block = getBlock(relation_blocks[table_name][position]);
+            if (block && block->getFreeSpace() >= bytes) {
+                return block;
+            }
+            // El mapa estaba desfasado: se corrige con el bloque real y se sigue buscando
+            map.setFree(position, block ? static_cast<uint32_t>(block->getFreeSpace()) : 0);
+        }
+        
+        return nullptr;
+    }
+
+    /**
+     * @brief Mapa de espacio libre de una tabla heap; se reconstruye si no cubre todos sus bloques
+     */
+    FreeSpaceMap& freeSpaceMapFor(const std::string& table_name) {
+        auto& map = free_space_maps[table_name];
+        const auto& addresses = relation_blocks[table_name];
+        if (!map || map->getBlockCount() != addresses.size()) {
+            map.reset(new FreeSpaceMap());
+            for (size_t position = 0; position < addresses.size(); ++position) {
+                auto block = getBlock(addresses[position]);
+                if (!map->publish(position, block ? static_cast<uint32_t>(block->getFreeSpace()) : 0)) {
+                    std::cerr << "Error: la tabla '" << table_name << "' tiene más bloques de los que admite "
+                              << "el mapa de espacio libre." << std::endl;
+                    break;
+                }
+            }
+        }
+        return *map;
+    }
+
+    void refreshFreeSpace(const std::string& table_name, size_t position, const Block& block) {
+        auto it = free_space_maps.find(table_name);
+        if (it != free_space_maps.end() && position < it->second->getBlockCount()) {
+            it->second->setFree(position, static_cast<uint32_t>(block.getFreeSpace()));
+        }
+    }
+
+    /**
+     * @brief Obtiene un bloque (desde cache o disco)
+     */
+    std::shared_ptr<Block> getBlock(const PhysicalAddress& addr) {
+        // Buscar en cache (los bloques del nivel en memoria siempre están aquí)
+        auto it = block_cache.find(addr);
+        if (it != block_cache.end()) {
+            last_access[addr] = SteadyClock::now();
+            return it->second;
+        }
+        
+        auto block = getCachedOrStoredBlock(addr);
+        if (!block) {
+            return nullptr;
+        }
+        
+        // Un bloque frío de una tabla en disco vuelve a su sector al usarse
+        if (cold_blocks.count(addr) > 0 && frozen_blocks.count(addr) == 0 &&
+            getTableTier(block->getRelationName()) == StorageTier::DISK &&
+            filesystem.writeBlock(addr, *block)) {
+            filesystem.deleteColdBlock(addr);
+            cold_blocks.erase(addr);
+        }
+        
+        block_cache[addr] = block;
+        last_access[addr] = SteadyClock::now();
+        return block;
+    }
+
+    /**
+     * @brief Lee un bloque de la caché, del nivel frío o de su sector sin cachearlo
+     */
+    std::shared_ptr<Block> getCachedOrStoredBlock(const PhysicalAddress& addr) {
+        auto it = block_cache.find(addr);
+        if (it != block_cache.end()) {
+            return it->second;
+        }
+        
+        auto block = std::make_shared<Block>(addr, config.getBytesPerSector());
+        bool loaded = cold_blocks.count(addr) > 0 ? filesystem.readColdBlock(addr, *block)
+                                                  : filesystem.readBlock(addr, *block);
+        return loaded ? block : nullptr;
+    }
+
+    /**
+     * @brief Persiste un bloque según el nivel de su relación
+     *
+     * Si el bloque pertenece a una instantánea en curso, su sector congelado no
+     * se toca: el bloque se reubica en una dirección nueva y se escribe allí.
+     * Si no queda espacio para reubicarlo, la escritura falla.
+     */
+    bool persistBlock(const std::shared_ptr<Block>& shared_block) {
+        if (frozen_blocks.count(shared_block->getAddress()) > 0 && !redirectFrozenBlock(shared_block)) {
+            std::cerr << "Error: no se pudo reubicar el bloque congelado " << shared_block->getAddress() << std::endl;
+            return false;
+        }
+        
+        shared_block->setPageLSN(++last_page_lsn);
+        block_lsns[shared_block->getAddress()] = last_page_lsn;
+        
+        bool ok = writeBlockToTier(*shared_block);
+        if (ok && ship_log.isOpen()) {
+            ship_log.append(WalRecord(last_page_lsn, shared_block->getRelationName(),
+                                      shared_block->getAddress(), shared_block->serialize()));
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Escribe un bloque en el nivel de su relación sin sellar su LSN
+     */
+    bool writeBlockToTier(const Block& block) {
+        const PhysicalAddress addr = block.getAddress();
+        const std::string& table_name = block.getRelationName();
+        bool ok = false;
+        
+        switch (getTableTier(table_name)) {
+            case StorageTier::MEMORY:
+                ok = wal.append(table_name, addr, block.serialize()) > 0;
+                if (ok && wal.getByteCount() > wal_checkpoint_bytes + WAL_CHECKPOINT_BYTES) {
+                    checkpointWal();
+                }
+                break;
+                
+            case StorageTier::COLD:
+                ok = filesystem.writeColdBlock(addr, block);
+                if (ok) cold_blocks.insert(addr);
+                break;
+                
+            case StorageTier::DISK:
+                ok = filesystem.writeBlock(addr, block);
+                if (ok && cold_blocks.erase(addr) > 0) {
+                    filesystem.deleteColdBlock(addr);
+                }
+                break;
+        }
+        
+        last_access[addr] = SteadyClock::now();
+        return ok;
+    }
+
+    /**
+     * @brief Registra el acceso en el reloj de E/S salvo para el nivel en memoria
+     * @return Tiempo de respuesta simulado (ms)
+     */
+    double chargeAccess(const std::string& table_name, IOType type, const PhysicalAddress& addr) {
+        if (getTableTier(table_name) == StorageTier::MEMORY) {
+            return 0.0;
+        }
+        return io_clock.serve(type, addr);
+    }
+
+    /**
+     * @brief Ejecuta la degradación automática si venció su periodo
+     */
+    void runDemotionSweep() {
+        // Instalar las compactaciones LSM terminadas antes de liberar la instantánea
+        pollLSMCompactions();
+        
+        // Liberar la instantánea en cuanto el volcado termine
+        if (snapshot_thread.joinable() && !snapshot_running) {
+            finishSnapshot();
+        }
+        
+        if (demotion_period.count() <= 0) return;
+        if (SteadyClock::now() - last_demotion_sweep >= demotion_period) {
+            demoteIdleBlocks(demotion_period);
+        }
+    }
+
+    std::string getWalPath() const {
+        return filesystem.getBasePath() + "/metadata/wal.log";
+    }
+
+    std::string getBackupHistoryPath() const {
+        return filesystem.getBasePath() + "/metadata/backup_history.txt";
+    }
+
+    std::string getShadowListPath() const {
+        return filesystem.getBasePath() + "/metadata/snapshot_shadowed.txt";
+    }
+
+    /**
+     * @brief Reubica un bloque congelado en una dirección nueva
+     *
+     * El par (antigua, nueva) se anota en disco: si el proceso cae antes de
+     * terminar la instantánea, loadBlockIndex descarta la versión congelada
+     * siempre que la nueva llegara a escribirse.
+     * @return false si no queda espacio (el bloque sigue en su sector congelado)
+     */
+    bool redirectFrozenBlock(const std::shared_ptr<Block>& block) {
+        PhysicalAddress old_addr = block->getAddress();
+        const std::string table_name = block->getRelationName();
+        PhysicalAddress new_addr;
+        if ((clustered_tables.count(table_name) == 0 ||
+             !allocateClusteredSlot(table_name, &old_addr, new_addr)) &&
+            !allocateNewBlock(new_addr, isTableHot(table_name))) {
+            return false;
+        }
+        
+        std::ofstream(getShadowListPath(), std::ios::app)
+            << old_addr.toString() << " " << new_addr.toString() << std::endl;
+        
+        block->relocate(new_addr);
+        block_cache.erase(old_addr);
+        block_cache[new_addr] = block;
+        last_access.erase(old_addr);
+        block_lsns.erase(old_addr);
+        
+        auto& addresses = relation_blocks[table_name];
+        std::replace(addresses.begin(), addresses.end(), old_addr, new_addr);
+        
+        frozen_blocks.erase(old_addr);
+        shadowed_blocks.push_back(old_addr);
+        
+        if (ship_log.isOpen()) {
+            ship_log.append(WalRecord(++last_page_lsn, ShippingLog::FREE_RELATION, old_addr, ""));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Retira un bloque de la relación y libera su sector
+     *
+     * Si una instantánea en curso todavía lo lee, el borrado se difiere hasta
+     * finishSnapshot y se anota en la lista de sombras por si el proceso cae.
+     */
+    void releaseBlock(const std::string& table_name, const PhysicalAddress& addr) {
+        auto& addresses = relation_blocks[table_name];
+        addresses.erase(std::remove(addresses.begin(), addresses.end(), addr), addresses.end());
+        block_cache.erase(addr);
+        last_access.erase(addr);
+        block_lsns.erase(addr);
+        
+        if (frozen_blocks.erase(addr) > 0) {
+            std::ofstream(getShadowListPath(), std::ios::app) << addr.toString() << std::endl;
+            shadowed_blocks.push_back(addr);
+        } else if (cold_blocks.erase(addr) > 0) {
+            filesystem.deleteColdBlock(addr);
+        } else {
+            filesystem.deleteBlock(addr);
+        }
+        
+        if (ship_log.isOpen()) {
+            ship_log.append(WalRecord(++last_page_lsn, ShippingLog::FREE_RELATION, addr, ""));
+        }
+    }
+
+    /**
+     * @brief Devuelve a su zona las direcciones reservadas que no se usaron
+     *
+     * Las que son las últimas asignadas de su zona retroceden el cursor; las
+     * demás pasan a la lista de huecos de la zona, de la que allocateNewBlock
+     * toma primero.
+     */
+    void releaseReservedAddresses(const std::vector<PhysicalAddress>& unused) {
+        if (zone_free_blocks.size() != static_cast<size_t>(config.getZoneCount())) {
+            zone_free_blocks.assign(config.getZoneCount(), {});
+        }
+        for (auto it = unused.rbegin(); it != unused.rend(); ++it) {
+            int zone = config.getZoneForTrack(it->getTrack());
+            long long zone_block = config.addressToZoneBlock(*it);
+            if (zone_next_block[zone] == zone_block + 1) {
+                zone_next_block[zone] = zone_block;
+            } else {
+                zone_free_blocks[zone].push_back(*it);
+            }
+        }
+    }
+
+    /**
+     * @brief Inserción en una tabla LSM: solo el log de la tabla y la memtable
+     */
+    bool insertLSMRecord(const std::string& table_name, const std::shared_ptr<Record>& record) {
+        LSMTree& tree = *lsm_trees.at(table_name);
+        // Un volcado pendiente (falló por falta de espacio) se reintenta antes de crecer más
+        if ((tree.needsFlush() && !flushMemtable(table_name)) || !tree.put(record)) {
+            std::cout << "Error: No se pudo insertar el registro." << std::endl;
+            return false;
+        }
+        
+        result_cache.invalidate(table_name);
+        
+        // El coste de E/S se paga al volcar, con escrituras secuenciales
+        double access_time = 0.0;
+        if (tree.needsFlush()) flushMemtable(table_name, &access_time);
+        
+        std::cout << "Registro insertado en tabla '" << table_name 
+                  << "' (ID: " << record->getId() << ", Tiempo: " 
+                  << access_time << " ms)" << std::endl;
+        runDemotionSweep();
+        return true;
+    }
+
+    /**
+     * @brief Vuelca la memtable como secuencia de nivel 0 en bloques consecutivos
+     * @param elapsed_ms Si se indica, recibe el tiempo de escritura simulado (ms)
+     * @return false si no hubo espacio: la memtable y su log quedan como estaban
+     */
+    bool flushMemtable(const std::string& table_name, double* elapsed_ms = nullptr) {
+        LSMTree& tree = *lsm_trees.at(table_name);
+        auto entries = tree.memtableEntries();
+        if (entries.empty()) {
+            return true;
+        }
+        
+        bool hot = isTableHot(table_name);
+        std::vector<std::shared_ptr<Block>> blocks;
+        if (!tree.packRecords(entries, [this, hot](PhysicalAddress& addr) {
+                return allocateNewBlock(addr, hot);
+            }, blocks)) {
+            // La memtable y su log siguen intactos: el volcado se reintenta más tarde
+            std::vector<PhysicalAddress> unused;
+            for (const auto& block : blocks) unused.push_back(block->getAddress());
+            releaseReservedAddresses(unused);
+            std::cerr << "Error: no hay espacio para volcar la memtable de " << table_name << std::endl;
+            return false;
+        }
+        
+        double elapsed = 0.0;
+        for (const auto& block : blocks) {
+            const PhysicalAddress& addr = block->getAddress();
+            block_cache[addr] = block;
+            relation_blocks[table_name].push_back(addr);
+            elapsed += chargeAccess(table_name, IOType::WRITE, addr);
+            persistBlock(block);
+        }
+        
+        if (elapsed_ms) *elapsed_ms = elapsed;
+        if (!tree.installFlush(blocks)) {
+            // Fuera del manifiesto los bloques no son de nadie; la memtable conserva las entradas
+            std::vector<PhysicalAddress> unused;
+            for (const auto& block : blocks) {
+                releaseBlock(table_name, block->getAddress());
+                unused.push_back(block->getAddress());
+            }
+            releaseReservedAddresses(unused);
+            std::cerr << "Error: no se pudo publicar el volcado LSM de " << table_name << std::endl;
+            return false;
+        }
+        startLSMCompaction(table_name, false);
+        return true;
+    }
+
+    /**
+     * @brief Búsqueda puntual: memtable y, después, una secuencia tras otra
+     */
+    std::shared_ptr<Record> findLSMRecord(const std::string& table_name, int record_id) {
+        LSMTree& tree = *lsm_trees.at(table_name);
+        std::shared_ptr<Record> record;
+        
+        if (!tree.lookupMemtable(record_id, record)) {
+            for (const auto& addr : tree.candidateBlocks(record_id)) {
+                auto block = getBlock(addr);
+                if (!block) continue;
+                chargeAccess(table_name, IOType::READ, addr);
+                
+                for (const auto& candidate : block->getAllRecords()) {
+                    if (candidate->getId() == record_id) {
+                        record = candidate;
+                        break;
+                    }
+                }
+                if (record) break;
+                tree.noteFalsePositive();
+            }
+        }
+        
+        runDemotionSweep();
+        if (!record || record->isDeleted()) {
+            return nullptr;
+        }
+        tree.prepareRecord(record);
+        return record;
+    }
+
+    /**
+     * @brief Borrado ciego: añade un tombstone sin leer ningún bloque
+     */
+    bool deleteLSMRecord(const std::string& table_name, int record_id) {
+        auto tombstone = std::make_shared<VariableRecord>(record_id);
+        tombstone->markAsDeleted();
+        tombstone->calculateOffsets();
+        
+        LSMTree& tree = *lsm_trees.at(table_name);
+        if ((tree.needsFlush() && !flushMemtable(table_name)) || !tree.put(tombstone)) {
+            return false;
+        }
+        result_cache.invalidate(table_name);
+        if (tree.needsFlush()) {
+            flushMemtable(table_name);
+        }
+        
+        std::cout << "Registro " << record_id << " eliminado (tombstone LSM)." << std::endl;
+        runDemotionSweep();
+        return true;
+    }
+
+    /**
+     * @brief Compactación completa: vuelca la memtable y fusiona todo en una secuencia
+     */
+    void compactLSMTable(const std::string& table_name) {
+        LSMTree& tree = *lsm_trees.at(table_name);
+        if (!flushMemtable(table_name)) {
+            std::cout << "Error: no se pudo volcar la memtable de " << table_name << "." << std::endl;
+            return;
+        }
+        pollLSMCompactions(true);
+        
+        if (startLSMCompaction(table_name, true)) {
+            pollLSMCompactions(true);
+        }
+        
+        std::cout << "Compactación LSM completada. " << tree.getRuns().size()
+                  << " secuencias." << std::endl;
+    }
+
+    /**
+     * @brief Recorrido completo: de la secuencia más antigua a la memtable
+     */
+    void displayLSMTable(const std::string& table_name) {
+        LSMTree& tree = *lsm_trees.at(table_name);
+        const auto& runs = tree.getRuns();
+        size_t versions = 0;
+        auto rows = collectLSMRows(table_name, versions);
+        
+        std::cout << "\n=== TABLA LSM: " << table_name << " ===" << std::endl;
+        int active_records = 0;
+        for (const auto& row : rows) {
+            if (row.second->isDeleted()) continue;
+            tree.prepareRecord(row.second);
+            row.second->display();
+            std::cout << "---" << std::endl;
+            active_records++;
+        }
+        
+        std::cout << "\nResumen: " << active_records << " registros activos de " 
+                  << versions << " versiones en " << runs.size() << " secuencias y la memtable."
+                  << std::endl;
+        runDemotionSweep();
+    }
+
+    /**
+     * @brief Última versión de cada clave (tombstones incluidos)
+     *
+     * Aplica las secuencias de la más antigua a la más reciente y la memtable
+     * al final, así que cada clave queda con su versión vigente.
+     */
+    std::map<int, std::shared_ptr<Record>> collectLSMRows(const std::string& table_name, size_t& versions) {
+        LSMTree& tree = *lsm_trees.at(table_name);
+        std::map<int, std::shared_ptr<Record>> rows;
+        
+        const auto& runs = tree.getRuns();
+        for (auto run = runs.rbegin(); run != runs.rend(); ++run) {
+            for (const auto& addr : run->blocks) {
+                auto block = getBlock(addr);
+                if (!block) continue;
+                chargeAccess(table_name, IOType::READ, addr);
+                for (const auto& record : block->getAllRecords()) {
+                    tree.prepareRecord(record);
+                    rows[record->getId()] = record;
+                    versions++;
+                }
+            }
+        }
+        for (const auto& record : tree.memtableEntries()) {
+            rows[record->getId()] = record;
+            versions++;
+        }
+        return rows;
+    }
+
+    /**
+     * @brief Planifica una compactación y la lanza en segundo plano
+     *
+     * Reserva direcciones consecutivas para la salida (cota: bloques de
+     * entrada más uno por secuencia) y un LSN por dirección.
+     */
+    bool startLSMCompaction(const std::string& table_name, bool full) {
+        LSMTree& tree = *lsm_trees.at(table_name);
+        CompactionJob job;
+        if (tree.isCompacting() || !tree.planCompaction(job, full)) {
+            return false;
+        }
+        
+        size_t bound = job.inputBlockCount() + job.inputs.size();
+        bool hot = isTableHot(table_name);
+        for (size_t i = 0; i < bound; ++i) {
+            PhysicalAddress addr;
+            if (!allocateNewBlock(addr, hot)) {
+                releaseReservedAddresses(job.reserved);
+                std::cerr << "Error: no hay espacio para compactar " << table_name << std::endl;
+                return false;
+            }
+            job.reserved.push_back(addr);
+        }
+        job.first_lsn = last_page_lsn + 1;
+        last_page_lsn += static_cast<long long>(bound);
+        
+        tree.startCompaction(std::move(job));
+        return true;
+    }
+
+    /**
+     * @brief Instala las compactaciones terminadas y encadena la siguiente
+     * @param wait Esperar a las que siguen en curso (sin lanzar otras)
+     */
+    void pollLSMCompactions(bool wait = false) {
+        for (auto& entry : lsm_trees) {
+            LSMTree& tree = *entry.second;
+            if (!tree.isCompacting() || (!wait && !tree.compactionFinished())) continue;
+            
+            auto job = tree.takeCompaction();
+            installLSMCompaction(entry.first, *job);
+            if (!wait) {
+                startLSMCompaction(entry.first, false);
+            }
+        }
+    }
+
+    /**
+     * @brief Publica la secuencia fusionada y libera las de entrada
+     *
+     * El manifiesto nuevo se escribe antes de borrar nada: tras una caída,
+     * loadLSMTrees elimina lo que no figure en él.
+     */
+    void installLSMCompaction(const std::string& table_name, const CompactionJob& job) {
+        LSMTree& tree = *lsm_trees.at(table_name);
+        size_t used = 0;
+        
+        if (!job.ok || !tree.installCompaction(job)) {
+            // El manifiesto sigue con las entradas; las salidas escritas se borran si nadie las usa
+            std::cerr << "Error: compactación LSM fallida en " << table_name << std::endl;
+            std::set<PhysicalAddress> live = tree.getLiveBlocks();
+            const auto& addresses = relation_blocks[table_name];
+            for (const auto& addr : job.reserved) {
+                if (live.count(addr) == 0 && std::find(addresses.begin(), addresses.end(), addr) == addresses.end()) {
+                    filesystem.deleteBlock(addr);
+                }
+            }
+        } else {
+            used = job.output.blocks.size();
+            double io_ms = 0.0;
+            for (const auto& run : job.inputs) {
+                for (const auto& addr : run.blocks) {
+                    io_ms += chargeAccess(table_name, IOType::READ, addr);
+                    releaseBlock(table_name, addr);
+                }
+            }
+            
+            auto& addresses = relation_blocks[table_name];
+            for (size_t i = 0; i < used; ++i) {
+                const PhysicalAddress& addr = job.output.blocks[i];
+                addresses.push_back(addr);
+                block_lsns[addr] = job.first_lsn + static_cast<long long>(i);
+                io_ms += chargeAccess(table_name, IOType::WRITE, addr);
+                
+                Block image(addr, config.getBytesPerSector());
+                if (ship_log.isOpen() && filesystem.readBlock(addr, image)) {
+                    ship_log.append(WalRecord(++last_page_lsn, table_name, addr, image.serialize()));
+                }
+            }
+            tree.addCompactionIO(io_ms);
+        }
+        
+        releaseReservedAddresses(std::vector<PhysicalAddress>(job.reserved.begin() + used,
+                                                              job.reserved.end()));
+    }
+
+    /**
+     * @brief Abre los árboles LSM y descarta los bloques que no estén en su manifiesto
+     */
+    void loadLSMTrees() {
+        std::string metadata_path = filesystem.getBasePath() + "/metadata";
+        if (!fs::exists(metadata_path)) return;
+        
+        // Se recorren los esquemas: una tabla LSM sin volcados no tiene bloques
+        const std::string prefix = "schema_";
+        for (const auto& entry : fs::directory_iterator(metadata_path)) {
+            std::string name = entry.path().stem().string();
+            if (name.find(prefix) != 0 || entry.path().extension() != ".txt") continue;
+            
+            std::string table_name = name.substr(prefix.size());
+            if (getTableOrganizationFromSchema(table_name) == TableOrganization::LSM) {
+                openLSMTree(table_name);
+            }
+        }
+    }
+
+    void openLSMTree(const std::string& table_name) {
+        auto tree = std::make_unique<LSMTree>(table_name, filesystem.getBasePath() + "/metadata",
+                                              filesystem, config.getBytesPerSector(),
+                                              loadTableSchema(table_name), isTableFixedRecord(table_name));
+        if (!tree->open()) {
+            std::cerr << "Error: no se pudo abrir el árbol LSM de " << table_name << std::endl;
+            return;
+        }
+        
+        // Restos de volcados o compactaciones interrumpidos
+        std::set<PhysicalAddress> live = tree->getLiveBlocks();
+        auto& addresses = relation_blocks[table_name];
+        for (const auto& addr : std::vector<PhysicalAddress>(addresses)) {
+            if (live.count(addr) == 0) {
+                addresses.erase(std::remove(addresses.begin(), addresses.end(), addr), addresses.end());
+                block_cache.erase(addr);
+                block_lsns.erase(addr);
+                filesystem.deleteBlock(addr);
+            }
+        }
+        
+        for (const auto& record : tree->memtableEntries()) {
+            next_record_id = std::max(next_record_id, record->getId() + 1);
+        }
+        lsm_trees[table_name] = std::move(tree);
+    }
+
+    /**
+     * @brief Comprueba que el nombre de una tabla nueva esté libre y no sea de una relación interna
+     */
+    bool checkNewTableName(const std::string& table_name) const {
+        if (relation_blocks.find(table_name) != relation_blocks.end()) {
+            std::cout << "La tabla '" << table_name << "' ya existe." << std::endl;
+            return false;
+        }
+        if (isInternalRelation(table_name)) {
+            std::cout << "Error: el nombre '" << table_name << "' está reservado para relaciones internas." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    TableOrganization getTableOrganizationFromSchema(const std::string& table_name) {
+        const CachedSchema* schema = cachedSchema(table_name);
+        return schema ? schema->organization : TableOrganization::HEAP;
+    }
+
+    std::string getClusteredPath(const std::string& table_name) const {
+        return filesystem.getBasePath() + "/metadata/clustered_" + table_name + ".txt";
+    }
+
+    /**
+     * @brief Inserción ordenada en la hoja que cubre la clave
+     */
+    bool insertClusteredRecord(const std::string& table_name, const std::shared_ptr<Record>& record) {
+        ClusteredIndex& index = clustered_tables.at(table_name);
+        std::string key = index.keyOf(*record);
+        
+        size_t leaf_position = index.findLeaf(key);
+        auto leaf = getBlock(index.getLeaves()[leaf_position].address);
+        if (!leaf) {
+            std::cout << "Error: No se pudo leer la hoja de la clave " << key << std::endl;
+            return false;
+        }
+        
+        const auto& records = leaf->getAllRecords();
+        for (size_t i = index.positionInLeaf(records, key);
+             i < records.size() && index.compare(index.keyOf(*records[i]), key) == 0; ++i) {
+            if (!records[i]->isDeleted()) {
+                std::cout << "Error: clave duplicada " << key << " en '" << table_name << "'." << std::endl;
+                return false;
+            }
+        }
+        
+        double access_time = 0.0;
+        if (!leaf->canFit(record)) {
+            access_time += splitLeaf(table_name, leaf_position);
+            leaf_position = index.findLeaf(key);
+            leaf = getBlock(index.getLeaves()[leaf_position].address);
+        }
+        
+        if (!leaf || !leaf->insertRecordAt(index.positionInLeaf(leaf->getAllRecords(), key), record)) {
+            std::cout << "Error: No se pudo insertar el registro." << std::endl;
+            return false;
+        }
+        
+        access_time += chargeAccess(table_name, IOType::WRITE, leaf->getAddress());
+        persistLeaf(table_name, leaf);
+        result_cache.invalidate(table_name);
+        
+        std::cout << "Registro insertado en tabla '" << table_name 
+                  << "' (ID: " << record->getId() << ", Tiempo: " 
+                  << access_time << " ms)" << std::endl;
+        runDemotionSweep();
+        return true;
+    }
+
+    /**
+     * @brief Divide una hoja llena: la mitad superior pasa a una hoja nueva
+     *
+     * La hoja nueva se coloca en el cilindro de la original si queda sitio,
+     * así que recorrer ambas en orden de clave no mueve el brazo.
+     * @return Tiempo de escritura simulado (ms)
+     */
+    double splitLeaf(const std::string& table_name, size_t leaf_position) {
+        ClusteredIndex& index = clustered_tables.at(table_name);
+        auto leaf = getBlock(index.getLeaves()[leaf_position].address);
+        if (!leaf || leaf->getRecordCount() < 2) {
+            return 0.0;
+        }
+        
+        PhysicalAddress near = leaf->getAddress();
+        PhysicalAddress sibling_addr;
+        if (!allocateClusteredSlot(table_name, &near, sibling_addr)) {
+            std::cerr << "Error: no hay espacio para dividir la hoja " << near << std::endl;
+            return 0.0;
+        }
+        
+        auto sibling = std::make_shared<Block>(sibling_addr, config.getBytesPerSector());
+        sibling->setRelationName(table_name);
+        for (const auto& moved : leaf->splitOff(leaf->getRecordCount() / 2)) {
+            sibling->addRecord(moved);
+        }
+        
+        block_cache[sibling_addr] = sibling;
+        auto& addresses = relation_blocks[table_name];
+        auto after = std::find(addresses.begin(), addresses.end(), leaf->getAddress());
+        addresses.insert(after == addresses.end() ? after : after + 1, sibling_addr);
+        index.insertLeafAfter(leaf_position, index.keyOf(*sibling->getAllRecords().front()), sibling_addr);
+        
+        double elapsed = chargeAccess(table_name, IOType::WRITE, leaf->getAddress()) +
+                         chargeAccess(table_name, IOType::WRITE, sibling_addr);
+        persistLeaf(table_name, leaf);
+        persistLeaf(table_name, sibling);
+        return elapsed;
+    }
+
+    /**
+     * @brief Persiste una hoja y sigue su dirección si una instantánea la reubicó
+     */
+    bool persistLeaf(const std::string& table_name, const std::shared_ptr<Block>& leaf) {
+        PhysicalAddress before = leaf->getAddress();
+        bool ok = persistBlock(leaf);
+        if (!(leaf->getAddress() == before)) {
+            clustered_tables.at(table_name).relocateLeaf(before, leaf->getAddress());
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Elige un sector libre en los cilindros de una tabla agrupada
+     *
+     * Con `near`, prueba primero su cilindro (empezando por el sector que le
+     * sigue) y después los más cercanos; si todos están llenos reserva el
+     * cilindro libre más próximo.
+     */
+    bool allocateClusteredSlot(const std::string& table_name, const PhysicalAddress* near,
+                               PhysicalAddress& slot) {
+        ClusteredIndex& index = clustered_tables.at(table_name);
+        std::set<PhysicalAddress> used(relation_blocks[table_name].begin(), relation_blocks[table_name].end());
+        used.insert(shadowed_blocks.begin(), shadowed_blocks.end());
+        
+        std::vector<int> tracks = index.getCylinders();
+        if (near) {
+            int origin = near->getTrack();
+            std::stable_sort(tracks.begin(), tracks.end(), [origin](int a, int b) {
+                return std::abs(a - origin) < std::abs(b - origin);
+            });
+        }
+        
+        for (int track : tracks) {
+            const PhysicalAddress* start = (near && near->getTrack() == track) ? near : nullptr;
+            if (findFreeSlotInCylinder(track, start, used, slot)) {
+                return true;
+            }
+        }
+        
+        int origin = near ? near->getTrack() : (tracks.empty() ? -1 : index.getCylinders().back());
+        int track = claimCylinder(table_name, origin);
+        return track >= 0 && findFreeSlotInCylinder(track, nullptr, used, slot);
+    }
+
+    /**
+     * @brief Primer sector libre de un cilindro, superficie a superficie
+     */
+    bool findFreeSlotInCylinder(int track, const PhysicalAddress* start,
+                                const std::set<PhysicalAddress>& used, PhysicalAddress& slot) const {
+        int sectors = config.getSectorsPerTrack(track);
+        int surfaces = config.getTotalSurfaces();
+        int per_platter = config.getSurfacesPerPlatter();
+        long long total = static_cast<long long>(sectors) * surfaces;
+        long long first = 0;
+        if (start) {
+            long long surface_index = static_cast<long long>(start->getPlatter()) * per_platter + start->getSurface();
+            first = surface_index * sectors + start->getSector() + 1;
+        }
+        
+        for (long long k = 0; k < total; ++k) {
+            long long linear = (first + k) % total;
+            int surface_index = static_cast<int>(linear / sectors);
+            PhysicalAddress candidate(surface_index / per_platter, surface_index % per_platter,
+                                      track, static_cast<int>(linear % sectors));
+            if (used.count(candidate) == 0) {
+                slot = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Reserva para la tabla el cilindro libre más cercano a `origin`
+     *
+     * Un cilindro está libre si ninguna tabla lo reservó y el asignador
+     * secuencial aún no entregó ningún sector suyo en ninguna superficie. El
+     * primero de cada tabla sale de la zona que le tocaría con
+     * allocateNewBlock, empezando por su pista más interior.
+     * @return Pista reservada o -1 si no queda ninguna
+     */
+    int claimCylinder(const std::string& table_name, int origin) {
+        int per_platter = config.getSurfacesPerPlatter();
+        auto isFree = [this, per_platter](int track) {
+            if (claimed_cylinders.count(track) > 0) return false;
+            int zone = config.getZoneForTrack(track);
+            for (int s = 0; s < config.getTotalSurfaces(); ++s) {
+                PhysicalAddress first_sector(s / per_platter, s % per_platter, track, 0);
+                if (config.addressToZoneBlock(first_sector) < zone_next_block[zone]) return false;
+            }
+            return true;
+        };
+        
+        int chosen = -1;
+        if (origin >= 0) {
+            for (int distance = 1; distance < config.getTracksPerSurface() && chosen < 0; ++distance) {
+                if (origin + distance < config.getTracksPerSurface() && isFree(origin + distance)) {
+                    chosen = origin + distance;
+                } else if (origin - distance >= 0 && isFree(origin - distance)) {
+                    chosen = origin - distance;
+                }
+            }
+        } else {
+            bool hot = isTableHot(table_name);
+            std::vector<int> order(config.getZoneCount());
+            for (int z = 0; z < config.getZoneCount(); ++z) order[z] = z;
+            std::stable_sort(order.begin(), order.end(), [this, hot](int a, int b) {
+                double ta = config.getZone(a).transfer_time_ms;
+                double tb = config.getZone(b).transfer_time_ms;
+                return hot ? ta < tb : ta > tb;
+            });
+            for (int z : order) {
+                DiskZone zone = config.getZone(z);
+                for (int track = zone.last_track; track >= zone.first_track && chosen < 0; --track) {
+                    if (isFree(track)) chosen = track;
+                }
+                if (chosen >= 0) break;
+            }
+        }
+        
+        if (chosen < 0) {
+            return -1;
+        }
+        claimed_cylinders[chosen] = table_name;
+        ClusteredIndex& index = clustered_tables.at(table_name);
+        index.addCylinder(chosen);
+        index.save(getClusteredPath(table_name));
+        return chosen;
+    }
+
+    /**
+     * @brief Reescribe las hojas en orden de clave sobre sectores consecutivos
+     *
+     * Elimina los registros borrados, deja cada hoja al CLUSTERED_FILL_FACTOR
+     * para absorber inserciones y coloca las hojas cilindro a cilindro, de
+     * modo que el orden físico vuelve a coincidir con el de la clave.
+     *
+     * Las hojas nuevas van a sectores libres de los cilindros (nunca encima de
+     * las antiguas) y el cambio lo registra un diario: PENDING antes de
+     * escribirlas, COMMITTED cuando ya están todas en disco. Solo entonces se
+     * liberan las antiguas. Al cargar, recoverClusteredReorganization deshace
+     * un diario PENDING o completa uno COMMITTED.
+     */
+    void reorganizeClusteredTable(const std::string& table_name) {
+        if (isSnapshotActive()) {
+            std::cout << "Error: hay una instantánea en curso; reintente al terminar." << std::endl;
+            return;
+        }
+        ClusteredIndex& index = clustered_tables.at(table_name);
+        
+        std::vector<std::shared_ptr<Record>> live;
+        for (const auto& leaf : index.getLeaves()) {
+            auto block = getBlock(leaf.address);
+            if (!block) continue;
+            chargeAccess(table_name, IOType::READ, leaf.address);
+            for (const auto& record : block->getAllRecords()) {
+                if (!record->isDeleted()) live.push_back(record);
+            }
+        }
+        
+        std::vector<PhysicalAddress> old_addresses = relation_blocks[table_name];
+        std::set<PhysicalAddress> used(old_addresses.begin(), old_addresses.end());
+        used.insert(shadowed_blocks.begin(), shadowed_blocks.end());
+        
+        std::vector<int> tracks = index.getCylinders();
+        std::sort(tracks.begin(), tracks.end());
+        std::vector<PhysicalAddress> slots;
+        auto addCylinderSlots = [this, &slots, &used](int track) {
+            int per_platter = config.getSurfacesPerPlatter();
+            for (int s = 0; s < config.getTotalSurfaces(); ++s) {
+                for (int sector = 0; sector < config.getSectorsPerTrack(track); ++sector) {
+                    PhysicalAddress slot(s / per_platter, s % per_platter, track, sector);
+                    if (used.count(slot) == 0) slots.push_back(slot);
+                }
+            }
+        };
+        for (int track : tracks) addCylinderSlots(track);
+        
+        const size_t fill_limit = static_cast<size_t>(config.getBytesPerSector() * CLUSTERED_FILL_FACTOR);
+        std::vector<std::shared_ptr<Block>> leaves;
+        for (const auto& record : live) {
+            bool full = !leaves.empty() &&
+                        (leaves.back()->getUsedSpace() + record->getSize() + sizeof(size_t) > fill_limit ||
+                         !leaves.back()->canFit(record));
+            if (leaves.empty() || full) {
+                if (leaves.size() == slots.size()) {
+                    int track = claimCylinder(table_name, slots.empty() ? -1 : slots.back().getTrack());
+                    if (track < 0) {
+                        std::cout << "Error: no quedan cilindros libres para reorganizar." << std::endl;
+                        return;
+                    }
+                    addCylinderSlots(track);
+                }
+                leaves.push_back(std::make_shared<Block>(slots[leaves.size()], config.getBytesPerSector()));
+                leaves.back()->setRelationName(table_name);
+            }
+            leaves.back()->addRecord(record);
+        }
+        if (leaves.empty()) {
+            if (slots.empty()) {
+                int track = claimCylinder(table_name, tracks.empty() ? -1 : tracks.back());
+                if (track < 0) {
+                    std::cout << "Error: no quedan cilindros libres para reorganizar." << std::endl;
+                    return;
+                }
+                addCylinderSlots(track);
+            }
+            leaves.push_back(std::make_shared<Block>(slots.front(), config.getBytesPerSector()));
+            leaves.back()->setRelationName(table_name);
+        }
+        
+        // 1. Hojas nuevas en sectores libres; las antiguas siguen siendo las vigentes
+        std::vector<PhysicalAddress> new_addresses;
+        for (const auto& leaf : leaves) new_addresses.push_back(leaf->getAddress());
+        if (!saveReorganizationJournal(table_name, "PENDING", new_addresses, old_addresses)) {
+            std::cout << "Error: no se pudo escribir el diario de la reorganización." << std::endl;
+            return;
+        }
+        bool written = true;
+        for (const auto& leaf : leaves) {
+            chargeAccess(table_name, IOType::WRITE, leaf->getAddress());
+            written = written && persistBlock(leaf);
+        }
+        
+        // 2. Punto de confirmación: el diario pasa a COMMITTED
+        if (!written || !saveReorganizationJournal(table_name, "COMMITTED", new_addresses, old_addresses)) {
+            for (const auto& addr : new_addresses) {
+                filesystem.deleteBlock(addr);
+                block_lsns.erase(addr);
+            }
+            // addRecord reapuntó los registros compartidos: las hojas antiguas se releen del disco
+            for (const auto& addr : old_addresses) block_cache.erase(addr);
+            std::error_code ec;
+            fs::remove(getReorganizationJournalPath(table_name), ec);
+            std::cout << "Error: no se pudieron escribir las hojas reorganizadas." << std::endl;
+            return;
+        }
+        
+        // 3. Cambio del directorio en memoria y liberación de las hojas antiguas
+        std::vector<ClusteredIndex::Leaf> entries;
+        relation_blocks[table_name].clear();
+        for (const auto& leaf : leaves) {
+            const PhysicalAddress& addr = leaf->getAddress();
+            const auto& records = leaf->getAllRecords();
+            entries.push_back({records.empty() ? "" : index.keyOf(*records.front()), addr});
+            relation_blocks[table_name].push_back(addr);
+            block_cache[addr] = leaf;
+        }
+        index.setLeaves(entries);
+        for (const auto& addr : old_addresses) {
+            releaseBlock(table_name, addr);
+        }
+        std::error_code ec;
+        fs::remove(getReorganizationJournalPath(table_name), ec);
+        
+        std::cout << "Reorganización completada: " << live.size() << " registros en "
+                  << leaves.size() << " hojas consecutivas." << std::endl;
+    }
+
+    std::string getReorganizationJournalPath(const std::string& table_name) const {
+        return filesystem.getBasePath() + "/metadata/reorg_" + table_name + ".txt";
+    }
+
+    /**
+     * @brief Escribe el diario de una reorganización (estado y direcciones nuevas y antiguas)
+     *
+     * Se escribe en un temporal y se renombra, así que el diario en disco es
+     * siempre el anterior o el nuevo, nunca uno a medias.
+     */
+    bool saveReorganizationJournal(const std::string& table_name, const std::string& state,
+                                   const std::vector<PhysicalAddress>& new_addresses,
+                                   const std::vector<PhysicalAddress>& old_addresses) {
+        std::string path = getReorganizationJournalPath(table_name);
+        std::string tmp_path = path + ".tmp";
+        {
+            std::ofstream file(tmp_path, std::ios::trunc);
+            if (!file.is_open()) return false;
+            file << "state=" << state << std::endl;
+            for (const auto& addr : new_addresses) file << "new=" << addr.toString() << std::endl;
+            for (const auto& addr : old_addresses) file << "old=" << addr.toString() << std::endl;
+            if (!file) return false;
+        }
+        std::error_code ec;
+        fs::rename(tmp_path, path, ec);
+        return !ec;
+    }
+
+    /**
+     * @brief Termina una reorganización interrumpida según su diario
+     *
+     * PENDING: las hojas nuevas pueden estar a medias, se borran y siguen
+     * valiendo las antiguas. COMMITTED: las nuevas están completas y se
+     * borran las antiguas que aún queden.
+     */
+    void recoverClusteredReorganization(const std::string& table_name) {
+        std::string path = getReorganizationJournalPath(table_name);
+        std::ifstream file(path);
+        if (!file.is_open()) return;
+        
+        std::string line, state;
+        std::vector<PhysicalAddress> new_addresses, old_addresses;
+        while (std::getline(file, line)) {
+            PhysicalAddress addr;
+            if (line.rfind("state=", 0) == 0) {
+                state = line.substr(6);
+            } else if (line.rfind("new=", 0) == 0 && PhysicalAddress::fromString(line.substr(4), addr)) {
+                new_addresses.push_back(addr);
+            } else if (line.rfind("old=", 0) == 0 && PhysicalAddress::fromString(line.substr(4), addr)) {
+                old_addresses.push_back(addr);
+            }
+        }
+        file.close();
+        
+        const auto& discard = state == "COMMITTED" ? old_addresses : new_addresses;
+        std::set<PhysicalAddress> keep;
+        if (state == "COMMITTED") keep.insert(new_addresses.begin(), new_addresses.end());
+        auto& addresses = relation_blocks[table_name];
+        for (const auto& addr : discard) {
+            if (keep.count(addr) > 0) continue;
+            addresses.erase(std::remove(addresses.begin(), addresses.end(), addr), addresses.end());
+            block_cache.erase(addr);
+            block_lsns.erase(addr);
+            filesystem.deleteBlock(addr);
+        }
+        std::cout << "Reorganización de " << table_name << " "
+                  << (state == "COMMITTED" ? "completada" : "deshecha") << " al recuperar." << std::endl;
+        std::error_code ec;
+        fs::remove(path, ec);
+    }
+
+    /**
+     * @brief Reconstruye el índice de cada tabla agrupada a partir de sus hojas
+     */
+    void loadClusteredTables() {
+        std::string metadata_path = filesystem.getBasePath() + "/metadata";
+        if (!fs::exists(metadata_path)) return;
+        
+        const std::string prefix = "schema_";
+        for (const auto& entry : fs::directory_iterator(metadata_path)) {
+            std::string name = entry.path().stem().string();
+            if (name.find(prefix) != 0 || entry.path().extension() != ".txt") continue;
+            
+            std::string table_name = name.substr(prefix.size());
+            if (getTableOrganizationFromSchema(table_name) != TableOrganization::CLUSTERED) continue;
+            
+            ClusteredIndex index;
+            if (!index.load(getClusteredPath(table_name), loadTableSchema(table_name))) {
+                std::cerr << "Error: no se pudo cargar el índice agrupado de " << table_name << std::endl;
+                continue;
+            }
+            for (int track : index.getCylinders()) {
+                claimed_cylinders[track] = table_name;
+            }
+            recoverClusteredReorganization(table_name);
+            
+            // Las hojas tienen rangos disjuntos: ordenarlas por su primera clave
+            std::vector<ClusteredIndex::Leaf> leaves;
+            for (const auto& addr : relation_blocks[table_name]) {
+                auto block = getCachedOrStoredBlock(addr);
+                if (!block) continue;
+                const auto& records = block->getAllRecords();
+                leaves.push_back({records.empty() ? "" : index.keyOf(*records.front()), addr});
+            }
+            std::stable_sort(leaves.begin(), leaves.end(),
+                             [&index](const ClusteredIndex::Leaf& a, const ClusteredIndex::Leaf& b) {
+                                 if (a.low_key.empty() || b.low_key.empty()) return a.low_key.empty() && !b.low_key.empty();
+                                 return index.compare(a.low_key, b.low_key) < 0;
+                             });
+            
+            relation_blocks[table_name].clear();
+            for (const auto& leaf : leaves) {
+                relation_blocks[table_name].push_back(leaf.address);
+            }
+            index.setLeaves(leaves);
+            clustered_tables[table_name] = index;
+        }
+    }
+
+    std::string getBitmapIndexPath(const std::string& table_name) const {
+        return filesystem.getBasePath() + "/metadata/bitmap_" + table_name + ".txt";
+    }
+
+    std::string getRadixIndexPath(const std::string& table_name) const {
+        return filesystem.getBasePath() + "/metadata/art_" + table_name + ".txt";
+    }
+
+    std::string getBTreeIndexPath(const std::string& table_name) const {
+        return filesystem.getBasePath() + "/metadata/btree_" + table_name + ".txt";
+    }
+
+    bool hasRowIndexes(const std::string& table_name) const {
+        return bitmap_indexes.count(table_name) > 0 || radix_indexes.count(table_name) > 0 ||
+               trigram_indexes.count(table_name) > 0 || btree_indexes.count(table_name) > 0;
+    }
+
+    /**
+     * @brief Añade a los índices de la tabla (mapas de bits y ART) la fila de una ranura
+     */
+    void indexRow(const std::string& table_name, const std::shared_ptr<Block>& block, size_t slot) {
+        if (!hasRowIndexes(table_name)) return;
+        
+        const auto& addresses = relation_blocks[table_name];
+        size_t position = static_cast<size_t>(
+            std::find(addresses.begin(), addresses.end(), block->getAddress()) - addresses.begin());
+        indexRowAt(table_name, position, block, slot);
+    }
+
+    /**
+     * @brief Como indexRow, cuando ya se conoce la posición del bloque en la relación
+     */
+    void indexRowAt(const std::string& table_name, size_t position, const std::shared_ptr<Block>& block,
+                    size_t slot) {
+        if (!hasRowIndexes(table_name)) return;
+        if (position >= BitmapIndex::MAX_BLOCKS || slot >= BitmapIndex::MAX_SLOTS) {
+            std::cerr << "Advertencia: " << table_name << " supera el rango de RID de sus índices." << std::endl;
+            return;
+        }
+        
+        uint32_t rid = BitmapIndex::makeRowId(position, slot);
+        const Record& record = *block->getAllRecords()[slot];
+        auto bitmap = bitmap_indexes.find(table_name);
+        if (bitmap != bitmap_indexes.end()) bitmap->second.addRow(rid, record);
+        auto radix = radix_indexes.find(table_name);
+        if (radix != radix_indexes.end()) {
+            for (auto& index : radix->second) index.second.addRow(rid, record);
+        }
+        auto trigram = trigram_indexes.find(table_name);
+        if (trigram != trigram_indexes.end()) {
+            for (auto& index : trigram->second) index.second.addRow(record.getId(), rid, record);
+        }
+        auto btree = btree_indexes.find(table_name);
+        if (btree != btree_indexes.end()) {
+            for (auto& index : btree->second) index.second.addRow(rid, record);
+        }
+    }
+
+    void unindexRow(const std::string& table_name, size_t position, size_t slot, const Record& record) {
+        uint32_t rid = BitmapIndex::makeRowId(position, slot);
+        auto bitmap = bitmap_indexes.find(table_name);
+        if (bitmap != bitmap_indexes.end()) bitmap->second.removeRow(rid, record);
+        auto radix = radix_indexes.find(table_name);
+        if (radix != radix_indexes.end()) {
+            for (auto& index : radix->second) index.second.removeRow(rid, record);
+        }
+        auto trigram = trigram_indexes.find(table_name);
+        if (trigram != trigram_indexes.end()) {
+            for (auto& index : trigram->second) index.second.removeRow(record.getId());
+        }
+        auto btree = btree_indexes.find(table_name);
+        if (btree != btree_indexes.end()) {
+            for (auto& index : btree->second) index.second.removeRow(rid, record);
+        }
+    }
+
+    /**
+     * @brief Vuelve a numerar todas las filas de la tabla en sus índices
+     */
+    bool rebuildRowIndexes(const std::string& table_name) {
+        if (!hasRowIndexes(table_name)) return false;
+        // Los índices B+ se reconstruyen aparte con la construcción paralela
+        bool rebuilt = true;
+        if (btree_indexes.count(table_name) > 0) {
+            for (auto& index : btree_indexes.at(table_name)) {
+                rebuilt = buildBTreeIndex(table_name, index.second, 0, nullptr).valid && rebuilt;
+            }
+        }
+        if (!rebuilt) return false;
+        
+        if (bitmap_indexes.count(table_name) > 0) bitmap_indexes.at(table_name).clearRows();
+        if (radix_indexes.count(table_name) > 0) {
+            for (auto& index : radix_indexes.at(table_name)) index.second.clearRows();
+        }
+        if (trigram_indexes.count(table_name) > 0) {
+            for (auto& index : trigram_indexes.at(table_name)) index.second.clearRows();
+        }
+        
+        if (bitmap_indexes.count(table_name) == 0 && radix_indexes.count(table_name) == 0 &&
+            trigram_indexes.count(table_name) == 0) {
+            return true;
+        }
+        
+        // indexRow también insertaría en los B+ ya reconstruidos
+        std::map<std::string, BTreeIndex> built;
+        if (btree_indexes.count(table_name) > 0) {
+            built = std::move(btree_indexes.at(table_name));
+            btree_indexes.erase(table_name);
+        }
+        for (const auto& addr : relation_blocks[table_name]) {
+            auto block = getCachedOrStoredBlock(addr);
+            if (!block) {
+                std::cout << "Error: no se pudo leer el bloque " << addr << std::endl;
+                rebuilt = false;
+                break;
+            }
+            const auto& records = block->getAllRecords();
+            for (size_t slot = 0; slot < records.size(); ++slot) {
+                if (!records[slot]->isDeleted()) indexRow(table_name, block, slot);
+            }
+        }
+        if (!built.empty()) btree_indexes[table_name] = std::move(built);
+        return rebuilt;
+    }
+
+    /**
+     * @brief Construye un índice B+ con ordenación y mezcla particionadas
+     *
+     * 1. Lectura: los hilos toman lotes de INDEX_BUILD_MORSEL_BLOCKS bloques
+     *    de un contador atómico, así que un hilo lento no retrasa a los demás.
+     *    Cada uno acumula sus entradas (clave, RID) y al terminar las ordena:
+     *    un tramo ordenado por hilo. La E/S simulada se cobra antes en orden
+     *    físico, porque el reloj del disco no admite accesos simultáneos.
+     * 2. Mezcla: unas claves de muestra de todos los tramos dividen el
+     *    espacio de claves en una partición por hilo. Cada hilo localiza su
+     *    partición en cada tramo por búsqueda binaria, la mezcla con un
+     *    montículo y llena sus propias hojas.
+     * 3. Carga: las hojas de las particiones se encadenan en orden y se
+     *    construyen los niveles internos, que son unos pocos nodos.
+     *
+     * Sin escritores concurrentes, los hilos solo leen la caché y los
+     * sectores. `progress` se llama con la fase, lo hecho y el total; en la
+     * lectura lo avisa el hilo que completa cada vigésima parte.
+     */
+    IndexBuildReport buildBTreeIndex(const std::string& table_name, BTreeIndex& index, size_t workers,
+                                     const IndexBuildProgress& progress) {
+        IndexBuildReport report;
+        auto total_start = SteadyClock::now();
+        const std::vector<PhysicalAddress> addresses = relation_blocks[table_name];
+        report.blocks = addresses.size();
+        if (addresses.size() > BitmapIndex::MAX_BLOCKS) {
+            // Las reconstrucciones llegan aquí sin pasar por createBTreeIndex: el RID daría la vuelta
+            std::cout << "Error: " << table_name << " supera el rango de RID de sus índices." << std::endl;
+            return report;
+        }
+        if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+        report.workers = std::max<size_t>(1, std::min(workers, std::max<size_t>(addresses.size(), 1)));
+        
+        std::vector<PhysicalAddress> physical = addresses;
+        std::sort(physical.begin(), physical.end());
+        for (const auto& addr : physical) report.simulated_ms += chargeAccess(table_name, IOType::READ, addr);
+        
+        // 1. Lectura por lotes y un tramo ordenado por hilo
+        auto start = SteadyClock::now();
+        std::vector<std::vector<BTreeIndex::Entry>> runs(report.workers);
+        std::vector<double> sort_ms(report.workers, 0.0);
+        std::atomic<size_t> next_block(0), blocks_done(0);
+        std::atomic<bool> failed(false);
+        std::atomic<bool> out_of_range(false);          // Un bloque con más de MAX_SLOTS ranuras
+        std::mutex progress_mutex;
+        auto scan = [&](size_t worker) {
+            std::vector<BTreeIndex::Entry>& run = runs[worker];
+            while (!failed) {
+                size_t first = next_block.fetch_add(INDEX_BUILD_MORSEL_BLOCKS);
+                if (first >= addresses.size()) break;
+                size_t last = std::min(addresses.size(), first + INDEX_BUILD_MORSEL_BLOCKS);
+                for (size_t position = first; position < last; ++position) {
+                    auto block = getCachedOrStoredBlock(addresses[position]);
+                    if (!block) {
+                        failed = true;
+                        break;
+                    }
+                    const auto& records = block->getAllRecords();
+                    if (records.size() > BitmapIndex::MAX_SLOTS) {
+                        out_of_range = true;
+                        failed = true;
+                        break;
+                    }
+                    for (size_t slot = 0; slot < records.size(); ++slot) {
+                        if (!records[slot]->isDeleted()) {
+                            run.push_back(index.entryOf(BitmapIndex::makeRowId(position, slot), *records[slot]));
+                        }
+                    }
+                }
+                size_t done = blocks_done.fetch_add(last - first) + (last - first);
+                if (progress && done * 20 / addresses.size() != (done - (last - first)) * 20 / addresses.size()) {
+                    std::lock_guard<std::mutex> lock(progress_mutex);
+                    progress("lectura", done, addresses.size());
+                }
+            }
+            auto sort_start = SteadyClock::now();
+            std::sort(run.begin(), run.end());
+            sort_ms[worker] = std::chrono::duration<double, std::milli>(SteadyClock::now() - sort_start).count();
+        };
+        std::vector<std::thread> threads;
+        for (size_t worker = 1; worker < report.workers; ++worker) threads.emplace_back(scan, worker);
+        scan(0);
+        for (auto& thread : threads) thread.join();
+        threads.clear();
+        if (out_of_range) {
+            std::cout << "Error: " << table_name << " supera el rango de RID de sus índices." << std::endl;
+            return report;
+        }
+        if (failed) {
+            std::cout << "Error: no se pudo leer un bloque de " << table_name << "." << std::endl;
+            return report;
+        }
+        report.scan_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+        report.sort_ms = *std::max_element(sort_ms.begin(), sort_ms.end());
+        for (const auto& run : runs) report.rows += run.size();
+        
+        // 2. Particiones de claves a partir de una muestra regular de cada tramo
+        start = SteadyClock::now();
+        size_t partitions = report.workers;
+        std::vector<BTreeIndex::Entry> samples;
+        for (const auto& run : runs) {
+            size_t step = std::max<size_t>(1, run.size() / (8 * partitions));
+            for (size_t i = step / 2; i < run.size(); i += step) samples.push_back(run[i]);
+        }
+        std::sort(samples.begin(), samples.end());
+        std::vector<BTreeIndex::Entry> splitters;
+        for (size_t p = 1; p < partitions && !samples.empty(); ++p) {
+            splitters.push_back(samples[samples.size() * p / partitions]);
+        }
+        partitions = splitters.size() + 1;
+        
+        std::vector<BPlusTree::LeafWriter> writers;
+        for (size_t p = 0; p < partitions; ++p) writers.push_back(index.makeLeafWriter(BTREE_FILL_FACTOR));
+        std::atomic<size_t> partitions_done(0);
+        auto merge = [&](size_t p) {
+            // Cursor [begin, end) de la partición en cada tramo
+            using Cursor = std::pair<const BTreeIndex::Entry*, const BTreeIndex::Entry*>;
+            std::vector<Cursor> cursors;
+            for (const auto& run : runs) {
+                auto begin = p == 0 ? run.begin() : std::lower_bound(run.begin(), run.end(), splitters[p - 1]);
+                auto end = p + 1 == partitions ? run.end() : std::lower_bound(run.begin(), run.end(), splitters[p]);
+                if (begin != end) cursors.emplace_back(&*begin, &*begin + (end - begin));
+            }
+            auto later = [](const Cursor& a, const Cursor& b) { return *b.first < *a.first; };
+            std::make_heap(cursors.begin(), cursors.end(), later);
+            while (!cursors.empty()) {
+                std::pop_heap(cursors.begin(), cursors.end(), later);
+                Cursor& cursor = cursors.back();
+                writers[p].append(BTreeIndex::keyBytes(cursor.first->key), cursor.first->rid);
+                if (++cursor.first == cursor.second) {
+                    cursors.pop_back();
+                } else {
+                    std::push_heap(cursors.begin(), cursors.end(), later);
+                }
+            }
+            size_t done = ++partitions_done;
+            if (progress) {
+                std::lock_guard<std::mutex> lock(progress_mutex);
+                progress("mezcla", done, partitions);
+            }
+        };
+        for (size_t p = 1; p < partitions; ++p) threads.emplace_back(merge, p);
+        merge(0);
+        for (auto& thread : threads) thread.join();
+        runs.clear();
+        report.merge_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+        
+        // 3. Hojas encadenadas y niveles internos
+        start = SteadyClock::now();
+        index.bulkLoad(writers);
+        report.load_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+        if (progress) progress("carga", 1, 1);
+        
+        report.height = index.getHeight();
+        report.nodes = index.getNodeCount();
+        report.total_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - total_start).count();
+        report.valid = true;
+        return report;
+    }
+
+    /**
+     * @brief Lee las columnas indexadas de cada tabla y reconstruye sus índices
+     */
+    void loadRowIndexes() {
+        std::string metadata_path = filesystem.getBasePath() + "/metadata";
+        if (!fs::exists(metadata_path)) return;
+        
+        std::set<std::string> tables;
+        for (const auto& entry : fs::directory_iterator(metadata_path)) {
+            std::string name = entry.path().stem().string();
+            if (entry.path().extension() != ".txt") continue;
+            
+            bool bitmap = name.find("bitmap_") == 0;
+            bool trigram = name.find("trigram_") == 0;
+            bool btree = name.find("btree_") == 0;
+            if (!bitmap && !trigram && !btree && name.find("art_") != 0) continue;
+            std::string table_name = name.substr(bitmap ? 7 : (trigram ? 8 : (btree ? 6 : 4)));
+            if (relation_blocks.count(table_name) == 0) continue;
+            auto schema = loadTableSchema(table_name);
+            
+            if (bitmap) {
+                BitmapIndex index;
+                if (!index.load(entry.path().string(), schema)) continue;
+                bitmap_indexes[table_name] = index;
+            } else if (trigram) {
+                for (const auto& column : loadTrigramColumns(entry.path().string())) {
+                    TrigramIndex index;
+                    if (!index.configure(schema, column.first)) continue;
+                    index.setFlushedId(column.second);
+                    loadTrigramDirectory(table_name, index);
+                    trigram_indexes[table_name][column.first] = std::move(index);
+                }
+            } else if (btree) {
+                for (const auto& column : loadBTreeColumns(entry.path().string())) {
+                    BTreeIndex index;
+                    if (index.configure(schema, column)) btree_indexes[table_name][column] = std::move(index);
+                }
+            } else {
+                for (const auto& column : loadRadixColumns(entry.path().string())) {
+                    RadixIndex index;
+                    if (index.configure(schema, column)) radix_indexes[table_name][column] = std::move(index);
+                }
+            }
+            tables.insert(table_name);
+        }
+        for (const auto& table_name : tables) {
+            rebuildRowIndexes(table_name);
+        }
+    }
+
+    /**
+     * @brief Lee el directorio de un índice de trigramas de los bloques de su relación
+     */
+    void loadTrigramDirectory(const std::string& table_name, TrigramIndex& index) {
+        const auto& postings = relation_blocks[index.getRelationName(table_name)];
+        for (size_t position = 0; position < postings.size(); ++position) {
+            auto block = getCachedOrStoredBlock(postings[position]);
+            if (block) index.loadBlockChunks(position, block->getAllRecords());
+        }
+    }
+
+    /**
+     * @brief En una réplica, rehace los índices de una tabla si el primario la cambió
+     *
+     * Los índices de filas apuntan a posiciones de bloque que los bloques
+     * recibidos pueden haber movido; el directorio de trigramas se relee de
+     * las listas que también llegaron del primario.
+     */
+    void refreshStaleRowIndexes(const std::string& table_name) {
+        if (stale_row_indexes.erase(table_name) == 0) return;
+        auto trigram = trigram_indexes.find(table_name);
+        if (trigram != trigram_indexes.end()) {
+            for (auto& index : trigram->second) {
+                index.second.clearPostings();
+                loadTrigramDirectory(table_name, index.second);
+            }
+        }
+        rebuildRowIndexes(table_name);
+    }
+
+    /**
+     * @brief Vuelca las inserciones pendientes de un índice de trigramas a sus bloques
+     *
+     * Los tramos nuevos se añaden tras los existentes, empezando por el hueco
+     * del último bloque; los ya escritos no se tocan.
+     */
+    double flushTrigramPostings(const std::string& table_name, TrigramIndex& index) {
+        std::vector<uint32_t> trigrams;
+        auto records = index.takePending(trigrams);
+        std::string relation = index.getRelationName(table_name);
+        auto& addresses = relation_blocks[relation];
+        
+        std::shared_ptr<Block> block = addresses.empty() ? nullptr : getBlock(addresses.back());
+        std::set<size_t> touched;
+        for (size_t i = 0; i < records.size(); ++i) {
+            if (!block || !block->canFit(records[i])) {
+                PhysicalAddress addr;
+                if (!allocateNewBlock(addr, false)) {
+                    // Los tramos sin colocar vuelven a pendientes: las búsquedas los siguen viendo
+                    for (size_t rest = i; rest < records.size(); ++rest) index.requeueChunk(*records[rest]);
+                    std::cerr << "Error: sin espacio para las listas de trigramas de " << table_name << std::endl;
+                    break;
+                }
+                block = std::make_shared<Block>(addr, config.getBytesPerSector());
+                block->setRelationName(relation);
+                block_cache[addr] = block;
+                addresses.push_back(addr);
+            }
+            block->addRecord(records[i]);
+            std::string ids = records[i]->getField(1);
+            size_t count = static_cast<size_t>(std::count(ids.begin(), ids.end(), ':')) + 1;
+            index.addChunk(trigrams[i], addresses.size() - 1, block->getRecordCount() - 1, count);
+            touched.insert(addresses.size() - 1);
+        }
+        
+        double elapsed = 0.0;
+        for (size_t position : touched) {
+            auto written = getBlock(addresses[position]);
+            if (!written) continue;
+            elapsed += chargeAccess(relation, IOType::WRITE, written->getAddress());
+            persistBlock(written);
+        }
+        saveTrigramColumns(getTrigramIndexPath(table_name), trigram_indexes[table_name]);
+        return elapsed;
+    }
+
+    /**
+     * @brief Reescribe desde cero las listas de los índices de trigramas de una tabla
+     *
+     * Descarta los IDs de filas borradas; las filas vivas entran como
+     * pendientes al reconstruir y se vuelcan juntas.
+     */
+    void rewriteTrigramIndexes(const std::string& table_name) {
+        auto indexes = trigram_indexes.find(table_name);
+        if (indexes == trigram_indexes.end()) return;
+        
+        for (auto& entry : indexes->second) {
+            std::string relation = entry.second.getRelationName(table_name);
+            for (const auto& addr : std::vector<PhysicalAddress>(relation_blocks[relation])) {
+                releaseBlock(relation, addr);
+            }
+            entry.second.clearPostings();
+        }
+        rebuildRowIndexes(table_name);
+        for (auto& entry : indexes->second) {
+            flushTrigramPostings(table_name, entry.second);
+        }
+    }
+
+    std::string getTrigramIndexPath(const std::string& table_name) const {
+        return filesystem.getBasePath() + "/metadata/trigram_" + table_name + ".txt";
+    }
+
+    /**
+     * @brief Crea un registro del tipo de la tabla (fijo o variable) con un ID dado
+     */
+    std::shared_ptr<Record> buildRecord(const std::string& table_name, const std::vector<FieldDefinition>& schema,
+                                        int record_id, const std::vector<std::string>& values) {
+        return makeRecord(schema, isTableFixedRecord(table_name), record_id, values);
+    }
+
+    /**
+     * @brief Bloque, posición y ranura de un registro vivo (tablas heap y agrupadas)
+     */
+    std::shared_ptr<Block> locateStoredRecord(const std::string& table_name, int record_id,
+                                              size_t& position, size_t& slot) {
+        const auto& addresses = relation_blocks[table_name];
+        for (position = 0; position < addresses.size(); ++position) {
+            auto block = getBlock(addresses[position]);
+            if (!block) continue;
+            const auto& records = block->getAllRecords();
+            for (slot = 0; slot < records.size(); ++slot) {
+                if (records[slot]->getId() == record_id && !records[slot]->isDeleted()) return block;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Recorre las filas vivas de una tabla con cualquier organización
+     */
+    void forEachLiveRecord(const std::string& table_name, const std::function<void(const Record&)>& visit,
+                           double* elapsed = nullptr) {
+        if (lsm_trees.count(table_name) > 0) {
+            size_t versions = 0;
+            for (const auto& row : collectLSMRows(table_name, versions)) {
+                if (!row.second->isDeleted()) visit(*row.second);
+            }
+            return;
+        }
+        for (const auto& addr : relation_blocks[table_name]) {
+            auto block = getBlock(addr);
+            if (!block) continue;
+            double ms = chargeAccess(table_name, IOType::READ, addr);
+            if (elapsed) *elapsed += ms;
+            for (const auto& record : block->getAllRecords()) {
+                if (!record->isDeleted()) visit(*record);
+            }
+        }
+    }
+
+    bool hasViews(const std::string& table_name) const {
+        for (const auto& entry : materialized_views) {
+            if (entry.second.getBaseTable() == table_name) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Aplica una fila insertada (+1) o borrada (-1) a las vistas de su tabla
+     *
+     * Solo se lee y reescribe el registro del grupo afectado. Si el borrado se
+     * lleva el mínimo o el máximo del grupo, se recalculan sus extremos
+     * recorriendo la tabla base, que a estas alturas ya no contiene la fila.
+     */
+    void applyViewDeltas(const std::string& table_name, const Record& record, int sign) {
+        for (auto& entry : materialized_views) {
+            MaterializedView& view = entry.second;
+            if (view.getBaseTable() != table_name) continue;
+            
+            auto group_values = view.groupValuesOf(record);
+            std::string key = MaterializedView::groupKey(group_values);
+            MaterializedView::GroupState state = view.emptyGroup(group_values);
+            readViewGroup(view, key, state);
+            
+            if (!view.apply(state, record, sign) && state.count > 0) {
+                view.resetExtremes(state);
+                forEachLiveRecord(table_name, [&view, &state, &key](const Record& row) {
+                    if (MaterializedView::groupKey(view.groupValuesOf(row)) == key) view.accumulateExtremes(state, row);
+                });
+            }
+            writeViewGroup(view, key, state);
+        }
     }
 
     /**
-     * @brief Muestra todos los registros de una tabla
+     * @brief Lee el estado de un grupo de la vista (un bloque)
      */
-    void displayTable(const std::string& table_name) {
-        auto it = relation_blocks.find(table_name);
-        if (it == relation_blocks.end()) {
-            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
-            return;
+    bool readViewGroup(const MaterializedView& view, const std::string& key, MaterializedView::GroupState& state,
+                       double* elapsed = nullptr) {
+        MaterializedView::Slot location;
+        const auto& addresses = relation_blocks[view.getName()];
+        if (!view.locate(key, location) || location.block >= addresses.size()) {
+            return false;
         }
-        
-        std::cout << "\n=== TABLA: " << table_name << " ===" << std::endl;
-        
-        int total_records = 0;
-        int active_records = 0;
-        
-        for (const auto& addr : it->second) {
-            auto block = getBlock(addr);
-            if (block) {
-                std::cout << "\n--- Bloque " << addr << " ---" << std::endl;
-                block->displayInfo();
-                
-                auto active_recs = block->getActiveRecords();
-                for (const auto& record : active_recs) {
-                    record->display();
-                    std::cout << "---" << std::endl;
-                }
-                
-                total_records += block->getRecordCount();
-                active_records += active_recs.size();
-            }
+        auto block = getBlock(addresses[location.block]);
+        if (!block || location.slot >= block->getRecordCount()) {
+            return false;
         }
-        
-        std::cout << "\nResumen: " << active_records << " registros activos de " 
-                  << total_records << " totales." << std::endl;
+        double ms = chargeAccess(view.getName(), IOType::READ, addresses[location.block]);
+        if (elapsed) *elapsed += ms;
+        return view.fromStoredValues(block->getAllRecords()[location.slot]->getFieldValues(), state);
     }
 
     /**
-     * @brief Muestra estadísticas del disco
+     * @brief Reescribe el registro de un grupo; un grupo sin filas se borra
+     *
+     * La nueva versión ocupa la misma ranura si cabe; si no, la antigua se
+     * marca como borrada y el grupo pasa al final de la relación.
      */
-    void displayStatistics() {
-        std::cout << "\n=== ESTADÍSTICAS DEL DISCO ===" << std::endl;
-        
-        config.displayConfig();
-        filesystem.displayUsageStatistics();
-        
-        std::cout << "\n=== ESTADÍSTICAS DE ACCESO ===" << std::endl;
-        std::cout << "Total de lecturas: " << total_reads << std::endl;
-        std::cout << "Total de escrituras: " << total_writes << std::endl;
-        std::cout << "Tiempo total de acceso: " << total_access_time << " ms" << std::endl;
+    void writeViewGroup(MaterializedView& view, const std::string& key, const MaterializedView::GroupState& state) {
+        const std::string& relation = view.getName();
+        result_cache.invalidate(relation);
+        MaterializedView::Slot location;
+        std::shared_ptr<Block> block;
+        if (view.locate(key, location) && location.block < relation_blocks[relation].size()) {
+            block = getBlock(relation_blocks[relation][location.block]);
+        }
+        std::shared_ptr<Record> old_record;
+        if (block && location.slot < block->getRecordCount()) {
+            old_record = block->getAllRecords()[location.slot];
+        }
         
-        if (total_reads + total_writes > 0) {
-            std::cout << "Tiempo promedio de acceso: " 
-                      << (total_access_time / (total_reads + total_writes)) 
-                      << " ms" << std::endl;
+        if (state.count <= 0) {
+            if (old_record) {
+                old_record->markAsDeleted();
+                chargeAccess(relation, IOType::WRITE, block->getAddress());
+                persistBlock(block);
+            }
+            view.forget(key);
+            return;
         }
         
-        std::cout << "\n=== TABLAS ===" << std::endl;
-        for (const auto& table : relation_blocks) {
-            std::cout << "- " << table.first << ": " << table.second.size() 
-                      << " bloques" << std::endl;
+        if (old_record && block->replaceRecordAt(location.slot, makeViewRecord(view, state))) {
+            chargeAccess(relation, IOType::WRITE, block->getAddress());
+            persistBlock(block);
+            return;
+        }
+        // El grupo se coloca antes de borrar la versión antigua: sin espacio, esta se conserva
+        size_t position = 0;
+        if (!placeViewGroup(view, key, state, position)) {
+            std::cerr << "Error: la vista " << relation << " no pudo guardar un grupo; refrésquela cuando haya espacio."
+                      << std::endl;
+            return;
+        }
+        if (old_record) {
+            old_record->markAsDeleted();
+            persistBlock(block);
+        }
+        auto target = getBlock(relation_blocks[relation][position]);
+        if (target) {
+            chargeAccess(relation, IOType::WRITE, target->getAddress());
+            persistBlock(target);
         }
     }
 
     /**
-     * @brief Muestra la estructura de directorios
+     * @brief Registro de un grupo (ID 0: la vista no consume IDs de la tabla base)
      */
-    void showDirectoryStructure() {
-        filesystem.displayDirectoryStructure();
+    std::shared_ptr<Record> makeViewRecord(const MaterializedView& view, const MaterializedView::GroupState& state) {
+        auto record = std::make_shared<VariableRecord>(0);
+        record->setSchema(view.storageSchema());
+        record->setFieldValues(view.toStoredValues(state));
+        record->calculateOffsets();
+        return record;
     }
 
-private:
     /**
-     * @brief Asigna una nueva dirección de bloque
+     * @brief Añade un grupo al último bloque de la vista (o a uno nuevo) sin escribirlo
+     * @param position Posición del bloque en la relación de la vista
+     * @return false si hacía falta un bloque nuevo y el disco está lleno
+     */
+    bool placeViewGroup(MaterializedView& view, const std::string& key, const MaterializedView::GroupState& state,
+                        size_t& position) {
+        const std::string& relation = view.getName();
+        auto record = makeViewRecord(view, state);
+        auto& addresses = relation_blocks[relation];
+        std::shared_ptr<Block> block = addresses.empty() ? nullptr : getBlock(addresses.back());
+        if (!block || !block->canFit(record)) {
+            PhysicalAddress addr;
+            if (!allocateNewBlock(addr, isTableHot(relation))) {
+                return false;
+            }
+            block = std::make_shared<Block>(addr, config.getBytesPerSector());
+            block->setRelationName(relation);
+            block_cache[addr] = block;
+            addresses.push_back(addr);
+        }
+        block->addRecord(record);
+        view.place(key, addresses.size() - 1, block->getRecordCount() - 1);
+        position = addresses.size() - 1;
+        return true;
+    }
+
+    void loadViewDirectory(MaterializedView& view) {
+        view.clearDirectory();
+        const auto& addresses = relation_blocks[view.getName()];
+        for (size_t position = 0; position < addresses.size(); ++position) {
+            auto block = getCachedOrStoredBlock(addresses[position]);
+            if (block) view.loadBlockGroups(position, block->getAllRecords());
+        }
+    }
+
+    /**
+     * @brief Lee la definición de cada vista y reconstruye su directorio de grupos
      */
-    PhysicalAddress allocateNewBlock() {
-        PhysicalAddress addr = next_free_address;
+    void loadMaterializedViews() {
+        std::string metadata_path = filesystem.getBasePath() + "/metadata";
+        if (!fs::exists(metadata_path)) return;
         
-        // Avanzar a la siguiente dirección
-        next_free_address.setSector(next_free_address.getSector() + 1);
-        if (next_free_address.getSector() >= config.getSectorsPerTrack()) {
-            next_free_address.setSector(0);
-            next_free_address.setTrack(next_free_address.getTrack() + 1);
+        for (const auto& entry : fs::directory_iterator(metadata_path)) {
+            std::string name = entry.path().stem().string();
+            if (entry.path().extension() != ".txt" || name.find("view_") != 0) continue;
             
-            if (next_free_address.getTrack() >= config.getTracksPerSurface()) {
-                next_free_address.setTrack(0);
-                next_free_address.setSurface(next_free_address.getSurface() + 1);
-                
-                if (next_free_address.getSurface() >= config.getSurfacesPerPlatter()) {
-                    next_free_address.setSurface(0);
-                    next_free_address.setPlatter(next_free_address.getPlatter() + 1);
-                }
+            MaterializedView view;
+            std::string view_name = name.substr(5);
+            if (!view.load(view_name, entry.path().string()) ||
+                relation_blocks.count(view.getBaseTable()) == 0 ||
+                !view.configure(loadTableSchema(view.getBaseTable()))) {
+                continue;
             }
+            relation_blocks[view_name];
+            loadViewDirectory(view);
+            materialized_views[view_name] = std::move(view);
         }
-        
-        return addr;
     }
 
+    std::string getViewPath(const std::string& view_name) const {
+        return filesystem.getBasePath() + "/metadata/view_" + view_name + ".txt";
+    }
+
+    // Filas por lote decodificado de filterAggregate
+    static constexpr size_t PIPELINE_BATCH_ROWS = 1024;
+
+    // Relación de los bloques temporales de ordenación y de particiones volcadas
+    static constexpr const char* SPILL_RELATION = "sort_tmp";
+
     /**
-     * @brief Encuentra un bloque con espacio suficiente
+     * @brief Volcado en curso: bloques ya escritos y el que se está llenando
      */
-    std::shared_ptr<Block> findBlockWithSpace(const std::string& table_name, size_t record_size) {
-        auto it = relation_blocks.find(table_name);
-        if (it == relation_blocks.end()) {
-            return nullptr;
-        }
-        
-        for (const auto& addr : it->second) {
-            auto block = getBlock(addr);
-            if (block && block->getFreeSpace() >= (record_size + sizeof(size_t))) {
-                return block;
+    struct SpillRun {
+        std::vector<PhysicalAddress> blocks;
+        std::shared_ptr<Block> current;
+    };
+
+    /**
+     * @brief Añade una fila al volcado; false si hacía falta un bloque y el disco está lleno
+     */
+    bool spillTuple(SpillRun& run, const std::string& table_name, const std::vector<FieldDefinition>& schema,
+                    const std::vector<std::string>& tuple, std::vector<PhysicalAddress>& temp_blocks,
+                    WindowReport& report) {
+        auto record = buildRecord(table_name, schema, 0, tuple);
+        if (run.current && !run.current->canFit(record)) closeSpill(run, report);
+        if (!run.current) {
+            PhysicalAddress addr;
+            if (!allocateNewBlock(addr)) {
+                return false;
             }
+            temp_blocks.push_back(addr);
+            run.current = std::make_shared<Block>(addr, config.getBytesPerSector());
+            run.current->setRelationName(SPILL_RELATION);
         }
-        
-        return nullptr;
+        run.current->addRecord(record);
+        return true;
     }
 
     /**
-     * @brief Obtiene un bloque (desde cache o disco)
+     * @brief Escribe el bloque que se estaba llenando (los temporales no pasan por el WAL)
      */
-    std::shared_ptr<Block> getBlock(const PhysicalAddress& addr) {
-        // Buscar en cache
-        auto it = block_cache.find(addr);
-        if (it != block_cache.end()) {
-            return it->second;
+    void closeSpill(SpillRun& run, WindowReport& report) {
+        if (!run.current) return;
+        const PhysicalAddress addr = run.current->getAddress();
+        if (!filesystem.writeBlock(addr, *run.current)) {
+            std::cerr << "Error: no se pudo escribir el bloque temporal " << addr << std::endl;
         }
-        
-        // Cargar desde disco
-        auto block = std::make_shared<Block>(addr, config.getBytesPerSector());
-        if (filesystem.readBlock(addr, *block)) {
-            block_cache[addr] = block;
-            return block;
+        report.simulated_ms += io_clock.serve(IOType::WRITE, addr);
+        report.spill_blocks_written++;
+        run.blocks.push_back(addr);
+        run.current.reset();
+    }
+
+    std::vector<std::vector<std::string>> readSpillBlock(const PhysicalAddress& addr, size_t field_count,
+                                                         WindowReport& report) {
+        std::vector<std::vector<std::string>> tuples;
+        Block block(addr, config.getBytesPerSector());
+        if (!filesystem.readBlock(addr, block)) {
+            std::cerr << "Error: no se pudo leer el bloque temporal " << addr << std::endl;
+            return tuples;
         }
-        
-        return nullptr;
+        report.simulated_ms += io_clock.serve(IOType::READ, addr);
+        report.spill_blocks_read++;
+        for (const auto& record : block.getAllRecords()) {
+            tuples.push_back(record->getFieldValues());
+            tuples.back().resize(field_count);
+        }
+        return tuples;
+    }
+
+    bool checkSketchColumn(const std::string& table_name, const std::string& column) {
+        if (relation_blocks.find(table_name) == relation_blocks.end()) {
+            std::cout << "Tabla '" << table_name << "' no encontrada." << std::endl;
+            return false;
+        }
+        if (lsm_trees.count(table_name) > 0) {
+            std::cout << "Error: los sketches por bloque no admiten tablas LSM." << std::endl;
+            return false;
+        }
+        for (const auto& field : loadTableSchema(table_name)) {
+            if (field.name == column) return true;
+        }
+        std::cout << "Campo '" << column << "' no encontrado en '" << table_name << "'." << std::endl;
+        return false;
+    }
+
+    std::string getSketchPath(const std::string& table_name) const {
+        return filesystem.getBasePath() + "/metadata/sketch_" + table_name + ".txt";
     }
 
     /**
-     * @brief Simula el tiempo de acceso a disco
+     * @brief Guarda los resúmenes de la tabla: `COLUMN|col` y `BLOCK|dirección|lsn|hll|kll`
      */
-    double simulateAccessTime(const PhysicalAddress& addr) {
-        // Simular seek time, rotational latency y transfer time
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
+    bool saveColumnSketches(const std::string& table_name) const {
+        std::ofstream file(getSketchPath(table_name), std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Error escribiendo los sketches de " << table_name << std::endl;
+            return false;
+        }
+        for (const auto& column : column_sketches.at(table_name)) {
+            file << "COLUMN|" << column.first << std::endl;
+            for (const auto& block : column.second) {
+                file << "BLOCK|" << block.first.toString() << "|" << block.second.lsn << "|"
+                     << block.second.sketch.toString() << std::endl;
+            }
+        }
+        return static_cast<bool>(file);
+    }
+
+    void loadColumnSketches() {
+        std::string metadata_path = filesystem.getBasePath() + "/metadata";
+        if (!fs::exists(metadata_path)) return;
         
-        // Seek time (variable según distancia)
-        std::uniform_real_distribution<> seek_dist(0.0, config.getSeekTime() * 2);
-        double seek_time = seek_dist(gen);
+        for (const auto& entry : fs::directory_iterator(metadata_path)) {
+            std::string name = entry.path().stem().string();
+            if (entry.path().extension() != ".txt" || name.find("sketch_") != 0) continue;
+            std::string table_name = name.substr(7);
+            if (relation_blocks.count(table_name) == 0) continue;
+            
+            std::ifstream file(entry.path());
+            std::string line;
+            std::map<PhysicalAddress, BlockSketch>* column = nullptr;
+            while (std::getline(file, line)) {
+                std::istringstream fields(line);
+                std::string type, addr_str, lsn_str, sketch_str;
+                std::getline(fields, type, '|');
+                if (type == "COLUMN") {
+                    std::getline(fields, addr_str);
+                    column = &column_sketches[table_name][addr_str];
+                    continue;
+                }
+                std::getline(fields, addr_str, '|');
+                std::getline(fields, lsn_str, '|');
+                std::getline(fields, sketch_str);
+                BlockSketch block;
+                PhysicalAddress addr;
+                if (type != "BLOCK" || !column || !PhysicalAddress::fromString(addr_str, addr) ||
+                    !block.sketch.fromString(sketch_str)) {
+                    continue;
+                }
+                try {
+                    block.lsn = std::stoll(lsn_str);
+                } catch (const std::exception&) {
+                    continue;
+                }
+                (*column)[addr] = std::move(block);
+            }
+        }
+    }
+
+    /**
+     * @brief Lee las filas de una lista de RIDs, cargando cada bloque una vez por tramo
+     */
+    std::vector<std::shared_ptr<Record>> fetchRows(const std::string& table_name,
+                                                   const std::vector<uint32_t>& rids,
+                                                   double* elapsed = nullptr) {
+        std::vector<std::shared_ptr<Record>> rows;
+        const auto& addresses = relation_blocks[table_name];
+        std::shared_ptr<Block> block;
+        size_t current = SIZE_MAX;
+        for (uint32_t rid : rids) {
+            size_t position = BitmapIndex::blockOf(rid);
+            if (position >= addresses.size()) continue;
+            if (position != current) {
+                block = getBlock(addresses[position]);
+                current = position;
+                if (block) {
+                    double ms = chargeAccess(table_name, IOType::READ, addresses[position]);
+                    if (elapsed) *elapsed += ms;
+                }
+            }
+            if (!block) continue;
+            const auto& records = block->getAllRecords();
+            size_t slot = BitmapIndex::slotOf(rid);
+            if (slot < records.size() && !records[slot]->isDeleted()) rows.push_back(records[slot]);
+        }
+        return rows;
+    }
+
+    /**
+     * @brief Copia la configuración y los esquemas para el respaldo
+     */
+    bool collectMetadataSections(std::vector<ArchiveSection>& sections) const {
+        std::string metadata_path = filesystem.getBasePath() + "/metadata";
+        if (!fs::exists(metadata_path)) return false;
         
-        // Rotational latency (0 a máximo)
-        std::uniform_real_distribution<> rot_dist(0.0, config.getRotationalLatency() * 2);
-        double rot_latency = rot_dist(gen);
+        auto readFile = [](const fs::path& path) {
+            std::ifstream file(path, std::ios::binary);
+            std::ostringstream content;
+            content << file.rdbuf();
+            return content.str();
+        };
         
-        // Transfer time (fijo)
-        double transfer_time = config.getTransferTime();
+        ArchiveSection config_section;
+        config_section.kind = "CONFIG";
+        config_section.name = "disk_config.txt";
+        config_section.data = readFile(metadata_path + "/disk_config.txt");
+        sections.push_back(config_section);
         
-        return seek_time + rot_latency + transfer_time;
+        for (const auto& entry : fs::directory_iterator(metadata_path)) {
+            std::string name = entry.path().filename().string();
+            if (name.find("schema_") != 0 && name.find("lsm_") != 0 &&
+                name.find("clustered_") != 0 && name.find("bitmap_") != 0 &&
+                name.find("art_") != 0 && name.find("trigram_") != 0 && name.find("btree_") != 0 &&
+                name.find("view_") != 0 && name.find("sketch_") != 0) continue;
+            
+            ArchiveSection schema_section;
+            schema_section.kind = "SCHEMA";
+            schema_section.name = name;
+            schema_section.data = readFile(entry.path());
+            sections.push_back(schema_section);
+        }
+        return true;
     }
 
     /**
-     * @brief Parsea una línea CSV
+     * @brief Cuerpo del hilo de volcado: copia los bloques congelados al archivo
+     *
+     * Solo lee sectores y archivos fríos congelados, que el hilo principal
+     * nunca reescribe mientras la instantánea está activa.
      */
-    std::vector<std::string> parseCSVLine(const std::string& line) {
-        std::vector<std::string> values;
-        std::istringstream iss(line);
-        std::string value;
+    void streamSnapshot(std::string archive_path, std::string label,
+                        std::vector<ArchiveSection> metadata, std::vector<FrozenBlock> frozen) {
+        auto start = SteadyClock::now();
+        SnapshotReport report = snapshot_report;
+        
+        ArchiveWriter writer;
+        bool ok = writer.open(archive_path, label);
+        for (const auto& section : metadata) {
+            ok = ok && writer.write(section);
+        }
+        
+        for (const auto& entry : frozen) {
+            if (!ok) break;
+            
+            ArchiveSection section;
+            section.kind = "BLOCK";
+            section.name = entry.relation;
+            section.address = entry.address;
+            section.tier = storageTierToString(entry.tier);
+            
+            if (entry.tier == StorageTier::MEMORY) {
+                section.data = entry.image;
+            } else {
+                Block block(entry.address, config.getBytesPerSector());
+                ok = entry.cold ? filesystem.readColdBlock(entry.address, block)
+                                : filesystem.readBlock(entry.address, block);
+                section.data = block.serialize();
+            }
+            
+            ok = ok && writer.write(section);
+            report.raw_bytes += static_cast<long long>(section.data.size());
+            report.copied_bytes += config.getBytesPerSector();
+            report.blocks++;
+            snapshot_progress++;
+        }
         
-        while (std::getline(iss, value, ',')) {
-            // Remover espacios en blanco
-            value.erase(0, value.find_first_not_of(" \t"));
-            value.erase(value.find_last_not_of(" \t") + 1);
-            values.push_back(value);
+        if (ok && writer.close()) {
+            report.ok = true;
+            report.archive_bytes = writer.getBytesWritten();
+        } else {
+            writer.abort();
         }
         
-        return values;
+        report.elapsed_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+        snapshot_report = report;
+        snapshot_running = false;
     }
 
     /**
@@ -477,117 +5735,308 @@ private:
      */
     void saveTableSchema(const std::string& table_name, 
                          const std::vector<FieldDefinition>& schema,
-                         bool use_fixed) {
+                         bool use_fixed,
+                         bool hot_table = false,
+                         TableOrganization organization = TableOrganization::HEAP) {
         std::string schema_path = filesystem.getBasePath() + "/metadata/schema_" + table_name + ".txt";
         std::ofstream file(schema_path);
         
         if (file.is_open()) {
             file << "# Esquema de la tabla: " << table_name << std::endl;
             file << "record_type=" << (use_fixed ? "FIXED" : "VARIABLE") << std::endl;
+            file << "placement=" << (hot_table ? "HOT" : "DEFAULT") << std::endl;
+            file << "tier=" << storageTierToString(StorageTier::DISK) << std::endl;
+            file << "organization=" << tableOrganizationToString(organization) << std::endl;
             file << "field_count=" << schema.size() << std::endl;
             
             for (const auto& field : schema) {
-                file << field.name << "|";
-                file << static_cast<int>(field.type) << "|";
-                file << field.max_length << "|";
-                file << (field.is_nullable ? 1 : 0) << std::endl;
+                file << serializeFieldDefinition(field) << std::endl;
             }
             
             file.close();
         }
+        schema_cache.erase(table_name);
+        shipTableSchema(table_name);
     }
 
     /**
-     * @brief Carga el esquema de una tabla
+     * @brief Esquema parseado de una tabla; el archivo se lee una sola vez
+     * @return nullptr si la tabla no tiene esquema
      */
-    std::vector<FieldDefinition> loadTableSchema(const std::string& table_name) {
-        std::vector<FieldDefinition> schema;
-        std::string schema_path = filesystem.getBasePath() + "/metadata/schema_" + table_name + ".txt";
+    const CachedSchema* cachedSchema(const std::string& table_name) {
+        auto cached = schema_cache.find(table_name);
+        if (cached != schema_cache.end()) {
+            return &cached->second;
+        }
         
+        std::string schema_path = filesystem.getBasePath() + "/metadata/schema_" + table_name + ".txt";
         std::ifstream file(schema_path);
         if (!file.is_open()) {
-            return schema;
+            return nullptr;
         }
         
+        CachedSchema schema;
         std::string line;
         while (std::getline(file, line)) {
             if (line.empty() || line[0] == '#') continue;
             
-            if (line.find("field_count=") == 0 || line.find("record_type=") == 0) {
-                continue;
-            }
-            
-            // Parsear definición de campo
-            std::istringstream iss(line);
-            std::string name, type_str, length_str, nullable_str;
-            
-            if (std::getline(iss, name, '|') &&
-                std::getline(iss, type_str, '|') &&
-                std::getline(iss, length_str, '|') &&
-                std::getline(iss, nullable_str)) {
-                
-                FieldType type = static_cast<FieldType>(std::stoi(type_str));
-                size_t length = std::stoull(length_str);
-                bool nullable = (nullable_str == "1");
-                
-                schema.emplace_back(name, type, length, nullable);
+            if (line.find("record_type=") == 0) {
+                schema.fixed_record = line.find("FIXED") != std::string::npos;
+            } else if (line.find("placement=") == 0) {
+                schema.hot = line.find("HOT") != std::string::npos;
+            } else if (line.find("organization=") == 0) {
+                schema.organization = tableOrganizationFromString(line.substr(13));
+            } else if (line.find("field_count=") != 0 && line.find("tier=") != 0) {
+                // Parsear definición de campo
+                parseFieldDefinition(line, schema.fields);
             }
         }
-        
-        file.close();
-        return schema;
+        return &schema_cache.emplace(table_name, std::move(schema)).first->second;
+    }
+
+    /**
+     * @brief Carga el esquema de una tabla
+     */
+    std::vector<FieldDefinition> loadTableSchema(const std::string& table_name) {
+        const CachedSchema* schema = cachedSchema(table_name);
+        return schema ? schema->fields : std::vector<FieldDefinition>();
     }
 
     /**
      * @brief Verifica si una tabla usa registros fijos
      */
     bool isTableFixedRecord(const std::string& table_name) {
+        const CachedSchema* schema = cachedSchema(table_name);
+        return schema ? schema->fixed_record : true;  // Por defecto, usar registros fijos
+    }
+
+    /**
+     * @brief Verifica si una tabla está marcada como caliente (zonas exteriores)
+     */
+    bool isTableHot(const std::string& table_name) {
+        const CachedSchema* schema = cachedSchema(table_name);
+        return schema && schema->hot;
+    }
+
+    /**
+     * @brief Guarda el nivel de almacenamiento en el esquema de la tabla
+     */
+    void saveTableTier(const std::string& table_name, StorageTier tier) {
         std::string schema_path = filesystem.getBasePath() + "/metadata/schema_" + table_name + ".txt";
-        std::ifstream file(schema_path);
+        std::vector<std::string> lines;
         
-        if (file.is_open()) {
+        std::ifstream in(schema_path);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.find("tier=") != 0) {
+                lines.push_back(line);
+            }
+        }
+        in.close();
+        
+        // La línea va tras la cabecera, antes de las definiciones de campo
+        size_t position = std::min<size_t>(lines.size(), 3);
+        lines.insert(lines.begin() + position, "tier=" + storageTierToString(tier));
+        
+        std::ofstream out(schema_path, std::ios::trunc);
+        for (const auto& l : lines) {
+            out << l << std::endl;
+        }
+        out.close();
+        schema_cache.erase(table_name);
+        shipTableSchema(table_name);
+    }
+
+    /**
+     * @brief Envía el archivo de esquema de una tabla a las réplicas
+     */
+    void shipTableSchema(const std::string& table_name) {
+        if (!ship_log.isOpen()) return;
+        
+        std::ifstream file(filesystem.getBasePath() + "/metadata/schema_" + table_name + ".txt");
+        std::ostringstream content;
+        content << file.rdbuf();
+        ship_log.append(WalRecord(++last_page_lsn, ShippingLog::SCHEMA_PREFIX + table_name,
+                                  PhysicalAddress(), content.str()));
+    }
+
+    /**
+     * @brief Lee el nivel de almacenamiento de cada tabla desde su esquema
+     */
+    void loadTableTiers() {
+        std::string metadata_path = filesystem.getBasePath() + "/metadata";
+        if (!fs::exists(metadata_path)) return;
+        
+        const std::string prefix = "schema_";
+        for (const auto& entry : fs::directory_iterator(metadata_path)) {
+            std::string name = entry.path().stem().string();
+            if (name.find(prefix) != 0 || entry.path().extension() != ".txt") continue;
+            
+            std::ifstream file(entry.path());
             std::string line;
             while (std::getline(file, line)) {
-                if (line.find("record_type=") == 0) {
-                    return line.find("FIXED") != std::string::npos;
+                if (line.find("tier=") == 0) {
+                    table_tiers[name.substr(prefix.size())] = storageTierFromString(line.substr(5));
+                    break;
                 }
             }
-            file.close();
         }
+    }
+
+    /**
+     * @brief Registra un bloque cargado en los índices en memoria
+     */
+    void indexBlock(const std::shared_ptr<Block>& block) {
+        std::string table_name = block->getRelationName();
+        if (!table_name.empty()) {
+            auto& addresses = relation_blocks[table_name];
+            if (std::find(addresses.begin(), addresses.end(), block->getAddress()) == addresses.end()) {
+                addresses.push_back(block->getAddress());
+            }
+        }
+        
+        // Actualizar next_record_id
+        for (const auto& record : block->getAllRecords()) {
+            if (record->getId() >= next_record_id) {
+                next_record_id = record->getId() + 1;
+            }
+        }
+        
+        block_lsns[block->getAddress()] = block->getPageLSN();
+        last_page_lsn = std::max(last_page_lsn, block->getPageLSN());
+    }
+
+    /**
+     * @brief Huecos de cada zona por debajo de su cursor: direcciones que ninguna relación ocupa
+     */
+    void loadFreeBlocks() {
+        std::set<PhysicalAddress> occupied(cold_blocks.begin(), cold_blocks.end());
+        for (const auto& table : relation_blocks) occupied.insert(table.second.begin(), table.second.end());
         
-        return true;  // Por defecto, usar registros fijos
+        zone_free_blocks.assign(config.getZoneCount(), {});
+        for (int z = 0; z < config.getZoneCount(); ++z) {
+            for (long long zone_block = zone_next_block[z] - 1; zone_block >= 0; --zone_block) {
+                PhysicalAddress addr = config.zoneBlockToAddress(z, zone_block);
+                if (claimed_cylinders.count(addr.getTrack()) == 0 && occupied.count(addr) == 0) {
+                    zone_free_blocks[z].push_back(addr);  // Los más bajos quedan al final y salen antes
+                }
+            }
+        }
     }
 
     /**
      * @brief Carga el índice de bloques existentes
+     *
+     * Los sectores en disco se cachean, los bloques fríos solo se indexan y
+     * el WAL se rehace encima: su última imagen de cada bloque es la vigente.
+     * Las imágenes de tablas que ya no están en memoria (migración interrumpida)
+     * se vuelcan a su nivel y el log se compacta.
      */
     void loadBlockIndex() {
-        auto occupied = filesystem.getOccupiedSectors();
+        loadTableTiers();
+        
+        // Versiones congeladas que una instantánea interrumpida no llegó a liberar
+        std::set<PhysicalAddress> wal_blocks;
+        for (const auto& record : wal.readAll()) {
+            wal_blocks.insert(record.address);
+        }
         
-        for (const auto& addr : occupied) {
+        // Línea "antigua nueva" (reubicación) o solo "antigua" (liberación diferida)
+        std::ifstream shadow_list(getShadowListPath());
+        std::string shadow_line;
+        while (std::getline(shadow_list, shadow_line)) {
+            std::istringstream fields(shadow_line);
+            std::string old_text, new_text;
+            fields >> old_text >> new_text;
+            
+            PhysicalAddress old_addr, new_addr;
+            if (!PhysicalAddress::fromString(old_text, old_addr) ||
+                (!new_text.empty() && !PhysicalAddress::fromString(new_text, new_addr))) {
+                continue;
+            }
+            bool replaced = new_text.empty() ||
+                            fs::exists(filesystem.getFullPath(new_addr)) ||
+                            fs::exists(filesystem.getColdPath(new_addr)) ||
+                            wal_blocks.count(new_addr) > 0;
+            if (replaced) {
+                filesystem.deleteBlock(old_addr);
+                filesystem.deleteColdBlock(old_addr);
+            }
+        }
+        shadow_list.close();
+        std::error_code ec;
+        fs::remove(getShadowListPath(), ec);
+        
+        for (const auto& addr : filesystem.getOccupiedSectors()) {
             auto block = std::make_shared<Block>(addr, config.getBytesPerSector());
             if (filesystem.readBlock(addr, *block)) {
-                block_cache[addr] = block;
-                
-                std::string table_name = block->getRelationName();
-                if (!table_name.empty()) {
-                    relation_blocks[table_name].push_back(addr);
-                }
-                
-                // Actualizar next_record_id
-                for (const auto& record : block->getAllRecords()) {
-                    if (record->getId() >= next_record_id) {
-                        next_record_id = record->getId() + 1;
-                    }
+                if (block->getRelationName() == SPILL_RELATION) {
+                    filesystem.deleteBlock(addr);  // Temporal de una consulta que no terminó
+                    continue;
                 }
+                block_cache[addr] = block;
+                indexBlock(block);
+            }
+        }
+        
+        for (const auto& addr : filesystem.getColdSectors()) {
+            if (block_cache.count(addr) > 0) {
+                filesystem.deleteColdBlock(addr);  // Promoción interrumpida: manda el sector
+                continue;
+            }
+            auto block = std::make_shared<Block>(addr, config.getBytesPerSector());
+            if (filesystem.readColdBlock(addr, *block)) {
+                cold_blocks.insert(addr);
+                indexBlock(block);
+            }
+        }
+        
+        std::map<PhysicalAddress, WalRecord> latest;
+        for (const auto& record : wal.readAll()) {
+            latest[record.address] = record;
+        }
+        
+        bool stale_entries = false;
+        for (const auto& entry : latest) {
+            auto block = std::make_shared<Block>(entry.first, config.getBytesPerSector());
+            if (!block->deserialize(entry.second.payload)) continue;
+            
+            if (getTableTier(entry.second.relation) != StorageTier::MEMORY) {
+                persistBlock(block);
+                stale_entries = true;
+            }
+            block_cache[entry.first] = block;
+            indexBlock(block);
+        }
+        if (stale_entries) {
+            checkpointWal();
+        }
+        
+        loadLSMTrees();
+        loadClusteredTables();
+        
+        // Continuar la asignación de cada zona tras su último bloque ocupado
+        for (auto& table : relation_blocks) {
+            if (clustered_tables.count(table.first) == 0) {
+                std::sort(table.second.begin(), table.second.end());
+            }
+            for (const auto& addr : table.second) {
+                if (claimed_cylinders.count(addr.getTrack()) > 0) continue;
+                int zone = config.getZoneForTrack(addr.getTrack());
+                zone_next_block[zone] = std::max(zone_next_block[zone], config.addressToZoneBlock(addr) + 1);
             }
         }
+        loadFreeBlocks();
+        loadRowIndexes();  // Las posiciones de bloque ya son las definitivas
+        loadMaterializedViews();
+        loadColumnSketches();
+        
+        // El contador nunca retrocede por debajo del último respaldo
+        last_page_lsn = std::max(last_page_lsn, getLastBackupLSN());
         
-        // Actualizar next_free_address
-        if (!occupied.empty()) {
-            auto last_addr = *std::max_element(occupied.begin(), occupied.end());
-            next_free_address = last_addr;
-            next_free_address.setSector(next_free_address.getSector() + 1);
+        auto now = SteadyClock::now();
+        for (const auto& entry : block_cache) {
+            last_access[entry.first] = now;
         }
     }
 };
@@ -0,0 +1,447 @@
+#ifndef DISK_SIMULATION_CLOCK_H
+#define DISK_SIMULATION_CLOCK_H
+
+#include <vector>
+#include <memory>
+#include <deque>
+#include <queue>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include "DiskConfig.h"
+#include "DeviceModel.h"
+#include "PhysicalAddress.h"
+
+/**
+ * @brief Política con la que cada actuador elige la siguiente petición
+ */
+enum class SchedulingPolicy {
+    FCFS,   // Orden de llegada
+    SSTF    // Menor coste de posicionamiento según el modelo del dispositivo
+};
+
+/**
+ * @brief Petición de E/S con sus instantes de simulación (en ms)
+ */
+struct IORequest {
+    long long id = 0;
+    IOType type = IOType::READ;
+    PhysicalAddress address;
+    int actuator = 0;               // Unidad (brazo, die...) cuya cola la atiende
+    double arrival_ms = 0.0;        // Llega al disco
+    double start_ms = 0.0;          // Empieza el servicio
+    double completion_ms = 0.0;     // Termina la transferencia
+    size_t queue_depth = 0;         // Peticiones delante al llegar (incluida la que se sirve)
+    bool completed = false;
+
+    double getQueueTime() const { return start_ms - arrival_ms; }
+    double getServiceTime() const { return completion_ms - start_ms; }
+    double getResponseTime() const { return completion_ms - arrival_ms; }
+};
+
+/**
+ * @brief Resumen estadístico de las peticiones completadas
+ */
+struct IOStatistics {
+    size_t completed = 0;
+    size_t reads = 0;
+    size_t writes = 0;
+    double elapsed_ms = 0.0;            // Primera llegada -> última finalización
+    double throughput_iops = 0.0;
+    double throughput_mbps = 0.0;
+    double utilization = 0.0;           // Promedio de ocupación de los actuadores
+    double mean_response_ms = 0.0;
+    double mean_queue_ms = 0.0;
+    double p50_response_ms = 0.0;
+    double p95_response_ms = 0.0;
+    double p99_response_ms = 0.0;
+    double max_response_ms = 0.0;
+    size_t max_queue_depth = 0;
+};
+
+/**
+ * @brief Reloj de simulación de eventos discretos para un disco
+ *
+ * Cada unidad independiente del dispositivo (actuador de un disco magnético,
+ * die de un SSD) tiene su propia cola. Las peticiones llegan en un instante
+ * dado, esperan en la cola mientras la unidad está ocupada y su tiempo de
+ * servicio lo calcula el DeviceModel según su estado (posición del brazo,
+ * mapa de páginas), de modo que las peticiones solapadas o encoladas se
+ * contabilizan correctamente en lugar de sumarse.
+ *
+ * Las estadísticas se acumulan al completar cada petición; los percentiles
+ * salen de una muestra uniforme de tamaño fijo (reservoir sampling), así que
+ * la memoria y el coste de getStatistics no crecen con la carga. Del
+ * historial solo se guardan las últimas HISTORY_LIMIT peticiones.
+ */
+class DiskSimulationClock {
+public:
+    static constexpr size_t HISTORY_LIMIT = 1 << 16;     // Peticiones consultables por índice
+    static constexpr size_t RESERVOIR_SIZE = 4096;       // Muestra para los percentiles
+
+private:
+    /**
+     * @brief Cola de una unidad del dispositivo
+     */
+    struct Actuator {
+        std::deque<size_t> queue;       // Índices de peticiones pendientes
+        bool busy = false;
+        double busy_time_ms = 0.0;
+    };
+
+    /**
+     * @brief Evento pendiente: llegada o finalización de una petición
+     */
+    struct Event {
+        double time_ms;
+        long long sequence;             // Desempate estable entre eventos simultáneos
+        bool is_completion;
+        size_t request;
+
+        bool operator>(const Event& other) const {
+            if (time_ms != other.time_ms) return time_ms > other.time_ms;
+            return sequence > other.sequence;
+        }
+    };
+
+    std::unique_ptr<DeviceModel> device;
+    SchedulingPolicy policy;
+    double now_ms;
+    long long next_sequence;
+    std::vector<Actuator> actuators;
+    std::deque<IORequest> requests;                      // Historial reciente; requests[0] tiene el índice `retired`
+    size_t retired;                                      // Peticiones ya descartadas del historial
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    size_t pending;
+    double first_arrival_ms;
+    double last_completion_ms;
+
+    // Agregados de las peticiones completadas
+    size_t completed_count;
+    size_t completed_reads;
+    double total_response_ms;
+    double total_queue_ms;
+    double max_response_ms;
+    size_t max_queue_depth;
+    std::vector<double> response_sample;
+    std::mt19937_64 sample_rng;
+
+public:
+    /**
+     * @brief Constructor
+     * @param disk_config Geometría y tiempos del disco
+     * @param surface_actuators Un actuador por superficie (si no, uno compartido)
+     */
+    explicit DiskSimulationClock(const DiskConfig& disk_config = DiskConfig(),
+                                 bool surface_actuators = false)
+        : policy(SchedulingPolicy::FCFS)
+    {
+        configure(disk_config, surface_actuators);
+    }
+
+    /**
+     * @brief Constructor con un modelo de dispositivo arbitrario
+     */
+    explicit DiskSimulationClock(std::unique_ptr<DeviceModel> device_model)
+        : policy(SchedulingPolicy::FCFS)
+    {
+        setDevice(std::move(device_model));
+    }
+
+    /**
+     * @brief Reinicia el reloj con un disco magnético de la configuración dada
+     */
+    void configure(const DiskConfig& disk_config, bool surface_actuators) {
+        setDevice(std::make_unique<MagneticDiskModel>(disk_config, surface_actuators));
+    }
+
+    /**
+     * @brief Reinicia el reloj sobre otro modelo de dispositivo
+     */
+    void setDevice(std::unique_ptr<DeviceModel> device_model) {
+        device = std::move(device_model);
+        reset();
+    }
+
+    /**
+     * @brief Vacía colas, estadísticas y devuelve el reloj y el dispositivo a cero
+     */
+    void reset() {
+        device->reset();
+        now_ms = 0.0;
+        next_sequence = 0;
+        actuators.assign(std::max(1, device->getParallelUnits()), Actuator());
+        requests.clear();
+        retired = 0;
+        events = decltype(events)();
+        pending = 0;
+        first_arrival_ms = -1.0;
+        last_completion_ms = 0.0;
+        completed_count = 0;
+        completed_reads = 0;
+        total_response_ms = 0.0;
+        total_queue_ms = 0.0;
+        max_response_ms = 0.0;
+        max_queue_depth = 0;
+        response_sample.clear();
+        sample_rng.seed(0);
+    }
+
+    void setSchedulingPolicy(SchedulingPolicy p) { policy = p; }
+    SchedulingPolicy getSchedulingPolicy() const { return policy; }
+    const DeviceModel& getDevice() const { return *device; }
+    double now() const { return now_ms; }
+    size_t getActuatorCount() const { return actuators.size(); }
+    size_t getPendingCount() const { return pending; }
+    const std::deque<IORequest>& getRequests() const { return requests; }
+
+    /**
+     * @brief Petición por índice; válida hasta que salga del historial (HISTORY_LIMIT envíos después)
+     */
+    const IORequest& getRequest(size_t index) const { return requests[index - retired]; }
+
+    /**
+     * @brief Encola la llegada de una petición
+     * @param arrival_ms Instante de llegada (no puede ser anterior al reloj)
+     * @return Índice de la petición para consultar sus tiempos
+     */
+    size_t submit(IOType type, const PhysicalAddress& address, double arrival_ms) {
+        // Se descarta solo al enviar, para que el índice devuelto siga siendo válido
+        while (requests.size() >= HISTORY_LIMIT && requests.front().completed) {
+            requests.pop_front();
+            retired++;
+        }
+
+        IORequest request;
+        request.id = static_cast<long long>(retired + requests.size());
+        request.type = type;
+        request.address = address;
+        request.actuator = std::min(std::max(device->unitFor(type, address), 0),
+                                    static_cast<int>(actuators.size()) - 1);
+        request.arrival_ms = std::max(arrival_ms, now_ms);
+        requests.push_back(request);
+
+        size_t index = static_cast<size_t>(request.id);
+        events.push({request.arrival_ms, next_sequence++, false, index});
+        pending++;
+        return index;
+    }
+
+    /**
+     * @brief Encola una petición que llega en el instante actual
+     */
+    size_t submit(IOType type, const PhysicalAddress& address) {
+        return submit(type, address, now_ms);
+    }
+
+    /**
+     * @brief Atiende una petición síncrona: llega ahora y se espera a que termine
+     * @return Tiempo de respuesta en ms
+     */
+    double serve(IOType type, const PhysicalAddress& address) {
+        size_t index = submit(type, address);
+        while (!getRequest(index).completed && step()) {
+        }
+        return getRequest(index).getResponseTime();
+    }
+
+    /**
+     * @brief Procesa eventos hasta el instante dado (inclusive)
+     */
+    void runUntil(double time_ms) {
+        while (!events.empty() && events.top().time_ms <= time_ms) {
+            step();
+        }
+        now_ms = std::max(now_ms, time_ms);
+    }
+
+    /**
+     * @brief Procesa eventos hasta que no quede ninguna petición pendiente
+     */
+    void runUntilIdle() {
+        while (step()) {
+        }
+    }
+
+    /**
+     * @brief Reejecuta una traza de peticiones sobre el dispositivo de este reloj
+     *
+     * Se mantienen como máximo `queue_depth` peticiones en vuelo: con 1 la carga
+     * es síncrona, con valores mayores se aprovechan las unidades paralelas.
+     */
+    IOStatistics replay(const std::deque<IORequest>& trace, size_t queue_depth = 1) {
+        reset();
+        queue_depth = std::max<size_t>(1, queue_depth);
+
+        for (const auto& request : trace) {
+            while (pending >= queue_depth && step()) {
+            }
+            submit(request.type, request.address);
+        }
+        runUntilIdle();
+        return getStatistics();
+    }
+
+    /**
+     * @brief Calcula las estadísticas de las peticiones completadas
+     *
+     * Medias, máximos y contadores son exactos; los percentiles son exactos
+     * hasta RESERVOIR_SIZE peticiones y estimados sobre la muestra a partir de ahí.
+     */
+    IOStatistics getStatistics() const {
+        IOStatistics stats;
+        stats.completed = completed_count;
+        if (stats.completed == 0) {
+            return stats;
+        }
+        stats.reads = completed_reads;
+        stats.writes = completed_count - completed_reads;
+        stats.max_queue_depth = max_queue_depth;
+
+        std::vector<double> responses(response_sample);
+        std::sort(responses.begin(), responses.end());
+
+        stats.elapsed_ms = last_completion_ms - std::max(0.0, first_arrival_ms);
+        stats.mean_response_ms = total_response_ms / stats.completed;
+        stats.mean_queue_ms = total_queue_ms / stats.completed;
+        stats.p50_response_ms = percentile(responses, 0.50);
+        stats.p95_response_ms = percentile(responses, 0.95);
+        stats.p99_response_ms = percentile(responses, 0.99);
+        stats.max_response_ms = max_response_ms;
+
+        if (stats.elapsed_ms > 0.0) {
+            double busy = 0.0;
+            for (const auto& actuator : actuators) busy += actuator.busy_time_ms;
+
+            stats.throughput_iops = stats.completed / (stats.elapsed_ms / 1000.0);
+            stats.throughput_mbps = (static_cast<double>(stats.completed) * device->getRequestSize() /
+                                     (1 << 20)) / (stats.elapsed_ms / 1000.0);
+            stats.utilization = busy / (stats.elapsed_ms * actuators.size());
+        }
+        return stats;
+    }
+
+    /**
+     * @brief Muestra las estadísticas de la simulación
+     */
+    void displayStatistics() const {
+        IOStatistics stats = getStatistics();
+
+        std::cout << "Peticiones completadas: " << stats.completed
+                  << " (lecturas: " << stats.reads << ", escrituras: " << stats.writes << ")" << std::endl;
+        std::cout << "Dispositivo: " << device->getName()
+                  << " | Unidades: " << actuators.size()
+                  << " | Política: " << (policy == SchedulingPolicy::FCFS ? "FCFS" : "SSTF") << std::endl;
+        std::cout << "Tiempo simulado: " << stats.elapsed_ms << " ms" << std::endl;
+        std::cout << "Throughput: " << stats.throughput_iops << " IOPS ("
+                  << stats.throughput_mbps << " MB/s)" << std::endl;
+        std::cout << "Utilización: " << (stats.utilization * 100.0) << "%" << std::endl;
+        std::cout << "Tiempo de respuesta medio: " << stats.mean_response_ms
+                  << " ms (espera en cola: " << stats.mean_queue_ms << " ms)" << std::endl;
+        std::cout << "Percentiles de respuesta: p50=" << stats.p50_response_ms
+                  << " p95=" << stats.p95_response_ms
+                  << " p99=" << stats.p99_response_ms
+                  << " max=" << stats.max_response_ms << " ms" << std::endl;
+        std::cout << "Profundidad máxima de cola: " << stats.max_queue_depth << std::endl;
+    }
+
+private:
+    /**
+     * @brief Procesa el siguiente evento
+     * @return false si no quedaban eventos
+     */
+    bool step() {
+        if (events.empty()) {
+            return false;
+        }
+
+        Event event = events.top();
+        events.pop();
+        now_ms = std::max(now_ms, event.time_ms);
+
+        IORequest& request = requests[event.request - retired];
+        Actuator& actuator = actuators[request.actuator];
+
+        if (event.is_completion) {
+            actuator.busy = false;
+            request.completed = true;
+            pending--;
+            last_completion_ms = std::max(last_completion_ms, request.completion_ms);
+            recordCompletion(request);
+        } else {
+            if (first_arrival_ms < 0.0) first_arrival_ms = request.arrival_ms;
+            request.queue_depth = actuator.queue.size() + (actuator.busy ? 1 : 0);
+            actuator.queue.push_back(event.request);
+        }
+
+        if (!actuator.busy && !actuator.queue.empty()) {
+            startNext(request.actuator);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Saca la siguiente petición de la cola del actuador y la sirve
+     */
+    void startNext(int actuator_index) {
+        Actuator& actuator = actuators[actuator_index];
+
+        auto chosen = actuator.queue.begin();
+        if (policy == SchedulingPolicy::SSTF) {
+            long long best_cost = -1;
+            for (auto it = actuator.queue.begin(); it != actuator.queue.end(); ++it) {
+                long long cost = device->positioningCost(actuator_index, requests[*it - retired].address);
+                if (best_cost < 0 || cost < best_cost) {
+                    best_cost = cost;
+                    chosen = it;
+                }
+            }
+        }
+
+        size_t index = *chosen;
+        actuator.queue.erase(chosen);
+
+        IORequest& request = requests[index - retired];
+        double service = device->service(actuator_index, request.type, request.address);
+        request.start_ms = now_ms;
+        request.completion_ms = now_ms + service;
+
+        actuator.busy = true;
+        actuator.busy_time_ms += service;
+
+        events.push({request.completion_ms, next_sequence++, true, index});
+    }
+
+    /**
+     * @brief Suma una petición completada a los agregados y a la muestra (algoritmo R)
+     */
+    void recordCompletion(const IORequest& request) {
+        double response = request.getResponseTime();
+        completed_count++;
+        if (request.type == IOType::READ) completed_reads++;
+        total_response_ms += response;
+        total_queue_ms += request.getQueueTime();
+        max_response_ms = std::max(max_response_ms, response);
+        max_queue_depth = std::max(max_queue_depth, request.queue_depth);
+
+        if (response_sample.size() < RESERVOIR_SIZE) {
+            response_sample.push_back(response);
+        } else {
+            size_t slot = std::uniform_int_distribution<size_t>(0, completed_count - 1)(sample_rng);
+            if (slot < RESERVOIR_SIZE) response_sample[slot] = response;
+        }
+    }
+
+    /**
+     * @brief Percentil por rango más cercano sobre un vector ordenado
+     */
+    static double percentile(const std::vector<double>& sorted, double fraction) {
+        size_t rank = static_cast<size_t>(fraction * sorted.size() + 0.999999);
+        rank = std::min(std::max<size_t>(rank, 1), sorted.size());
+        return sorted[rank - 1];
+    }
+};
+
+#endif // DISK_SIMULATION_CLOCK_H
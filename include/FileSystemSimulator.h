@@ -7,9 +7,11 @@
 #include <iostream>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
 #include "DiskConfig.h"
 #include "PhysicalAddress.h"
 #include "Block.h"
+#include "BlockCompressor.h"
 
 namespace fs = std::filesystem;
 
@@ -93,14 +95,7 @@ public:
      * @brief Verifica si una dirección física es válida
      */
     bool isValidAddress(const PhysicalAddress& address) const {
-        return address.getPlatter() >= 0 && 
-               address.getPlatter() < disk_config.getNumPlatters() &&
-               address.getSurface() >= 0 && 
-               address.getSurface() < disk_config.getSurfacesPerPlatter() &&
-               address.getTrack() >= 0 && 
-               address.getTrack() < disk_config.getTracksPerSurface() &&
-               address.getSector() >= 0 && 
-               address.getSector() < disk_config.getSectorsPerTrack();
+        return disk_config.isValidAddress(address);
     }
 
     /**
@@ -205,6 +200,114 @@ public:
         }
     }
 
+    /**
+     * @brief Ruta del archivo comprimido de un bloque del nivel frío
+     */
+    std::string getColdPath(const PhysicalAddress& address) const {
+        return base_path + "/cold/" + address.toString() + ".lz";
+    }
+
+    /**
+     * @brief Escribe un bloque comprimido en el nivel frío
+     *
+     * El sector conserva su dirección, pero su contenido pasa a cold/ y el
+     * archivo de sector sin comprimir se elimina.
+     */
+    bool writeColdBlock(const PhysicalAddress& address, const Block& block) {
+        if (!initialized || !isValidAddress(address)) {
+            return false;
+        }
+
+        try {
+            fs::create_directories(base_path + "/cold");
+            
+            std::ofstream file(getColdPath(address), std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::string compressed = BlockCompressor::compress(block.serialize());
+            file.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+            file.close();
+            
+            std::string sector_path = getFullPath(address);
+            if (fs::exists(sector_path)) {
+                fs::remove(sector_path);
+            }
+            return true;
+            
+        } catch (const std::exception& e) {
+            std::cerr << "Error escribiendo bloque frío: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    /**
+     * @brief Lee y descomprime un bloque del nivel frío
+     */
+    bool readColdBlock(const PhysicalAddress& address, Block& block) {
+        if (!initialized || !isValidAddress(address)) {
+            return false;
+        }
+
+        std::ifstream file(getColdPath(address), std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        
+        std::ostringstream content;
+        content << file.rdbuf();
+        
+        std::string data;
+        if (!BlockCompressor::decompress(content.str(), data)) {
+            std::cerr << "Bloque frío corrupto: " << address << std::endl;
+            return false;
+        }
+        return block.deserialize(data);
+    }
+
+    /**
+     * @brief Elimina la copia comprimida de un bloque
+     */
+    bool deleteColdBlock(const PhysicalAddress& address) {
+        try {
+            return fs::remove(getColdPath(address));
+        } catch (const std::exception& e) {
+            std::cerr << "Error eliminando bloque frío: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    /**
+     * @brief Tamaño en bytes de la copia comprimida de un bloque
+     */
+    long long getColdBlockSize(const PhysicalAddress& address) const {
+        std::error_code ec;
+        auto size = fs::file_size(getColdPath(address), ec);
+        return ec ? 0 : static_cast<long long>(size);
+    }
+
+    /**
+     * @brief Lista los bloques guardados en el nivel frío
+     */
+    std::vector<PhysicalAddress> getColdSectors() const {
+        std::vector<PhysicalAddress> cold;
+        std::string cold_path = base_path + "/cold";
+        
+        if (!initialized || !fs::exists(cold_path)) return cold;
+        
+        for (const auto& entry : fs::directory_iterator(cold_path)) {
+            PhysicalAddress addr;
+            if (entry.is_regular_file() && entry.path().extension() == ".lz" &&
+                PhysicalAddress::fromString(entry.path().stem().string(), addr) &&
+                isValidAddress(addr)) {
+                cold.push_back(addr);
+            }
+        }
+        
+        std::sort(cold.begin(), cold.end());
+        return cold;
+    }
+
     /**
      * @brief Lista todos los sectores ocupados
      */
@@ -216,10 +319,12 @@ public:
         try {
             for (int p = 0; p < disk_config.getNumPlatters(); ++p) {
                 for (int s = 0; s < disk_config.getSurfacesPerPlatter(); ++s) {
+                    std::string surface_path = base_path + "/platter_" + std::to_string(p) + 
+                                               "/surface_" + std::to_string(s);
+                    if (!fs::exists(surface_path)) continue;
+                    
                     for (int t = 0; t < disk_config.getTracksPerSurface(); ++t) {
-                        std::string track_path = base_path + "/platter_" + std::to_string(p) + 
-                                               "/surface_" + std::to_string(s) + 
-                                               "/track_" + std::to_string(t);
+                        std::string track_path = surface_path + "/track_" + std::to_string(t);
                         
                         if (fs::exists(track_path)) {
                             for (const auto& entry : fs::directory_iterator(track_path)) {
@@ -229,7 +334,10 @@ public:
                                     std::string filename = entry.path().stem().string();
                                     if (filename.find("sector_") == 0) {
                                         int sector_num = std::stoi(filename.substr(7));
-                                        occupied.emplace_back(p, s, t, sector_num);
+                                        PhysicalAddress addr(p, s, t, sector_num);
+                                        if (disk_config.isValidAddress(addr)) {
+                                            occupied.push_back(addr);
+                                        }
                                     }
                                 }
                             }
@@ -241,6 +349,9 @@ public:
             std::cerr << "Error listando sectores: " << e.what() << std::endl;
         }
         
+        // El orden de directory_iterator no está definido
+        std::sort(occupied.begin(), occupied.end());
+        
         return occupied;
     }
 
@@ -347,10 +458,14 @@ private:
             return false;
         }
         
-        // Aquí se implementaría la carga de configuración desde archivo
-        // Por simplicidad, usamos configuración por defecto
-        disk_config = DiskConfig();
+        // La geometría guardada determina el espacio de direcciones a recorrer
+        DiskConfig loaded;
+        if (!loaded.loadFromFile(config_path)) {
+            std::cerr << "Configuración del disco inválida: " << config_path << std::endl;
+            return false;
+        }
         
+        disk_config = loaded;
         return true;
     }
 
@@ -361,8 +476,12 @@ private:
         auto now = std::chrono::system_clock::now();
         auto time_t = std::chrono::system_clock::to_time_t(now);
         
+        // localtime_r: los hilos de fondo también escriben sectores
+        std::tm local_time{};
+        localtime_r(&time_t, &local_time);
+        
         std::ostringstream oss;
-        oss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
+        oss << std::put_time(&local_time, "%Y-%m-%d %H:%M:%S");
         return oss.str();
     }
 
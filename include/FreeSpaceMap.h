@@ -0,0 +1,276 @@
+#ifndef FREE_SPACE_MAP_H
+#define FREE_SPACE_MAP_H
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "PhysicalAddress.h"
+
+/**
+ * @brief Mapa de espacio libre de una tabla heap, seguro para varios insertores
+ *
+ * Guarda los bytes libres de cada bloque por su posición en la relación.
+ * Reservar es un CAS sobre el contador del bloque, sin cerrojos, y quien lo
+ * consigue tiene el hueco garantizado. Cada insertor usa una ranura con su
+ * bloque preferido, del que es dueño mientras le quepan filas: al buscar,
+ * nadie elige un bloque con dueño, así que cada bloque lo escribe un solo
+ * hilo a la vez y varios hilos llenan bloques distintos. Las entradas viven
+ * en trozos que nunca se mueven, colgados de segmentos que se crean al
+ * crecer la tabla, así que publicar un bloque no detiene a los que buscan;
+ * una entrada aún sin publicar tiene 0 bytes libres. Caben CAPACITY
+ * bloques; más allá publish devuelve false y el llamador debe rechazar la
+ * inserción.
+ *
+ * La búsqueda empieza en `first_candidate`, que avanza sobre los bloques
+ * sin dueño demasiado llenos para la fila pedida y retrocede al liberar
+ * espacio. Con filas de tamaños muy distintos puede saltarse un hueco útil
+ * para una fila menor: nunca da un hueco falso, a lo sumo desperdicia uno.
+ */
+class FreeSpaceMap {
+public:
+    static constexpr size_t NONE = static_cast<size_t>(-1);
+    static constexpr size_t CHUNK_BLOCKS = 1024;
+    static constexpr size_t SEGMENT_CHUNKS = 1024;
+    static constexpr size_t MAX_SEGMENTS = 1024;
+    static constexpr size_t CAPACITY = CHUNK_BLOCKS * SEGMENT_CHUNKS * MAX_SEGMENTS;   // ~1G bloques por tabla
+    static constexpr size_t SLOTS = 64;                // Insertores con bloque preferido propio
+
+private:
+    struct Entry {
+        std::atomic<uint32_t> free{0};
+        std::atomic<uint32_t> owner{0};                 // Ranura + 1 del dueño, 0 si no tiene
+    };
+    using Chunk = std::array<Entry, CHUNK_BLOCKS>;
+    using Segment = std::array<std::atomic<Chunk*>, SEGMENT_CHUNKS>;
+
+    std::array<std::atomic<Segment*>, MAX_SEGMENTS> segments;
+    std::atomic<size_t> block_count{0};
+    std::atomic<size_t> first_candidate{0};
+    std::array<std::atomic<size_t>, SLOTS> preferred;
+
+public:
+    FreeSpaceMap() {
+        for (auto& segment : segments) segment.store(nullptr, std::memory_order_relaxed);
+        for (auto& position : preferred) position.store(NONE, std::memory_order_relaxed);
+    }
+
+    ~FreeSpaceMap() {
+        for (auto& slot : segments) {
+            Segment* segment = slot.load(std::memory_order_relaxed);
+            if (!segment) continue;
+            for (auto& chunk : *segment) delete chunk.load(std::memory_order_relaxed);
+            delete segment;
+        }
+    }
+
+    FreeSpaceMap(const FreeSpaceMap&) = delete;
+    FreeSpaceMap& operator=(const FreeSpaceMap&) = delete;
+
+    size_t getBlockCount() const { return block_count.load(std::memory_order_acquire); }
+
+    uint32_t getFree(size_t position) const {
+        const Entry* entry = find(position);
+        return entry ? entry->free.load(std::memory_order_acquire) : 0;
+    }
+
+    /**
+     * @brief Publica el bloque de `position` con `free` bytes libres
+     * @param slot Si se indica, el bloque pasa a ser el preferido de esa ranura
+     * @return false si `position` no cabe en el mapa (CAPACITY)
+     */
+    bool publish(size_t position, uint32_t free, size_t slot = NONE) {
+        Entry* entry = findOrCreate(position);
+        if (!entry) return false;
+        if (slot != NONE) {
+            slot %= SLOTS;
+            entry->owner.store(static_cast<uint32_t>(slot + 1), std::memory_order_relaxed);
+            disown(slot, preferred[slot].exchange(position, std::memory_order_relaxed));
+        }
+        entry->free.store(free, std::memory_order_release);
+
+        size_t count = block_count.load(std::memory_order_relaxed);
+        while (count <= position &&
+               !block_count.compare_exchange_weak(count, position + 1, std::memory_order_release)) {
+        }
+        return true;
+    }
+
+    /**
+     * @brief Corrige los bytes libres de un bloque ya publicado (actualización, borrado o error de reserva)
+     */
+    void setFree(size_t position, uint32_t free) {
+        Entry* entry = find(position);
+        if (!entry) return;
+        entry->free.store(free, std::memory_order_release);
+        size_t first = first_candidate.load(std::memory_order_relaxed);
+        while (free > 0 && position < first &&
+               !first_candidate.compare_exchange_weak(first, position, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Reserva `bytes` en el preferido de la ranura o en el primer bloque libre sin dueño
+     * @return Posición del bloque, o NONE si hay que añadir uno
+     */
+    size_t reserve(uint32_t bytes, size_t slot = 0) {
+        slot %= SLOTS;
+        uint32_t self = static_cast<uint32_t>(slot + 1);
+        size_t count = block_count.load(std::memory_order_acquire);
+
+        size_t mine = preferred[slot].load(std::memory_order_relaxed);
+        if (mine < count) {
+            if (tryReserve(*find(mine), bytes)) return mine;
+            disown(slot, preferred[slot].exchange(NONE, std::memory_order_relaxed));
+        }
+
+        size_t start = first_candidate.load(std::memory_order_relaxed);
+        size_t skipped = start;                         // Prefijo de bloques sin dueño y llenos
+        for (size_t position = start; position < count; ++position) {
+            Entry* entry = find(position);
+            if (!entry) continue;                       // Trozo de un bloque aún sin publicar
+            uint32_t owner = entry->owner.load(std::memory_order_relaxed);
+            bool fits = entry->free.load(std::memory_order_relaxed) >= bytes;
+            if (owner == 0 && fits && entry->owner.compare_exchange_strong(owner, self, std::memory_order_acquire)) {
+                if (tryReserve(*entry, bytes)) {
+                    preferred[slot].store(position, std::memory_order_relaxed);
+                    return position;
+                }
+                entry->owner.store(0, std::memory_order_release);
+            }
+            if (skipped == position && owner == 0 && !fits) skipped = position + 1;
+        }
+        if (skipped > start) first_candidate.compare_exchange_strong(start, skipped, std::memory_order_relaxed);
+        return NONE;
+    }
+
+    /**
+     * @brief Suelta los bloques preferidos de todas las ranuras (al acabar una carga paralela)
+     */
+    void releaseSlots() {
+        for (size_t slot = 0; slot < SLOTS; ++slot) {
+            disown(slot, preferred[slot].exchange(NONE, std::memory_order_relaxed));
+        }
+    }
+
+private:
+    static bool tryReserve(Entry& entry, uint32_t bytes) {
+        uint32_t free = entry.free.load(std::memory_order_relaxed);
+        while (free >= bytes) {
+            if (entry.free.compare_exchange_weak(free, free - bytes, std::memory_order_acquire)) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Deja sin dueño un bloque de la ranura; sus escrituras quedan visibles para el siguiente
+     */
+    void disown(size_t slot, size_t position) {
+        if (position == NONE) return;
+        Entry* entry = find(position);
+        uint32_t self = static_cast<uint32_t>(slot + 1);
+        if (entry) entry->owner.compare_exchange_strong(self, 0, std::memory_order_release);
+    }
+
+    Entry* find(size_t position) const {
+        if (position >= CAPACITY) return nullptr;
+        size_t chunk_number = position / CHUNK_BLOCKS;
+        Segment* segment = segments[chunk_number / SEGMENT_CHUNKS].load(std::memory_order_acquire);
+        if (!segment) return nullptr;
+        Chunk* chunk = (*segment)[chunk_number % SEGMENT_CHUNKS].load(std::memory_order_acquire);
+        return chunk ? &(*chunk)[position % CHUNK_BLOCKS] : nullptr;
+    }
+
+    /**
+     * @brief Puntero publicado en `slot`, creándolo con CAS si falta (si otro hilo gana, se usa el suyo)
+     */
+    template <typename T>
+    static T* getOrCreate(std::atomic<T*>& slot) {
+        T* current = slot.load(std::memory_order_acquire);
+        if (current) return current;
+        T* fresh = new T();
+        if (slot.compare_exchange_strong(current, fresh, std::memory_order_acq_rel)) return fresh;
+        delete fresh;
+        return current;
+    }
+
+    Entry* findOrCreate(size_t position) {
+        if (position >= CAPACITY) return nullptr;
+        size_t chunk_number = position / CHUNK_BLOCKS;
+        Segment* segment = getOrCreate(segments[chunk_number / SEGMENT_CHUNKS]);
+        Chunk* chunk = getOrCreate((*segment)[chunk_number % SEGMENT_CHUNKS]);
+        return &(*chunk)[position % CHUNK_BLOCKS];
+    }
+};
+
+/**
+ * @brief Direcciones de bloques nuevos repartidas entre hilos por extensiones
+ *
+ * Tomar una dirección es un fetch_add sobre un índice. Solo cuando la
+ * extensión publicada se agota, un hilo pide `extent_blocks` direcciones al
+ * asignador (que no es concurrente) bajo un mutex; los demás siguen tomando
+ * las ya publicadas. La capacidad se fija al construir, así que el vector
+ * nunca se mueve. Si el asignador se queda sin espacio, la cola se da por
+ * agotada y toda toma posterior devuelve NONE.
+ */
+class BlockExtentQueue {
+public:
+    static constexpr size_t NONE = static_cast<size_t>(-1);
+
+private:
+    std::vector<PhysicalAddress> addresses;
+    size_t extent_blocks;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> filled{0};
+    std::atomic<bool> exhausted{false};
+    std::mutex refill_mutex;
+
+public:
+    BlockExtentQueue(size_t capacity, size_t extent) : addresses(capacity), extent_blocks(std::max<size_t>(extent, 1)) {}
+
+    /**
+     * @brief Índice de la siguiente dirección, o NONE si se agotó la capacidad o el disco
+     * @param allocate `bool(PhysicalAddress&)`, false si no quedan bloques
+     */
+    template <typename Allocate>
+    size_t take(Allocate allocate) {
+        size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= addresses.size()) return NONE;
+        if (index >= filled.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(refill_mutex);
+            size_t ready = filled.load(std::memory_order_relaxed);
+            while (ready <= index && !exhausted.load(std::memory_order_relaxed)) {
+                size_t end = std::min(addresses.size(), ready + extent_blocks);
+                for (; ready < end; ++ready) {
+                    if (!allocate(addresses[ready])) {
+                        exhausted.store(true, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+                filled.store(ready, std::memory_order_release);
+            }
+            if (ready <= index) return NONE;
+        }
+        return index;
+    }
+
+    bool isExhausted() const { return exhausted.load(std::memory_order_acquire); }
+
+    const PhysicalAddress& address(size_t index) const { return addresses[index]; }
+
+    size_t getTakenCount() const {
+        return std::min(next.load(std::memory_order_acquire), filled.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief Direcciones asignadas que nadie tomó, en orden de asignación
+     */
+    std::vector<PhysicalAddress> unusedAddresses() const {
+        return std::vector<PhysicalAddress>(addresses.begin() + getTakenCount(),
+                                            addresses.begin() + filled.load(std::memory_order_acquire));
+    }
+};
+
+#endif // FREE_SPACE_MAP_H
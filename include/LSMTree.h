@@ -0,0 +1,844 @@
+#ifndef LSM_TREE_H
+#define LSM_TREE_H
+
+#include <map>
+#include <set>
+#include <queue>
+#include <tuple>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include "Block.h"
+#include "Record.h"
+#include "BloomFilter.h"
+#include "WriteAheadLog.h"
+#include "FileSystemSimulator.h"
+
+/**
+ * @brief Política de compactación de un árbol LSM
+ *
+ * LEVELED: cada nivel (salvo el 0) es una sola secuencia ordenada y se
+ * fusiona con el siguiente al superar su capacidad; lecturas baratas.
+ * TIERED: cada nivel acumula `size_ratio` secuencias antes de fusionarlas
+ * en una del nivel siguiente; menos reescritura por inserción.
+ */
+enum class CompactionPolicy {
+    LEVELED,
+    TIERED
+};
+
+inline std::string compactionPolicyToString(CompactionPolicy policy) {
+    return policy == CompactionPolicy::TIERED ? "TIERED" : "LEVELED";
+}
+
+inline CompactionPolicy compactionPolicyFromString(const std::string& text) {
+    return text == "TIERED" ? CompactionPolicy::TIERED : CompactionPolicy::LEVELED;
+}
+
+/**
+ * @brief Parámetros de una relación LSM
+ */
+struct LSMOptions {
+    CompactionPolicy policy = CompactionPolicy::LEVELED;
+    size_t memtable_limit = 256;        // Entradas en memoria antes de volcar
+    size_t size_ratio = 4;              // Factor entre niveles / secuencias por nivel
+};
+
+/**
+ * @brief Contadores de actividad de un árbol LSM
+ */
+struct LSMStatistics {
+    size_t flushes = 0;
+    size_t flushed_blocks = 0;
+    size_t compactions = 0;
+    size_t compaction_read_blocks = 0;
+    size_t compaction_written_blocks = 0;
+    size_t dropped_entries = 0;         // Versiones antiguas y tombstones descartados
+    size_t lookups = 0;
+    size_t bloom_skips = 0;             // Secuencias descartadas por su filtro
+    size_t bloom_false_positives = 0;
+    double compaction_ms = 0.0;         // Tiempo real del hilo de compactación
+    double compaction_io_ms = 0.0;      // Tiempo de E/S simulado de las compactaciones
+};
+
+/**
+ * @brief Memtable: lista de saltos ordenada por ID de registro
+ *
+ * Un tombstone es un registro marcado como eliminado; sustituye a cualquier
+ * versión anterior de la misma clave igual que una inserción.
+ */
+class SkipListMemtable {
+private:
+    static constexpr int MAX_LEVEL = 16;
+
+    struct Node {
+        int key;
+        std::shared_ptr<Record> value;
+        std::vector<Node*> next;
+
+        Node(int k, std::shared_ptr<Record> v, int levels)
+            : key(k), value(std::move(v)), next(levels, nullptr) {}
+    };
+
+    Node head;
+    std::vector<std::unique_ptr<Node>> nodes;  // Propietario de los nodos
+    int levels;
+    std::mt19937 rng;
+
+public:
+    SkipListMemtable() : head(0, nullptr, MAX_LEVEL), levels(1), rng(0x5eed) {}
+
+    SkipListMemtable(const SkipListMemtable&) = delete;
+    SkipListMemtable& operator=(const SkipListMemtable&) = delete;
+
+    /**
+     * @brief Inserta o sustituye la entrada de la clave del registro
+     */
+    void put(const std::shared_ptr<Record>& record) {
+        int key = record->getId();
+        Node* update[MAX_LEVEL];
+        Node* node = &head;
+
+        for (int level = levels - 1; level >= 0; --level) {
+            while (node->next[level] && node->next[level]->key < key) {
+                node = node->next[level];
+            }
+            update[level] = node;
+        }
+
+        Node* existing = node->next[0];
+        if (existing && existing->key == key) {
+            existing->value = record;
+            return;
+        }
+
+        int height = randomHeight();
+        for (int level = levels; level < height; ++level) {
+            update[level] = &head;
+        }
+        levels = std::max(levels, height);
+
+        nodes.push_back(std::make_unique<Node>(key, record, height));
+        Node* inserted = nodes.back().get();
+        for (int level = 0; level < height; ++level) {
+            inserted->next[level] = update[level]->next[level];
+            update[level]->next[level] = inserted;
+        }
+    }
+
+    /**
+     * @brief Entrada de la clave (puede ser un tombstone) o nullptr
+     */
+    std::shared_ptr<Record> get(int key) const {
+        const Node* node = &head;
+        for (int level = levels - 1; level >= 0; --level) {
+            while (node->next[level] && node->next[level]->key < key) {
+                node = node->next[level];
+            }
+        }
+        node = node->next[0];
+        return (node && node->key == key) ? node->value : nullptr;
+    }
+
+    /**
+     * @brief Entradas en orden de clave
+     */
+    std::vector<std::shared_ptr<Record>> entries() const {
+        std::vector<std::shared_ptr<Record>> result;
+        result.reserve(nodes.size());
+        for (const Node* node = head.next[0]; node; node = node->next[0]) {
+            result.push_back(node->value);
+        }
+        return result;
+    }
+
+    size_t size() const { return nodes.size(); }
+    bool empty() const { return nodes.empty(); }
+
+    void clear() {
+        nodes.clear();
+        std::fill(head.next.begin(), head.next.end(), nullptr);
+        levels = 1;
+    }
+
+private:
+    int randomHeight() {
+        int height = 1;
+        while (height < MAX_LEVEL && (rng() & 3) == 0) {  // p = 1/4
+            height++;
+        }
+        return height;
+    }
+};
+
+/**
+ * @brief Secuencia ordenada inmutable escrita en bloques consecutivos
+ */
+struct SortedRun {
+    int id = 0;
+    int level = 0;
+    size_t entries = 0;
+    int min_key = 0;
+    int max_key = 0;
+    std::vector<PhysicalAddress> blocks;
+    std::vector<int> fences;            // Primera clave de cada bloque
+    BloomFilter bloom;
+
+    /**
+     * @brief Índice del único bloque que puede contener la clave (-1 si ninguno)
+     */
+    int locateBlock(int key) const {
+        if (blocks.empty() || key < min_key || key > max_key) {
+            return -1;
+        }
+        auto it = std::upper_bound(fences.begin(), fences.end(), key);
+        return static_cast<int>(it - fences.begin()) - 1;
+    }
+};
+
+/**
+ * @brief Trabajo de compactación que ejecuta el hilo de fondo
+ *
+ * Las direcciones de salida y sus LSN se reservan en el hilo principal; el
+ * hilo de fondo solo lee sectores de secuencias inmutables y escribe en las
+ * direcciones reservadas, así que no toca ninguna estructura compartida.
+ */
+struct CompactionJob {
+    std::vector<SortedRun> inputs;      // De la más reciente a la más antigua
+    int target_level = 1;
+    int output_id = 0;
+    bool drop_tombstones = false;
+    std::vector<PhysicalAddress> reserved;
+    long long first_lsn = 0;            // LSN de reserved[i] = first_lsn + i
+
+    // Resultado
+    bool ok = false;
+    SortedRun output;
+    size_t blocks_read = 0;
+    size_t dropped = 0;
+    double elapsed_ms = 0.0;
+
+    size_t inputBlockCount() const {
+        size_t count = 0;
+        for (const auto& run : inputs) count += run.blocks.size();
+        return count;
+    }
+};
+
+/**
+ * @brief Organización LSM de una relación
+ *
+ * Las inserciones y los borrados van al WAL propio de la tabla y a la
+ * memtable; al llenarse, la memtable se vuelca como una secuencia ordenada en
+ * bloques contiguos (escritura secuencial) y un hilo de fondo fusiona las
+ * secuencias según la política. El manifiesto `metadata/lsm_<tabla>.txt`
+ * enumera las secuencias vivas: un bloque de la relación que no figure en él
+ * es un resto de un volcado o compactación interrumpidos.
+ */
+class LSMTree {
+private:
+    using SteadyClock = std::chrono::steady_clock;
+
+    std::string table_name;
+    std::string metadata_path;
+    FileSystemSimulator& filesystem;
+    size_t block_size;
+    std::vector<FieldDefinition> schema;
+    bool fixed_records;
+    LSMOptions options;
+
+    SkipListMemtable memtable;
+    WriteAheadLog memtable_log;
+    std::vector<SortedRun> runs;        // Por nivel y, dentro del nivel, más reciente primero
+    int next_run_id;
+    LSMStatistics stats;
+
+    std::thread worker;
+    std::atomic<bool> job_done{false};
+    std::unique_ptr<CompactionJob> job;
+
+public:
+    LSMTree(const std::string& table, const std::string& metadata_dir,
+            FileSystemSimulator& fs_simulator, size_t bytes_per_block,
+            const std::vector<FieldDefinition>& table_schema, bool use_fixed_records)
+        : table_name(table)
+        , metadata_path(metadata_dir)
+        , filesystem(fs_simulator)
+        , block_size(bytes_per_block)
+        , schema(table_schema)
+        , fixed_records(use_fixed_records)
+        , next_run_id(1)
+    {
+    }
+
+    ~LSMTree() {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    LSMTree(const LSMTree&) = delete;
+    LSMTree& operator=(const LSMTree&) = delete;
+
+    /**
+     * @brief Crea un árbol vacío con las opciones indicadas
+     */
+    bool create(const LSMOptions& lsm_options) {
+        options = lsm_options;
+        options.memtable_limit = std::max<size_t>(1, options.memtable_limit);
+        options.size_ratio = std::max<size_t>(2, options.size_ratio);
+        return saveManifest() && memtable_log.open(getLogPath()) && memtable_log.rewrite({});
+    }
+
+    /**
+     * @brief Carga el manifiesto y rehace la memtable desde su log
+     */
+    bool open() {
+        if (!loadManifest() || !memtable_log.open(getLogPath())) {
+            return false;
+        }
+        for (const auto& entry : memtable_log.readAll()) {
+            auto record = parseRecord(entry.payload);
+            if (record) {
+                prepareRecord(record);
+                memtable.put(record);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Registra una inserción o un tombstone
+     */
+    bool put(const std::shared_ptr<Record>& record) {
+        if (memtable_log.append(table_name, PhysicalAddress(), record->serialize()) == 0) {
+            return false;
+        }
+        memtable.put(record);
+        return true;
+    }
+
+    bool needsFlush() const { return memtable.size() >= options.memtable_limit; }
+
+    /**
+     * @brief Entrada de la memtable para la clave
+     * @return true si la memtable decide (registro vivo o tombstone)
+     */
+    bool lookupMemtable(int key, std::shared_ptr<Record>& record) const {
+        record = memtable.get(key);
+        return record != nullptr;
+    }
+
+    std::vector<std::shared_ptr<Record>> memtableEntries() const { return memtable.entries(); }
+    size_t getMemtableSize() const { return memtable.size(); }
+
+    /**
+     * @brief Bloques que pueden contener la clave, del más reciente al más antiguo
+     *
+     * Las secuencias se descartan por rango y por filtro de Bloom; de cada
+     * secuencia restante las claves frontera eligen un único bloque.
+     */
+    std::vector<PhysicalAddress> candidateBlocks(int key) {
+        std::vector<PhysicalAddress> candidates;
+        stats.lookups++;
+
+        for (const auto& run : runs) {
+            int index = run.locateBlock(key);
+            if (index < 0) continue;
+            if (!run.bloom.mayContain(key)) {
+                stats.bloom_skips++;
+                continue;
+            }
+            candidates.push_back(run.blocks[index]);
+        }
+        return candidates;
+    }
+
+    void noteFalsePositive() { stats.bloom_false_positives++; }
+    void addCompactionIO(double ms) { stats.compaction_io_ms += ms; }
+
+    /**
+     * @brief Reparte registros ordenados en bloques llenos
+     * @param next_address Proporciona la dirección de cada bloque nuevo
+     * @return false si se agotaron las direcciones
+     */
+    bool packRecords(const std::vector<std::shared_ptr<Record>>& records,
+                     const std::function<bool(PhysicalAddress&)>& next_address,
+                     std::vector<std::shared_ptr<Block>>& blocks) const {
+        std::shared_ptr<Block> current;
+        for (const auto& record : records) {
+            if (!current || !current->canFit(record)) {
+                PhysicalAddress addr;
+                if (!next_address(addr)) {
+                    return false;
+                }
+                current = std::make_shared<Block>(addr, block_size);
+                current->setRelationName(table_name);
+                blocks.push_back(current);
+            }
+            current->addRecord(record);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Registra una secuencia recién volcada y vacía la memtable
+     *
+     * Los bloques ya deben estar escritos: el manifiesto se publica primero y
+     * solo después se trunca el log, así que una caída intermedia solo repite
+     * entradas que la secuencia ya contiene.
+     */
+    bool installFlush(const std::vector<std::shared_ptr<Block>>& blocks) {
+        std::vector<SortedRun> installed = runs;
+        installed.push_back(makeRun(next_run_id, 0, blocks));
+        sortRuns(installed);
+        next_run_id++;
+        if (!saveManifest(installed)) {
+            next_run_id--;
+            return false;
+        }
+        runs = std::move(installed);
+
+        memtable.clear();
+        stats.flushes++;
+        stats.flushed_blocks += blocks.size();
+        return memtable_log.rewrite({});
+    }
+
+    /**
+     * @brief Elige las secuencias a fusionar según la política
+     * @param full Fusionar todas las secuencias en una sola (compactación manual)
+     */
+    bool planCompaction(CompactionJob& plan, bool full) const {
+        if (runs.empty()) {
+            return false;
+        }
+
+        int deepest = runs.back().level;
+        plan = CompactionJob();
+
+        if (full) {
+            plan.inputs = runs;
+            plan.target_level = std::max(1, deepest);
+        } else if (options.policy == CompactionPolicy::TIERED) {
+            for (int level = 0; level <= deepest && plan.inputs.empty(); ++level) {
+                if (runsInLevel(level) >= options.size_ratio) {
+                    collectLevel(level, plan.inputs);
+                    plan.target_level = level + 1;
+                }
+            }
+        } else {
+            if (runsInLevel(0) >= options.size_ratio) {
+                collectLevel(0, plan.inputs);
+                collectLevel(1, plan.inputs);
+                plan.target_level = 1;
+            }
+            for (int level = 1; level <= deepest && plan.inputs.empty(); ++level) {
+                if (entriesInLevel(level) > levelCapacity(level)) {
+                    collectLevel(level, plan.inputs);
+                    collectLevel(level + 1, plan.inputs);
+                    plan.target_level = level + 1;
+                }
+            }
+        }
+
+        if (plan.inputs.empty()) {
+            return false;
+        }
+
+        // Los tombstones solo pueden desaparecer si no queda nada más antiguo debajo
+        plan.drop_tombstones = true;
+        for (const auto& run : runs) {
+            bool is_input = std::any_of(plan.inputs.begin(), plan.inputs.end(),
+                                        [&run](const SortedRun& input) { return input.id == run.id; });
+            if (!is_input && run.level >= plan.target_level) {
+                plan.drop_tombstones = false;
+            }
+        }
+        return true;
+    }
+
+    bool isCompacting() const { return job != nullptr; }
+    bool compactionFinished() const { return job != nullptr && job_done; }
+
+    /**
+     * @brief Lanza la fusión en el hilo de fondo
+     */
+    void startCompaction(CompactionJob planned) {
+        planned.output_id = next_run_id++;
+        job = std::make_unique<CompactionJob>(std::move(planned));
+        job_done = false;
+        worker = std::thread(&LSMTree::runCompaction, this, job.get());
+    }
+
+    /**
+     * @brief Espera a la compactación en curso y devuelve su resultado
+     */
+    std::unique_ptr<CompactionJob> takeCompaction() {
+        if (worker.joinable()) {
+            worker.join();
+        }
+        return std::move(job);
+    }
+
+    /**
+     * @brief Sustituye las secuencias de entrada por la fusionada
+     *
+     * Todo o nada: el manifiesto nuevo se publica antes de tocar las
+     * secuencias en memoria, y si no se pudo escribir el árbol sigue con las
+     * de entrada (las del manifiesto anterior).
+     */
+    bool installCompaction(const CompactionJob& finished) {
+        std::vector<SortedRun> remaining;
+        for (const auto& run : runs) {
+            bool is_input = std::any_of(finished.inputs.begin(), finished.inputs.end(),
+                                        [&run](const SortedRun& input) { return input.id == run.id; });
+            if (!is_input) {
+                remaining.push_back(run);
+            }
+        }
+        if (finished.output.entries > 0) {
+            remaining.push_back(finished.output);
+        }
+        sortRuns(remaining);
+        if (!saveManifest(remaining)) {
+            return false;
+        }
+        runs = std::move(remaining);
+
+        stats.compactions++;
+        stats.compaction_read_blocks += finished.blocks_read;
+        stats.compaction_written_blocks += finished.output.blocks.size();
+        stats.dropped_entries += finished.dropped;
+        stats.compaction_ms += finished.elapsed_ms;
+        return true;
+    }
+
+    const std::vector<SortedRun>& getRuns() const { return runs; }
+    const LSMOptions& getOptions() const { return options; }
+    const LSMStatistics& getStatistics() const { return stats; }
+
+    /**
+     * @brief Todas las direcciones de las secuencias vivas
+     */
+    std::set<PhysicalAddress> getLiveBlocks() const {
+        std::set<PhysicalAddress> live;
+        for (const auto& run : runs) {
+            live.insert(run.blocks.begin(), run.blocks.end());
+        }
+        return live;
+    }
+
+    /**
+     * @brief Completa un registro leído de disco con el esquema de la tabla
+     */
+    void prepareRecord(const std::shared_ptr<Record>& record) const {
+        if (record->isDeleted()) return;
+        record->setSchema(schema);
+        if (fixed_records) {
+            auto fixed = std::dynamic_pointer_cast<FixedRecord>(record);
+            if (fixed) fixed->calculateFixedSize();
+        }
+    }
+
+    static std::shared_ptr<Record> parseRecord(const std::string& data) {
+        std::shared_ptr<Record> record;
+        if (data.find("FIXED|") == 0) {
+            record = std::make_shared<FixedRecord>();
+        } else if (data.find("VARIABLE|") == 0) {
+            record = std::make_shared<VariableRecord>();
+        }
+        return (record && record->deserialize(data)) ? record : nullptr;
+    }
+
+    /**
+     * @brief Muestra niveles, secuencias y contadores
+     */
+    void displayStatistics() const {
+        std::cout << "\n=== ÁRBOL LSM: " << table_name << " ===" << std::endl;
+        std::cout << "Política: " << compactionPolicyToString(options.policy)
+                  << " | Memtable: " << memtable.size() << "/" << options.memtable_limit
+                  << " | Factor: " << options.size_ratio
+                  << (isCompacting() ? " | compactando" : "") << std::endl;
+
+        for (const auto& run : runs) {
+            std::cout << "  L" << run.level << " secuencia " << run.id << ": "
+                      << run.entries << " entradas, " << run.blocks.size() << " bloques, claves ["
+                      << run.min_key << ", " << run.max_key << "]" << std::endl;
+        }
+
+        std::cout << "Volcados: " << stats.flushes << " (" << stats.flushed_blocks << " bloques)"
+                  << " | Compactaciones: " << stats.compactions << " (" << stats.compaction_read_blocks
+                  << " leídos, " << stats.compaction_written_blocks << " escritos, "
+                  << stats.dropped_entries << " entradas descartadas)" << std::endl;
+        if (stats.flushed_blocks > 0) {
+            double amplification = static_cast<double>(stats.flushed_blocks + stats.compaction_written_blocks) /
+                                   stats.flushed_blocks;
+            std::cout << "Amplificación de escritura: " << amplification << "x" << std::endl;
+        }
+        std::cout << "Búsquedas: " << stats.lookups << " | Descartes por Bloom: " << stats.bloom_skips
+                  << " | Falsos positivos: " << stats.bloom_false_positives << std::endl;
+        std::cout << "Compactación: " << stats.compaction_ms << " ms reales, "
+                  << stats.compaction_io_ms << " ms de E/S simulada" << std::endl;
+    }
+
+private:
+    std::string getManifestPath() const { return metadata_path + "/lsm_" + table_name + ".txt"; }
+    std::string getLogPath() const { return metadata_path + "/lsm_" + table_name + ".wal"; }
+
+    size_t runsInLevel(int level) const {
+        return static_cast<size_t>(std::count_if(runs.begin(), runs.end(),
+                                                 [level](const SortedRun& run) { return run.level == level; }));
+    }
+
+    size_t entriesInLevel(int level) const {
+        size_t entries = 0;
+        for (const auto& run : runs) {
+            if (run.level == level) entries += run.entries;
+        }
+        return entries;
+    }
+
+    /**
+     * @brief Capacidad en entradas del nivel (política por niveles)
+     */
+    size_t levelCapacity(int level) const {
+        size_t capacity = options.memtable_limit;
+        for (int i = 0; i < level; ++i) capacity *= options.size_ratio;
+        return capacity;
+    }
+
+    void collectLevel(int level, std::vector<SortedRun>& inputs) const {
+        for (const auto& run : runs) {
+            if (run.level == level) inputs.push_back(run);
+        }
+    }
+
+    /**
+     * @brief Orden de búsqueda: niveles superiores y secuencias recientes primero
+     */
+    static void sortRuns(std::vector<SortedRun>& ordered) {
+        std::sort(ordered.begin(), ordered.end(), [](const SortedRun& a, const SortedRun& b) {
+            return a.level != b.level ? a.level < b.level : a.id > b.id;
+        });
+    }
+
+    SortedRun makeRun(int id, int level, const std::vector<std::shared_ptr<Block>>& blocks) const {
+        SortedRun run;
+        run.id = id;
+        run.level = level;
+        for (const auto& block : blocks) {
+            run.entries += block->getRecordCount();
+        }
+
+        run.bloom = BloomFilter(run.entries);
+        for (const auto& block : blocks) {
+            const auto& records = block->getAllRecords();
+            if (records.empty()) continue;
+
+            run.blocks.push_back(block->getAddress());
+            run.fences.push_back(records.front()->getId());
+            for (const auto& record : records) {
+                run.bloom.add(record->getId());
+            }
+        }
+        if (!blocks.empty() && !run.blocks.empty()) {
+            run.min_key = run.fences.front();
+            run.max_key = blocks.back()->getAllRecords().back()->getId();
+        }
+        return run;
+    }
+
+    /**
+     * @brief Cuerpo del hilo de compactación: fusión de k vías
+     *
+     * Ante claves repetidas gana la secuencia más reciente; los tombstones se
+     * conservan salvo que la salida vaya al nivel más profundo.
+     */
+    void runCompaction(CompactionJob* current) {
+        auto start = SteadyClock::now();
+
+        std::vector<std::vector<std::shared_ptr<Record>>> sources;
+        bool ok = true;
+        for (const auto& run : current->inputs) {
+            std::vector<std::shared_ptr<Record>> records;
+            for (const auto& addr : run.blocks) {
+                Block block(addr, block_size);
+                if (!filesystem.readBlock(addr, block)) {
+                    ok = false;
+                    break;
+                }
+                current->blocks_read++;
+                const auto& block_records = block.getAllRecords();
+                records.insert(records.end(), block_records.begin(), block_records.end());
+            }
+            sources.push_back(std::move(records));
+        }
+
+        // (clave, antigüedad de la secuencia, secuencia, posición)
+        using Cursor = std::tuple<int, size_t, size_t, size_t>;
+        std::priority_queue<Cursor, std::vector<Cursor>, std::greater<Cursor>> heap;
+        for (size_t s = 0; s < sources.size(); ++s) {
+            if (!sources[s].empty()) heap.emplace(sources[s][0]->getId(), s, s, 0);
+        }
+
+        std::vector<std::shared_ptr<Record>> merged;
+        bool has_last = false;
+        int last_key = 0;
+        while (ok && !heap.empty()) {
+            auto [key, rank, source, position] = heap.top();
+            heap.pop();
+            if (position + 1 < sources[source].size()) {
+                heap.emplace(sources[source][position + 1]->getId(), rank, source, position + 1);
+            }
+
+            const auto& record = sources[source][position];
+            if (has_last && key == last_key) {
+                current->dropped++;  // Versión anterior de una clave ya emitida
+                continue;
+            }
+            has_last = true;
+            last_key = key;
+
+            if (record->isDeleted() && current->drop_tombstones) {
+                current->dropped++;
+                continue;
+            }
+            prepareRecord(record);
+            merged.push_back(record);
+        }
+
+        std::vector<std::shared_ptr<Block>> blocks;
+        size_t next = 0;
+        ok = ok && packRecords(merged, [current, &next](PhysicalAddress& addr) {
+            if (next >= current->reserved.size()) return false;
+            addr = current->reserved[next++];
+            return true;
+        }, blocks);
+
+        for (size_t i = 0; ok && i < blocks.size(); ++i) {
+            blocks[i]->setPageLSN(current->first_lsn + static_cast<long long>(i));
+            ok = filesystem.writeBlock(blocks[i]->getAddress(), *blocks[i]);
+        }
+
+        if (ok) {
+            current->output = makeRun(current->output_id, current->target_level, blocks);
+        }
+        current->ok = ok;
+        current->elapsed_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+        job_done = true;
+    }
+
+    bool saveManifest() const { return saveManifest(runs); }
+
+    /**
+     * @brief Escribe un manifiesto con las secuencias dadas en un temporal y lo renombra
+     */
+    bool saveManifest(const std::vector<SortedRun>& manifest_runs) const {
+        std::string path = getManifestPath();
+        {
+            std::ofstream file(path + ".tmp", std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "Error escribiendo el manifiesto LSM: " << path << std::endl;
+                return false;
+            }
+
+            file << "# Árbol LSM de la tabla: " << table_name << std::endl;
+            file << "policy=" << compactionPolicyToString(options.policy) << std::endl;
+            file << "memtable_limit=" << options.memtable_limit << std::endl;
+            file << "size_ratio=" << options.size_ratio << std::endl;
+            file << "next_run=" << next_run_id << std::endl;
+
+            // RUN|id|nivel|entradas|mín|máx|bloom|dirección:frontera,...
+            for (const auto& run : manifest_runs) {
+                file << "RUN|" << run.id << "|" << run.level << "|" << run.entries << "|"
+                     << run.min_key << "|" << run.max_key << "|" << run.bloom.toString() << "|";
+                for (size_t i = 0; i < run.blocks.size(); ++i) {
+                    if (i > 0) file << ",";
+                    file << run.blocks[i].toString() << ":" << run.fences[i];
+                }
+                file << std::endl;
+            }
+            if (!file) return false;
+        }
+
+        std::error_code ec;
+        fs::rename(path + ".tmp", path, ec);
+        return !ec;
+    }
+
+    bool loadManifest() {
+        std::ifstream file(getManifestPath());
+        if (!file.is_open()) {
+            std::cerr << "Error: falta el manifiesto LSM de " << table_name << std::endl;
+            return false;
+        }
+
+        runs.clear();
+        std::string line;
+        try {
+            while (std::getline(file, line)) {
+                if (line.empty() || line[0] == '#') continue;
+
+                if (line.find("policy=") == 0) {
+                    options.policy = compactionPolicyFromString(line.substr(7));
+                } else if (line.find("memtable_limit=") == 0) {
+                    options.memtable_limit = std::stoull(line.substr(15));
+                } else if (line.find("size_ratio=") == 0) {
+                    options.size_ratio = std::stoull(line.substr(11));
+                } else if (line.find("next_run=") == 0) {
+                    next_run_id = std::stoi(line.substr(9));
+                } else if (line.find("RUN|") == 0) {
+                    std::istringstream fields(line.substr(4));
+                    std::string id, level, entries, min_key, max_key, bloom, blocks;
+                    std::getline(fields, id, '|');
+                    std::getline(fields, level, '|');
+                    std::getline(fields, entries, '|');
+                    std::getline(fields, min_key, '|');
+                    std::getline(fields, max_key, '|');
+                    std::getline(fields, bloom, '|');
+                    std::getline(fields, blocks);
+
+                    SortedRun run;
+                    run.id = std::stoi(id);
+                    run.level = std::stoi(level);
+                    run.entries = std::stoull(entries);
+                    run.min_key = std::stoi(min_key);
+                    run.max_key = std::stoi(max_key);
+                    if (!run.bloom.fromString(bloom)) return false;
+
+                    std::istringstream block_list(blocks);
+                    std::string item;
+                    while (std::getline(block_list, item, ',')) {
+                        size_t colon = item.find(':');
+                        PhysicalAddress addr;
+                        if (colon == std::string::npos ||
+                            !PhysicalAddress::fromString(item.substr(0, colon), addr)) {
+                            return false;
+                        }
+                        run.blocks.push_back(addr);
+                        run.fences.push_back(std::stoi(item.substr(colon + 1)));
+                    }
+                    runs.push_back(run);
+                }
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Error: manifiesto LSM corrupto de " << table_name << std::endl;
+            return false;
+        }
+
+        sortRuns(runs);
+        return true;
+    }
+};
+
+#endif // LSM_TREE_H
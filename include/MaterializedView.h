@@ -0,0 +1,403 @@
+#ifndef MATERIALIZED_VIEW_H
+#define MATERIALIZED_VIEW_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include "Record.h"
+#include "ClusteredIndex.h"
+
+/**
+ * @brief Función de agregación de una vista materializada
+ */
+enum class AggregateFunction {
+    COUNT,
+    SUM,
+    AVG,
+    MIN,
+    MAX
+};
+
+inline std::string aggregateFunctionToString(AggregateFunction function) {
+    switch (function) {
+        case AggregateFunction::COUNT: return "COUNT";
+        case AggregateFunction::SUM: return "SUM";
+        case AggregateFunction::AVG: return "AVG";
+        case AggregateFunction::MIN: return "MIN";
+        case AggregateFunction::MAX: return "MAX";
+    }
+    return "COUNT";
+}
+
+inline bool aggregateFunctionFromString(const std::string& text, AggregateFunction& function) {
+    for (AggregateFunction candidate : {AggregateFunction::COUNT, AggregateFunction::SUM, AggregateFunction::AVG,
+                                        AggregateFunction::MIN, AggregateFunction::MAX}) {
+        if (aggregateFunctionToString(candidate) == text) {
+            function = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Agregado `FUNCIÓN(columna)`; COUNT no usa columna
+ */
+struct AggregateSpec {
+    AggregateFunction function;
+    std::string column;
+
+    AggregateSpec(AggregateFunction f = AggregateFunction::COUNT, const std::string& c = "")
+        : function(f), column(c) {}
+
+    std::string toString() const {
+        return aggregateFunctionToString(function) + "(" + (column.empty() ? "*" : column) + ")";
+    }
+};
+
+/**
+ * @brief Vista materializada `SELECT grupo..., agregados... FROM tabla GROUP BY grupo...`
+ *
+ * Cada grupo es un registro de la relación de la vista con las columnas de
+ * agrupación, el número de filas y el estado de cada agregado: la suma para
+ * SUM y AVG, el valor extremo para MIN y MAX. Una inserción o un borrado en
+ * la tabla base se aplica como delta sobre ese único registro. La única
+ * excepción es borrar el mínimo o el máximo de un grupo, que obliga a
+ * recalcularlo desde la tabla base. La definición se guarda en
+ * `metadata/view_<vista>.txt`.
+ */
+class MaterializedView {
+public:
+    struct Slot {
+        size_t block;       // Posición en la relación de la vista
+        size_t slot;
+    };
+
+private:
+    std::string name;
+    std::string base_table;
+    std::vector<std::string> group_columns;
+    std::vector<AggregateSpec> aggregates;
+
+    // Posiciones en el esquema base (resueltas en configure)
+    std::vector<size_t> group_fields;
+    std::vector<size_t> aggregate_fields;
+    std::vector<FieldType> aggregate_types;
+    std::vector<FieldDefinition> base_schema;
+    std::map<std::string, Slot> directory;          // Clave de grupo -> ranura
+
+public:
+    /**
+     * @brief Estado de un grupo, tal como se guarda en la relación de la vista
+     */
+    struct GroupState {
+        std::vector<std::string> group_values;
+        long long count = 0;
+        std::vector<std::string> states;        // Suma o extremo de cada agregado
+    };
+
+    MaterializedView() = default;
+
+    MaterializedView(const std::string& view_name, const std::string& table,
+                     const std::vector<std::string>& group_by, const std::vector<AggregateSpec>& specs)
+        : name(view_name), base_table(table), group_columns(group_by), aggregates(specs) {}
+
+    /**
+     * @brief Resuelve las columnas contra el esquema de la tabla base
+     */
+    bool configure(const std::vector<FieldDefinition>& schema) {
+        base_schema = schema;
+        group_fields.clear();
+        aggregate_fields.clear();
+        aggregate_types.clear();
+        auto position = [&schema](const std::string& column, size_t& index) {
+            for (size_t i = 0; i < schema.size(); ++i) {
+                if (schema[i].name == column) {
+                    index = i;
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        for (const auto& column : group_columns) {
+            size_t index = 0;
+            if (!position(column, index)) {
+                std::cout << "Error: columna de agrupación desconocida '" << column << "'." << std::endl;
+                return false;
+            }
+            group_fields.push_back(index);
+        }
+        for (const auto& spec : aggregates) {
+            size_t index = 0;
+            if (spec.function == AggregateFunction::COUNT) {
+                aggregate_fields.push_back(0);
+                aggregate_types.push_back(FieldType::INTEGER);
+                continue;
+            }
+            if (!position(spec.column, index)) {
+                std::cout << "Error: columna de agregado desconocida '" << spec.column << "'." << std::endl;
+                return false;
+            }
+            bool numeric = schema[index].type == FieldType::INTEGER || schema[index].type == FieldType::FLOAT;
+            if (!numeric && (spec.function == AggregateFunction::SUM || spec.function == AggregateFunction::AVG)) {
+                std::cout << "Error: " << spec.toString() << " necesita una columna numérica." << std::endl;
+                return false;
+            }
+            aggregate_fields.push_back(index);
+            aggregate_types.push_back(schema[index].type);
+        }
+        return true;
+    }
+
+    const std::string& getName() const { return name; }
+    const std::string& getBaseTable() const { return base_table; }
+    const std::vector<std::string>& getGroupColumns() const { return group_columns; }
+    const std::vector<AggregateSpec>& getAggregates() const { return aggregates; }
+
+    bool locate(const std::string& key, Slot& slot) const {
+        auto it = directory.find(key);
+        if (it == directory.end()) return false;
+        slot = it->second;
+        return true;
+    }
+
+    void place(const std::string& key, size_t block, size_t slot) { directory[key] = Slot{block, slot}; }
+    void forget(const std::string& key) { directory.erase(key); }
+    void clearDirectory() { directory.clear(); }
+    size_t getGroupCount() const { return directory.size(); }
+
+    /**
+     * @brief Registra en el directorio los grupos vivos de un bloque de la vista
+     */
+    void loadBlockGroups(size_t block, const std::vector<std::shared_ptr<Record>>& records) {
+        for (size_t slot = 0; slot < records.size(); ++slot) {
+            if (records[slot]->isDeleted()) continue;
+            const auto& values = records[slot]->getFieldValues();
+            if (values.size() < group_fields.size()) continue;
+            place(groupKey(std::vector<std::string>(values.begin(),
+                                                    values.begin() + static_cast<std::ptrdiff_t>(group_fields.size()))),
+                  block, slot);
+        }
+    }
+
+    /**
+     * @brief Esquema de la relación que almacena la vista
+     */
+    std::vector<FieldDefinition> storageSchema() const {
+        std::vector<FieldDefinition> schema;
+        for (size_t g = 0; g < group_fields.size(); ++g) {
+            schema.push_back(base_schema[group_fields[g]]);
+        }
+        schema.push_back(FieldDefinition("filas", FieldType::INTEGER));
+        for (size_t a = 0; a < aggregates.size(); ++a) {
+            bool extreme = aggregates[a].function == AggregateFunction::MIN ||
+                           aggregates[a].function == AggregateFunction::MAX;
+            std::string column = aggregates[a].column.empty() ? "filas" : aggregates[a].column;
+            std::string state_name = extreme ? aggregateFunctionToString(aggregates[a].function) : "SUM";
+            schema.push_back(FieldDefinition(state_name + "_" + column,
+                                             extreme ? aggregate_types[a] : FieldType::FLOAT,
+                                             extreme ? base_schema[aggregate_fields[a]].max_length : 0));
+        }
+        return schema;
+    }
+
+    std::vector<std::string> groupValuesOf(const Record& record) const {
+        std::vector<std::string> values;
+        for (size_t field : group_fields) values.push_back(record.getField(field));
+        return values;
+    }
+
+    static std::string groupKey(const std::vector<std::string>& values) {
+        std::string key;
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i > 0) key += '\x1f';
+            key += values[i];
+        }
+        return key;
+    }
+
+    GroupState emptyGroup(const std::vector<std::string>& group_values) const {
+        GroupState state;
+        state.group_values = group_values;
+        state.states.assign(aggregates.size(), "");
+        return state;
+    }
+
+    /**
+     * @brief Aplica una fila base al grupo (`sign` = +1 inserción, -1 borrado)
+     * @return false si el borrado se llevó un mínimo o máximo y hay que recalcularlo
+     */
+    bool apply(GroupState& state, const Record& record, int sign) const {
+        state.count += sign;
+        bool exact = true;
+        for (size_t a = 0; a < aggregates.size(); ++a) {
+            const AggregateSpec& spec = aggregates[a];
+            if (spec.function == AggregateFunction::COUNT) continue;
+            std::string value = record.getField(aggregate_fields[a]);
+
+            if (spec.function == AggregateFunction::SUM || spec.function == AggregateFunction::AVG) {
+                double sum = state.states[a].empty() ? 0.0 : toNumber(state.states[a]);
+                state.states[a] = formatNumber(sum + sign * toNumber(value));
+                continue;
+            }
+
+            int direction = (spec.function == AggregateFunction::MIN) ? -1 : 1;
+            int order = state.states[a].empty() ? direction
+                                                 : compareFieldValues(aggregate_types[a], value, state.states[a]);
+            if (sign > 0 && (state.states[a].empty() || order * direction > 0)) {
+                state.states[a] = value;
+            } else if (sign < 0 && order == 0) {
+                exact = false;
+            }
+        }
+        return exact;
+    }
+
+    /**
+     * @brief Reinicia los extremos antes de recalcular un grupo desde la tabla base
+     */
+    void resetExtremes(GroupState& state) const {
+        for (size_t a = 0; a < aggregates.size(); ++a) {
+            if (aggregates[a].function == AggregateFunction::MIN || aggregates[a].function == AggregateFunction::MAX) {
+                state.states[a].clear();
+            }
+        }
+    }
+
+    /**
+     * @brief Incorpora una fila base a los extremos del grupo sin tocar el resto
+     */
+    void accumulateExtremes(GroupState& state, const Record& record) const {
+        for (size_t a = 0; a < aggregates.size(); ++a) {
+            int direction = (aggregates[a].function == AggregateFunction::MIN) ? -1
+                          : (aggregates[a].function == AggregateFunction::MAX) ? 1 : 0;
+            if (direction == 0) continue;
+            std::string value = record.getField(aggregate_fields[a]);
+            if (state.states[a].empty() ||
+                compareFieldValues(aggregate_types[a], value, state.states[a]) * direction > 0) {
+                state.states[a] = value;
+            }
+        }
+    }
+
+    std::vector<std::string> toStoredValues(const GroupState& state) const {
+        std::vector<std::string> values = state.group_values;
+        values.push_back(std::to_string(state.count));
+        values.insert(values.end(), state.states.begin(), state.states.end());
+        return values;
+    }
+
+    bool fromStoredValues(const std::vector<std::string>& values, GroupState& state) const {
+        if (values.size() < group_fields.size() + 1) {
+            return false;
+        }
+        state.group_values.assign(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(group_fields.size()));
+        try {
+            state.count = std::stoll(values[group_fields.size()]);
+        } catch (const std::exception&) {
+            return false;
+        }
+        state.states.assign(values.begin() + static_cast<std::ptrdiff_t>(group_fields.size()) + 1, values.end());
+        state.states.resize(aggregates.size());
+        return true;
+    }
+
+    /**
+     * @brief Fila de resultado: columnas de agrupación y valor final de cada agregado
+     */
+    std::vector<std::string> resultRow(const GroupState& state) const {
+        std::vector<std::string> row = state.group_values;
+        for (size_t a = 0; a < aggregates.size(); ++a) {
+            switch (aggregates[a].function) {
+                case AggregateFunction::COUNT:
+                    row.push_back(std::to_string(state.count));
+                    break;
+                case AggregateFunction::AVG:
+                    row.push_back(state.count > 0 ? formatNumber(toNumber(state.states[a]) / state.count) : "");
+                    break;
+                default:
+                    row.push_back(state.states[a].empty() ? "0" : state.states[a]);
+                    break;
+            }
+        }
+        return row;
+    }
+
+    std::vector<std::string> resultHeader() const {
+        std::vector<std::string> header = group_columns;
+        for (const auto& spec : aggregates) header.push_back(spec.toString());
+        return header;
+    }
+
+    bool save(const std::string& path) const {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Error escribiendo la vista: " << path << std::endl;
+            return false;
+        }
+        file << "table=" << base_table << std::endl;
+        file << "group=";
+        for (size_t i = 0; i < group_columns.size(); ++i) {
+            file << (i > 0 ? "," : "") << group_columns[i];
+        }
+        file << std::endl;
+        for (const auto& spec : aggregates) {
+            file << "aggregate=" << aggregateFunctionToString(spec.function) << "," << spec.column << std::endl;
+        }
+        return static_cast<bool>(file);
+    }
+
+    bool load(const std::string& view_name, const std::string& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+        name = view_name;
+        group_columns.clear();
+        aggregates.clear();
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.find("table=") == 0) {
+                base_table = line.substr(6);
+            } else if (line.find("group=") == 0) {
+                std::istringstream columns(line.substr(6));
+                std::string column;
+                while (std::getline(columns, column, ',')) {
+                    if (!column.empty()) group_columns.push_back(column);
+                }
+            } else if (line.find("aggregate=") == 0) {
+                std::string spec = line.substr(10);
+                size_t comma = spec.find(',');
+                AggregateFunction function;
+                if (comma == std::string::npos || !aggregateFunctionFromString(spec.substr(0, comma), function)) {
+                    return false;
+                }
+                aggregates.emplace_back(function, spec.substr(comma + 1));
+            }
+        }
+        return !base_table.empty();
+    }
+
+private:
+    static double toNumber(const std::string& text) {
+        try {
+            return std::stod(text);
+        } catch (const std::exception&) {
+            return 0.0;
+        }
+    }
+
+    static std::string formatNumber(double value) {
+        std::ostringstream out;
+        out << std::setprecision(15) << value;
+        return out.str();
+    }
+};
+
+#endif // MATERIALIZED_VIEW_H
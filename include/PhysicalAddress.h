@@ -4,6 +4,7 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <cstdio>
 
 /**
  * @brief Representa una dirección física en el disco simulado
@@ -51,6 +52,19 @@ public:
         return oss.str();
     }
 
+    /**
+     * @brief Interpreta el formato de toString ("P0_S1_T2_SEC3")
+     */
+    static bool fromString(const std::string& text, PhysicalAddress& address) {
+        int p, s, t, sec;
+        char tail;
+        if (std::sscanf(text.c_str(), "P%d_S%d_T%d_SEC%d%c", &p, &s, &t, &sec, &tail) != 4) {
+            return false;
+        }
+        address = PhysicalAddress(p, s, t, sec);
+        return true;
+    }
+
     /**
      * @brief Obtiene la ruta del directorio para esta dirección
      */
@@ -0,0 +1,497 @@
+#ifndef PIPELINE_KERNELS_H
+#define PIPELINE_KERNELS_H
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include "Record.h"
+#include "MaterializedView.h"
+
+/**
+ * @brief Operador de comparación de un filtro `columna op constante`
+ */
+enum class CompareOp {
+    LT,
+    LE,
+    EQ,
+    NE,
+    GE,
+    GT
+};
+
+inline std::string compareOpToString(CompareOp op) {
+    switch (op) {
+        case CompareOp::LT: return "<";
+        case CompareOp::LE: return "<=";
+        case CompareOp::EQ: return "=";
+        case CompareOp::NE: return "<>";
+        case CompareOp::GE: return ">=";
+        case CompareOp::GT: return ">";
+    }
+    return "=";
+}
+
+/**
+ * @brief `SELECT agregado FROM tabla WHERE filtro op constante`
+ */
+struct FilterAggregateQuery {
+    std::string filter_column;
+    CompareOp op = CompareOp::EQ;
+    std::string constant;
+    AggregateSpec aggregate;
+
+    std::string toString() const {
+        return "SELECT " + aggregate.toString() + " WHERE " + filter_column + " " + compareOpToString(op) + " " +
+               constant;
+    }
+};
+
+/**
+ * @brief Columna de un bloque decodificada a su tipo nativo
+ *
+ * INTEGER se guarda como int64_t, FLOAT como double y STRING o DATE como
+ * texto; un valor numérico ilegible se decodifica como 0.
+ */
+struct TypedColumn {
+    FieldType type = FieldType::STRING;
+    std::vector<int64_t> ints;
+    std::vector<double> floats;
+    std::vector<std::string> strings;
+
+    void append(const std::string& text) {
+        switch (type) {
+            case FieldType::INTEGER:
+                try {
+                    ints.push_back(static_cast<int64_t>(std::stoll(text)));
+                } catch (const std::exception&) {
+                    ints.push_back(0);
+                }
+                break;
+            case FieldType::FLOAT:
+                try {
+                    floats.push_back(std::stod(text));
+                } catch (const std::exception&) {
+                    floats.push_back(0.0);
+                }
+                break;
+            default:
+                strings.push_back(text);
+                break;
+        }
+    }
+
+    size_t size() const { return ints.size() + floats.size() + strings.size(); }
+
+    /**
+     * @brief Vacía la columna conservando su capacidad (el lote se reutiliza)
+     */
+    void clear() {
+        ints.clear();
+        floats.clear();
+        strings.clear();
+    }
+
+    template <typename T> const T* data() const;
+};
+
+template <> inline const int64_t* TypedColumn::data<int64_t>() const { return ints.data(); }
+template <> inline const double* TypedColumn::data<double>() const { return floats.data(); }
+template <> inline const std::string* TypedColumn::data<std::string>() const { return strings.data(); }
+
+/**
+ * @brief Filas vivas de un bloque: la columna del filtro y la del agregado
+ *
+ * Es la salida del scan y la entrada común de los dos caminos de ejecución.
+ */
+struct ColumnBatch {
+    size_t rows = 0;
+    TypedColumn filter;
+    TypedColumn value;
+};
+
+/**
+ * @brief Constante del filtro ya convertida al tipo de la comparación
+ *
+ * Las columnas numéricas se comparan como double, igual que compareFieldValues.
+ */
+struct PredicateConstant {
+    double number = 0.0;
+    std::string text;
+};
+
+/**
+ * @brief Estado de un agregado; `count` son las filas que pasaron el filtro
+ */
+struct AggregateState {
+    int64_t int_sum = 0;                // SUM y AVG de columnas INTEGER (exactos)
+    double float_sum = 0.0;             // SUM y AVG de columnas FLOAT
+    int64_t count = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    /**
+     * @brief Valor final del agregado (NaN = NULL si ninguna fila pasó el filtro)
+     */
+    double result(const AggregateSpec& aggregate, FieldType value_type) const {
+        if (aggregate.function == AggregateFunction::COUNT) return static_cast<double>(count);
+        if (count == 0) return std::numeric_limits<double>::quiet_NaN();
+        double sum = value_type == FieldType::INTEGER ? static_cast<double>(int_sum) : float_sum;
+        switch (aggregate.function) {
+            case AggregateFunction::SUM: return sum;
+            case AggregateFunction::AVG: return sum / static_cast<double>(count);
+            case AggregateFunction::MIN: return min;
+            case AggregateFunction::MAX: return max;
+            default: return static_cast<double>(count);
+        }
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Camino interpretado: árbol de operadores con una llamada virtual por tupla
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Valor con etiqueta de tipo que circula entre operadores interpretados
+ */
+struct ScalarValue {
+    FieldType type = FieldType::INTEGER;
+    int64_t integer = 0;
+    double number = 0.0;
+    std::string text;
+
+    double asDouble() const { return type == FieldType::INTEGER ? static_cast<double>(integer) : number; }
+};
+
+/**
+ * @brief Expresión interpretada sobre una tupla
+ *
+ * Devuelve una referencia (a la tupla, a su constante o a su propio
+ * resultado), válida hasta la siguiente evaluación: ningún nodo copia el
+ * texto de un valor. Un árbol lo evalúa un solo hilo.
+ */
+class Expression {
+public:
+    virtual ~Expression() = default;
+    virtual const ScalarValue& eval(const std::vector<ScalarValue>& tuple) const = 0;
+};
+
+class ColumnExpression : public Expression {
+private:
+    size_t index;
+
+public:
+    explicit ColumnExpression(size_t i) : index(i) {}
+    const ScalarValue& eval(const std::vector<ScalarValue>& tuple) const override { return tuple[index]; }
+};
+
+class ConstantExpression : public Expression {
+private:
+    ScalarValue value;
+
+public:
+    explicit ConstantExpression(const ScalarValue& v) : value(v) {}
+    const ScalarValue& eval(const std::vector<ScalarValue>&) const override { return value; }
+};
+
+/**
+ * @brief Comparación que decide el tipo y el operador en cada evaluación
+ */
+class CompareExpression : public Expression {
+private:
+    CompareOp op;
+    std::unique_ptr<Expression> left;
+    std::unique_ptr<Expression> right;
+    mutable ScalarValue result;
+
+public:
+    CompareExpression(CompareOp o, std::unique_ptr<Expression> l, std::unique_ptr<Expression> r)
+        : op(o), left(std::move(l)), right(std::move(r)) {}
+
+    const ScalarValue& eval(const std::vector<ScalarValue>& tuple) const override {
+        const ScalarValue& a = left->eval(tuple);
+        const ScalarValue& b = right->eval(tuple);
+        int cmp;
+        if (a.type == FieldType::INTEGER || a.type == FieldType::FLOAT) {
+            double x = a.asDouble(), y = b.asDouble();
+            cmp = x < y ? -1 : (x > y ? 1 : 0);
+        } else {
+            cmp = a.text.compare(b.text);
+        }
+        bool pass = false;
+        switch (op) {
+            case CompareOp::LT: pass = cmp < 0; break;
+            case CompareOp::LE: pass = cmp <= 0; break;
+            case CompareOp::EQ: pass = cmp == 0; break;
+            case CompareOp::NE: pass = cmp != 0; break;
+            case CompareOp::GE: pass = cmp >= 0; break;
+            case CompareOp::GT: pass = cmp > 0; break;
+        }
+        result.integer = pass ? 1 : 0;
+        return result;
+    }
+};
+
+/**
+ * @brief Operador de tipo iterador (Volcano): cada `next` produce una tupla
+ */
+class PipelineOperator {
+public:
+    virtual ~PipelineOperator() = default;
+    virtual bool next(std::vector<ScalarValue>& tuple) = 0;
+};
+
+/**
+ * @brief Recorre un lote decodificado y produce tuplas (filtro, valor)
+ */
+class BatchScanOperator : public PipelineOperator {
+private:
+    const ColumnBatch& batch;
+    size_t row;
+
+    /**
+     * @brief Escribe la celda en la ranura de la tupla, reutilizando su texto
+     */
+    static void cell(const TypedColumn& column, size_t i, ScalarValue& value) {
+        value.type = column.type;
+        switch (column.type) {
+            case FieldType::INTEGER: value.integer = column.ints[i]; break;
+            case FieldType::FLOAT: value.number = column.floats[i]; break;
+            default: value.text.assign(column.strings[i]); break;
+        }
+    }
+
+public:
+    explicit BatchScanOperator(const ColumnBatch& input) : batch(input), row(0) {}
+
+    bool next(std::vector<ScalarValue>& tuple) override {
+        if (row >= batch.rows) return false;
+        tuple.resize(2);
+        cell(batch.filter, row, tuple[0]);
+        if (row < batch.value.size()) {
+            cell(batch.value, row, tuple[1]);
+        } else {
+            tuple[1].type = FieldType::INTEGER;         // COUNT no decodifica el valor
+        }
+        row++;
+        return true;
+    }
+};
+
+class FilterOperator : public PipelineOperator {
+private:
+    std::unique_ptr<PipelineOperator> child;
+    std::unique_ptr<Expression> predicate;
+
+public:
+    FilterOperator(std::unique_ptr<PipelineOperator> c, std::unique_ptr<Expression> p)
+        : child(std::move(c)), predicate(std::move(p)) {}
+
+    bool next(std::vector<ScalarValue>& tuple) override {
+        while (child->next(tuple)) {
+            if (predicate->eval(tuple).integer != 0) return true;
+        }
+        return false;
+    }
+};
+
+class ProjectOperator : public PipelineOperator {
+private:
+    std::unique_ptr<PipelineOperator> child;
+    std::vector<std::unique_ptr<Expression>> expressions;
+    std::vector<ScalarValue> input;
+
+public:
+    ProjectOperator(std::unique_ptr<PipelineOperator> c, std::vector<std::unique_ptr<Expression>> e)
+        : child(std::move(c)), expressions(std::move(e)) {}
+
+    bool next(std::vector<ScalarValue>& tuple) override {
+        if (!child->next(input)) return false;
+        tuple.resize(expressions.size());
+        for (size_t i = 0; i < expressions.size(); ++i) tuple[i] = expressions[i]->eval(input);
+        return true;
+    }
+};
+
+/**
+ * @brief Agregado interpretado: consume a su hijo y decide la función en cada fila
+ */
+inline void runInterpretedAggregate(PipelineOperator& input, AggregateFunction function, AggregateState& state) {
+    std::vector<ScalarValue> tuple;
+    while (input.next(tuple)) {
+        const ScalarValue& value = tuple[0];
+        state.count++;
+        switch (function) {
+            case AggregateFunction::SUM:
+            case AggregateFunction::AVG:
+                if (value.type == FieldType::INTEGER) {
+                    state.int_sum += value.integer;
+                } else {
+                    state.float_sum += value.number;
+                }
+                break;
+            case AggregateFunction::MIN:
+                state.min = std::min(state.min, value.asDouble());
+                break;
+            case AggregateFunction::MAX:
+                state.max = std::max(state.max, value.asDouble());
+                break;
+            case AggregateFunction::COUNT:
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Construye y ejecuta scan -> filtro -> proyección -> agregado sobre un lote
+ *
+ * Acumula en `state`, así que se llama una vez por lote del recorrido.
+ */
+inline void runInterpretedPipeline(const ColumnBatch& batch, FieldType filter_type, CompareOp op,
+                                   const PredicateConstant& constant, AggregateFunction function,
+                                   AggregateState& state) {
+    ScalarValue literal;
+    literal.type = filter_type;
+    literal.number = constant.number;
+    literal.integer = static_cast<int64_t>(constant.number);
+    literal.text = constant.text;
+    if (filter_type == FieldType::INTEGER) literal.type = FieldType::FLOAT;  // Se compara como double
+
+    std::unique_ptr<PipelineOperator> scan(new BatchScanOperator(batch));
+    std::unique_ptr<Expression> predicate(new CompareExpression(op, std::unique_ptr<Expression>(new ColumnExpression(0)),
+                                                                std::unique_ptr<Expression>(new ConstantExpression(literal))));
+    std::unique_ptr<PipelineOperator> filter(new FilterOperator(std::move(scan), std::move(predicate)));
+    std::vector<std::unique_ptr<Expression>> projection;
+    projection.emplace_back(new ColumnExpression(1));
+    ProjectOperator project(std::move(filter), std::move(projection));
+    runInterpretedAggregate(project, function, state);
+}
+
+// ---------------------------------------------------------------------------
+// Camino especializado: una plantilla por tipos, operador y agregado
+// ---------------------------------------------------------------------------
+
+template <CompareOp OP, typename A, typename B>
+inline bool comparePredicate(const A& a, const B& b) {
+    if constexpr (OP == CompareOp::LT) return a < b;
+    if constexpr (OP == CompareOp::LE) return a <= b;
+    if constexpr (OP == CompareOp::EQ) return a == b;
+    if constexpr (OP == CompareOp::NE) return a != b;
+    if constexpr (OP == CompareOp::GE) return a >= b;
+    return a > b;
+}
+
+/**
+ * @brief Núcleo fusionado: filtro, proyección y agregado en un único bucle
+ *
+ * `F` es el tipo de la columna del filtro y `V` el de la columna agregada.
+ * Sin llamadas virtuales ni decisiones de tipo por fila: el compilador ve un
+ * bucle sobre dos arrays contiguos.
+ */
+template <typename F, typename V, CompareOp OP, AggregateFunction AGG>
+void fusedFilterAggregate(const ColumnBatch& batch, const PredicateConstant& constant, AggregateState& state) {
+    using Constant = typename std::conditional<std::is_same<F, std::string>::value, std::string, double>::type;
+    const Constant* literal;
+    if constexpr (std::is_same<F, std::string>::value) {
+        literal = &constant.text;
+    } else {
+        literal = &constant.number;
+    }
+    const Constant bound = *literal;
+    const F* filter = batch.filter.data<F>();
+    const V* values = batch.value.data<V>();
+    const size_t rows = batch.rows;
+
+    int64_t count = state.count;
+    if constexpr (AGG == AggregateFunction::COUNT) {
+        for (size_t i = 0; i < rows; ++i) count += comparePredicate<OP>(filter[i], bound) ? 1 : 0;
+    } else if constexpr (AGG == AggregateFunction::SUM || AGG == AggregateFunction::AVG) {
+        if constexpr (std::is_same<V, int64_t>::value) {
+            int64_t sum = state.int_sum;
+            for (size_t i = 0; i < rows; ++i) {
+                bool pass = comparePredicate<OP>(filter[i], bound);
+                count += pass;
+                sum += pass ? values[i] : 0;
+            }
+            state.int_sum = sum;
+        } else {
+            double sum = state.float_sum;
+            for (size_t i = 0; i < rows; ++i) {
+                if (comparePredicate<OP>(filter[i], bound)) {
+                    count++;
+                    sum += values[i];
+                }
+            }
+            state.float_sum = sum;
+        }
+    } else {
+        double extreme = AGG == AggregateFunction::MIN ? state.min : state.max;
+        for (size_t i = 0; i < rows; ++i) {
+            if (comparePredicate<OP>(filter[i], bound)) {
+                count++;
+                double value = static_cast<double>(values[i]);
+                extreme = AGG == AggregateFunction::MIN ? std::min(extreme, value) : std::max(extreme, value);
+            }
+        }
+        (AGG == AggregateFunction::MIN ? state.min : state.max) = extreme;
+    }
+    state.count = count;
+}
+
+using FusedKernel = void (*)(const ColumnBatch&, const PredicateConstant&, AggregateState&);
+
+template <typename F, typename V, CompareOp OP>
+FusedKernel selectAggregateKernel(AggregateFunction function) {
+    switch (function) {
+        case AggregateFunction::COUNT: return &fusedFilterAggregate<F, V, OP, AggregateFunction::COUNT>;
+        case AggregateFunction::SUM: return &fusedFilterAggregate<F, V, OP, AggregateFunction::SUM>;
+        case AggregateFunction::AVG: return &fusedFilterAggregate<F, V, OP, AggregateFunction::AVG>;
+        case AggregateFunction::MIN: return &fusedFilterAggregate<F, V, OP, AggregateFunction::MIN>;
+        case AggregateFunction::MAX: return &fusedFilterAggregate<F, V, OP, AggregateFunction::MAX>;
+    }
+    return nullptr;
+}
+
+template <typename F, typename V>
+FusedKernel selectCompareKernel(CompareOp op, AggregateFunction function) {
+    switch (op) {
+        case CompareOp::LT: return selectAggregateKernel<F, V, CompareOp::LT>(function);
+        case CompareOp::LE: return selectAggregateKernel<F, V, CompareOp::LE>(function);
+        case CompareOp::EQ: return selectAggregateKernel<F, V, CompareOp::EQ>(function);
+        case CompareOp::NE: return selectAggregateKernel<F, V, CompareOp::NE>(function);
+        case CompareOp::GE: return selectAggregateKernel<F, V, CompareOp::GE>(function);
+        case CompareOp::GT: return selectAggregateKernel<F, V, CompareOp::GT>(function);
+    }
+    return nullptr;
+}
+
+template <typename F>
+FusedKernel selectValueKernel(FieldType value_type, CompareOp op, AggregateFunction function) {
+    if (value_type == FieldType::FLOAT) return selectCompareKernel<F, double>(op, function);
+    return selectCompareKernel<F, int64_t>(op, function);
+}
+
+/**
+ * @brief Elige en tiempo de plan la instancia que corresponde a la consulta
+ *
+ * Las 3 x 2 x 6 x 5 combinaciones (tipo del filtro, tipo del valor,
+ * operador, agregado) se instancian al compilar. COUNT no lee la columna
+ * agregada. Devuelve nullptr si el agregado necesita una columna no numérica.
+ */
+inline FusedKernel selectFusedKernel(FieldType filter_type, FieldType value_type, CompareOp op,
+                                     AggregateFunction function) {
+    if (function != AggregateFunction::COUNT && value_type != FieldType::INTEGER && value_type != FieldType::FLOAT) {
+        return nullptr;
+    }
+    switch (filter_type) {
+        case FieldType::INTEGER: return selectValueKernel<int64_t>(value_type, op, function);
+        case FieldType::FLOAT: return selectValueKernel<double>(value_type, op, function);
+        default: return selectValueKernel<std::string>(value_type, op, function);
+    }
+}
+
+#endif // PIPELINE_KERNELS_H
@@ -0,0 +1,251 @@
+#ifndef QUERY_RESULT_CACHE_H
+#define QUERY_RESULT_CACHE_H
+
+#include <map>
+#include <set>
+#include <list>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+#include "Record.h"
+#include "BitmapIndex.h"
+
+/**
+ * @brief Caché de resultados de consultas de solo lectura
+ *
+ * La clave es el plan normalizado de la consulta (operador, tabla y
+ * parámetros en forma canónica) y cada entrada anota el contador de
+ * modificaciones de cada relación que leyó. Una escritura en una relación
+ * incrementa su contador y descarta al momento las entradas que la
+ * referencian; una entrada con contadores atrasados nunca se devuelve.
+ * Las entradas se expulsan por LRU cuando su tamaño estimado supera el
+ * presupuesto de memoria. Con presupuesto 0 la caché está desactivada.
+ */
+class QueryResultCache {
+public:
+    using Rows = std::vector<std::shared_ptr<Record>>;
+
+private:
+    struct Entry {
+        std::string key;
+        Rows rows;
+        std::vector<std::pair<std::string, uint64_t>> versions;   // Relación -> contador al calcularla
+        size_t bytes;
+    };
+
+    size_t budget_bytes;
+    size_t used_bytes;
+    std::list<Entry> lru;                                          // Más reciente al principio
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries;
+    std::map<std::string, uint64_t> table_versions;
+    std::map<std::string, std::set<std::string>> keys_by_table;
+
+    // Estadísticas
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t invalidations;
+
+public:
+    explicit QueryResultCache(size_t budget = 0)
+        : budget_bytes(budget), used_bytes(0), hits(0), misses(0), evictions(0), invalidations(0) {}
+
+    bool isEnabled() const { return budget_bytes > 0; }
+
+    void setBudget(size_t bytes) {
+        budget_bytes = bytes;
+        evictToBudget();
+    }
+
+    /**
+     * @brief Plan normalizado de una consulta por rango
+     *
+     * Los límites numéricos se reescriben en forma canónica (`007` y `7.0`
+     * dan la misma clave).
+     */
+    static std::string rangeKey(const std::string& table_name, const std::string& field, FieldType type,
+                                const std::string& low, const std::string& high) {
+        return "RANGE|" + table_name + "|" + field + "|" + canonicalValue(type, low) + "|" +
+               canonicalValue(type, high);
+    }
+
+    /**
+     * @brief Plan normalizado de una conjunción de términos de mapas de bits
+     *
+     * El orden de los términos y de los valores de cada IN no cambia el
+     * resultado, así que se ordenan y se quitan duplicados.
+     */
+    static std::string bitmapKey(const std::string& table_name, const std::vector<BitmapTerm>& terms) {
+        std::vector<std::string> parts;
+        for (const auto& term : terms) {
+            std::vector<std::string> values = term.values;
+            std::sort(values.begin(), values.end());
+            values.erase(std::unique(values.begin(), values.end()), values.end());
+            std::string part = (term.negated ? "NOT " : "") + term.column + " IN(";
+            for (size_t i = 0; i < values.size(); ++i) {
+                part += (i > 0 ? "\x1f" : "") + values[i];
+            }
+            parts.push_back(part + ")");
+        }
+        std::sort(parts.begin(), parts.end());
+        parts.erase(std::unique(parts.begin(), parts.end()), parts.end());
+
+        std::string key = "BITMAP|" + table_name;
+        for (const auto& part : parts) key += "|" + part;
+        return key;
+    }
+
+    /**
+     * @brief Plan normalizado de una búsqueda LIKE (`%%` equivale a `%`)
+     */
+    static std::string likeKey(const std::string& table_name, const std::string& column, const std::string& pattern) {
+        std::string normalized;
+        for (char c : pattern) {
+            if (c == '%' && !normalized.empty() && normalized.back() == '%') continue;
+            normalized += c;
+        }
+        return "LIKE|" + table_name + "|" + column + "|" + normalized;
+    }
+
+    /**
+     * @brief Devuelve las filas de una entrada vigente y la marca como la más reciente
+     */
+    bool lookup(const std::string& key, Rows& rows) {
+        if (!isEnabled()) return false;
+        auto it = entries.find(key);
+        if (it == entries.end() || !isCurrent(*it->second)) {
+            if (it != entries.end()) erase(it->second);
+            misses++;
+            return false;
+        }
+        lru.splice(lru.begin(), lru, it->second);
+        rows = it->second->rows;
+        hits++;
+        return true;
+    }
+
+    /**
+     * @brief Guarda el resultado de una consulta que leyó `tables`
+     *
+     * Un resultado mayor que todo el presupuesto no se guarda.
+     */
+    void store(const std::string& key, const std::vector<std::string>& tables, const Rows& rows) {
+        if (!isEnabled()) return;
+        auto existing = entries.find(key);
+        if (existing != entries.end()) erase(existing->second);
+
+        Entry entry;
+        entry.key = key;
+        entry.rows = rows;
+        entry.bytes = sizeof(Entry) + 2 * key.size();
+        for (const auto& row : rows) entry.bytes += sizeof(row) + row->getSize();
+        if (entry.bytes > budget_bytes) return;
+        for (const auto& table : tables) {
+            entry.versions.emplace_back(table, table_versions[table]);
+            keys_by_table[table].insert(key);
+        }
+
+        used_bytes += entry.bytes;
+        lru.push_front(std::move(entry));
+        entries[key] = lru.begin();
+        evictToBudget();
+    }
+
+    /**
+     * @brief Una relación ha cambiado: avanza su contador y descarta sus entradas
+     */
+    void invalidate(const std::string& table_name) {
+        table_versions[table_name]++;
+        auto keys = keys_by_table.find(table_name);
+        if (keys == keys_by_table.end()) return;
+        for (const auto& key : std::set<std::string>(keys->second)) {
+            auto it = entries.find(key);
+            if (it != entries.end()) {
+                erase(it->second);
+                invalidations++;
+            }
+        }
+    }
+
+    void clear() {
+        lru.clear();
+        entries.clear();
+        keys_by_table.clear();
+        used_bytes = 0;
+    }
+
+    size_t getEntryCount() const { return entries.size(); }
+    size_t getUsedBytes() const { return used_bytes; }
+    size_t getBudgetBytes() const { return budget_bytes; }
+    size_t getHits() const { return hits; }
+    size_t getMisses() const { return misses; }
+    size_t getEvictions() const { return evictions; }
+    size_t getInvalidations() const { return invalidations; }
+    uint64_t getTableVersion(const std::string& table_name) const {
+        auto it = table_versions.find(table_name);
+        return it != table_versions.end() ? it->second : 0;
+    }
+
+    void displayStatistics() const {
+        std::cout << "\n=== CACHÉ DE RESULTADOS ===" << std::endl;
+        if (!isEnabled()) {
+            std::cout << "Desactivada (presupuesto 0)" << std::endl;
+            return;
+        }
+        size_t lookups = hits + misses;
+        std::cout << "Entradas: " << entries.size() << " | Memoria: " << used_bytes << " / "
+                  << budget_bytes << " bytes" << std::endl;
+        std::cout << "Aciertos: " << hits << " | Fallos: " << misses << " | Tasa de acierto: "
+                  << (lookups > 0 ? 100.0 * hits / lookups : 0.0) << "%" << std::endl;
+        std::cout << "Expulsiones LRU: " << evictions << " | Invalidaciones: " << invalidations << std::endl;
+    }
+
+private:
+    bool isCurrent(const Entry& entry) const {
+        for (const auto& version : entry.versions) {
+            if (getTableVersion(version.first) != version.second) return false;
+        }
+        return true;
+    }
+
+    void erase(std::list<Entry>::iterator it) {
+        for (const auto& version : it->versions) {
+            auto keys = keys_by_table.find(version.first);
+            if (keys == keys_by_table.end()) continue;
+            keys->second.erase(it->key);
+            if (keys->second.empty()) keys_by_table.erase(keys);
+        }
+        used_bytes -= it->bytes;
+        entries.erase(it->key);
+        lru.erase(it);
+    }
+
+    void evictToBudget() {
+        while (used_bytes > budget_bytes && !lru.empty()) {
+            erase(std::prev(lru.end()));
+            evictions++;
+        }
+    }
+
+    static std::string canonicalValue(FieldType type, const std::string& value) {
+        if (type != FieldType::INTEGER && type != FieldType::FLOAT) {
+            return value;
+        }
+        // Mismo criterio que compareFieldValues: los números se comparan como double
+        try {
+            std::ostringstream out;
+            out.precision(17);
+            out << std::stod(value);
+            return out.str();
+        } catch (const std::exception&) {
+            return value;  // Valor no numérico: se compara como texto
+        }
+    }
+};
+
+#endif // QUERY_RESULT_CACHE_H
@@ -0,0 +1,170 @@
+#ifndef RADIX_INDEX_H
+#define RADIX_INDEX_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "Record.h"
+#include "AdaptiveRadixTree.h"
+
+/**
+ * @brief Número como entero sin signo que ordena igual que el valor
+ *
+ * En FLOAT los negativos invierten todos sus bits y los positivos solo el
+ * de signo; en INTEGER basta invertir el signo. Un valor ilegible da 0.
+ */
+inline uint64_t orderedNumberBits(FieldType type, const std::string& value) {
+    uint64_t bits = 0;
+    try {
+        if (type == FieldType::FLOAT) {
+            double number = std::stod(value);
+            std::memcpy(&bits, &number, sizeof(bits));
+            bits = (bits >> 63) ? ~bits : (bits | (1ULL << 63));
+        } else {
+            bits = static_cast<uint64_t>(std::stoll(value)) ^ (1ULL << 63);
+        }
+    } catch (const std::exception&) {
+        bits = 0;
+    }
+    return bits;
+}
+
+/**
+ * @brief Índice ART sobre el ID de registro o una columna de una tabla heap
+ *
+ * Traduce los valores a claves binarias comparables byte a byte: los
+ * números a 8 bytes big-endian con el bit de signo invertido, las cadenas a
+ * sus bytes más un terminador 0 (así ninguna clave es prefijo de otra). Los
+ * valores del árbol son RIDs con el mismo formato que BitmapIndex. El índice
+ * vive en memoria y se reconstruye al cargar; `metadata/art_<tabla>.txt`
+ * solo guarda las columnas indexadas.
+ */
+class RadixIndex {
+public:
+    static constexpr const char* RECORD_ID = "record_id";
+
+private:
+    std::string column;
+    size_t field;
+    FieldType type;
+    AdaptiveRadixTree<uint32_t> tree;
+
+public:
+    RadixIndex() : field(0), type(FieldType::INTEGER) {}
+
+    /**
+     * @brief Elige la columna: un campo del esquema o RECORD_ID
+     */
+    bool configure(const std::vector<FieldDefinition>& schema, const std::string& name) {
+        if (name == RECORD_ID) {
+            column = name;
+            type = FieldType::INTEGER;
+            return true;
+        }
+        for (size_t i = 0; i < schema.size(); ++i) {
+            if (schema[i].name == name) {
+                column = name;
+                field = i;
+                type = schema[i].type;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const std::string& getColumn() const { return column; }
+    bool isStringKey() const { return type == FieldType::STRING || type == FieldType::DATE; }
+
+    std::string valueOf(const Record& record) const {
+        return column == RECORD_ID ? std::to_string(record.getId()) : record.getField(field);
+    }
+
+    /**
+     * @brief Clave binaria de un valor
+     * @param terminated false para prefijos de cadena (sin terminador)
+     */
+    AdaptiveRadixTree<uint32_t>::Key encode(const std::string& value, bool terminated = true) const {
+        AdaptiveRadixTree<uint32_t>::Key key;
+        if (isStringKey()) {
+            key.assign(value.begin(), value.end());
+            if (terminated) key.push_back(0);
+            return key;
+        }
+
+        uint64_t bits = orderedNumberBits(type, value);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            key.push_back(static_cast<uint8_t>(bits >> shift));
+        }
+        return key;
+    }
+
+    void addRow(uint32_t rid, const Record& record) { tree.insert(encode(valueOf(record)), rid); }
+    void removeRow(uint32_t rid, const Record& record) { tree.erase(encode(valueOf(record)), rid); }
+    void clearRows() { tree.clear(); }
+
+    std::vector<uint32_t> lookup(const std::string& value) const {
+        const std::vector<uint32_t>* rids = tree.find(encode(value));
+        return rids ? *rids : std::vector<uint32_t>();
+    }
+
+    /**
+     * @brief RIDs de las claves que empiezan por `prefix` (solo cadenas)
+     */
+    std::vector<uint32_t> prefixLookup(const std::string& prefix) const {
+        std::vector<uint32_t> rids;
+        if (!isStringKey()) return rids;
+        tree.prefixScan(encode(prefix, false), [&rids](const AdaptiveRadixTree<uint32_t>::Key&,
+                                                       const std::vector<uint32_t>& values) {
+            rids.insert(rids.end(), values.begin(), values.end());
+            return true;
+        });
+        return rids;
+    }
+
+    /**
+     * @brief RIDs de [low, high] en orden de clave
+     */
+    std::vector<uint32_t> rangeLookup(const std::string& low, const std::string& high) const {
+        std::vector<uint32_t> rids;
+        tree.rangeScan(encode(low), encode(high), [&rids](const AdaptiveRadixTree<uint32_t>::Key&,
+                                                          const std::vector<uint32_t>& values) {
+            rids.insert(rids.end(), values.begin(), values.end());
+            return true;
+        });
+        return rids;
+    }
+
+    size_t getKeyCount() const { return tree.size(); }
+    size_t getMemoryBytes() const { return tree.getMemoryBytes(); }
+    std::array<size_t, 4> getNodeCounts() const { return tree.getNodeCounts(); }
+};
+
+/**
+ * @brief Guarda las columnas con índice ART de una tabla
+ */
+inline bool saveRadixColumns(const std::string& path, const std::vector<std::string>& columns) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error escribiendo los índices ART: " << path << std::endl;
+        return false;
+    }
+    for (const auto& column : columns) {
+        file << column << std::endl;
+    }
+    return static_cast<bool>(file);
+}
+
+inline std::vector<std::string> loadRadixColumns(const std::string& path) {
+    std::vector<std::string> columns;
+    std::ifstream file(path);
+    std::string column;
+    while (std::getline(file, column)) {
+        if (!column.empty()) columns.push_back(column);
+    }
+    return columns;
+}
+
+#endif // RADIX_INDEX_H
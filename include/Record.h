@@ -178,7 +178,7 @@ public:
         if (!std::getline(iss, id_str, '|')) return false;
         if (!std::getline(iss, deleted_str, '|')) return false;
         if (!std::getline(iss, addr_str, '|')) return false;
-        if (!std::getline(iss, fields_str)) return false;
+        std::getline(iss, fields_str);  // Vacío en registros sin valores (tombstones)
         
         record_id = std::stoi(id_str);
         is_deleted = (deleted_str == "1");
@@ -280,7 +280,7 @@ public:
         if (!std::getline(iss, addr_str, '|')) return false;
         if (!std::getline(iss, size_str, '|')) return false;
         if (!std::getline(iss, offsets_str, '|')) return false;
-        if (!std::getline(iss, fields_str)) return false;
+        std::getline(iss, fields_str);  // Vacío en registros sin valores (tombstones)
         
         record_id = std::stoi(id_str);
         is_deleted = (deleted_str == "1");
@@ -316,4 +316,65 @@ public:
     }
 };
 
+/**
+ * @brief Construye un registro fijo o variable con los valores de una fila
+ */
+inline std::shared_ptr<Record> makeRecord(const std::vector<FieldDefinition>& schema, bool fixed_record,
+                                          int record_id, const std::vector<std::string>& values) {
+    if (fixed_record) {
+        auto fixed = std::make_shared<FixedRecord>(record_id);
+        fixed->setSchema(schema);
+        fixed->setFieldValues(values);
+        fixed->calculateFixedSize();
+        return fixed;
+    }
+    auto variable = std::make_shared<VariableRecord>(record_id);
+    variable->setSchema(schema);
+    variable->setFieldValues(values);
+    variable->calculateOffsets();
+    return variable;
+}
+
+/**
+ * @brief Definición de campo como `nombre|tipo|longitud|nullable` (formato de los esquemas)
+ */
+inline std::string serializeFieldDefinition(const FieldDefinition& field) {
+    return field.name + "|" + std::to_string(static_cast<int>(field.type)) + "|" +
+           std::to_string(field.max_length) + "|" + (field.is_nullable ? "1" : "0");
+}
+
+/**
+ * @brief Inversa de serializeFieldDefinition; añade el campo a `schema` si la línea es válida
+ */
+inline bool parseFieldDefinition(const std::string& line, std::vector<FieldDefinition>& schema) {
+    std::istringstream iss(line);
+    std::string name, type_str, length_str, nullable_str;
+    if (!std::getline(iss, name, '|') || !std::getline(iss, type_str, '|') ||
+        !std::getline(iss, length_str, '|') || !std::getline(iss, nullable_str)) {
+        return false;
+    }
+    try {
+        schema.emplace_back(name, static_cast<FieldType>(std::stoi(type_str)), std::stoull(length_str),
+                            nullable_str == "1");
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Valores de una línea CSV, sin los espacios de los extremos
+ */
+inline std::vector<std::string> parseCSVLine(const std::string& line) {
+    std::vector<std::string> values;
+    std::istringstream iss(line);
+    std::string value;
+    while (std::getline(iss, value, ',')) {
+        value.erase(0, value.find_first_not_of(" \t"));
+        value.erase(value.find_last_not_of(" \t") + 1);
+        values.push_back(value);
+    }
+    return values;
+}
+
 #endif // RECORD_H
\ No newline at end of file
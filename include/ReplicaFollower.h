@@ -0,0 +1,287 @@
+#ifndef REPLICA_FOLLOWER_H
+#define REPLICA_FOLLOWER_H
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <condition_variable>
+#include "DiskManager.h"
+#include "ShippingLog.h"
+
+/**
+ * @brief Retraso de una réplica medido durante una carga masiva
+ */
+struct ReplicationLagReport {
+    size_t records = 0;                 // Registros insertados en el primario
+    double load_ms = 0.0;               // Duración de la carga
+    double catch_up_ms = 0.0;           // Tiempo hasta que la réplica alcanzó al primario
+    long long max_lag_lsn = 0;          // Máximo de entradas pendientes de reproducir
+    double mean_lag_lsn = 0.0;
+    double mean_lag_ms = 0.0;           // Escritura en el primario -> visible en la réplica
+    double p99_lag_ms = 0.0;
+    double max_lag_ms = 0.0;
+};
+
+/**
+ * @brief Réplica de solo lectura que reproduce el log enviado por el primario
+ *
+ * Un hilo sigue el directorio compartido y aplica cada entrada en su propio
+ * DiskManager. Las consultas se serializan con la reproducción mediante un
+ * mutex. Se puede fijar un límite de reproducción para leer el estado exacto
+ * en un LSN dado y reanudar después. Funciona igual si el primario vive en
+ * otro proceso: solo comparten el directorio.
+ */
+class ReplicaFollower {
+private:
+    using SteadyClock = std::chrono::steady_clock;
+
+    std::unique_ptr<DiskManager> replica;
+    ShippingLogReader reader;
+    std::thread replay_thread;
+    std::atomic<bool> running;
+    std::atomic<long long> applied_lsn;
+    long long replay_limit;             // 0 = sin límite
+    std::deque<WalRecord> pending;      // Entradas recibidas por encima del límite
+    std::vector<std::pair<long long, SteadyClock::time_point>> apply_history;
+    std::chrono::milliseconds poll_interval;
+
+    mutable std::mutex mutex;
+    std::condition_variable applied_cv;
+
+public:
+    ReplicaFollower(const std::string& replica_path, const std::string& ship_directory)
+        : replica(std::make_unique<DiskManager>(replica_path))
+        , reader(ship_directory)
+        , running(false)
+        , applied_lsn(0)
+        , replay_limit(0)
+        , poll_interval(2)
+    {
+    }
+
+    ~ReplicaFollower() {
+        stop();
+    }
+
+    ReplicaFollower(const ReplicaFollower&) = delete;
+    ReplicaFollower& operator=(const ReplicaFollower&) = delete;
+
+    /**
+     * @brief Crea el disco base de una réplica a partir del primario
+     *
+     * Activa el envío de log (si no lo estaba) antes de tomar la instantánea,
+     * de modo que toda modificación posterior al respaldo llega por el log.
+     * El respaldo base queda en `<réplica>_base.arc`.
+     */
+    static bool bootstrap(DiskManager& primary, const std::string& ship_directory,
+                          const std::string& replica_path) {
+        if (!primary.isShippingLog() && !primary.enableLogShipping(ship_directory)) {
+            return false;
+        }
+
+        std::string archive = replica_path + "_base.arc";
+        if (!primary.beginSnapshot(archive)) {
+            return false;
+        }
+        SnapshotReport report = primary.finishSnapshot();
+        return report.ok && DiskManager::restoreSnapshot(archive, replica_path);
+    }
+
+    /**
+     * @brief Carga el disco de la réplica y arranca la reproducción continua
+     */
+    bool start() {
+        if (running) {
+            return true;
+        }
+        if (!replica->loadExistingDisk()) {
+            std::cout << "Error: no se pudo cargar el disco de la réplica." << std::endl;
+            return false;
+        }
+
+        applied_lsn = replica->getLastPageLSN();
+        running = true;
+        replay_thread = std::thread(&ReplicaFollower::replayLoop, this);
+        return true;
+    }
+
+    void stop() {
+        running = false;
+        if (replay_thread.joinable()) {
+            replay_thread.join();
+        }
+    }
+
+    long long getAppliedLSN() const { return applied_lsn; }
+
+    /**
+     * @brief Detiene la reproducción tras el LSN indicado (0 = sin límite)
+     */
+    void setReplayLimit(long long lsn) {
+        std::lock_guard<std::mutex> lock(mutex);
+        replay_limit = lsn;
+    }
+
+    /**
+     * @brief Espera a que la réplica haya reproducido hasta `lsn`
+     */
+    bool waitForReplay(long long lsn, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return applied_cv.wait_for(lock, timeout, [this, lsn] { return applied_lsn >= lsn; });
+    }
+
+    /**
+     * @brief Busca un registro en el estado actual de la réplica
+     */
+    std::shared_ptr<Record> findRecord(const std::string& table_name, int record_id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return replica->findRecord(table_name, record_id);
+    }
+
+    /**
+     * @brief Ejecuta una consulta cualquiera sobre la réplica, serializada con la reproducción
+     */
+    template <typename Query>
+    auto query(Query&& run) -> decltype(run(std::declval<DiskManager&>())) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return run(*replica);
+    }
+
+    /**
+     * @brief Busca un registro en cuanto la réplica alcanza el punto indicado
+     * @return nullptr si el registro no existe o si no se alcanzó `lsn` a tiempo
+     */
+    std::shared_ptr<Record> findRecordAt(const std::string& table_name, int record_id,
+                                         long long lsn,
+                                         std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!applied_cv.wait_for(lock, timeout, [this, lsn] { return applied_lsn >= lsn; })) {
+            return nullptr;
+        }
+        return replica->findRecord(table_name, record_id);
+    }
+
+    /**
+     * @brief Inserta filas en el primario y mide cuánto tarda la réplica en verlas
+     *
+     * Cada inserción anota el LSN del primario y el instante de escritura; el
+     * retraso de esa escritura es el tiempo hasta que la réplica aplica su LSN.
+     */
+    ReplicationLagReport measureLag(DiskManager& primary, const std::string& table_name,
+                                    const std::vector<std::vector<std::string>>& rows) {
+        ReplicationLagReport report;
+        std::vector<std::pair<long long, SteadyClock::time_point>> writes;
+        long long lag_sum = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            apply_history.clear();
+        }
+
+        auto start = SteadyClock::now();
+        for (const auto& row : rows) {
+            if (!primary.insertRecord(table_name, row)) continue;
+
+            long long lsn = primary.getLastPageLSN();
+            long long lag = lsn - applied_lsn;
+            writes.emplace_back(lsn, SteadyClock::now());
+            report.max_lag_lsn = std::max(report.max_lag_lsn, lag);
+            lag_sum += lag;
+            report.records++;
+        }
+        auto loaded = SteadyClock::now();
+        report.load_ms = std::chrono::duration<double, std::milli>(loaded - start).count();
+
+        if (writes.empty()) {
+            return report;
+        }
+        if (!waitForReplay(writes.back().first, std::chrono::milliseconds(60000))) {
+            std::cout << "Advertencia: la réplica no alcanzó al primario en 60 s." << std::endl;
+        }
+        report.catch_up_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - loaded).count();
+        report.mean_lag_lsn = static_cast<double>(lag_sum) / report.records;
+
+        std::vector<double> lags;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& write : writes) {
+                auto applied = std::lower_bound(
+                    apply_history.begin(), apply_history.end(), write.first,
+                    [](const std::pair<long long, SteadyClock::time_point>& entry, long long lsn) {
+                        return entry.first < lsn;
+                    });
+                if (applied != apply_history.end()) {
+                    lags.push_back(std::chrono::duration<double, std::milli>(applied->second - write.second).count());
+                }
+            }
+        }
+
+        if (!lags.empty()) {
+            std::sort(lags.begin(), lags.end());
+            double sum = 0.0;
+            for (double lag : lags) sum += lag;
+            report.mean_lag_ms = sum / lags.size();
+            report.p99_lag_ms = lags[std::min(lags.size() - 1, static_cast<size_t>(lags.size() * 0.99))];
+            report.max_lag_ms = lags.back();
+        }
+        return report;
+    }
+
+    static void displayLagReport(const ReplicationLagReport& report) {
+        std::cout << "\n=== RETRASO DE REPLICACIÓN ===" << std::endl;
+        std::cout << "Registros: " << report.records << " en " << report.load_ms << " ms" << std::endl;
+        std::cout << "Entradas pendientes: media " << report.mean_lag_lsn
+                  << " | máximo " << report.max_lag_lsn << std::endl;
+        std::cout << "Retraso: medio " << report.mean_lag_ms << " ms | p99 " << report.p99_lag_ms
+                  << " ms | máximo " << report.max_lag_ms << " ms" << std::endl;
+        std::cout << "Puesta al día tras la carga: " << report.catch_up_ms << " ms" << std::endl;
+    }
+
+private:
+    /**
+     * @brief Cuerpo del hilo de reproducción
+     */
+    void replayLoop() {
+        while (running) {
+            auto batch = reader.poll();
+            bool applied_any = false;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (const auto& record : batch) {
+                    if (record.lsn > applied_lsn) {
+                        pending.push_back(record);
+                    }
+                }
+
+                while (!pending.empty() &&
+                       (replay_limit == 0 || pending.front().lsn <= replay_limit)) {
+                    replica->applyShippedRecord(pending.front());
+                    applied_lsn = pending.front().lsn;
+                    pending.pop_front();
+                    applied_any = true;
+                }
+
+                if (applied_any) {
+                    apply_history.emplace_back(applied_lsn.load(), SteadyClock::now());
+                }
+            }
+
+            if (applied_any) {
+                applied_cv.notify_all();
+            } else {
+                std::this_thread::sleep_for(poll_interval);
+            }
+        }
+    }
+};
+
+#endif // REPLICA_FOLLOWER_H
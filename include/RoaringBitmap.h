@@ -0,0 +1,290 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Conjunto comprimido de enteros de 32 bits (estilo Roaring)
+ *
+ * Los 16 bits altos eligen un contenedor y los 16 bajos la posición dentro
+ * de él. Un contenedor con pocos elementos es un arreglo ordenado de
+ * uint16_t; por encima de ARRAY_LIMIT pasa a ser un mapa de 65536 bits,
+ * que ocupa lo mismo (8 KB) que 4096 elementos en arreglo. Las operaciones
+ * entre dos mapas de bits recorren palabras de 128 bits con SSE2, que todo
+ * x86-64 tiene y que el Makefile (sin -march) sí llega a compilar.
+ */
+class RoaringBitmap {
+public:
+    static constexpr size_t ARRAY_LIMIT = 4096;
+    static constexpr size_t BITMAP_WORDS = 65536 / 64;
+
+    struct Container {
+        uint16_t key = 0;
+        bool is_bitmap = false;
+        uint32_t cardinality = 0;
+        std::vector<uint16_t> values;       // Contenedor arreglo (ordenado)
+        std::vector<uint64_t> words;        // Contenedor mapa de bits
+
+        bool contains(uint16_t low) const {
+            if (is_bitmap) return (words[low >> 6] >> (low & 63)) & 1ULL;
+            return std::binary_search(values.begin(), values.end(), low);
+        }
+
+        template <typename Visitor>
+        void forEach(Visitor visit) const {
+            uint32_t high = static_cast<uint32_t>(key) << 16;
+            if (!is_bitmap) {
+                for (uint16_t low : values) visit(high | low);
+                return;
+            }
+            for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+                uint64_t word = words[w];
+                while (word != 0) {
+                    visit(high | static_cast<uint32_t>(w * 64 + __builtin_ctzll(word)));
+                    word &= word - 1;
+                }
+            }
+        }
+
+        size_t sizeInBytes() const {
+            return is_bitmap ? BITMAP_WORDS * sizeof(uint64_t) : values.size() * sizeof(uint16_t);
+        }
+    };
+
+private:
+    std::vector<Container> containers;  // Ordenados por clave
+
+    enum class BitOp { AND, OR, ANDNOT };
+
+public:
+    void add(uint32_t value) {
+        Container& container = containerFor(static_cast<uint16_t>(value >> 16));
+        uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+        if (container.is_bitmap) {
+            uint64_t mask = 1ULL << (low & 63);
+            if ((container.words[low >> 6] & mask) == 0) {
+                container.words[low >> 6] |= mask;
+                container.cardinality++;
+            }
+            return;
+        }
+        auto it = std::lower_bound(container.values.begin(), container.values.end(), low);
+        if (it != container.values.end() && *it == low) return;
+        container.values.insert(it, low);
+        container.cardinality++;
+        if (container.cardinality > ARRAY_LIMIT) toBitmap(container);
+    }
+
+    void remove(uint32_t value) {
+        auto it = findContainer(static_cast<uint16_t>(value >> 16));
+        if (it == containers.end()) return;
+        uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+        if (it->is_bitmap) {
+            uint64_t mask = 1ULL << (low & 63);
+            if (it->words[low >> 6] & mask) {
+                it->words[low >> 6] &= ~mask;
+                it->cardinality--;
+                if (it->cardinality <= ARRAY_LIMIT) toArray(*it);
+            }
+        } else {
+            auto pos = std::lower_bound(it->values.begin(), it->values.end(), low);
+            if (pos == it->values.end() || *pos != low) return;
+            it->values.erase(pos);
+            it->cardinality--;
+        }
+        if (it->cardinality == 0) containers.erase(it);
+    }
+
+    bool contains(uint32_t value) const {
+        auto it = std::lower_bound(containers.begin(), containers.end(), static_cast<uint16_t>(value >> 16),
+                                   [](const Container& c, uint16_t key) { return c.key < key; });
+        return it != containers.end() && it->key == (value >> 16) &&
+               it->contains(static_cast<uint16_t>(value & 0xFFFF));
+    }
+
+    size_t cardinality() const {
+        size_t total = 0;
+        for (const auto& container : containers) total += container.cardinality;
+        return total;
+    }
+
+    bool isEmpty() const { return containers.empty(); }
+    void clear() { containers.clear(); }
+
+    const std::vector<Container>& getContainers() const { return containers; }
+
+    size_t sizeInBytes() const {
+        size_t bytes = 0;
+        for (const auto& container : containers) bytes += container.sizeInBytes() + sizeof(Container);
+        return bytes;
+    }
+
+    std::vector<uint32_t> toVector() const {
+        std::vector<uint32_t> result;
+        result.reserve(cardinality());
+        for (const auto& container : containers) {
+            container.forEach([&result](uint32_t value) { result.push_back(value); });
+        }
+        return result;
+    }
+
+    static RoaringBitmap andOf(const RoaringBitmap& a, const RoaringBitmap& b) { return combine(a, b, BitOp::AND); }
+    static RoaringBitmap orOf(const RoaringBitmap& a, const RoaringBitmap& b) { return combine(a, b, BitOp::OR); }
+
+    /**
+     * @brief Elementos de `a` que no están en `b` (NOT relativo a `a`)
+     */
+    static RoaringBitmap andNotOf(const RoaringBitmap& a, const RoaringBitmap& b) { return combine(a, b, BitOp::ANDNOT); }
+
+private:
+    std::vector<Container>::iterator findContainer(uint16_t key) {
+        auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                                   [](const Container& c, uint16_t k) { return c.key < k; });
+        return (it != containers.end() && it->key == key) ? it : containers.end();
+    }
+
+    Container& containerFor(uint16_t key) {
+        auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                                   [](const Container& c, uint16_t k) { return c.key < k; });
+        if (it == containers.end() || it->key != key) {
+            Container fresh;
+            fresh.key = key;
+            it = containers.insert(it, fresh);
+        }
+        return *it;
+    }
+
+    static void toBitmap(Container& container) {
+        container.words.assign(BITMAP_WORDS, 0);
+        for (uint16_t low : container.values) {
+            container.words[low >> 6] |= 1ULL << (low & 63);
+        }
+        container.values.clear();
+        container.values.shrink_to_fit();
+        container.is_bitmap = true;
+    }
+
+    static void toArray(Container& container) {
+        std::vector<uint16_t> values;
+        values.reserve(container.cardinality);
+        container.forEach([&values](uint32_t value) { values.push_back(static_cast<uint16_t>(value & 0xFFFF)); });
+        container.values = std::move(values);
+        container.words.clear();
+        container.words.shrink_to_fit();
+        container.is_bitmap = false;
+    }
+
+    /**
+     * @brief Operación palabra a palabra entre dos mapas de 1024 palabras
+     * @return Cardinalidad del resultado
+     */
+    static uint32_t combineWords(const uint64_t* a, const uint64_t* b, uint64_t* out, BitOp op) {
+        size_t w = 0;
+#if defined(__SSE2__)
+        for (; w + 2 <= BITMAP_WORDS; w += 2) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + w));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + w));
+            __m128i r = (op == BitOp::AND) ? _mm_and_si128(x, y)
+                      : (op == BitOp::OR)  ? _mm_or_si128(x, y)
+                                           : _mm_andnot_si128(y, x);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + w), r);
+        }
+#endif
+        for (; w < BITMAP_WORDS; ++w) {
+            out[w] = (op == BitOp::AND) ? (a[w] & b[w]) : (op == BitOp::OR) ? (a[w] | b[w]) : (a[w] & ~b[w]);
+        }
+        uint32_t count = 0;
+        for (size_t i = 0; i < BITMAP_WORDS; ++i) count += static_cast<uint32_t>(__builtin_popcountll(out[i]));
+        return count;
+    }
+
+    static Container combineContainers(const Container& a, const Container& b, BitOp op) {
+        Container result;
+        result.key = a.key;
+
+        if (a.is_bitmap && b.is_bitmap) {
+            result.words.assign(BITMAP_WORDS, 0);
+            result.is_bitmap = true;
+            result.cardinality = combineWords(a.words.data(), b.words.data(), result.words.data(), op);
+            if (result.cardinality <= ARRAY_LIMIT) toArray(result);
+            return result;
+        }
+
+        if (!a.is_bitmap && !b.is_bitmap) {
+            auto& out = result.values;
+            if (op == BitOp::AND) {
+                std::set_intersection(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                                      std::back_inserter(out));
+            } else if (op == BitOp::OR) {
+                std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                               std::back_inserter(out));
+            } else {
+                std::set_difference(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                                    std::back_inserter(out));
+            }
+            result.cardinality = static_cast<uint32_t>(out.size());
+            if (result.cardinality > ARRAY_LIMIT) toBitmap(result);
+            return result;
+        }
+
+        // Arreglo contra mapa: sondear el mapa con cada elemento del arreglo
+        const Container& array = a.is_bitmap ? b : a;
+        const Container& bitmap = a.is_bitmap ? a : b;
+        if (op == BitOp::AND || (op == BitOp::ANDNOT && !a.is_bitmap)) {
+            bool keep_present = (op == BitOp::AND);
+            for (uint16_t low : array.values) {
+                if (bitmap.contains(low) == keep_present) result.values.push_back(low);
+            }
+            result.cardinality = static_cast<uint32_t>(result.values.size());
+            return result;
+        }
+
+        // OR, o mapa ANDNOT arreglo: copiar el mapa y aplicar el arreglo
+        result = bitmap;
+        result.key = a.key;
+        for (uint16_t low : array.values) {
+            uint64_t mask = 1ULL << (low & 63);
+            bool present = (result.words[low >> 6] & mask) != 0;
+            if (op == BitOp::OR && !present) {
+                result.words[low >> 6] |= mask;
+                result.cardinality++;
+            } else if (op == BitOp::ANDNOT && present) {
+                result.words[low >> 6] &= ~mask;
+                result.cardinality--;
+            }
+        }
+        if (result.cardinality <= ARRAY_LIMIT) toArray(result);
+        return result;
+    }
+
+    static RoaringBitmap combine(const RoaringBitmap& a, const RoaringBitmap& b, BitOp op) {
+        RoaringBitmap result;
+        size_t i = 0, j = 0;
+        while (i < a.containers.size() || j < b.containers.size()) {
+            bool has_a = i < a.containers.size();
+            bool has_b = j < b.containers.size();
+            if (has_a && (!has_b || a.containers[i].key < b.containers[j].key)) {
+                if (op != BitOp::AND) result.containers.push_back(a.containers[i]);
+                ++i;
+            } else if (has_b && (!has_a || b.containers[j].key < a.containers[i].key)) {
+                if (op == BitOp::OR) result.containers.push_back(b.containers[j]);
+                ++j;
+            } else {
+                Container merged = combineContainers(a.containers[i], b.containers[j], op);
+                if (merged.cardinality > 0) result.containers.push_back(std::move(merged));
+                ++i;
+                ++j;
+            }
+        }
+        return result;
+    }
+};
+
+#endif // ROARING_BITMAP_H
@@ -0,0 +1,314 @@
+#ifndef SSD_MODEL_H
+#define SSD_MODEL_H
+
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include "DeviceModel.h"
+#include "DiskConfig.h"
+#include "PhysicalAddress.h"
+
+/**
+ * @brief Parámetros de un SSD/NVMe simulado
+ *
+ * Los tiempos están en milisegundos. La unidad de lectura/programación es la
+ * página y la de borrado el bloque de borrado (erase block).
+ */
+struct SSDConfig {
+    int channels = 4;                   // Canales del controlador
+    int dies_per_channel = 2;           // Dies que comparten cada canal
+    int blocks_per_die = 1024;          // Bloques de borrado por die
+    int pages_per_block = 256;          // Páginas por bloque de borrado
+    int page_size = 4096;               // Bytes por página
+    double page_read_ms = 0.05;         // Lectura de una página del arreglo flash
+    double page_program_ms = 0.5;       // Programación de una página
+    double block_erase_ms = 3.0;        // Borrado de un bloque completo
+    double channel_transfer_ms = 0.005; // Transferencia de una página por el canal
+    int gc_free_block_threshold = 2;    // Bloques libres por die que disparan GC
+
+    int getTotalDies() const { return channels * dies_per_channel; }
+
+    long long getTotalPages() const {
+        return static_cast<long long>(getTotalDies()) * blocks_per_die * pages_per_block;
+    }
+
+    bool isValid() const {
+        return channels > 0 && dies_per_channel > 0 && blocks_per_die > gc_free_block_threshold &&
+               pages_per_block > 0 && page_size > 0 && gc_free_block_threshold > 0;
+    }
+
+    /**
+     * @brief Ajusta la capacidad física a `logical_pages` más un sobreaprovisionamiento
+     *
+     * Con la capacidad por defecto (millones de páginas) una carga del SGBD
+     * nunca llena un die y la GC no llega a ejecutarse; dimensionado al
+     * conjunto de trabajo, reescribir páginas obliga a recuperar bloques.
+     */
+    static SSDConfig sizedFor(long long logical_pages, double over_provisioning = 0.25) {
+        SSDConfig config;
+        config.pages_per_block = 64;
+        long long physical = static_cast<long long>(logical_pages * (1.0 + std::max(0.0, over_provisioning)));
+        long long per_die = (physical + config.getTotalDies() - 1) / config.getTotalDies();
+        long long blocks = (per_die + config.pages_per_block - 1) / config.pages_per_block;
+        config.blocks_per_die = static_cast<int>(std::max<long long>(blocks, config.gc_free_block_threshold + 2));
+        return config;
+    }
+};
+
+/**
+ * @brief SSD con FTL de mapeo por página y recolección de basura voraz
+ *
+ * Las direcciones físicas del SGBD se traducen a páginas lógicas con
+ * DiskConfig::addressToBlock. Las escrituras nunca sobrescriben: se programan
+ * en el bloque abierto del siguiente die (reparto rotativo entre dies) y la
+ * página anterior queda inválida. Cuando un die se queda sin bloques libres,
+ * la GC mueve las páginas válidas del bloque con menos páginas válidas y lo
+ * borra; esas copias son la amplificación de escritura. Cada die es una unidad
+ * independiente del reloj de simulación.
+ */
+class SSDModel : public DeviceModel {
+private:
+    /**
+     * @brief Ubicación física de una página lógica
+     */
+    struct PageLocation {
+        int die;
+        int block;
+        int page;
+    };
+
+    /**
+     * @brief Estado de un bloque de borrado
+     */
+    struct EraseBlock {
+        std::vector<long long> owners;  // Página lógica escrita en cada página física
+        int valid_pages = 0;
+        int erase_count = 0;
+        bool free = true;
+    };
+
+    /**
+     * @brief Estado de un die
+     */
+    struct Die {
+        std::vector<EraseBlock> blocks;
+        std::vector<int> free_blocks;
+        int open_block = -1;
+        int next_page = 0;
+    };
+
+    SSDConfig ssd;
+    DiskConfig address_space;           // Codificación de direcciones del SGBD
+    std::vector<Die> dies;
+    std::unordered_map<long long, PageLocation> mapping;
+    int next_write_die;
+
+    // Contadores
+    size_t host_reads;
+    size_t host_writes;
+    size_t gc_page_copies;
+    size_t erases;
+    size_t failed_writes;
+
+public:
+    SSDModel(const SSDConfig& config = SSDConfig(), const DiskConfig& addressing = DiskConfig())
+        : ssd(config)
+        , address_space(addressing)
+    {
+        reset();
+    }
+
+    std::string getName() const override {
+        return "SSD (" + std::to_string(ssd.channels) + " canales x " +
+               std::to_string(ssd.dies_per_channel) + " dies)";
+    }
+
+    int getParallelUnits() const override {
+        return ssd.getTotalDies();
+    }
+
+    size_t getRequestSize() const override {
+        return static_cast<size_t>(ssd.page_size);
+    }
+
+    /**
+     * @brief Las lecturas van al die que contiene la página; las escrituras rotan
+     */
+    int unitFor(IOType type, const PhysicalAddress& address) override {
+        long long lpn = address_space.addressToBlock(address);
+        if (type == IOType::READ) {
+            auto it = mapping.find(lpn);
+            if (it != mapping.end()) return it->second.die;
+            return static_cast<int>(lpn % ssd.getTotalDies());
+        }
+
+        int die = next_write_die;
+        next_write_die = (next_write_die + 1) % ssd.getTotalDies();
+        return die;
+    }
+
+    double service(int unit, IOType type, const PhysicalAddress& address) override {
+        long long lpn = address_space.addressToBlock(address);
+
+        if (type == IOType::READ) {
+            host_reads++;
+            return ssd.page_read_ms + ssd.channel_transfer_ms;
+        }
+
+        host_writes++;
+        double time = ssd.channel_transfer_ms;
+        time += collectGarbage(unit);
+
+        // La copia anterior solo se invalida si la nueva quedó programada
+        auto previous = mapping.find(lpn);
+        bool had_copy = previous != mapping.end();
+        PageLocation old_location = had_copy ? previous->second : PageLocation{0, 0, 0};
+        if (!programPage(unit, lpn)) {
+            failed_writes++;
+            return time;
+        }
+        if (had_copy) invalidatePage(old_location);
+        return time + ssd.page_program_ms;
+    }
+
+    void reset() override {
+        dies.assign(ssd.getTotalDies(), Die());
+        for (auto& die : dies) {
+            die.blocks.assign(ssd.blocks_per_die, EraseBlock());
+            for (int b = ssd.blocks_per_die - 1; b >= 0; --b) {
+                die.free_blocks.push_back(b);
+            }
+        }
+        mapping.clear();
+        next_write_die = 0;
+        host_reads = 0;
+        host_writes = 0;
+        gc_page_copies = 0;
+        erases = 0;
+        failed_writes = 0;
+    }
+
+    std::unique_ptr<DeviceModel> clone() const override {
+        return std::make_unique<SSDModel>(ssd, address_space);
+    }
+
+    /**
+     * @brief Páginas programadas por página escrita por el host
+     */
+    double getWriteAmplification() const {
+        if (host_writes == 0) return 1.0;
+        return static_cast<double>(host_writes + gc_page_copies) / host_writes;
+    }
+
+    size_t getEraseCount() const { return erases; }
+    size_t getFailedWrites() const { return failed_writes; }
+    size_t getMappedPages() const { return mapping.size(); }
+    size_t getGCPageCopies() const { return gc_page_copies; }
+    const SSDConfig& getSSDConfig() const { return ssd; }
+
+    void displayModel() const override {
+        std::cout << "Modelo: " << getName()
+                  << " | Lectura: " << ssd.page_read_ms << " ms"
+                  << " | Programación: " << ssd.page_program_ms << " ms"
+                  << " | Borrado: " << ssd.block_erase_ms << " ms ("
+                  << ssd.pages_per_block << " páginas/bloque)" << std::endl;
+        std::cout << "Escrituras del host: " << host_writes
+                  << " | Copias de GC: " << gc_page_copies
+                  << " | Borrados: " << erases
+                  << " | Amplificación de escritura: " << getWriteAmplification() << std::endl;
+        if (failed_writes > 0) {
+            std::cout << "Escrituras sin espacio físico: " << failed_writes << std::endl;
+        }
+    }
+
+private:
+    /**
+     * @brief Marca como inválida una copia que ya no es la vigente de su página lógica
+     */
+    void invalidatePage(const PageLocation& location) {
+        EraseBlock& block = dies[location.die].blocks[location.block];
+        block.owners[location.page] = -1;
+        block.valid_pages--;
+    }
+
+    /**
+     * @brief Programa una página lógica en el bloque abierto del die
+     */
+    bool programPage(int die_index, long long lpn) {
+        Die& die = dies[die_index];
+
+        if (die.open_block < 0 || die.next_page >= ssd.pages_per_block) {
+            if (die.free_blocks.empty()) {
+                return false;
+            }
+            die.open_block = die.free_blocks.back();
+            die.free_blocks.pop_back();
+            die.next_page = 0;
+
+            EraseBlock& fresh = die.blocks[die.open_block];
+            fresh.free = false;
+            fresh.owners.assign(ssd.pages_per_block, -1);
+        }
+
+        EraseBlock& block = die.blocks[die.open_block];
+        block.owners[die.next_page] = lpn;
+        block.valid_pages++;
+        mapping[lpn] = {die_index, die.open_block, die.next_page};
+        die.next_page++;
+        return true;
+    }
+
+    /**
+     * @brief Recupera bloques del die si quedan pocos libres
+     * @return Tiempo dedicado a copias y borrados (ms)
+     */
+    double collectGarbage(int die_index) {
+        Die& die = dies[die_index];
+        double time = 0.0;
+        int attempts = 0;
+
+        while (static_cast<int>(die.free_blocks.size()) < ssd.gc_free_block_threshold &&
+               attempts++ < ssd.blocks_per_die) {
+            // Víctima voraz: bloque lleno con menos páginas válidas
+            int victim = -1;
+            for (int b = 0; b < ssd.blocks_per_die; ++b) {
+                const EraseBlock& candidate = die.blocks[b];
+                if (candidate.free || b == die.open_block) continue;
+                if (victim < 0 || candidate.valid_pages < die.blocks[victim].valid_pages) {
+                    victim = b;
+                }
+            }
+            if (victim < 0 || die.blocks[victim].valid_pages >= ssd.pages_per_block) {
+                break;  // Nada que recuperar
+            }
+
+            // Primero se copian las páginas válidas; la víctima solo se borra vacía
+            for (int page = 0; page < ssd.pages_per_block; ++page) {
+                long long lpn = die.blocks[victim].owners[page];
+                if (lpn < 0) continue;
+                if (!programPage(die_index, lpn)) {
+                    return time;  // Sin páginas libres: la víctima conserva el resto
+                }
+                die.blocks[victim].owners[page] = -1;
+                die.blocks[victim].valid_pages--;
+                gc_page_copies++;
+                time += ssd.page_read_ms + ssd.page_program_ms;
+            }
+
+            EraseBlock& erased = die.blocks[victim];
+            erased.owners.clear();
+            erased.valid_pages = 0;
+            erased.erase_count++;
+            erased.free = true;
+            die.free_blocks.insert(die.free_blocks.begin(), victim);
+            erases++;
+            time += ssd.block_erase_ms;
+        }
+        return time;
+    }
+};
+
+#endif // SSD_MODEL_H
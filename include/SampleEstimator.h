@@ -0,0 +1,225 @@
+#ifndef SAMPLE_ESTIMATOR_H
+#define SAMPLE_ESTIMATOR_H
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+
+/**
+ * @brief Muestra de una consulta aproximada (TABLESAMPLE)
+ *
+ * Primero se eligen unidades al azar y sin reemplazo (`SYSTEM`): tramos de
+ * `run_blocks` bloques consecutivos en orden físico, así que un tramo largo
+ * paga un solo posicionamiento. Después, dentro de cada bloque leído, se
+ * elige cada fila de forma independiente (`BERNOULLI`). `max_blocks` fija el
+ * presupuesto de E/S: nunca se leen más bloques, sea cual sea el porcentaje;
+ * un tramo más largo que el presupuesto se recorta a él.
+ */
+struct SampleSpec {
+    double block_percent = 100.0;       // Porcentaje de bloques de la relación
+    double row_percent = 100.0;         // Porcentaje de filas de cada bloque leído
+    size_t max_blocks = 0;              // 0 = sin límite
+    size_t run_blocks = 1;              // Bloques consecutivos por unidad de muestreo
+    double confidence = 0.95;           // Nivel del intervalo de confianza
+    unsigned seed = 1;
+
+    static SampleSpec system(double percent, size_t budget = 0) {
+        SampleSpec spec;
+        spec.block_percent = percent;
+        spec.max_blocks = budget;
+        return spec;
+    }
+
+    static SampleSpec bernoulli(double percent, size_t budget = 0) {
+        SampleSpec spec;
+        spec.row_percent = percent;
+        spec.max_blocks = budget;
+        return spec;
+    }
+
+    std::string toString() const {
+        std::ostringstream out;
+        if (row_percent >= 100.0) {
+            out << "SYSTEM(" << block_percent << ")";
+        } else if (block_percent >= 100.0) {
+            out << "BERNOULLI(" << row_percent << ")";
+        } else {
+            out << "SYSTEM(" << block_percent << ") + BERNOULLI(" << row_percent << ")";
+        }
+        if (run_blocks > 1) out << " por tramos de " << run_blocks << " bloques";
+        if (max_blocks > 0) out << " con presupuesto de " << max_blocks << " bloques";
+        return out.str();
+    }
+};
+
+/**
+ * @brief Estimación puntual con su intervalo de confianza
+ */
+struct Estimate {
+    double value = 0.0;
+    double std_error = 0.0;
+    double low = 0.0;
+    double high = 0.0;
+
+    bool covers(double exact) const { return exact >= low && exact <= high; }
+};
+
+/**
+ * @brief Estimadores de un muestreo en dos etapas: unidades (bloques o tramos) y filas
+ *
+ * Cada unidad leída aporta totales expandidos por 1/p (Horvitz-Thompson),
+ * con p la probabilidad de elegir una fila. Un total se estima como
+ * N/n veces la suma de los totales de unidad. Su varianza suma dos términos:
+ * la dispersión entre unidades, con corrección por población finita, y la
+ * del muestreo de filas dentro de cada unidad. La media es un estimador de
+ * razón (suma / cuenta) cuya varianza se linealiza con d = y - R·x.
+ */
+class SampleEstimator {
+private:
+    struct UnitTotals {
+        double y = 0.0, x = 0.0;            // Totales expandidos
+        double yy = 0.0, xx = 0.0, xy = 0.0; // Sumas de cuadrados sin expandir (varianza intra-bloque)
+    };
+
+    size_t population_units;
+    double row_rate;
+    std::vector<UnitTotals> units;
+
+public:
+    SampleEstimator(size_t total_units, double rate)
+        : population_units(total_units), row_rate(std::min(1.0, std::max(rate, 1e-9))) {}
+
+    void beginUnit() { units.emplace_back(); }
+
+    /**
+     * @brief Añade una fila elegida: `y` valor agregado, `x` 1 si cumple el filtro
+     */
+    void addRow(double y, double x) {
+        if (units.empty()) beginUnit();
+        UnitTotals& unit = units.back();
+        unit.y += y / row_rate;
+        unit.x += x / row_rate;
+        unit.yy += y * y;
+        unit.xx += x * x;
+        unit.xy += x * y;
+    }
+
+    size_t getSampledUnits() const { return units.size(); }
+
+    Estimate total(bool of_y, double confidence) const {
+        return linearEstimate(of_y ? 1.0 : 0.0, of_y ? 0.0 : 1.0, confidence);
+    }
+
+    /**
+     * @brief Media de y entre las filas con x = 1 (AVG con filtro)
+     */
+    Estimate ratio(double confidence) const {
+        double y = linearEstimate(1.0, 0.0, confidence).value;
+        double x = linearEstimate(0.0, 1.0, confidence).value;
+        Estimate estimate;
+        if (x <= 0.0) {
+            estimate.std_error = std::numeric_limits<double>::infinity();
+            estimate.low = -estimate.std_error;
+            estimate.high = estimate.std_error;
+            return estimate;
+        }
+        double r = y / x;
+        Estimate residual = linearEstimate(1.0, -r, confidence);  // Total de d = y - r·x
+        estimate.value = r;
+        estimate.std_error = residual.std_error / x;
+        double margin = criticalValue(confidence) * estimate.std_error;
+        estimate.low = r - margin;
+        estimate.high = r + margin;
+        return estimate;
+    }
+
+    /**
+     * @brief Cuantil normal de un intervalo bilateral (0.95 -> 1.96)
+     */
+    static double zScore(double confidence) {
+        confidence = std::min(std::max(confidence, 0.5), 0.999999);
+        double low = 0.0, high = 10.0;
+        for (int i = 0; i < 100; ++i) {
+            double mid = (low + high) / 2;
+            if (std::erf(mid / std::sqrt(2.0)) < confidence) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        return (low + high) / 2;
+    }
+
+    /**
+     * @brief Cuantil t de Student con `df` grados de libertad (Cornish-Fisher)
+     */
+    static double tScore(double confidence, size_t df) {
+        double z = zScore(confidence);
+        double v = static_cast<double>(std::max<size_t>(df, 1));
+        double z3 = z * z * z, z5 = z3 * z * z, z7 = z5 * z * z;
+        return z + (z3 + z) / (4 * v) + (5 * z5 + 16 * z3 + 3 * z) / (96 * v * v) +
+               (3 * z7 + 19 * z5 + 17 * z3 - 15 * z) / (384 * v * v * v);
+    }
+
+private:
+    /**
+     * @brief Con pocas unidades la varianza entre ellas se estima con n - 1 grados de libertad
+     */
+    double criticalValue(double confidence) const {
+        return units.size() < population_units ? tScore(confidence, units.size() - 1) : zScore(confidence);
+    }
+
+    /**
+     * @brief Total estimado de a·y + b·x y su intervalo
+     */
+    Estimate linearEstimate(double a, double b, double confidence) const {
+        Estimate estimate;
+        size_t n = units.size();
+        double big_n = static_cast<double>(population_units);
+        if (n == 0) {
+            estimate.std_error = std::numeric_limits<double>::infinity();
+            estimate.low = -estimate.std_error;
+            estimate.high = estimate.std_error;
+            return estimate;
+        }
+
+        double sum = 0.0, within = 0.0;
+        std::vector<double> totals;
+        for (const auto& unit : units) {
+            double t = a * unit.y + b * unit.x;
+            totals.push_back(t);
+            sum += t;
+            // Varianza de un total Bernoulli: (1 - p) / p² · Σ z²
+            within += (1.0 - row_rate) / (row_rate * row_rate) *
+                      (a * a * unit.yy + 2 * a * b * unit.xy + b * b * unit.xx);
+        }
+        double mean = sum / n;
+        estimate.value = big_n * mean;
+
+        double between = 0.0;
+        if (n < population_units) {
+            if (n < 2) {
+                // Una sola unidad no dice nada de la dispersión entre unidades
+                estimate.std_error = std::numeric_limits<double>::infinity();
+                estimate.low = -estimate.std_error;
+                estimate.high = estimate.std_error;
+                return estimate;
+            }
+            double squares = 0.0;
+            for (double t : totals) squares += (t - mean) * (t - mean);
+            double s2 = squares / (n - 1);
+            between = big_n * big_n * (1.0 - n / big_n) * s2 / n;
+        }
+        double variance = between + (big_n / n) * within;
+        estimate.std_error = std::sqrt(std::max(variance, 0.0));
+        double margin = criticalValue(confidence) * estimate.std_error;
+        estimate.low = estimate.value - margin;
+        estimate.high = estimate.value + margin;
+        return estimate;
+    }
+};
+
+#endif // SAMPLE_ESTIMATOR_H
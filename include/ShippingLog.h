@@ -0,0 +1,123 @@
+#ifndef SHIPPING_LOG_H
+#define SHIPPING_LOG_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+#include <iostream>
+#include <filesystem>
+#include "WriteAheadLog.h"
+
+/**
+ * @brief Log enviado del primario a las réplicas por un directorio compartido
+ *
+ * Cada imagen de bloque persistida por el primario se añade, con su LSN de
+ * página, a segmentos `segment_NNNNNN.log` con el formato de WriteAheadLog.
+ * Un segmento se cierra al alcanzar `segment_records` entradas y nunca vuelve a
+ * modificarse, así que los seguidores pueden leerlos sin coordinación.
+ * Las entradas con relación `#SCHEMA:<tabla>` llevan el archivo de esquema y
+ * las `#FREE` liberan la dirección indicada.
+ */
+class ShippingLog {
+private:
+    std::string directory;
+    size_t segment_records;
+    int segment;
+    WriteAheadLog current;
+
+public:
+    static constexpr const char* SCHEMA_PREFIX = "#SCHEMA:";
+    static constexpr const char* FREE_RELATION = "#FREE";
+
+    ShippingLog() : segment_records(4096), segment(0) {}
+
+    /**
+     * @brief Abre el directorio y continúa en el último segmento existente
+     */
+    bool open(const std::string& dir, size_t records_per_segment = 4096) {
+        directory = dir;
+        segment_records = std::max<size_t>(1, records_per_segment);
+
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        if (ec) {
+            std::cerr << "Error creando el directorio de envío: " << directory << std::endl;
+            return false;
+        }
+
+        segment = 1;
+        while (std::filesystem::exists(segmentPath(directory, segment + 1))) {
+            segment++;
+        }
+        return current.open(segmentPath(directory, segment));
+    }
+
+    /**
+     * @brief Añade una entrada; abre un segmento nuevo si el actual está lleno
+     */
+    bool append(const WalRecord& record) {
+        if (!isOpen()) {
+            return false;
+        }
+        if (current.getRecordCount() >= segment_records) {
+            segment++;
+            if (!current.open(segmentPath(directory, segment))) {
+                return false;
+            }
+        }
+        return current.appendRecord(record);
+    }
+
+    bool isOpen() const { return !directory.empty(); }
+    const std::string& getDirectory() const { return directory; }
+    int getSegment() const { return segment; }
+
+    static std::string segmentPath(const std::string& dir, int number) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "segment_%06d.log", number);
+        return dir + "/" + name;
+    }
+};
+
+/**
+ * @brief Lector incremental de un ShippingLog escrito por otro proceso
+ */
+class ShippingLogReader {
+private:
+    std::string directory;
+    int segment;
+    std::streamoff offset;
+
+public:
+    explicit ShippingLogReader(const std::string& dir = "")
+        : directory(dir), segment(1), offset(0) {}
+
+    /**
+     * @brief Devuelve las entradas nuevas desde la última llamada
+     */
+    std::vector<WalRecord> poll() {
+        std::vector<WalRecord> records;
+
+        while (true) {
+            WriteAheadLog log(ShippingLog::segmentPath(directory, segment));
+            auto batch = log.readFromOffset(offset);
+            records.insert(records.end(), batch.begin(), batch.end());
+
+            if (!std::filesystem::exists(ShippingLog::segmentPath(directory, segment + 1))) {
+                break;
+            }
+
+            // El siguiente segmento existe: el actual ya no crece, releer su final
+            batch = log.readFromOffset(offset);
+            records.insert(records.end(), batch.begin(), batch.end());
+            segment++;
+            offset = 0;
+        }
+        return records;
+    }
+
+    int getSegment() const { return segment; }
+};
+
+#endif // SHIPPING_LOG_H
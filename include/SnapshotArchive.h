@@ -0,0 +1,196 @@
+#ifndef SNAPSHOT_ARCHIVE_H
+#define SNAPSHOT_ARCHIVE_H
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <filesystem>
+#include "PhysicalAddress.h"
+#include "BlockCompressor.h"
+
+/**
+ * @brief Sección de un archivo de respaldo
+ *
+ * CONFIG guarda disk_config.txt, SCHEMA un archivo de esquema (name es el
+ * nombre del archivo) y BLOCK la imagen serializada de un bloque (name es la
+ * relación y tier el nivel de almacenamiento de origen).
+ */
+struct ArchiveSection {
+    std::string kind;
+    std::string name;
+    PhysicalAddress address;
+    std::string tier;
+    std::string data;       // Contenido sin comprimir
+};
+
+/**
+ * @brief Escribe un respaldo completo en un único archivo
+ *
+ * Formato: una línea de cabecera `SGBD_ARCHIVE|1|<etiqueta>` y, por sección,
+ * una línea `SECTION|tipo|nombre|dirección|nivel|bytes` seguida de los bytes
+ * comprimidos con LZSS. Se escribe en `<ruta>.part` y solo se renombra al
+ * cerrar, así que un respaldo interrumpido nunca parece completo.
+ */
+class ArchiveWriter {
+private:
+    std::string path;
+    std::ofstream file;
+    size_t sections;
+    long long raw_bytes;
+    long long bytes_written;
+
+public:
+    ArchiveWriter() : sections(0), raw_bytes(0), bytes_written(0) {}
+
+    bool open(const std::string& archive_path, const std::string& label) {
+        path = archive_path;
+        sections = 0;
+        raw_bytes = 0;
+        bytes_written = 0;
+
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        std::error_code ec;
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent, ec);
+        }
+
+        file.open(path + ".part", std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        writeLine("SGBD_ARCHIVE|1|" + label);
+        return static_cast<bool>(file);
+    }
+
+    bool write(const ArchiveSection& section) {
+        std::string compressed = BlockCompressor::compress(section.data);
+        std::ostringstream header;
+        header << "SECTION|" << section.kind << "|" << section.name << "|"
+               << section.address.toString() << "|" << section.tier << "|" << compressed.size();
+
+        writeLine(header.str());
+        file.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+        file << '\n';
+        bytes_written += static_cast<long long>(compressed.size() + 1);
+        raw_bytes += static_cast<long long>(section.data.size());
+        sections++;
+        return static_cast<bool>(file);
+    }
+
+    /**
+     * @brief Cierra el archivo y lo publica con su nombre definitivo
+     */
+    bool close() {
+        writeLine("END|" + std::to_string(sections));
+        file.flush();
+        bool ok = static_cast<bool>(file);
+        file.close();
+        if (!ok) {
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(path + ".part", path, ec);
+        return !ec;
+    }
+
+    /**
+     * @brief Descarta un respaldo a medias
+     */
+    void abort() {
+        file.close();
+        std::error_code ec;
+        std::filesystem::remove(path + ".part", ec);
+    }
+
+    size_t getSectionCount() const { return sections; }
+    long long getRawBytes() const { return raw_bytes; }
+    long long getBytesWritten() const { return bytes_written; }
+
+private:
+    void writeLine(const std::string& line) {
+        file << line << '\n';
+        bytes_written += static_cast<long long>(line.size() + 1);
+    }
+};
+
+/**
+ * @brief Lee secuencialmente las secciones de un archivo de respaldo
+ */
+class ArchiveReader {
+private:
+    std::ifstream file;
+    std::string label;
+    bool complete;
+
+public:
+    ArchiveReader() : complete(false) {}
+
+    bool open(const std::string& archive_path) {
+        file.open(archive_path, std::ios::binary);
+        complete = false;
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string header;
+        if (!std::getline(file, header) || header.find("SGBD_ARCHIVE|1|") != 0) {
+            std::cerr << "Archivo de respaldo no reconocido: " << archive_path << std::endl;
+            return false;
+        }
+        label = header.substr(15);
+        return true;
+    }
+
+    /**
+     * @brief Lee la siguiente sección
+     * @return false al llegar a la marca END o si el archivo está corrupto
+     */
+    bool next(ArchiveSection& section) {
+        std::string line;
+        if (!std::getline(file, line)) {
+            return false;
+        }
+        if (line.find("END|") == 0) {
+            complete = true;
+            return false;
+        }
+
+        std::istringstream iss(line);
+        std::string tag, address, size;
+        if (!std::getline(iss, tag, '|') || tag != "SECTION" ||
+            !std::getline(iss, section.kind, '|') || !std::getline(iss, section.name, '|') ||
+            !std::getline(iss, address, '|') || !std::getline(iss, section.tier, '|') ||
+            !std::getline(iss, size)) {
+            return false;
+        }
+
+        size_t length = 0;
+        try {
+            length = static_cast<size_t>(std::stoull(size));
+        } catch (const std::exception&) {
+            return false;
+        }
+        if (!PhysicalAddress::fromString(address, section.address)) {
+            return false;
+        }
+
+        std::string compressed(length, '\0');
+        file.read(&compressed[0], static_cast<std::streamsize>(compressed.size()));
+        if (!file) {
+            return false;
+        }
+        file.ignore(1);  // Salto de línea tras los datos
+        return BlockCompressor::decompress(compressed, section.data);
+    }
+
+    const std::string& getLabel() const { return label; }
+
+    /**
+     * @brief Indica si se alcanzó la marca final (respaldo íntegro)
+     */
+    bool isComplete() const { return complete; }
+};
+
+#endif // SNAPSHOT_ARCHIVE_H
@@ -0,0 +1,330 @@
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+#include "Record.h"
+
+/**
+ * @brief Coincidencia de un valor con un patrón LIKE (`%` cualquier secuencia, `_` un carácter)
+ */
+inline bool likeMatch(const std::string& value, const std::string& pattern) {
+    size_t v = 0, p = 0;
+    size_t star = std::string::npos, resume = 0;
+    while (v < value.size()) {
+        if (p < pattern.size() && (pattern[p] == '_' || pattern[p] == value[v])) {
+            ++v;
+            ++p;
+        } else if (p < pattern.size() && pattern[p] == '%') {
+            star = p++;
+            resume = v;
+        } else if (star != std::string::npos) {
+            p = star + 1;
+            v = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '%') ++p;
+    return p == pattern.size();
+}
+
+/**
+ * @brief Índice invertido de trigramas sobre una columna STRING de una tabla heap
+ *
+ * Las listas de apariciones (IDs de registro ordenados) se guardan en bloques
+ * del disco simulado, en una relación propia `trgm_<tabla>_<columna>`: cada
+ * registro del índice lleva un trigrama en hexadecimal y un tramo de hasta
+ * CHUNK_IDS IDs codificados por diferencias. En memoria solo quedan el
+ * directorio (trigrama -> tramos) y las inserciones pendientes, que se
+ * vuelcan en bloques nuevos cada FLUSH_ROWS filas. Como los IDs no cambian al
+ * compactar ni al recargar, las listas en disco siguen siendo válidas; el
+ * localizador ID -> RID se reconstruye con el resto de índices de filas.
+ * `metadata/trigram_<tabla>.txt` guarda cada columna con el último ID volcado.
+ */
+class TrigramIndex {
+public:
+    static constexpr size_t CHUNK_IDS = 96;
+    static constexpr size_t FLUSH_ROWS = 128;
+
+    struct Chunk {
+        size_t block;       // Posición en la relación del índice
+        size_t slot;
+        size_t count;
+    };
+
+private:
+    std::string column;
+    size_t field;
+    std::map<uint32_t, std::vector<Chunk>> directory;
+    std::map<uint32_t, std::vector<int>> pending;
+    size_t pending_rows;
+    int flushed_id;                                 // IDs <= flushed_id ya están en disco
+    std::unordered_map<int, uint32_t> locator;      // ID de registro -> RID
+
+public:
+    TrigramIndex() : field(0), pending_rows(0), flushed_id(0) {}
+
+    bool configure(const std::vector<FieldDefinition>& schema, const std::string& name) {
+        for (size_t i = 0; i < schema.size(); ++i) {
+            if (schema[i].name == name && schema[i].type == FieldType::STRING) {
+                column = name;
+                field = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const std::string& getColumn() const { return column; }
+    std::string getRelationName(const std::string& table_name) const {
+        return "trgm_" + table_name + "_" + column;
+    }
+
+    /**
+     * @brief Trigramas distintos de un texto, ordenados (3 bytes por entero)
+     */
+    static std::vector<uint32_t> trigramsOf(const std::string& text) {
+        std::vector<uint32_t> trigrams;
+        for (size_t i = 0; i + 3 <= text.size(); ++i) {
+            trigrams.push_back((static_cast<uint32_t>(static_cast<uint8_t>(text[i])) << 16) |
+                               (static_cast<uint32_t>(static_cast<uint8_t>(text[i + 1])) << 8) |
+                               static_cast<uint32_t>(static_cast<uint8_t>(text[i + 2])));
+        }
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        return trigrams;
+    }
+
+    /**
+     * @brief Trigramas que debe contener cualquier valor que cumpla el patrón LIKE
+     */
+    static std::vector<uint32_t> trigramsOfPattern(const std::string& pattern) {
+        std::vector<uint32_t> trigrams;
+        std::string literal;
+        for (size_t i = 0; i <= pattern.size(); ++i) {
+            if (i == pattern.size() || pattern[i] == '%' || pattern[i] == '_') {
+                auto piece = trigramsOf(literal);
+                trigrams.insert(trigrams.end(), piece.begin(), piece.end());
+                literal.clear();
+            } else {
+                literal += pattern[i];
+            }
+        }
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        return trigrams;
+    }
+
+    void addRow(int record_id, uint32_t rid, const Record& record) {
+        locator[record_id] = rid;
+        if (record_id > flushed_id) queueRow(record_id, record);
+    }
+
+    /**
+     * @brief Encola los trigramas de una fila aunque su ID ya esté volcado (actualizaciones)
+     */
+    void queueRow(int record_id, const Record& record) {
+        for (uint32_t trigram : trigramsOf(record.getField(field))) {
+            pending[trigram].push_back(record_id);
+        }
+        pending_rows++;
+    }
+
+    void removeRow(int record_id) { locator.erase(record_id); }
+
+    /**
+     * @brief Olvida las filas (no las listas en disco) antes de reconstruir
+     */
+    void clearRows() {
+        locator.clear();
+        pending.clear();
+        pending_rows = 0;
+    }
+
+    /**
+     * @brief Olvida también las listas en disco (la relación del índice se reescribe)
+     */
+    void clearPostings() {
+        directory.clear();
+        flushed_id = 0;
+    }
+
+    bool needsFlush() const { return pending_rows >= FLUSH_ROWS; }
+    bool hasPending() const { return pending_rows > 0; }
+    size_t getPendingRows() const { return pending_rows; }
+
+    bool locate(int record_id, uint32_t& rid) const {
+        auto it = locator.find(record_id);
+        if (it == locator.end()) return false;
+        rid = it->second;
+        return true;
+    }
+
+    /**
+     * @brief Convierte las inserciones pendientes en registros de índice
+     *
+     * El llamador los coloca en bloques y anota cada tramo con addChunk.
+     * @param trigrams Trigrama de cada registro devuelto
+     */
+    std::vector<std::shared_ptr<Record>> takePending(std::vector<uint32_t>& trigrams) {
+        std::vector<std::shared_ptr<Record>> records;
+        static const std::vector<FieldDefinition> layout = {
+            FieldDefinition("trigrama", FieldType::STRING, 6),
+            FieldDefinition("ids", FieldType::STRING, 0)
+        };
+        for (auto& entry : pending) {
+            std::vector<int>& ids = entry.second;
+            std::sort(ids.begin(), ids.end());
+            ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+            for (size_t start = 0; start < ids.size(); start += CHUNK_IDS) {
+                size_t end = std::min(ids.size(), start + CHUNK_IDS);
+                auto record = std::make_shared<VariableRecord>(0);
+                record->setSchema(layout);
+                record->setFieldValues({toHex(entry.first), encodeIds(ids, start, end)});
+                record->calculateOffsets();
+                records.push_back(record);
+                trigrams.push_back(entry.first);
+            }
+            flushed_id = std::max(flushed_id, ids.back());
+        }
+        pending.clear();
+        pending_rows = 0;
+        return records;
+    }
+
+    /**
+     * @brief Devuelve a pendientes un tramo de takePending que no se pudo escribir
+     */
+    void requeueChunk(const Record& chunk) {
+        uint32_t trigram = 0;
+        std::vector<int> ids;
+        if (!parseChunk(chunk, trigram, ids)) return;
+        auto& queued = pending[trigram];
+        queued.insert(queued.end(), ids.begin(), ids.end());
+        pending_rows += ids.size();
+    }
+
+    void addChunk(uint32_t trigram, size_t block, size_t slot, size_t count) {
+        directory[trigram].push_back(Chunk{block, slot, count});
+    }
+
+    /**
+     * @brief Registra en el directorio los tramos de un bloque del índice
+     */
+    void loadBlockChunks(size_t block, const std::vector<std::shared_ptr<Record>>& records) {
+        for (size_t slot = 0; slot < records.size(); ++slot) {
+            uint32_t trigram = 0;
+            std::vector<int> ids;
+            if (parseChunk(*records[slot], trigram, ids) && !ids.empty()) {
+                addChunk(trigram, block, slot, ids.size());
+                flushed_id = std::max(flushed_id, ids.back());
+            }
+        }
+    }
+
+    /**
+     * @brief IDs aproximados de un trigrama: tramos en disco más pendientes
+     */
+    size_t estimateCount(uint32_t trigram) const {
+        size_t count = 0;
+        auto it = directory.find(trigram);
+        if (it != directory.end()) {
+            for (const auto& chunk : it->second) count += chunk.count;
+        }
+        auto p = pending.find(trigram);
+        return count + (p != pending.end() ? p->second.size() : 0);
+    }
+
+    const std::vector<Chunk>* chunksOf(uint32_t trigram) const {
+        auto it = directory.find(trigram);
+        return it != directory.end() ? &it->second : nullptr;
+    }
+
+    std::vector<int> pendingOf(uint32_t trigram) const {
+        auto it = pending.find(trigram);
+        return it != pending.end() ? it->second : std::vector<int>();
+    }
+
+    size_t getTrigramCount() const { return directory.size(); }
+    size_t getChunkCount() const {
+        size_t count = 0;
+        for (const auto& entry : directory) count += entry.second.size();
+        return count;
+    }
+
+    static bool parseChunk(const Record& record, uint32_t& trigram, std::vector<int>& ids) {
+        if (record.getFieldValues().size() < 2) return false;
+        try {
+            trigram = static_cast<uint32_t>(std::stoul(record.getField(0), nullptr, 16));
+            std::istringstream deltas(record.getField(1));
+            std::string delta;
+            int current = 0;
+            while (std::getline(deltas, delta, ':')) {
+                current += static_cast<int>(std::stol(delta, nullptr, 16));
+                ids.push_back(current);
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+        return true;
+    }
+
+    void setFlushedId(int id) { flushed_id = id; }
+    int getFlushedId() const { return flushed_id; }
+
+private:
+    static std::string toHex(uint32_t value) {
+        std::ostringstream out;
+        out << std::hex << value;
+        return out.str();
+    }
+
+    static std::string encodeIds(const std::vector<int>& ids, size_t start, size_t end) {
+        std::ostringstream out;
+        out << std::hex;
+        int previous = 0;
+        for (size_t i = start; i < end; ++i) {
+            if (i > start) out << ":";
+            out << (ids[i] - previous);
+            previous = ids[i];
+        }
+        return out.str();
+    }
+};
+
+/**
+ * @brief Guarda las columnas con índice de trigramas y su último ID volcado
+ */
+inline bool saveTrigramColumns(const std::string& path, const std::map<std::string, TrigramIndex>& indexes) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error escribiendo los índices de trigramas: " << path << std::endl;
+        return false;
+    }
+    for (const auto& entry : indexes) {
+        file << entry.first << " " << entry.second.getFlushedId() << std::endl;
+    }
+    return static_cast<bool>(file);
+}
+
+inline std::vector<std::pair<std::string, int>> loadTrigramColumns(const std::string& path) {
+    std::vector<std::pair<std::string, int>> columns;
+    std::ifstream file(path);
+    std::string column;
+    int flushed_id = 0;
+    while (file >> column >> flushed_id) {
+        columns.emplace_back(column, flushed_id);
+    }
+    return columns;
+}
+
+#endif // TRIGRAM_INDEX_H
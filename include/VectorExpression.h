@@ -0,0 +1,896 @@
+#ifndef VECTOR_EXPRESSION_H
+#define VECTOR_EXPRESSION_H
+
+#include <cmath>
+#include <cctype>
+#include <memory>
+#include <string>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <sstream>
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include "Record.h"
+#include "PipelineKernels.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+inline bool isNumericType(FieldType type) {
+    return type == FieldType::INTEGER || type == FieldType::FLOAT;
+}
+
+/**
+ * @brief Vector tipado de un lote con su mapa de bits de NULL
+ *
+ * INTEGER se guarda como int64_t, FLOAT como double y STRING o DATE como
+ * texto. Los booleanos son INTEGER 0/1. `nulls` tiene un bit por fila (1 =
+ * NULL) y está vacío mientras ninguna fila es NULL. En los registros un
+ * campo vacío es NULL.
+ */
+struct ColumnVector {
+    FieldType type = FieldType::INTEGER;
+    size_t size = 0;
+    std::vector<int64_t> ints;
+    std::vector<double> floats;
+    std::vector<std::string> strings;
+    std::vector<uint64_t> nulls;
+
+    static ColumnVector make(FieldType type, size_t size) {
+        ColumnVector column;
+        column.type = type == FieldType::DATE ? FieldType::STRING : type;
+        column.size = size;
+        switch (column.type) {
+            case FieldType::INTEGER: column.ints.assign(size, 0); break;
+            case FieldType::FLOAT: column.floats.assign(size, 0.0); break;
+            default: column.strings.assign(size, ""); break;
+        }
+        return column;
+    }
+
+    bool hasNulls() const { return !nulls.empty(); }
+    bool isNull(size_t i) const { return !nulls.empty() && ((nulls[i >> 6] >> (i & 63)) & 1) != 0; }
+
+    void setNull(size_t i) {
+        if (nulls.empty()) nulls.assign((size + 63) / 64, 0);
+        nulls[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+
+    /**
+     * @brief NULL donde lo sea cualquiera de las entradas (OR de palabras de 64 filas)
+     */
+    void propagateNulls(const ColumnVector& a, const ColumnVector& b) {
+        if (!a.hasNulls() && !b.hasNulls()) return;
+        nulls.assign((size + 63) / 64, 0);
+        for (size_t w = 0; w < nulls.size(); ++w) {
+            nulls[w] = (a.hasNulls() ? a.nulls[w] : 0) | (b.hasNulls() ? b.nulls[w] : 0);
+        }
+    }
+
+    double number(size_t i) const { return type == FieldType::INTEGER ? static_cast<double>(ints[i]) : floats[i]; }
+
+    /**
+     * @brief Texto de una fila ("NULL" si lo es)
+     */
+    std::string text(size_t i) const {
+        if (isNull(i)) return "NULL";
+        switch (type) {
+            case FieldType::INTEGER: return std::to_string(ints[i]);
+            case FieldType::FLOAT: {
+                std::ostringstream out;
+                out.precision(15);
+                out << floats[i];
+                return out.str();
+            }
+            default: return strings[i];
+        }
+    }
+
+    /**
+     * @brief Añade una fila decodificando el texto del registro
+     */
+    void appendText(const std::string& value) {
+        size++;
+        if (type == FieldType::INTEGER) ints.push_back(0);
+        else if (type == FieldType::FLOAT) floats.push_back(0.0);
+        else strings.push_back(value);
+        if (!nulls.empty() && nulls.size() * 64 < size) nulls.push_back(0);
+        if (value.empty()) {
+            setNull(size - 1);
+            return;
+        }
+        try {
+            if (type == FieldType::INTEGER) ints.back() = static_cast<int64_t>(std::stoll(value));
+            else if (type == FieldType::FLOAT) floats.back() = std::stod(value);
+        } catch (const std::exception&) {
+            setNull(size - 1);  // Valor ilegible en una columna numérica
+        }
+    }
+
+    /**
+     * @brief Copia la fila `row` de `source` a la posición `i`, convirtiendo al tipo de esta columna
+     */
+    void assign(size_t i, const ColumnVector& source, size_t row) {
+        if (source.isNull(row)) {
+            setNull(i);
+            return;
+        }
+        switch (type) {
+            case FieldType::INTEGER: ints[i] = static_cast<int64_t>(source.number(row)); break;
+            case FieldType::FLOAT: floats[i] = source.number(row); break;
+            default: strings[i] = source.text(row); break;
+        }
+    }
+
+    /**
+     * @brief Añade al final la fila `row` de `source` (gather de las filas seleccionadas)
+     */
+    void append(const ColumnVector& source, size_t row) {
+        size++;
+        if (type == FieldType::INTEGER) ints.push_back(0);
+        else if (type == FieldType::FLOAT) floats.push_back(0.0);
+        else strings.push_back("");
+        if (!nulls.empty() && nulls.size() * 64 < size) nulls.push_back(0);
+        assign(size - 1, source, row);
+    }
+
+    /**
+     * @brief Copia en FLOAT (los INTEGER se convierten; los NULL se conservan)
+     */
+    ColumnVector toFloat() const {
+        if (type == FieldType::FLOAT) return *this;
+        ColumnVector result = make(FieldType::FLOAT, size);
+        for (size_t i = 0; i < size; ++i) result.floats[i] = static_cast<double>(ints[i]);
+        result.nulls = nulls;
+        return result;
+    }
+};
+
+/**
+ * @brief Vector de selección: las filas del lote que siguen vivas
+ *
+ * Denso significa todas las filas; si no, `rows` lista sus posiciones en
+ * orden. Los operadores solo calculan en esas posiciones.
+ */
+struct SelectionVector {
+    bool dense = true;
+    std::vector<uint32_t> rows;
+
+    size_t count(size_t batch_rows) const { return dense ? batch_rows : rows.size(); }
+
+    /**
+     * @brief Con más de la mitad de las filas vivas compensa calcular el lote entero con SIMD
+     */
+    bool worthDense(size_t batch_rows) const { return dense || rows.size() * 2 > batch_rows; }
+
+    template <typename Visit>
+    void forEach(size_t batch_rows, Visit visit) const {
+        if (dense) {
+            for (size_t i = 0; i < batch_rows; ++i) visit(i);
+        } else {
+            for (uint32_t i : rows) visit(i);
+        }
+    }
+};
+
+/**
+ * @brief a[i] op b[i] en double; con SSE2 dos filas por instrucción
+ */
+template <char OP>
+inline void vectorFloatArithmetic(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(a + i);
+        __m128d y = _mm_loadu_pd(b + i);
+        __m128d r;
+        if constexpr (OP == '+') r = _mm_add_pd(x, y);
+        else if constexpr (OP == '-') r = _mm_sub_pd(x, y);
+        else if constexpr (OP == '*') r = _mm_mul_pd(x, y);
+        else r = _mm_div_pd(x, y);
+        _mm_storeu_pd(out + i, r);
+    }
+#endif
+    for (; i < n; ++i) {
+        if constexpr (OP == '+') out[i] = a[i] + b[i];
+        else if constexpr (OP == '-') out[i] = a[i] - b[i];
+        else if constexpr (OP == '*') out[i] = a[i] * b[i];
+        else out[i] = a[i] / b[i];
+    }
+}
+
+/**
+ * @brief a[i] op b[i] en int64_t; SSE2 suma y resta de dos en dos (el producto es escalar)
+ *
+ * El desbordamiento da la vuelta en complemento a dos, como las instrucciones SIMD.
+ */
+template <char OP>
+inline void vectorIntegerArithmetic(const int64_t* a, const int64_t* b, int64_t* out, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    if constexpr (OP == '+' || OP == '-') {
+        for (; i + 2 <= n; i += 2) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            __m128i r = OP == '+' ? _mm_add_epi64(x, y) : _mm_sub_epi64(x, y);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), r);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        uint64_t x = static_cast<uint64_t>(a[i]), y = static_cast<uint64_t>(b[i]);
+        if constexpr (OP == '+') out[i] = static_cast<int64_t>(x + y);
+        else if constexpr (OP == '-') out[i] = static_cast<int64_t>(x - y);
+        else out[i] = static_cast<int64_t>(x * y);
+    }
+}
+
+/**
+ * @brief Dominio en que se compara: enteros, double (con alguna columna FLOAT) o texto
+ */
+enum class CompareDomain {
+    INTEGER,
+    NUMBER,
+    TEXT
+};
+
+/**
+ * @brief out[i] = a[i] ORDER b[i] en las filas seleccionadas, sin decisiones dentro del bucle
+ */
+template <typename Order, CompareDomain DOMAIN>
+inline void compareVectors(const ColumnVector& a, const ColumnVector& b, ColumnVector& out, size_t rows,
+                           const SelectionVector& selection) {
+    Order order;
+    int64_t* result = out.ints.data();
+    if constexpr (DOMAIN == CompareDomain::INTEGER) {
+        const int64_t* x = a.ints.data();
+        const int64_t* y = b.ints.data();
+        if (selection.dense) {
+            for (size_t i = 0; i < rows; ++i) result[i] = order(x[i], y[i]);
+        } else {
+            for (uint32_t i : selection.rows) result[i] = order(x[i], y[i]);
+        }
+    } else if constexpr (DOMAIN == CompareDomain::NUMBER) {
+        const double* x = a.floats.data();
+        const double* y = b.floats.data();
+        if (selection.dense) {
+            for (size_t i = 0; i < rows; ++i) result[i] = order(x[i], y[i]);
+        } else {
+            for (uint32_t i : selection.rows) result[i] = order(x[i], y[i]);
+        }
+    } else {
+        selection.forEach(rows, [&](size_t i) { result[i] = order(a.strings[i], b.strings[i]); });
+    }
+}
+
+using CompareKernel = void (*)(const ColumnVector&, const ColumnVector&, ColumnVector&, size_t,
+                               const SelectionVector&);
+
+template <typename Order>
+inline CompareKernel compareKernelFor(CompareDomain domain) {
+    switch (domain) {
+        case CompareDomain::INTEGER: return compareVectors<Order, CompareDomain::INTEGER>;
+        case CompareDomain::NUMBER: return compareVectors<Order, CompareDomain::NUMBER>;
+        case CompareDomain::TEXT: return compareVectors<Order, CompareDomain::TEXT>;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Instancia de compareVectors para un operador y un dominio (se elige al enlazar)
+ */
+inline CompareKernel selectCompareKernel(CompareOp op, CompareDomain domain) {
+    switch (op) {
+        case CompareOp::LT: return compareKernelFor<std::less<>>(domain);
+        case CompareOp::LE: return compareKernelFor<std::less_equal<>>(domain);
+        case CompareOp::EQ: return compareKernelFor<std::equal_to<>>(domain);
+        case CompareOp::NE: return compareKernelFor<std::not_equal_to<>>(domain);
+        case CompareOp::GE: return compareKernelFor<std::greater_equal<>>(domain);
+        case CompareOp::GT: return compareKernelFor<std::greater<>>(domain);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Expresión evaluada lote a lote
+ *
+ * Cada nodo recibe los vectores del lote y un vector de selección y
+ * devuelve un vector del tamaño del lote, válido en las filas
+ * seleccionadas. bind resuelve el núcleo de cada comparación y cada
+ * función, así que al evaluar solo queda un bucle cerrado por caso. La
+ * aritmética sigue a SQL: INTEGER con INTEGER da INTEGER (salvo `/`, que da
+ * FLOAT), un NULL en cualquier operando da NULL y dividir entre cero
+ * también, igual que los resultados que no caben en int64_t
+ * (`INT64_MIN % -1` y `ABS(INT64_MIN)`). AND, OR y NOT usan lógica de tres
+ * valores. CASE evalúa cada rama solo sobre las filas que llegan a ella.
+ * Funciones: UPPER, LOWER, LENGTH, SUBSTR(texto, inicio, longitud), CONCAT
+ * y ABS.
+ */
+class VectorExpression {
+public:
+    using Ptr = std::shared_ptr<VectorExpression>;
+    using Columns = std::vector<std::shared_ptr<ColumnVector>>;
+
+    enum class Kind {
+        COLUMN,
+        LITERAL,
+        ARITHMETIC,
+        COMPARE,
+        AND,
+        OR,
+        NOT,
+        IS_NULL,
+        CASE,
+        FUNCTION
+    };
+
+    enum class Function {
+        UPPER,
+        LOWER,
+        LENGTH,
+        SUBSTR,
+        CONCAT,
+        ABS
+    };
+
+private:
+    Kind kind;
+    std::string name;                   // Columna, función o texto del literal
+    char arithmetic_op = '+';
+    CompareOp compare_op = CompareOp::EQ;
+    FieldType literal_type = FieldType::INTEGER;
+    std::vector<Ptr> children;          // CASE: condición, valor, ... y ELSE si has_else
+    bool has_else = false;
+
+    // Resueltos por bind
+    size_t column_index = 0;
+    FieldType result_type = FieldType::INTEGER;
+    CompareDomain compare_domain = CompareDomain::INTEGER;
+    CompareKernel compare_kernel = nullptr;
+    Function function_id = Function::UPPER;
+
+    explicit VectorExpression(Kind k) : kind(k) {}
+
+public:
+    static Ptr column(const std::string& column_name) {
+        Ptr node(new VectorExpression(Kind::COLUMN));
+        node->name = column_name;
+        return node;
+    }
+
+    static Ptr literal(const std::string& text, FieldType type) {
+        Ptr node(new VectorExpression(Kind::LITERAL));
+        node->name = text;
+        node->literal_type = type == FieldType::DATE ? FieldType::STRING : type;
+        return node;
+    }
+
+    static Ptr arithmetic(char op, Ptr left, Ptr right) {
+        Ptr node(new VectorExpression(Kind::ARITHMETIC));
+        node->arithmetic_op = op;
+        node->children = {std::move(left), std::move(right)};
+        return node;
+    }
+
+    static Ptr compare(CompareOp op, Ptr left, Ptr right) {
+        Ptr node(new VectorExpression(Kind::COMPARE));
+        node->compare_op = op;
+        node->children = {std::move(left), std::move(right)};
+        return node;
+    }
+
+    static Ptr logicalAnd(Ptr left, Ptr right) {
+        Ptr node(new VectorExpression(Kind::AND));
+        node->children = {std::move(left), std::move(right)};
+        return node;
+    }
+
+    static Ptr logicalOr(Ptr left, Ptr right) {
+        Ptr node(new VectorExpression(Kind::OR));
+        node->children = {std::move(left), std::move(right)};
+        return node;
+    }
+
+    static Ptr logicalNot(Ptr operand) {
+        Ptr node(new VectorExpression(Kind::NOT));
+        node->children = {std::move(operand)};
+        return node;
+    }
+
+    static Ptr isNull(Ptr operand) {
+        Ptr node(new VectorExpression(Kind::IS_NULL));
+        node->children = {std::move(operand)};
+        return node;
+    }
+
+    /**
+     * @brief CASE WHEN c1 THEN v1 ... ELSE otherwise END (sin ELSE: NULL)
+     */
+    static Ptr caseWhen(const std::vector<std::pair<Ptr, Ptr>>& branches, Ptr otherwise = nullptr) {
+        Ptr node(new VectorExpression(Kind::CASE));
+        for (const auto& branch : branches) {
+            node->children.push_back(branch.first);
+            node->children.push_back(branch.second);
+        }
+        if (otherwise) {
+            node->children.push_back(std::move(otherwise));
+            node->has_else = true;
+        }
+        return node;
+    }
+
+    static Ptr function(const std::string& function_name, const std::vector<Ptr>& arguments) {
+        Ptr node(new VectorExpression(Kind::FUNCTION));
+        node->name = function_name;
+        node->children = arguments;
+        return node;
+    }
+
+    FieldType getType() const { return result_type; }
+
+    /**
+     * @brief Resuelve columnas y tipos contra el esquema
+     * @param used Se añaden las posiciones de las columnas que hay que decodificar
+     */
+    bool bind(const std::vector<FieldDefinition>& schema, std::vector<bool>& used) {
+        for (auto& child : children) {
+            if (!child || !child->bind(schema, used)) return false;
+        }
+        switch (kind) {
+            case Kind::COLUMN:
+                for (column_index = 0; column_index < schema.size(); ++column_index) {
+                    if (schema[column_index].name == name) break;
+                }
+                if (column_index == schema.size()) {
+                    std::cout << "Campo '" << name << "' no encontrado." << std::endl;
+                    return false;
+                }
+                used[column_index] = true;
+                result_type = schema[column_index].type == FieldType::DATE ? FieldType::STRING
+                                                                            : schema[column_index].type;
+                return true;
+            case Kind::LITERAL:
+                result_type = literal_type;
+                if (isNumericType(literal_type)) {
+                    try {
+                        (void)std::stod(name);
+                    } catch (const std::exception&) {
+                        std::cout << "Error: el literal '" << name << "' no es un número." << std::endl;
+                        return false;
+                    }
+                }
+                return true;
+            case Kind::ARITHMETIC:
+                if (!isNumericType(children[0]->result_type) || !isNumericType(children[1]->result_type)) {
+                    std::cout << "Error: " << toString() << " necesita operandos numéricos." << std::endl;
+                    return false;
+                }
+                if (arithmetic_op == '%' && (children[0]->result_type != FieldType::INTEGER ||
+                                             children[1]->result_type != FieldType::INTEGER)) {
+                    std::cout << "Error: % necesita operandos INTEGER." << std::endl;
+                    return false;
+                }
+                result_type = arithmetic_op != '/' && children[0]->result_type == FieldType::INTEGER &&
+                                      children[1]->result_type == FieldType::INTEGER
+                                  ? FieldType::INTEGER
+                                  : FieldType::FLOAT;
+                return true;
+            case Kind::COMPARE:
+                if (isNumericType(children[0]->result_type) != isNumericType(children[1]->result_type)) {
+                    std::cout << "Error: " << toString() << " compara texto con números." << std::endl;
+                    return false;
+                }
+                if (!isNumericType(children[0]->result_type)) {
+                    compare_domain = CompareDomain::TEXT;
+                } else if (children[0]->result_type == FieldType::INTEGER &&
+                           children[1]->result_type == FieldType::INTEGER) {
+                    compare_domain = CompareDomain::INTEGER;
+                } else {
+                    compare_domain = CompareDomain::NUMBER;
+                }
+                compare_kernel = selectCompareKernel(compare_op, compare_domain);
+                result_type = FieldType::INTEGER;
+                return true;
+            case Kind::AND:
+            case Kind::OR:
+            case Kind::NOT:
+            case Kind::IS_NULL:
+                result_type = FieldType::INTEGER;
+                return true;
+            case Kind::CASE: {
+                // Tipo común de las ramas: texto si alguna lo es, FLOAT si alguna lo es
+                result_type = FieldType::INTEGER;
+                auto widen = [this](FieldType branch) {
+                    if (branch == FieldType::STRING) result_type = FieldType::STRING;
+                    else if (branch == FieldType::FLOAT && result_type == FieldType::INTEGER) result_type = branch;
+                };
+                size_t branches = (children.size() - (has_else ? 1 : 0)) / 2;
+                for (size_t b = 0; b < branches; ++b) widen(children[2 * b + 1]->result_type);
+                if (has_else) widen(children.back()->result_type);
+                return true;
+            }
+            case Kind::FUNCTION:
+                return bindFunction();
+        }
+        return false;
+    }
+
+    std::string toString() const {
+        switch (kind) {
+            case Kind::COLUMN: return name;
+            case Kind::LITERAL: return literal_type == FieldType::STRING ? "'" + name + "'" : name;
+            case Kind::ARITHMETIC:
+                return "(" + children[0]->toString() + " " + arithmetic_op + " " + children[1]->toString() + ")";
+            case Kind::COMPARE:
+                return children[0]->toString() + " " + compareOpToString(compare_op) + " " + children[1]->toString();
+            case Kind::AND: return "(" + children[0]->toString() + " AND " + children[1]->toString() + ")";
+            case Kind::OR: return "(" + children[0]->toString() + " OR " + children[1]->toString() + ")";
+            case Kind::NOT: return "NOT " + children[0]->toString();
+            case Kind::IS_NULL: return children[0]->toString() + " IS NULL";
+            case Kind::CASE: {
+                std::string text = "CASE";
+                size_t branches = (children.size() - (has_else ? 1 : 0)) / 2;
+                for (size_t b = 0; b < branches; ++b) {
+                    text += " WHEN " + children[2 * b]->toString() + " THEN " + children[2 * b + 1]->toString();
+                }
+                if (has_else) text += " ELSE " + children.back()->toString();
+                return text + " END";
+            }
+            case Kind::FUNCTION: {
+                std::string text = name + "(";
+                for (size_t i = 0; i < children.size(); ++i) text += (i > 0 ? ", " : "") + children[i]->toString();
+                return text + ")";
+            }
+        }
+        return "";
+    }
+
+    /**
+     * @brief Evalúa la expresión sobre las filas seleccionadas de un lote
+     */
+    std::shared_ptr<ColumnVector> evaluate(const Columns& columns, size_t rows, const SelectionVector& selection) const {
+        switch (kind) {
+            case Kind::COLUMN: return columns[column_index];
+            case Kind::LITERAL: return evaluateLiteral(rows);
+            case Kind::ARITHMETIC: return evaluateArithmetic(columns, rows, selection);
+            case Kind::COMPARE: return evaluateCompare(columns, rows, selection);
+            case Kind::AND:
+            case Kind::OR:
+            case Kind::NOT:
+            case Kind::IS_NULL: return evaluateLogical(columns, rows, selection);
+            case Kind::CASE: return evaluateCase(columns, rows, selection);
+            case Kind::FUNCTION: return evaluateFunction(columns, rows, selection);
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Filtro: deja en la selección las filas donde la expresión es verdadera (ni falsa ni NULL)
+     */
+    SelectionVector select(const Columns& columns, size_t rows, const SelectionVector& selection) const {
+        auto truth = evaluate(columns, rows, selection);
+        SelectionVector result;
+        result.dense = false;
+        selection.forEach(rows, [&](size_t i) {
+            if (!truth->isNull(i) && truth->ints[i] != 0) result.rows.push_back(static_cast<uint32_t>(i));
+        });
+        if (result.rows.size() == rows) {
+            result.dense = true;
+            result.rows.clear();
+        }
+        return result;
+    }
+
+private:
+    bool bindFunction() {
+        auto argumentCount = [this](size_t low, size_t high) {
+            if (children.size() >= low && children.size() <= high) return true;
+            std::cout << "Error: número de argumentos incorrecto en " << name << "." << std::endl;
+            return false;
+        };
+        if (name == "UPPER" || name == "LOWER") {
+            function_id = name == "UPPER" ? Function::UPPER : Function::LOWER;
+            result_type = FieldType::STRING;
+            return argumentCount(1, 1);
+        }
+        if (name == "LENGTH") {
+            function_id = Function::LENGTH;
+            result_type = FieldType::INTEGER;
+            return argumentCount(1, 1);
+        }
+        if (name == "SUBSTR") {
+            function_id = Function::SUBSTR;
+            result_type = FieldType::STRING;
+            if (!argumentCount(2, 3)) return false;
+            for (size_t i = 1; i < children.size(); ++i) {
+                if (children[i]->result_type != FieldType::INTEGER) {
+                    std::cout << "Error: SUBSTR necesita posiciones INTEGER." << std::endl;
+                    return false;
+                }
+            }
+            return true;
+        }
+        if (name == "CONCAT") {
+            function_id = Function::CONCAT;
+            result_type = FieldType::STRING;
+            return argumentCount(1, children.size() + 1);
+        }
+        if (name == "ABS") {
+            function_id = Function::ABS;
+            if (!argumentCount(1, 1)) return false;
+            result_type = children[0]->result_type;
+            if (!isNumericType(result_type)) {
+                std::cout << "Error: ABS necesita un argumento numérico." << std::endl;
+                return false;
+            }
+            return true;
+        }
+        std::cout << "Error: función '" << name << "' desconocida." << std::endl;
+        return false;
+    }
+
+    std::shared_ptr<ColumnVector> evaluateLiteral(size_t rows) const {
+        auto result = std::make_shared<ColumnVector>(ColumnVector::make(literal_type, rows));
+        switch (literal_type) {
+            case FieldType::INTEGER:
+                std::fill(result->ints.begin(), result->ints.end(), static_cast<int64_t>(std::stoll(name)));
+                break;
+            case FieldType::FLOAT:
+                std::fill(result->floats.begin(), result->floats.end(), std::stod(name));
+                break;
+            default:
+                std::fill(result->strings.begin(), result->strings.end(), name);
+                break;
+        }
+        return result;
+    }
+
+    template <char OP>
+    void applyArithmetic(const ColumnVector& a, const ColumnVector& b, ColumnVector& out, size_t rows,
+                         const SelectionVector& selection) const {
+        bool dense = selection.worthDense(rows);
+        if (out.type == FieldType::INTEGER) {
+            if (dense) {
+                vectorIntegerArithmetic<OP>(a.ints.data(), b.ints.data(), out.ints.data(), rows);
+            } else {
+                for (uint32_t i : selection.rows) vectorIntegerArithmetic<OP>(&a.ints[i], &b.ints[i], &out.ints[i], 1);
+            }
+        } else if (dense) {
+            vectorFloatArithmetic<OP>(a.floats.data(), b.floats.data(), out.floats.data(), rows);
+        } else {
+            for (uint32_t i : selection.rows) vectorFloatArithmetic<OP>(&a.floats[i], &b.floats[i], &out.floats[i], 1);
+        }
+    }
+
+    std::shared_ptr<ColumnVector> evaluateArithmetic(const Columns& columns, size_t rows,
+                                                     const SelectionVector& selection) const {
+        auto left = children[0]->evaluate(columns, rows, selection);
+        auto right = children[1]->evaluate(columns, rows, selection);
+        if (result_type == FieldType::FLOAT) {
+            if (left->type != FieldType::FLOAT) left = std::make_shared<ColumnVector>(left->toFloat());
+            if (right->type != FieldType::FLOAT) right = std::make_shared<ColumnVector>(right->toFloat());
+        }
+        auto result = std::make_shared<ColumnVector>(ColumnVector::make(result_type, rows));
+        result->propagateNulls(*left, *right);
+
+        switch (arithmetic_op) {
+            case '+': applyArithmetic<'+'>(*left, *right, *result, rows, selection); break;
+            case '-': applyArithmetic<'-'>(*left, *right, *result, rows, selection); break;
+            case '*': applyArithmetic<'*'>(*left, *right, *result, rows, selection); break;
+            case '/': applyArithmetic<'/'>(*left, *right, *result, rows, selection); break;
+            case '%':
+                selection.forEach(rows, [&](size_t i) {
+                    int64_t divisor = right->ints[i];
+                    if (divisor == 0 || (divisor == -1 && left->ints[i] == std::numeric_limits<int64_t>::min())) {
+                        result->setNull(i);     // Entre cero o INT64_MIN % -1 (trampa en x86): NULL
+                    } else {
+                        result->ints[i] = left->ints[i] % divisor;
+                    }
+                });
+                break;
+        }
+        if (arithmetic_op == '/') {
+            selection.forEach(rows, [&](size_t i) {
+                if (right->floats[i] == 0.0) result->setNull(i);  // División entre cero: NULL
+            });
+        }
+        return result;
+    }
+
+    std::shared_ptr<ColumnVector> evaluateCompare(const Columns& columns, size_t rows,
+                                                  const SelectionVector& selection) const {
+        auto left = children[0]->evaluate(columns, rows, selection);
+        auto right = children[1]->evaluate(columns, rows, selection);
+        if (compare_domain == CompareDomain::NUMBER) {
+            if (left->type != FieldType::FLOAT) left = std::make_shared<ColumnVector>(left->toFloat());
+            if (right->type != FieldType::FLOAT) right = std::make_shared<ColumnVector>(right->toFloat());
+        }
+        auto result = std::make_shared<ColumnVector>(ColumnVector::make(FieldType::INTEGER, rows));
+        result->propagateNulls(*left, *right);
+        compare_kernel(*left, *right, *result, rows, selection);
+        return result;
+    }
+
+    std::shared_ptr<ColumnVector> evaluateLogical(const Columns& columns, size_t rows,
+                                                  const SelectionVector& selection) const {
+        auto result = std::make_shared<ColumnVector>(ColumnVector::make(FieldType::INTEGER, rows));
+        auto first = children[0]->evaluate(columns, rows, selection);
+        if (kind == Kind::IS_NULL) {
+            selection.forEach(rows, [&](size_t i) { result->ints[i] = first->isNull(i) ? 1 : 0; });
+            return result;
+        }
+        if (kind == Kind::NOT) {
+            selection.forEach(rows, [&](size_t i) {
+                if (first->isNull(i)) result->setNull(i);
+                else result->ints[i] = first->number(i) != 0.0 ? 0 : 1;
+            });
+            return result;
+        }
+        auto second = children[1]->evaluate(columns, rows, selection);
+        bool is_and = kind == Kind::AND;
+        selection.forEach(rows, [&](size_t i) {
+            bool null_a = first->isNull(i), null_b = second->isNull(i);
+            bool a = !null_a && first->number(i) != 0.0;
+            bool b = !null_b && second->number(i) != 0.0;
+            // Un FALSE decide AND y un TRUE decide OR aunque el otro lado sea NULL
+            bool decided = is_and ? ((!null_a && !a) || (!null_b && !b)) : (a || b);
+            if (decided) {
+                result->ints[i] = is_and ? 0 : 1;
+            } else if (null_a || null_b) {
+                result->setNull(i);
+            } else {
+                result->ints[i] = is_and ? 1 : 0;
+            }
+        });
+        return result;
+    }
+
+    std::shared_ptr<ColumnVector> evaluateCase(const Columns& columns, size_t rows,
+                                               const SelectionVector& selection) const {
+        auto result = std::make_shared<ColumnVector>(ColumnVector::make(result_type, rows));
+        SelectionVector remaining;
+        remaining.dense = false;
+        selection.forEach(rows, [&](size_t i) { remaining.rows.push_back(static_cast<uint32_t>(i)); });
+
+        size_t branches = (children.size() - (has_else ? 1 : 0)) / 2;
+        for (size_t b = 0; b < branches && !remaining.rows.empty(); ++b) {
+            SelectionVector taken = children[2 * b]->select(columns, rows, remaining);
+            if (taken.dense) {
+                taken.dense = false;
+                taken.rows = remaining.rows;
+            }
+            if (taken.rows.empty()) continue;
+            auto value = children[2 * b + 1]->evaluate(columns, rows, taken);
+            for (uint32_t i : taken.rows) result->assign(i, *value, i);
+
+            std::vector<uint32_t> rest;
+            std::set_difference(remaining.rows.begin(), remaining.rows.end(), taken.rows.begin(), taken.rows.end(),
+                                std::back_inserter(rest));
+            remaining.rows = std::move(rest);
+        }
+        if (has_else && !remaining.rows.empty()) {
+            auto value = children.back()->evaluate(columns, rows, remaining);
+            for (uint32_t i : remaining.rows) result->assign(i, *value, i);
+        } else {
+            for (uint32_t i : remaining.rows) result->setNull(i);
+        }
+        return result;
+    }
+
+    std::shared_ptr<ColumnVector> evaluateFunction(const Columns& columns, size_t rows,
+                                                   const SelectionVector& selection) const {
+        std::vector<std::shared_ptr<ColumnVector>> arguments;
+        for (const auto& child : children) arguments.push_back(child->evaluate(columns, rows, selection));
+        auto result = std::make_shared<ColumnVector>(ColumnVector::make(result_type, rows));
+        const ColumnVector& first = *arguments[0];
+
+        // Una fila es NULL si lo es cualquier argumento: OR de los mapas, una palabra por 64 filas
+        for (const auto& argument : arguments) {
+            if (!argument->hasNulls()) continue;
+            if (!result->hasNulls()) result->nulls.assign((rows + 63) / 64, 0);
+            for (size_t w = 0; w < result->nulls.size(); ++w) result->nulls[w] |= argument->nulls[w];
+        }
+        auto forEachLive = [&](auto visit) {
+            if (!result->hasNulls()) {
+                selection.forEach(rows, visit);
+            } else {
+                selection.forEach(rows, [&](size_t i) {
+                    if (!result->isNull(i)) visit(i);
+                });
+            }
+        };
+
+        switch (function_id) {
+            case Function::UPPER:
+            case Function::LOWER: {
+                int (*convert)(int) = function_id == Function::UPPER ? ::toupper : ::tolower;
+                forEachLive([&](size_t i) {
+                    std::string& text = result->strings[i];
+                    text = first.text(i);
+                    for (char& c : text) c = static_cast<char>(convert(static_cast<unsigned char>(c)));
+                });
+                break;
+            }
+            case Function::LENGTH:
+                forEachLive([&](size_t i) { result->ints[i] = static_cast<int64_t>(first.text(i).size()); });
+                break;
+            case Function::SUBSTR:
+                forEachLive([&](size_t i) {
+                    std::string text = first.text(i);
+                    int64_t start = std::max<int64_t>(arguments[1]->ints[i], 1) - 1;  // Posiciones desde 1
+                    int64_t length = arguments.size() > 2 ? std::max<int64_t>(arguments[2]->ints[i], 0)
+                                                          : static_cast<int64_t>(text.size());
+                    result->strings[i] = start < static_cast<int64_t>(text.size())
+                                             ? text.substr(static_cast<size_t>(start), static_cast<size_t>(length))
+                                             : "";
+                });
+                break;
+            case Function::CONCAT:
+                forEachLive([&](size_t i) {
+                    std::string& text = result->strings[i];
+                    for (const auto& argument : arguments) text += argument->text(i);
+                });
+                break;
+            case Function::ABS:
+                if (result_type == FieldType::INTEGER) {
+                    forEachLive([&](size_t i) {
+                        int64_t value = first.ints[i];
+                        if (value == std::numeric_limits<int64_t>::min()) result->setNull(i);  // No cabe en int64_t
+                        else result->ints[i] = value < 0 ? -value : value;
+                    });
+                } else {
+                    forEachLive([&](size_t i) { result->floats[i] = std::fabs(first.floats[i]); });
+                }
+                break;
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief Elemento de la lista SELECT: una expresión o un agregado sobre una expresión
+ *
+ * COUNT sin expresión es COUNT(*); los demás agregados ignoran los NULL.
+ */
+struct VectorSelectItem {
+    std::string alias;
+    VectorExpression::Ptr expression;
+    bool is_aggregate = false;
+    AggregateFunction function = AggregateFunction::COUNT;
+
+    static VectorSelectItem scalar(const std::string& alias, VectorExpression::Ptr expression) {
+        VectorSelectItem item;
+        item.alias = alias;
+        item.expression = std::move(expression);
+        return item;
+    }
+
+    static VectorSelectItem aggregate(const std::string& alias, AggregateFunction function,
+                                      VectorExpression::Ptr expression = nullptr) {
+        VectorSelectItem item;
+        item.alias = alias;
+        item.expression = std::move(expression);
+        item.is_aggregate = true;
+        item.function = function;
+        return item;
+    }
+};
+
+/**
+ * @brief `SELECT items FROM tabla WHERE ... ORDER BY ... LIMIT n`
+ *
+ * Si algún elemento es un agregado, los elementos escalares forman la clave
+ * de agrupación. `order_by` indica columnas de la salida (posición y si el
+ * orden es descendente).
+ */
+struct VectorQuery {
+    std::vector<VectorSelectItem> select;
+    VectorExpression::Ptr where;
+    std::vector<std::pair<size_t, bool>> order_by;
+    size_t limit = 0;                   // 0 = sin límite
+};
+
+#endif // VECTOR_EXPRESSION_H
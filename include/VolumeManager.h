@@ -0,0 +1,534 @@
+#ifndef VOLUME_MANAGER_H
+#define VOLUME_MANAGER_H
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "DiskConfig.h"
+#include "FileSystemSimulator.h"
+#include "DiskSimulationClock.h"
+#include "Block.h"
+#include "Record.h"
+#include "PhysicalAddress.h"
+
+/**
+ * @brief Dirección de un bloque dentro de un volumen multi-disco
+ */
+struct VolumeAddress {
+    int disk;                   // Índice del disco dentro del volumen
+    PhysicalAddress address;    // Dirección física dentro de ese disco
+
+    VolumeAddress(int d = 0, const PhysicalAddress& addr = PhysicalAddress())
+        : disk(d), address(addr) {}
+
+    bool operator<(const VolumeAddress& other) const {
+        if (disk != other.disk) return disk < other.disk;
+        return address < other.address;
+    }
+
+    bool operator==(const VolumeAddress& other) const {
+        return disk == other.disk && address == other.address;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const VolumeAddress& addr) {
+        os << "D" << addr.disk << addr.address;
+        return os;
+    }
+};
+
+/**
+ * @brief Resultado de un recorrido completo sobre un volumen
+ */
+struct VolumeScanReport {
+    std::vector<std::shared_ptr<Record>> records;   // Registros activos leídos
+    size_t blocks_read = 0;                         // Bloques leídos en total
+    size_t bytes_read = 0;                          // Bytes transferidos
+    double makespan_ms = 0.0;                       // Tiempo hasta terminar el último disco
+    std::vector<double> disk_busy_ms;               // Tiempo ocupado de cada cola
+
+    /**
+     * @brief Ancho de banda agregado simulado en MB/s
+     */
+    double getBandwidthMBps() const {
+        if (makespan_ms <= 0.0) return 0.0;
+        return (static_cast<double>(bytes_read) / (1 << 20)) / (makespan_ms / 1000.0);
+    }
+};
+
+/**
+ * @brief Volumen lógico que reparte las relaciones entre varios discos (RAID-0)
+ *
+ * Cada disco es un FileSystemSimulator independiente, con su propia ruta base
+ * y su propia DiskConfig. Los bloques de una relación se agrupan en extensiones
+ * de `stripe_unit` bloques consecutivos que se asignan a los discos en turno
+ * rotativo, de modo que un recorrido reparte sus lecturas entre colas de E/S
+ * independientes y el tiempo total es el del disco más cargado.
+ */
+class VolumeManager {
+private:
+    /**
+     * @brief Estado de un disco miembro del volumen
+     */
+    struct MemberDisk {
+        std::unique_ptr<FileSystemSimulator> filesystem;
+        long long next_block_number = 0;
+        DiskSimulationClock clock;      // Cola de E/S propia del disco
+    };
+
+    /**
+     * @brief Metadatos de una relación distribuida
+     */
+    struct VolumeRelation {
+        std::vector<FieldDefinition> schema;
+        bool use_fixed_records = true;
+        std::vector<VolumeAddress> blocks;  // Bloques en orden lógico
+    };
+
+    std::string volume_path;                                  // Metadatos del volumen
+    size_t stripe_unit;                                       // Bloques por extensión
+    std::vector<MemberDisk> disks;
+    std::map<std::string, VolumeRelation> relations;
+    std::map<VolumeAddress, std::shared_ptr<Block>> block_cache;
+    int next_record_id;
+
+public:
+    /**
+     * @brief Constructor
+     * @param path Directorio donde se guardan los metadatos del volumen
+     * @param stripe_blocks Número de bloques consecutivos por extensión
+     */
+    VolumeManager(const std::string& path = "./volume_simulation", size_t stripe_blocks = 4)
+        : volume_path(path)
+        , stripe_unit(stripe_blocks > 0 ? stripe_blocks : 1)
+        , next_record_id(1)
+    {
+    }
+
+    /**
+     * @brief Añade e inicializa un disco nuevo en el volumen
+     */
+    bool addDisk(const std::string& disk_path, const DiskConfig& config) {
+        if (!config.isValid()) {
+            std::cout << "Configuración inválida para el disco " << disk_path << std::endl;
+            return false;
+        }
+
+        MemberDisk member;
+        member.filesystem = std::make_unique<FileSystemSimulator>(disk_path);
+        if (!member.filesystem->initialize(config)) {
+            return false;
+        }
+        member.clock.configure(config, config.hasIndependentActuators());
+
+        disks.push_back(std::move(member));
+        saveVolumeMetadata();
+        return true;
+    }
+
+    /**
+     * @brief Carga un volumen existente a partir de sus metadatos
+     */
+    bool loadExisting() {
+        std::ifstream file(volume_path + "/volume.txt");
+        if (!file.is_open()) {
+            return false;
+        }
+
+        disks.clear();
+        relations.clear();
+        block_cache.clear();
+
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;
+
+            std::istringstream iss(line);
+            std::string type;
+            std::getline(iss, type, '|');
+
+            if (type == "stripe_unit") {
+                std::string value;
+                std::getline(iss, value);
+                stripe_unit = std::max<size_t>(1, std::stoull(value));
+            } else if (type == "DISK") {
+                std::string disk_path;
+                std::getline(iss, disk_path);
+
+                MemberDisk member;
+                member.filesystem = std::make_unique<FileSystemSimulator>(disk_path);
+                if (!member.filesystem->loadExisting()) {
+                    std::cerr << "No se pudo cargar el disco " << disk_path << std::endl;
+                    return false;
+                }
+                const DiskConfig& config = member.filesystem->getDiskConfig();
+                member.clock.configure(config, config.hasIndependentActuators());
+                disks.push_back(std::move(member));
+            } else if (type == "RELATION") {
+                std::string name, record_type;
+                std::getline(iss, name, '|');
+                std::getline(iss, record_type);
+                relations[name].use_fixed_records = (record_type == "FIXED");
+            } else if (type == "FIELD") {
+                std::string rel, definition;
+                std::getline(iss, rel, '|');
+                std::getline(iss, definition);
+                parseFieldDefinition(definition, relations[rel].schema);
+            } else if (type == "EXTENT") {
+                std::string rel, disk_str, p, s, t, sec;
+                std::getline(iss, rel, '|');
+                std::getline(iss, disk_str, '|');
+                std::getline(iss, p, '|');
+                std::getline(iss, s, '|');
+                std::getline(iss, t, '|');
+                std::getline(iss, sec);
+                relations[rel].blocks.emplace_back(
+                    std::stoi(disk_str),
+                    PhysicalAddress(std::stoi(p), std::stoi(s), std::stoi(t), std::stoi(sec)));
+            }
+        }
+
+        // Reconstruir punteros de asignación e identificadores
+        for (const auto& rel : relations) {
+            for (const auto& vaddr : rel.second.blocks) {
+                if (vaddr.disk < 0 || vaddr.disk >= static_cast<int>(disks.size())) continue;
+
+                MemberDisk& member = disks[vaddr.disk];
+                long long block_number =
+                    member.filesystem->getDiskConfig().addressToBlock(vaddr.address);
+                member.next_block_number = std::max(member.next_block_number, block_number + 1);
+
+                auto block = readVolumeBlock(vaddr);
+                if (block) {
+                    for (const auto& record : block->getAllRecords()) {
+                        next_record_id = std::max(next_record_id, record->getId() + 1);
+                    }
+                }
+            }
+        }
+
+        std::cout << "Volumen cargado: " << disks.size() << " discos, "
+                  << relations.size() << " relaciones." << std::endl;
+        return true;
+    }
+
+    /**
+     * @brief Crea una relación distribuida en el volumen
+     */
+    bool createTable(const std::string& table_name,
+                     const std::vector<FieldDefinition>& schema,
+                     bool use_fixed_records = true) {
+        if (disks.empty()) {
+            std::cout << "El volumen no tiene discos." << std::endl;
+            return false;
+        }
+        if (relations.find(table_name) != relations.end()) {
+            std::cout << "La tabla '" << table_name << "' ya existe en el volumen." << std::endl;
+            return false;
+        }
+
+        VolumeRelation& relation = relations[table_name];
+        relation.schema = schema;
+        relation.use_fixed_records = use_fixed_records;
+
+        saveVolumeMetadata();
+        if (!appendBlock(table_name)) {
+            relations.erase(table_name);
+            saveVolumeMetadata();
+            return false;
+        }
+
+        std::cout << "Tabla '" << table_name << "' creada en volumen de "
+                  << disks.size() << " discos." << std::endl;
+        return true;
+    }
+
+    /**
+     * @brief Inserta un registro al final de la relación
+     *
+     * Solo se prueba el último bloque lógico: al llenarse se abre el siguiente,
+     * que cae en el disco que indique la política de striping.
+     */
+    bool insertRecord(const std::string& table_name, const std::vector<std::string>& values) {
+        auto it = relations.find(table_name);
+        if (it == relations.end()) {
+            std::cout << "Tabla '" << table_name << "' no encontrada en el volumen." << std::endl;
+            return false;
+        }
+
+        std::shared_ptr<Record> record = makeRecord(it->second.schema, it->second.use_fixed_records,
+                                                    next_record_id, values);
+
+        auto block = readVolumeBlock(it->second.blocks.back());
+        if (!block || !block->canFit(record)) {
+            block = appendBlock(table_name);
+            if (!block) return false;
+        }
+
+        if (!block->addRecord(record)) {
+            std::cout << "Error: el registro no cabe en un bloque vacío." << std::endl;
+            return false;
+        }
+
+        next_record_id++;
+        return writeVolumeBlock(it->second.blocks.back(), *block);
+    }
+
+    /**
+     * @brief Carga registros desde CSV en una relación del volumen
+     */
+    bool loadFromCSV(const std::string& table_name, const std::string& csv_file) {
+        std::ifstream file(csv_file);
+        if (!file.is_open()) {
+            std::cout << "Error: No se pudo abrir el archivo " << csv_file << std::endl;
+            return false;
+        }
+
+        std::string line;
+        int records_loaded = 0;
+        while (std::getline(file, line)) {
+            std::vector<std::string> values = parseCSVLine(line);
+            if (!values.empty() && insertRecord(table_name, values)) {
+                records_loaded++;
+            }
+        }
+
+        std::cout << "Cargados " << records_loaded << " registros en el volumen desde "
+                  << csv_file << std::endl;
+        return records_loaded > 0;
+    }
+
+    /**
+     * @brief Recorre la relación completa repartiendo lecturas entre los discos
+     *
+     * Todas las lecturas llegan a la vez a la cola de su disco; como los discos
+     * trabajan en paralelo, el tiempo simulado del recorrido es el instante en
+     * que termina el último de ellos.
+     */
+    VolumeScanReport scanTable(const std::string& table_name) {
+        VolumeScanReport report;
+        report.disk_busy_ms.assign(disks.size(), 0.0);
+
+        auto it = relations.find(table_name);
+        if (it == relations.end()) {
+            return report;
+        }
+
+        // Las peticiones del recorrido llegan juntas, cuando el volumen queda libre
+        double start_ms = 0.0;
+        for (auto& member : disks) {
+            member.clock.runUntilIdle();
+            start_ms = std::max(start_ms, member.clock.now());
+        }
+
+        std::vector<bool> submitted(disks.size(), false);
+        for (const auto& vaddr : it->second.blocks) {
+            auto block = readVolumeBlock(vaddr);
+            if (!block) continue;
+
+            disks[vaddr.disk].clock.submit(IOType::READ, vaddr.address, start_ms);
+            submitted[vaddr.disk] = true;
+            report.blocks_read++;
+            report.bytes_read += block->getBlockSize();
+
+            auto active = block->getActiveRecords();
+            report.records.insert(report.records.end(), active.begin(), active.end());
+        }
+
+        // Con el disco ya libre al empezar, su reloj acaba en la última finalización del recorrido
+        for (size_t disk = 0; disk < disks.size(); ++disk) {
+            disks[disk].clock.runUntilIdle();
+            if (!submitted[disk]) continue;
+            double finish = disks[disk].clock.now() - start_ms;
+            report.disk_busy_ms[disk] = finish;
+            report.makespan_ms = std::max(report.makespan_ms, finish);
+        }
+        return report;
+    }
+
+    /**
+     * @brief Muestra cómo se reparte una relación y el rendimiento del recorrido
+     */
+    void displayScanReport(const std::string& table_name) {
+        VolumeScanReport report = scanTable(table_name);
+
+        std::cout << "\n=== RECORRIDO DEL VOLUMEN: " << table_name << " ===" << std::endl;
+        std::cout << "Discos: " << disks.size() << " | Unidad de striping: "
+                  << stripe_unit << " bloques" << std::endl;
+        std::cout << "Registros activos: " << report.records.size() << std::endl;
+        std::cout << "Bloques leídos: " << report.blocks_read << std::endl;
+        for (size_t d = 0; d < report.disk_busy_ms.size(); ++d) {
+            std::cout << "  Disco " << d << " (" << disks[d].filesystem->getBasePath()
+                      << "): " << report.disk_busy_ms[d] << " ms" << std::endl;
+        }
+        std::cout << "Tiempo simulado (makespan): " << report.makespan_ms << " ms" << std::endl;
+        std::cout << "Ancho de banda agregado: " << report.getBandwidthMBps() << " MB/s" << std::endl;
+    }
+
+    /**
+     * @brief Muestra estadísticas de cada disco del volumen
+     */
+    void displayStatistics() const {
+        std::cout << "\n=== ESTADÍSTICAS DEL VOLUMEN ===" << std::endl;
+        std::cout << "Ruta de metadatos: " << volume_path << std::endl;
+        std::cout << "Unidad de striping: " << stripe_unit << " bloques" << std::endl;
+
+        for (size_t d = 0; d < disks.size(); ++d) {
+            const MemberDisk& member = disks[d];
+            IOStatistics stats = member.clock.getStatistics();
+            std::cout << "Disco " << d << ": " << member.filesystem->getBasePath()
+                      << " (" << member.filesystem->getDiskConfig().getFormattedCapacity() << ")"
+                      << " | Lecturas: " << stats.reads
+                      << " | Escrituras: " << stats.writes
+                      << " | Utilización: " << (stats.utilization * 100.0) << "%" << std::endl;
+        }
+
+        for (const auto& rel : relations) {
+            std::vector<size_t> per_disk(disks.size(), 0);
+            for (const auto& vaddr : rel.second.blocks) {
+                if (vaddr.disk >= 0 && vaddr.disk < static_cast<int>(per_disk.size())) {
+                    per_disk[vaddr.disk]++;
+                }
+            }
+            std::cout << "- " << rel.first << ": " << rel.second.blocks.size() << " bloques [";
+            for (size_t d = 0; d < per_disk.size(); ++d) {
+                if (d > 0) std::cout << ", ";
+                std::cout << per_disk[d];
+            }
+            std::cout << "]" << std::endl;
+        }
+    }
+
+    // Getters
+    size_t getDiskCount() const { return disks.size(); }
+    size_t getStripeUnit() const { return stripe_unit; }
+    const std::string& getVolumePath() const { return volume_path; }
+
+private:
+    /**
+     * @brief Disco que corresponde al bloque lógico `index` de una relación
+     */
+    int diskForBlock(size_t index) const {
+        return static_cast<int>((index / stripe_unit) % disks.size());
+    }
+
+    /**
+     * @brief Añade un bloque nuevo al final de la relación según el striping
+     *
+     * La extensión se añade al final de volume.txt en vez de reescribirlo.
+     * @return nullptr si el disco que toca está lleno o no se pudo escribir
+     */
+    std::shared_ptr<Block> appendBlock(const std::string& table_name) {
+        VolumeRelation& relation = relations[table_name];
+        int disk = diskForBlock(relation.blocks.size());
+        MemberDisk& member = disks[disk];
+        const DiskConfig& config = member.filesystem->getDiskConfig();
+        if (member.next_block_number >= config.getTotalSectors()) {
+            std::cerr << "Error: el disco " << disk << " del volumen está lleno." << std::endl;
+            return nullptr;
+        }
+
+        VolumeAddress vaddr(disk, config.blockToAddress(member.next_block_number));
+        auto block = std::make_shared<Block>(vaddr.address, config.getBytesPerSector());
+        block->setRelationName(table_name);
+        if (!writeVolumeBlock(vaddr, *block) || !appendExtent(table_name, vaddr)) {
+            return nullptr;
+        }
+
+        member.next_block_number++;
+        relation.blocks.push_back(vaddr);
+        block_cache[vaddr] = block;
+        return block;
+    }
+
+    /**
+     * @brief Obtiene un bloque del volumen (desde cache o disco)
+     */
+    std::shared_ptr<Block> readVolumeBlock(const VolumeAddress& vaddr) {
+        if (vaddr.disk < 0 || vaddr.disk >= static_cast<int>(disks.size())) {
+            return nullptr;
+        }
+
+        MemberDisk& member = disks[vaddr.disk];
+
+        auto it = block_cache.find(vaddr);
+        if (it != block_cache.end()) {
+            return it->second;
+        }
+
+        auto block = std::make_shared<Block>(
+            vaddr.address, member.filesystem->getDiskConfig().getBytesPerSector());
+        if (member.filesystem->readBlock(vaddr.address, *block)) {
+            block_cache[vaddr] = block;
+            return block;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Escribe un bloque en su disco y cobra el tiempo en su cola
+     */
+    bool writeVolumeBlock(const VolumeAddress& vaddr, const Block& block) {
+        MemberDisk& member = disks[vaddr.disk];
+        member.clock.serve(IOType::WRITE, vaddr.address);
+        return member.filesystem->writeBlock(vaddr.address, block);
+    }
+
+    /**
+     * @brief Guarda discos, esquemas y mapa de extensiones del volumen
+     */
+    void saveVolumeMetadata() const {
+        try {
+            fs::create_directories(volume_path);
+        } catch (const std::exception& e) {
+            std::cerr << "Error creando directorio del volumen: " << e.what() << std::endl;
+            return;
+        }
+
+        std::ofstream file(volume_path + "/volume.txt");
+        if (!file.is_open()) {
+            return;
+        }
+
+        file << "# Volumen SGBD (RAID-0)" << std::endl;
+        file << "stripe_unit|" << stripe_unit << std::endl;
+        for (const auto& member : disks) {
+            file << "DISK|" << member.filesystem->getBasePath() << std::endl;
+        }
+        for (const auto& rel : relations) {
+            file << "RELATION|" << rel.first << "|"
+                 << (rel.second.use_fixed_records ? "FIXED" : "VARIABLE") << std::endl;
+            for (const auto& field : rel.second.schema) {
+                file << "FIELD|" << rel.first << "|" << serializeFieldDefinition(field) << std::endl;
+            }
+            for (const auto& vaddr : rel.second.blocks) {
+                file << extentLine(rel.first, vaddr) << std::endl;
+            }
+        }
+    }
+
+    /**
+     * @brief Añade una extensión al final de los metadatos (O(1) por bloque)
+     */
+    bool appendExtent(const std::string& table_name, const VolumeAddress& vaddr) const {
+        std::ofstream file(volume_path + "/volume.txt", std::ios::app);
+        if (!file.is_open()) {
+            std::cerr << "Error escribiendo los metadatos del volumen." << std::endl;
+            return false;
+        }
+        file << extentLine(table_name, vaddr) << std::endl;
+        return static_cast<bool>(file);
+    }
+
+    static std::string extentLine(const std::string& table_name, const VolumeAddress& vaddr) {
+        const PhysicalAddress& a = vaddr.address;
+        return "EXTENT|" + table_name + "|" + std::to_string(vaddr.disk) + "|" + std::to_string(a.getPlatter()) +
+               "|" + std::to_string(a.getSurface()) + "|" + std::to_string(a.getTrack()) + "|" +
+               std::to_string(a.getSector());
+    }
+};
+
+#endif // VOLUME_MANAGER_H
@@ -0,0 +1,268 @@
+#ifndef WINDOW_FUNCTION_H
+#define WINDOW_FUNCTION_H
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <sstream>
+#include <algorithm>
+#include "MaterializedView.h"
+
+/**
+ * @brief Marco `ROWS BETWEEN ... AND ...` relativo a la fila actual
+ *
+ * `preceding` y `following` cuentan filas; UNBOUNDED llega hasta el borde de
+ * la partición y 0 es CURRENT ROW. El marco por omisión es el acumulado
+ * (UNBOUNDED PRECEDING AND CURRENT ROW).
+ */
+struct WindowFrame {
+    static constexpr long long UNBOUNDED = -1;
+
+    long long preceding = UNBOUNDED;
+    long long following = 0;
+
+    static WindowFrame running() { return WindowFrame(); }
+
+    static WindowFrame sliding(long long rows_before, long long rows_after) {
+        WindowFrame frame;
+        frame.preceding = rows_before;
+        frame.following = rows_after;
+        return frame;
+    }
+
+    static WindowFrame wholePartition() { return sliding(UNBOUNDED, UNBOUNDED); }
+
+    /**
+     * @brief Primera y última fila del marco de la fila `row` (first > last: marco vacío)
+     */
+    void bounds(size_t row, size_t rows, long long& first, long long& last) const {
+        long long i = static_cast<long long>(row);
+        first = preceding == UNBOUNDED ? 0 : std::max(0LL, i - preceding);
+        last = following == UNBOUNDED ? static_cast<long long>(rows) - 1
+                                      : std::min(static_cast<long long>(rows) - 1, i + following);
+    }
+
+    std::string toString() const {
+        auto side = [](long long rows, const char* direction) {
+            if (rows == UNBOUNDED) return std::string("UNBOUNDED ") + direction;
+            if (rows == 0) return std::string("CURRENT ROW");
+            return std::to_string(rows) + " " + direction;
+        };
+        return "ROWS BETWEEN " + side(preceding, "PRECEDING") + " AND " + side(following, "FOLLOWING");
+    }
+};
+
+/**
+ * @brief Funciones de ventana: numeración, rango o un agregado sobre el marco
+ */
+enum class WindowFunction {
+    ROW_NUMBER,
+    RANK,
+    DENSE_RANK,
+    AGGREGATE
+};
+
+/**
+ * @brief Una llamada `función OVER (...)` dentro de una ventana
+ */
+struct WindowCall {
+    WindowFunction function;
+    AggregateSpec aggregate;            // Solo con AGGREGATE
+    WindowFrame frame;                  // Solo con AGGREGATE
+
+    WindowCall(WindowFunction f = WindowFunction::ROW_NUMBER) : function(f) {}
+
+    WindowCall(const AggregateSpec& spec, const WindowFrame& window_frame = WindowFrame())
+        : function(WindowFunction::AGGREGATE), aggregate(spec), frame(window_frame) {}
+
+    bool isInteger() const {
+        return function != WindowFunction::AGGREGATE || aggregate.function == AggregateFunction::COUNT;
+    }
+
+    std::string toString() const {
+        switch (function) {
+            case WindowFunction::ROW_NUMBER: return "ROW_NUMBER()";
+            case WindowFunction::RANK: return "RANK()";
+            case WindowFunction::DENSE_RANK: return "DENSE_RANK()";
+            case WindowFunction::AGGREGATE: break;
+        }
+        return aggregate.toString() + " " + frame.toString();
+    }
+};
+
+/**
+ * @brief `OVER (PARTITION BY ... ORDER BY ...)` compartido por varias llamadas
+ */
+struct WindowSpec {
+    std::vector<std::string> partition_by;
+    std::vector<std::string> order_by;
+    std::vector<WindowCall> calls;
+};
+
+/**
+ * @brief Árbol de segmentos ascendente para SUM, MIN o MAX de un intervalo
+ *
+ * Ocupa 2n valores y responde cualquier intervalo en O(log n), así que un
+ * marco arbitrario no obliga a recorrer sus filas una por una.
+ */
+class SegmentTree {
+private:
+    AggregateFunction function;
+    size_t size;
+    std::vector<double> nodes;
+
+    double combine(double a, double b) const {
+        switch (function) {
+            case AggregateFunction::MIN: return std::min(a, b);
+            case AggregateFunction::MAX: return std::max(a, b);
+            default: return a + b;
+        }
+    }
+
+    double identity() const {
+        switch (function) {
+            case AggregateFunction::MIN: return std::numeric_limits<double>::infinity();
+            case AggregateFunction::MAX: return -std::numeric_limits<double>::infinity();
+            default: return 0.0;
+        }
+    }
+
+public:
+    SegmentTree(const std::vector<double>& values, AggregateFunction f)
+        : function(f == AggregateFunction::MIN || f == AggregateFunction::MAX ? f : AggregateFunction::SUM),
+          size(values.size()), nodes(2 * values.size()) {
+        std::copy(values.begin(), values.end(), nodes.begin() + static_cast<std::ptrdiff_t>(size));
+        for (size_t i = size; i-- > 1;) {
+            nodes[i] = combine(nodes[2 * i], nodes[2 * i + 1]);
+        }
+    }
+
+    /**
+     * @brief Agregado de las posiciones [first, last]
+     */
+    double query(size_t first, size_t last) const {
+        double left = identity(), right = identity();
+        for (size_t l = first + size, r = last + size + 1; l < r; l /= 2, r /= 2) {
+            if (l & 1) left = combine(left, nodes[l++]);
+            if (r & 1) right = combine(nodes[--r], right);
+        }
+        return combine(left, right);
+    }
+};
+
+/**
+ * @brief Entrada de una partición ya ordenada: lo único que necesitan las funciones
+ *
+ * Cada llamada agregada guarda su columna como double y `peer_start` marca
+ * las filas cuya clave de orden cambia respecto a la anterior (RANK). Son
+ * unos pocos bytes por fila, así que una partición cuyas filas completas no
+ * caben en memoria todavía puede evaluarse entera.
+ */
+struct WindowPartition {
+    size_t rows = 0;
+    std::vector<std::vector<double>> values;    // Una columna por llamada (vacía si no agrega)
+    std::vector<uint8_t> peer_start;
+};
+
+/**
+ * @brief Evalúa las llamadas de una ventana sobre una partición en una pasada
+ *
+ * ROW_NUMBER, RANK y DENSE_RANK se calculan al avanzar. Un agregado sobre
+ * toda la partición se calcula una vez; con el marco acumulado (UNBOUNDED
+ * PRECEDING) basta un acumulador que avanza con el final del marco. El resto
+ * de marcos consulta un árbol de segmentos. COUNT es el tamaño del marco y
+ * AVG divide la suma entre él. Un marco vacío devuelve NaN (NULL).
+ */
+class WindowEvaluator {
+public:
+    static std::vector<std::vector<double>> evaluate(const std::vector<WindowCall>& calls,
+                                                     const WindowPartition& partition) {
+        std::vector<std::vector<double>> outputs(calls.size(), std::vector<double>(partition.rows));
+        for (size_t c = 0; c < calls.size(); ++c) {
+            const WindowCall& call = calls[c];
+            std::vector<double>& out = outputs[c];
+            if (call.function != WindowFunction::AGGREGATE) {
+                evaluateRanking(call.function, partition, out);
+            } else {
+                evaluateAggregate(call, partition.values[c], partition.rows, out);
+            }
+        }
+        return outputs;
+    }
+
+    static std::string format(const WindowCall& call, double value) {
+        if (std::isnan(value)) return "NULL";
+        if (call.isInteger()) return std::to_string(static_cast<long long>(value));
+        std::ostringstream out;
+        out.precision(15);
+        out << value;
+        return out.str();
+    }
+
+private:
+    static void evaluateRanking(WindowFunction function, const WindowPartition& partition, std::vector<double>& out) {
+        double rank = 0.0, dense = 0.0;
+        for (size_t i = 0; i < partition.rows; ++i) {
+            if (i == 0 || partition.peer_start[i]) {
+                rank = static_cast<double>(i + 1);
+                dense += 1.0;
+            }
+            out[i] = function == WindowFunction::ROW_NUMBER ? static_cast<double>(i + 1)
+                                                            : (function == WindowFunction::RANK ? rank : dense);
+        }
+    }
+
+    static void evaluateAggregate(const WindowCall& call, const std::vector<double>& values, size_t rows,
+                                  std::vector<double>& out) {
+        AggregateFunction function = call.aggregate.function;
+        const WindowFrame& frame = call.frame;
+        auto finish = [function](double accumulated, long long count) {
+            if (function == AggregateFunction::COUNT) return static_cast<double>(count);
+            if (count <= 0) return std::numeric_limits<double>::quiet_NaN();
+            return function == AggregateFunction::AVG ? accumulated / count : accumulated;
+        };
+        auto step = [function](double accumulated, double value) {
+            switch (function) {
+                case AggregateFunction::MIN: return std::min(accumulated, value);
+                case AggregateFunction::MAX: return std::max(accumulated, value);
+                default: return accumulated + value;
+            }
+        };
+        double start = function == AggregateFunction::MIN ? std::numeric_limits<double>::infinity()
+                     : function == AggregateFunction::MAX ? -std::numeric_limits<double>::infinity() : 0.0;
+
+        if (frame.preceding == WindowFrame::UNBOUNDED) {
+            // Acumulado: el inicio del marco no se mueve y el final solo avanza
+            double accumulated = start;
+            long long included = 0;
+            for (size_t i = 0; i < rows; ++i) {
+                long long first = 0, last = 0;
+                frame.bounds(i, rows, first, last);
+                while (included <= last) {
+                    accumulated = step(accumulated, function == AggregateFunction::COUNT ? 0.0 : values[included]);
+                    included++;
+                }
+                out[i] = finish(accumulated, last - first + 1);
+            }
+            return;
+        }
+
+        std::unique_ptr<SegmentTree> tree;
+        if (function != AggregateFunction::COUNT) tree.reset(new SegmentTree(values, function));
+        for (size_t i = 0; i < rows; ++i) {
+            long long first = 0, last = 0;
+            frame.bounds(i, rows, first, last);
+            if (first > last) {
+                out[i] = finish(0.0, 0);
+                continue;
+            }
+            double accumulated = tree ? tree->query(static_cast<size_t>(first), static_cast<size_t>(last)) : 0.0;
+            out[i] = finish(accumulated, last - first + 1);
+        }
+    }
+};
+
+#endif // WINDOW_FUNCTION_H
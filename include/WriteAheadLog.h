@@ -0,0 +1,298 @@
+#ifndef WRITE_AHEAD_LOG_H
+#define WRITE_AHEAD_LOG_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include "PhysicalAddress.h"
+
+/**
+ * @brief Entrada del log: imagen completa de un bloque tras modificarlo
+ */
+struct WalRecord {
+    long long lsn = 0;              // Número de secuencia del log
+    std::string relation;           // Relación dueña del bloque
+    PhysicalAddress address;        // Identidad del bloque
+    std::string payload;            // Block::serialize() del bloque
+
+    WalRecord() = default;
+    WalRecord(long long l, const std::string& rel, const PhysicalAddress& addr, const std::string& data)
+        : lsn(l), relation(rel), address(addr), payload(data) {}
+};
+
+/**
+ * @brief Log de escritura anticipada con registro físico de bloques
+ *
+ * Cada modificación añade la imagen completa del bloque en una línea:
+ * `LSN|relación|plato|superficie|pista|sector|checksum|imagen` (la imagen con
+ * `\n` escapado). Rehacer el log en orden deja cada bloque en su última imagen.
+ */
+class WriteAheadLog {
+private:
+    std::string log_path;
+    long long last_lsn;
+    size_t record_count;
+    size_t byte_count;
+
+public:
+    WriteAheadLog(const std::string& path = "")
+        : log_path(path), last_lsn(0), record_count(0), byte_count(0) {}
+
+    /**
+     * @brief Abre (o crea) el log y recupera el último LSN
+     */
+    bool open(const std::string& path) {
+        log_path = path;
+        last_lsn = 0;
+        record_count = 0;
+
+        for (const auto& record : readAll()) {
+            last_lsn = std::max(last_lsn, record.lsn);
+            record_count++;
+        }
+
+        std::ofstream file(log_path, std::ios::app);
+        std::error_code error;
+        auto size = std::filesystem::file_size(log_path, error);
+        byte_count = error ? 0 : static_cast<size_t>(size);
+        return file.is_open();
+    }
+
+    /**
+     * @brief Añade la imagen de un bloque y la fuerza a disco
+     * @return LSN asignado (0 si falló)
+     */
+    long long append(const std::string& relation, const PhysicalAddress& address,
+                     const std::string& payload) {
+        std::ofstream file(log_path, std::ios::app);
+        if (!file.is_open()) {
+            std::cerr << "Error escribiendo en el log: " << log_path << std::endl;
+            return 0;
+        }
+
+        WalRecord record(last_lsn + 1, relation, address, payload);
+        std::string line = formatRecord(record);
+        file << line << std::endl;
+        file.flush();
+        if (!file) {
+            return 0;
+        }
+
+        last_lsn = record.lsn;
+        record_count++;
+        byte_count += line.size() + 1;
+        return record.lsn;
+    }
+
+    /**
+     * @brief Añade una entrada con un LSN ya asignado (debe ser creciente)
+     */
+    bool appendRecord(const WalRecord& record) {
+        if (record.lsn <= last_lsn) {
+            return false;
+        }
+        std::ofstream file(log_path, std::ios::app);
+        if (!file.is_open()) {
+            return false;
+        }
+        
+        std::string line = formatRecord(record);
+        file << line << std::endl;
+        file.flush();
+        if (!file) {
+            return false;
+        }
+        
+        last_lsn = record.lsn;
+        record_count++;
+        byte_count += line.size() + 1;
+        return true;
+    }
+
+    /**
+     * @brief Lee las líneas completas escritas a partir de un desplazamiento
+     *
+     * Pensado para seguir el log mientras otro proceso lo escribe: una línea
+     * sin salto final todavía se está escribiendo y se deja para la próxima
+     * lectura. `offset` avanza hasta el final de la última línea consumida.
+     */
+    std::vector<WalRecord> readFromOffset(std::streamoff& offset) const {
+        std::vector<WalRecord> records;
+        std::ifstream file(log_path, std::ios::binary);
+        if (!file.is_open()) {
+            return records;
+        }
+        
+        file.seekg(offset);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (file.eof()) {
+                break;  // Línea incompleta
+            }
+            offset += static_cast<std::streamoff>(line.size() + 1);
+            
+            WalRecord record;
+            if (parseRecord(line, record)) {
+                records.push_back(record);
+            }
+        }
+        return records;
+    }
+
+    /**
+     * @brief Lee todas las entradas válidas del log en orden
+     *
+     * Una última línea truncada (caída a mitad de escritura) se ignora.
+     */
+    std::vector<WalRecord> readAll() const {
+        return readFrom(0);
+    }
+
+    /**
+     * @brief Lee las entradas con LSN mayor que `after_lsn`
+     */
+    std::vector<WalRecord> readFrom(long long after_lsn) const {
+        std::vector<WalRecord> records;
+        std::ifstream file(log_path);
+        std::string line;
+
+        while (std::getline(file, line)) {
+            WalRecord record;
+            if (parseRecord(line, record) && record.lsn > after_lsn) {
+                records.push_back(record);
+            }
+        }
+        return records;
+    }
+
+    /**
+     * @brief Reescribe el log conservando solo las entradas indicadas
+     *
+     * Se escribe un archivo temporal y se renombra, de modo que una caída a
+     * mitad del checkpoint deja el log anterior intacto.
+     */
+    bool rewrite(const std::vector<WalRecord>& records) {
+        std::string tmp_path = log_path + ".tmp";
+        size_t written = 0;
+        {
+            std::ofstream file(tmp_path, std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+            for (const auto& record : records) {
+                std::string line = formatRecord(record);
+                file << line << std::endl;
+                written += line.size() + 1;
+            }
+            file.flush();
+            if (!file) {
+                return false;
+            }
+        }
+
+        try {
+            std::filesystem::rename(tmp_path, log_path);
+        } catch (const std::exception& e) {
+            std::cerr << "Error reescribiendo el log: " << e.what() << std::endl;
+            return false;
+        }
+
+        record_count = records.size();
+        byte_count = written;
+        for (const auto& record : records) {
+            last_lsn = std::max(last_lsn, record.lsn);
+        }
+        return true;
+    }
+
+    long long getLastLSN() const { return last_lsn; }
+    size_t getRecordCount() const { return record_count; }
+    size_t getByteCount() const { return byte_count; }
+    const std::string& getPath() const { return log_path; }
+    bool isOpen() const { return !log_path.empty(); }
+
+    /**
+     * @brief Serializa una entrada en una sola línea
+     */
+    static std::string formatRecord(const WalRecord& record) {
+        std::ostringstream oss;
+        oss << record.lsn << "|" << record.relation << "|"
+            << record.address.getPlatter() << "|" << record.address.getSurface() << "|"
+            << record.address.getTrack() << "|" << record.address.getSector() << "|"
+            << checksum(record.payload) << "|" << escape(record.payload);
+        return oss.str();
+    }
+
+    /**
+     * @brief Interpreta una línea del log
+     */
+    static bool parseRecord(const std::string& line, WalRecord& record) {
+        std::istringstream iss(line);
+        std::string lsn, relation, p, s, t, sec, sum, payload;
+
+        if (!std::getline(iss, lsn, '|') || !std::getline(iss, relation, '|') ||
+            !std::getline(iss, p, '|') || !std::getline(iss, s, '|') ||
+            !std::getline(iss, t, '|') || !std::getline(iss, sec, '|') ||
+            !std::getline(iss, sum, '|')) {
+            return false;
+        }
+        std::getline(iss, payload);
+
+        try {
+            record.lsn = std::stoll(lsn);
+            record.relation = relation;
+            record.address = PhysicalAddress(std::stoi(p), std::stoi(s), std::stoi(t), std::stoi(sec));
+            record.payload = unescape(payload);
+        } catch (const std::exception&) {
+            return false;
+        }
+        // Una línea truncada o corrupta no coincide con su checksum
+        return sum == checksum(record.payload);
+    }
+
+private:
+    /**
+     * @brief FNV-1a de 64 bits en hexadecimal
+     */
+    static std::string checksum(const std::string& data) {
+        unsigned long long hash = 1469598103934665603ULL;
+        for (unsigned char c : data) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        std::ostringstream oss;
+        oss << std::hex << hash;
+        return oss.str();
+    }
+
+    static std::string escape(const std::string& data) {
+        std::string out;
+        out.reserve(data.size());
+        for (char c : data) {
+            if (c == '\\') out += "\\\\";
+            else if (c == '\n') out += "\\n";
+            else out += c;
+        }
+        return out;
+    }
+
+    static std::string unescape(const std::string& data) {
+        std::string out;
+        out.reserve(data.size());
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (data[i] == '\\' && i + 1 < data.size()) {
+                out += (data[i + 1] == 'n') ? '\n' : data[i + 1];
+                ++i;
+            } else {
+                out += data[i];
+            }
+        }
+        return out;
+    }
+};
+
+#endif // WRITE_AHEAD_LOG_H
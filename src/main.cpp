@@ -2,7 +2,13 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <functional>
 #include "DiskManager.h"
+#include "VolumeManager.h"
+#include "ReplicaFollower.h"
 
 /**
  * @brief Muestra el menú principal
@@ -21,6 +27,29 @@ void showMenu() {
     std::cout << "10. Mostrar estadísticas" << std::endl;
     std::cout << "11. Mostrar estructura de directorios" << std::endl;
     std::cout << "12. Crear datos de prueba" << std::endl;
+    std::cout << "13. Volumen multi-disco (striping)" << std::endl;
+    std::cout << "14. Comparar recorrido con actuadores por superficie" << std::endl;
+    std::cout << "15. Comparar carga en HDD y SSD" << std::endl;
+    std::cout << "16. Cambiar nivel de almacenamiento de una tabla" << std::endl;
+    std::cout << "17. Degradar bloques inactivos al nivel frío" << std::endl;
+    std::cout << "18. Instantánea en línea (respaldo completo o incremental)" << std::endl;
+    std::cout << "19. Restaurar cadena de respaldos en un disco nuevo" << std::endl;
+    std::cout << "20. Réplica por envío de log (retraso bajo carga)" << std::endl;
+    std::cout << "21. Tabla LSM: comparar inserciones con una tabla heap" << std::endl;
+    std::cout << "22. Tabla agrupada: comparar consultas por rango con una tabla heap" << std::endl;
+    std::cout << "23. Índices de mapas de bits: filtro multicolumna" << std::endl;
+    std::cout << "24. Índice ART en memoria: comparar búsquedas puntuales" << std::endl;
+    std::cout << "25. Búsqueda LIKE con índice de trigramas" << std::endl;
+    std::cout << "26. Vista materializada de agregados (mantenimiento incremental)" << std::endl;
+    std::cout << "27. Caché de resultados: consultas repetidas e invalidación" << std::endl;
+    std::cout << "28. Consultas aproximadas con muestreo (TABLESAMPLE)" << std::endl;
+    std::cout << "29. COUNT DISTINCT y percentiles con sketches (HyperLogLog y KLL)" << std::endl;
+    std::cout << "30. Funciones de ventana con ordenamiento externo" << std::endl;
+    std::cout << "31. Pipelines especializados por plantillas frente al intérprete" << std::endl;
+    std::cout << "32. Columnas calculadas con el evaluador vectorizado" << std::endl;
+    std::cout << "33. Construcción paralela de un índice B+" << std::endl;
+    std::cout << "34. Búsquedas e inserciones concurrentes en un índice B+" << std::endl;
+    std::cout << "35. Inserción paralela con mapa de espacio libre" << std::endl;
     std::cout << "0.  Salir" << std::endl;
     std::cout << "Opción: ";
 }
@@ -95,6 +124,19 @@ int main() {
                     std::cin >> bytes_sector;
                     
                     config = DiskConfig(platters, surfaces, tracks, sectors, bytes_sector);
+                    std::cin.ignore();
+                }
+                
+                std::cout << "¿Un actuador independiente por superficie? (s/n): ";
+                std::getline(std::cin, input);
+                config.setIndependentActuators(input == "s" || input == "S");
+                
+                std::cout << "Zonas de grabación (1 = densidad constante): ";
+                int num_zones;
+                std::cin >> num_zones;
+                std::cin.ignore();
+                if (num_zones > 1 && !config.setLinearZones(num_zones)) {
+                    std::cout << "Número de zonas inválido, se usa densidad constante." << std::endl;
                 }
                 
                 if (disk_manager.initialize(config)) {
@@ -125,6 +167,10 @@ int main() {
                 std::getline(std::cin, input);
                 bool use_fixed = (input == "f" || input == "F");
                 
+                std::cout << "¿Tabla caliente (zonas exteriores)? (s/n): ";
+                std::getline(std::cin, input);
+                bool hot_table = (input == "s" || input == "S");
+                
                 std::vector<FieldDefinition> schema;
                 std::cout << "Número de campos: ";
                 int num_fields;
@@ -152,7 +198,7 @@ int main() {
                     schema.emplace_back(field_name, type, max_length);
                 }
                 
-                if (disk_manager.createTable(table_name, schema, use_fixed)) {
+                if (disk_manager.createTable(table_name, schema, use_fixed, hot_table)) {
                     std::cout << "Tabla creada exitosamente." << std::endl;
                 } else {
                     std::cout << "Error creando la tabla." << std::endl;
@@ -284,6 +330,1015 @@ int main() {
                 break;
             }
             
+            case 13: {
+                // Volumen multi-disco con striping RAID-0
+                int num_disks;
+                size_t stripe_blocks;
+                std::string csv_file;
+                std::cout << "Número de discos: ";
+                std::cin >> num_disks;
+                std::cout << "Bloques por unidad de striping: ";
+                std::cin >> stripe_blocks;
+                std::cin.ignore();
+                std::cout << "Archivo CSV a distribuir: ";
+                std::getline(std::cin, csv_file);
+
+                std::ifstream csv(csv_file);
+                std::string first_line;
+                if (!csv.is_open() || !std::getline(csv, first_line)) {
+                    std::cout << "No se pudo leer el archivo CSV." << std::endl;
+                    break;
+                }
+                csv.close();
+
+                // Un campo STRING por columna del CSV
+                std::vector<FieldDefinition> schema;
+                std::istringstream header(first_line);
+                std::string column;
+                while (std::getline(header, column, ',')) {
+                    schema.emplace_back("col_" + std::to_string(schema.size()),
+                                        FieldType::STRING, 50);
+                }
+
+                VolumeManager volume("./mi_volumen_sgbd", stripe_blocks);
+                bool ok = true;
+                for (int d = 0; d < num_disks && ok; ++d) {
+                    ok = volume.addDisk("./mi_volumen_sgbd/disco_" + std::to_string(d),
+                                        DiskConfig(1, 2, 16, 16, 512));
+                }
+
+                if (ok && volume.createTable("datos", schema, false) &&
+                    volume.loadFromCSV("datos", csv_file)) {
+                    volume.displayStatistics();
+                    volume.displayScanReport("datos");
+                } else {
+                    std::cout << "Error preparando el volumen." << std::endl;
+                }
+                break;
+            }
+
+            case 14: {
+                // Makespan de un recorrido con uno o varios actuadores
+                std::string table_name;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                
+                disk_manager.displayScanComparison(table_name);
+                break;
+            }
+            
+            case 15: {
+                // Reejecutar la carga registrada en ambos modelos de dispositivo
+                size_t queue_depth;
+                std::cout << "Profundidad de cola: ";
+                std::cin >> queue_depth;
+                
+                disk_manager.compareDeviceModels(queue_depth);
+                break;
+            }
+            
+            case 16: {
+                // Nivel en memoria, en disco o comprimido
+                std::string table_name;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                
+                std::cout << "Nivel (m=memoria, d=disco, c=frío comprimido): ";
+                std::getline(std::cin, input);
+                StorageTier tier = StorageTier::DISK;
+                if (input == "m" || input == "M") tier = StorageTier::MEMORY;
+                else if (input == "c" || input == "C") tier = StorageTier::COLD;
+                
+                disk_manager.setTableTier(table_name, tier);
+                break;
+            }
+            
+            case 17: {
+                // Degradación inmediata y periodo de la automática
+                long long idle_ms;
+                std::cout << "Milisegundos sin acceso para degradar (0 = todos): ";
+                std::cin >> idle_ms;
+                
+                size_t demoted = disk_manager.demoteIdleBlocks(std::chrono::milliseconds(idle_ms));
+                std::cout << demoted << " bloques comprimidos al nivel frío." << std::endl;
+                
+                long long period_ms;
+                std::cout << "Periodo de degradación automática en ms (0 = desactivada): ";
+                std::cin >> period_ms;
+                disk_manager.setDemotionPeriod(std::chrono::milliseconds(period_ms));
+                break;
+            }
+            
+            case 18: {
+                // Congelar, seguir atendiendo y esperar al volcado
+                std::string archive_path;
+                std::cout << "Archivo de respaldo: ";
+                std::getline(std::cin, archive_path);
+                
+                std::cout << "¿Incremental sobre el último respaldo? (s/n): ";
+                std::getline(std::cin, input);
+                bool started = (input == "s" || input == "S")
+                    ? disk_manager.beginIncrementalBackup(archive_path)
+                    : disk_manager.beginSnapshot(archive_path);
+                
+                if (started) {
+                    disk_manager.displaySnapshotReport(disk_manager.finishSnapshot());
+                }
+                break;
+            }
+            
+            case 19: {
+                // Reconstruir un disco a partir de un respaldo y sus incrementales
+                std::vector<std::string> archives;
+                std::string archive_path, target_path;
+                std::cout << "Archivos de respaldo en orden (completo primero, línea vacía para terminar):" << std::endl;
+                while (std::getline(std::cin, archive_path) && !archive_path.empty()) {
+                    archives.push_back(archive_path);
+                }
+                std::cout << "Directorio del disco restaurado: ";
+                std::getline(std::cin, target_path);
+                
+                DiskManager::restoreBackupChain(archives, target_path);
+                break;
+            }
+            
+            case 20: {
+                // Réplica de solo lectura alimentada por el log del primario
+                std::string ship_dir, replica_path;
+                size_t num_records;
+                std::cout << "Directorio compartido del log: ";
+                std::getline(std::cin, ship_dir);
+                std::cout << "Directorio del disco réplica (nuevo): ";
+                std::getline(std::cin, replica_path);
+                std::cout << "Registros de la carga masiva: ";
+                std::cin >> num_records;
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("id", FieldType::INTEGER),
+                    FieldDefinition("payload", FieldType::STRING, 32)
+                };
+                disk_manager.createTable("replica_load", schema);
+                
+                if (!ReplicaFollower::bootstrap(disk_manager, ship_dir, replica_path)) {
+                    std::cout << "Error preparando la réplica." << std::endl;
+                    break;
+                }
+                
+                ReplicaFollower follower(replica_path, ship_dir);
+                if (!follower.start()) {
+                    break;
+                }
+                
+                std::vector<std::vector<std::string>> rows;
+                for (size_t i = 0; i < num_records; ++i) {
+                    rows.push_back({std::to_string(i), "fila_" + std::to_string(i)});
+                }
+                ReplicaFollower::displayLagReport(follower.measureLag(disk_manager, "replica_load", rows));
+                
+                long long lsn = disk_manager.getLastPageLSN();
+                std::cout << "Réplica en LSN " << follower.getAppliedLSN() << " de " << lsn << std::endl;
+                follower.stop();
+                break;
+            }
+            
+            case 21: {
+                // Misma carga en una tabla heap y en una LSM
+                std::string table_name, policy;
+                size_t num_records, memtable_limit;
+                std::cout << "Nombre de la tabla LSM: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Política de compactación (LEVELED/TIERED): ";
+                std::getline(std::cin, policy);
+                std::cout << "Entradas de la memtable: ";
+                std::cin >> memtable_limit;
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("evento", FieldType::STRING, 24),
+                    FieldDefinition("valor", FieldType::INTEGER)
+                };
+                LSMOptions options;
+                options.policy = compactionPolicyFromString(policy);
+                options.memtable_limit = memtable_limit;
+                
+                std::string heap_name = table_name + "_heap";
+                if (!disk_manager.createTable(heap_name, schema) ||
+                    !disk_manager.createLSMTable(table_name, schema, true, options)) {
+                    break;
+                }
+                
+                // Tiempo de E/S simulado acumulado por el reloj del disco
+                auto simulatedTime = [&disk_manager]() {
+                    IOStatistics stats = disk_manager.getIOStatistics();
+                    return stats.mean_response_ms * stats.completed;
+                };
+                
+                double heap_io = 0.0, lsm_io = 0.0;
+                std::chrono::duration<double, std::milli> heap_wall{}, lsm_wall{};
+                for (const std::string& target : {heap_name, table_name}) {
+                    double io_before = simulatedTime();
+                    auto start = std::chrono::steady_clock::now();
+                    for (size_t i = 0; i < num_records; ++i) {
+                        disk_manager.insertRecord(target, {"evento_" + std::to_string(i), std::to_string(i % 97)});
+                    }
+                    auto wall = std::chrono::steady_clock::now() - start;
+                    double io = simulatedTime() - io_before;
+                    if (target == heap_name) { heap_io = io; heap_wall = wall; }
+                    else { lsm_io = io; lsm_wall = wall; }
+                }
+                
+                std::cout << "\n=== INSERCIONES: HEAP vs LSM ===" << std::endl;
+                std::cout << "Heap: " << heap_io << " ms de E/S simulada, "
+                          << heap_wall.count() << " ms reales" << std::endl;
+                std::cout << "LSM:  " << lsm_io << " ms de E/S simulada, "
+                          << lsm_wall.count() << " ms reales" << std::endl;
+                disk_manager.displayStatistics();
+                break;
+            }
+            
+            case 22: {
+                // Claves en orden aleatorio en una tabla agrupada y en una heap
+                std::string table_name;
+                size_t num_records;
+                int low, high;
+                std::cout << "Nombre de la tabla agrupada: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                std::cout << "Rango de códigos a consultar (desde hasta): ";
+                std::cin >> low >> high;
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("codigo", FieldType::INTEGER),
+                    FieldDefinition("descripcion", FieldType::STRING, 24)
+                };
+                std::string heap_name = table_name + "_heap";
+                if (!disk_manager.createTable(heap_name, schema) ||
+                    !disk_manager.createClusteredTable(table_name, schema, "codigo")) {
+                    break;
+                }
+                
+                std::vector<int> keys(num_records);
+                for (size_t i = 0; i < num_records; ++i) keys[i] = static_cast<int>(i);
+                std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+                for (int key : keys) {
+                    std::vector<std::string> values = {std::to_string(key), "item_" + std::to_string(key)};
+                    disk_manager.insertRecord(heap_name, values);
+                    disk_manager.insertRecord(table_name, values);
+                }
+                
+                std::string from = std::to_string(low), to = std::to_string(high);
+                RangeScanReport heap = disk_manager.rangeScan(heap_name, "codigo", from, to);
+                RangeScanReport clustered = disk_manager.rangeScan(table_name, "codigo", from, to);
+                
+                std::cout << "\n=== RANGO codigo " << from << ".." << to << " ===" << std::endl;
+                std::cout << "Heap:     " << heap.records.size() << " registros, " << heap.blocks_read
+                          << " bloques, " << heap.cylinder_changes << " cambios de cilindro, "
+                          << heap.simulated_ms << " ms" << std::endl;
+                std::cout << "Agrupada: " << clustered.records.size() << " registros, " << clustered.blocks_read
+                          << " bloques, " << clustered.cylinder_changes << " cambios de cilindro, "
+                          << clustered.simulated_ms << " ms" << std::endl;
+                disk_manager.displayStatistics();
+                break;
+            }
+            
+            case 23: {
+                // Columnas de baja cardinalidad combinadas con AND / OR / NOT
+                std::string table_name;
+                size_t num_records;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("nombre", FieldType::STRING, 20),
+                    FieldDefinition("categoria", FieldType::STRING, 8),
+                    FieldDefinition("puesto", FieldType::STRING, 12),
+                    FieldDefinition("salario", FieldType::INTEGER)
+                };
+                if (!disk_manager.createTable(table_name, schema)) {
+                    break;
+                }
+                
+                const std::vector<std::string> categorias = {"A", "B", "C", "D"};
+                const std::vector<std::string> puestos = {"analista", "tecnico", "gerente", "soporte", "ventas"};
+                std::mt19937 rng(7);
+                for (size_t i = 0; i < num_records; ++i) {
+                    disk_manager.insertRecord(table_name, {"empleado_" + std::to_string(i),
+                                                           categorias[rng() % categorias.size()],
+                                                           puestos[rng() % puestos.size()],
+                                                           std::to_string(1000 + rng() % 4000)});
+                }
+                disk_manager.createBitmapIndex(table_name, "categoria");
+                disk_manager.createBitmapIndex(table_name, "puesto");
+                
+                // categoria IN ('A', 'B') AND puesto = 'tecnico' AND NOT categoria = 'B'
+                std::vector<BitmapTerm> terms = {
+                    BitmapTerm("categoria", {"A", "B"}),
+                    BitmapTerm("puesto", {"tecnico"}),
+                    BitmapTerm("categoria", {"B"}, true)
+                };
+                BitmapScanReport report = disk_manager.bitmapHeapScan(table_name, terms);
+                
+                std::cout << "\n=== categoria IN (A,B) AND puesto = tecnico AND NOT categoria = B ===" << std::endl;
+                std::cout << "Filas: " << report.records.size() << " (candidatas " << report.candidate_rows
+                          << ", mapas combinados en " << report.bitmap_ms << " ms)" << std::endl;
+                std::cout << "Bloques leídos: " << report.blocks_read << " de " << report.table_blocks
+                          << " (" << report.simulated_ms << " ms de E/S simulada)" << std::endl;
+                disk_manager.displayStatistics();
+                break;
+            }
+            
+            case 24: {
+                // Tabla caliente en memoria: ART frente al índice de la tabla agrupada y al recorrido
+                std::string table_name;
+                size_t num_records, lookups;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                std::cout << "Búsquedas a medir: ";
+                std::cin >> lookups;
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("codigo", FieldType::INTEGER),
+                    FieldDefinition("descripcion", FieldType::STRING, 24)
+                };
+                std::string clustered_name = table_name + "_agrupada";
+                if (!disk_manager.createTable(table_name, schema) ||
+                    !disk_manager.createClusteredTable(clustered_name, schema, "codigo")) {
+                    break;
+                }
+                disk_manager.setTableTier(table_name, StorageTier::MEMORY);
+                disk_manager.setTableTier(clustered_name, StorageTier::MEMORY);
+                for (size_t i = 0; i < num_records; ++i) {
+                    std::vector<std::string> values = {std::to_string(i), "item_" + std::to_string(i)};
+                    disk_manager.insertRecord(table_name, values);
+                    disk_manager.insertRecord(clustered_name, values);
+                }
+                disk_manager.createRadixIndex(table_name, "codigo");
+                disk_manager.createRadixIndex(table_name, "descripcion");
+                
+                std::mt19937 rng(11);
+                std::vector<std::string> keys;
+                for (size_t i = 0; i < lookups; ++i) keys.push_back(std::to_string(rng() % num_records));
+                
+                auto measure = [&keys](const std::function<size_t(const std::string&)>& lookup) {
+                    size_t found = 0;
+                    auto start = std::chrono::steady_clock::now();
+                    for (const auto& key : keys) found += lookup(key);
+                    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+                    std::cout << found << " encontrados, " << elapsed.count() / keys.size() << " us por búsqueda" << std::endl;
+                };
+                
+                std::cout << "\n=== BÚSQUEDA POR codigo (" << keys.size() << " claves) ===" << std::endl;
+                std::cout << "ART:               ";
+                measure([&](const std::string& key) { return disk_manager.radixLookup(table_name, "codigo", key).size(); });
+                std::cout << "Tabla agrupada:    ";
+                measure([&](const std::string& key) {
+                    return disk_manager.rangeScan(clustered_name, "codigo", key, key).records.size();
+                });
+                std::cout << "Recorrido heap:    ";
+                measure([&](const std::string& key) {
+                    return disk_manager.rangeScan(table_name, "codigo", key, key).records.size();
+                });
+                
+                auto prefixed = disk_manager.radixPrefixLookup(table_name, "descripcion", "item_12");
+                std::cout << "Prefijo 'item_12': " << prefixed.size() << " filas" << std::endl;
+                break;
+            }
+            
+            case 25: {
+                // Mismo texto en dos columnas: solo `nombre` tiene índice de trigramas
+                std::string table_name, pattern;
+                size_t num_records;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                std::cin.ignore();
+                std::cout << "Patrón LIKE (ej. %lopez 12%): ";
+                std::getline(std::cin, pattern);
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("nombre", FieldType::STRING, 24),
+                    FieldDefinition("comentario", FieldType::STRING, 24)
+                };
+                if (!disk_manager.createTable(table_name, schema)) {
+                    break;
+                }
+                const std::vector<std::string> apellidos = {"garcia", "lopez", "martinez", "rodriguez",
+                                                            "sanchez", "perez", "gomez", "torres"};
+                std::mt19937 rng(13);
+                for (size_t i = 0; i < num_records; ++i) {
+                    std::string text = apellidos[rng() % apellidos.size()] + " " + std::to_string(rng() % 1000);
+                    disk_manager.insertRecord(table_name, {text, text});
+                }
+                disk_manager.createTrigramIndex(table_name, "nombre");
+                
+                LikeSearchReport indexed = disk_manager.likeSearch(table_name, "nombre", pattern);
+                LikeSearchReport scanned = disk_manager.likeSearch(table_name, "comentario", pattern);
+                std::cout << "\n=== LIKE '" << pattern << "' ===" << std::endl;
+                std::cout << "Con trigramas: " << indexed.records.size() << " filas (" << indexed.candidates
+                          << " candidatas), " << indexed.index_blocks_read << " bloques de índice + "
+                          << indexed.data_blocks_read << " de " << indexed.table_blocks << " bloques de datos, "
+                          << indexed.simulated_ms << " ms" << (indexed.used_index ? "" : " [sin trigramas: recorrido]")
+                          << std::endl;
+                std::cout << "Recorrido:     " << scanned.records.size() << " filas, " << scanned.data_blocks_read
+                          << " bloques, " << scanned.simulated_ms << " ms" << std::endl;
+                break;
+            }
+            
+            case 26: {
+                // Ventas por región: la vista se mantiene con cada inserción, borrado y actualización
+                std::string table_name;
+                size_t num_records;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("region", FieldType::STRING, 12),
+                    FieldDefinition("producto", FieldType::STRING, 16),
+                    FieldDefinition("importe", FieldType::INTEGER)
+                };
+                std::string view_name = table_name + "_por_region";
+                if (!disk_manager.createTable(table_name, schema, false)) {
+                    break;
+                }
+                const std::vector<std::string> regiones = {"norte", "sur", "este", "oeste"};
+                std::mt19937 rng(17);
+                auto randomRow = [&]() {
+                    return std::vector<std::string>{regiones[rng() % regiones.size()],
+                                                    "producto_" + std::to_string(rng() % 50),
+                                                    std::to_string(rng() % 1000)};
+                };
+                for (size_t i = 0; i < num_records / 2; ++i) {
+                    disk_manager.insertRecord(table_name, randomRow());
+                }
+                if (!disk_manager.createMaterializedView(view_name, table_name, {"region"},
+                        {AggregateSpec(AggregateFunction::COUNT), AggregateSpec(AggregateFunction::SUM, "importe"),
+                         AggregateSpec(AggregateFunction::AVG, "importe"), AggregateSpec(AggregateFunction::MIN, "importe"),
+                         AggregateSpec(AggregateFunction::MAX, "importe")})) {
+                    break;
+                }
+                
+                // El resto de la carga, borrados y actualizaciones llegan a la vista como deltas
+                for (size_t i = num_records / 2; i < num_records; ++i) {
+                    disk_manager.insertRecord(table_name, randomRow());
+                }
+                for (size_t i = 0; i < num_records / 10; ++i) {
+                    int record_id = static_cast<int>(rng() % num_records) + 1;
+                    if (i % 2 == 0) {
+                        disk_manager.deleteRecord(table_name, record_id);
+                    } else {
+                        disk_manager.updateRecord(table_name, record_id, randomRow());
+                    }
+                }
+                
+                disk_manager.displayMaterializedView(view_name);
+                std::vector<std::string> row;
+                double view_ms = 0.0;
+                disk_manager.readMaterializedView(view_name, {"norte"}, row, &view_ms);
+                double refresh_ms = disk_manager.refreshMaterializedView(view_name);
+                std::cout << "\nLeer el grupo 'norte' de la vista: " << view_ms << " ms" << std::endl;
+                std::cout << "Recalcular la vista desde la tabla:  " << refresh_ms << " ms" << std::endl;
+                break;
+            }
+            
+            case 27: {
+                // Dos tablas con los mismos datos; solo se escribe en la primera entre consultas
+                std::string table_name;
+                size_t num_records, budget_kb;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                std::cout << "Presupuesto de la caché (KB): ";
+                std::cin >> budget_kb;
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("codigo", FieldType::INTEGER),
+                    FieldDefinition("ciudad", FieldType::STRING, 16)
+                };
+                std::string other_name = table_name + "_copia";
+                if (!disk_manager.createTable(table_name, schema) || !disk_manager.createTable(other_name, schema)) {
+                    break;
+                }
+                const std::vector<std::string> ciudades = {"lima", "cusco", "arequipa", "trujillo", "piura"};
+                for (size_t i = 0; i < num_records; ++i) {
+                    std::vector<std::string> values = {std::to_string(i), ciudades[i % ciudades.size()]};
+                    disk_manager.insertRecord(table_name, values);
+                    disk_manager.insertRecord(other_name, values);
+                }
+                disk_manager.setResultCacheBudget(budget_kb * 1024);
+                
+                std::string high = std::to_string(num_records / 4);
+                auto query = [&](const std::string& name, const std::string& label) {
+                    auto start = std::chrono::steady_clock::now();
+                    RangeScanReport report = disk_manager.rangeScan(name, "codigo", "0", high);
+                    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+                    std::cout << label << report.records.size() << " filas, " << report.blocks_read << " bloques, "
+                              << report.simulated_ms << " ms simulados, " << elapsed.count() << " us"
+                              << (report.from_cache ? " [caché]" : "") << std::endl;
+                };
+                
+                std::cout << "\n=== codigo ENTRE 0 Y " << high << " ===" << std::endl;
+                query(table_name, "Primera ejecución:      ");
+                query(table_name, "Repetida:               ");
+                disk_manager.rangeScan(other_name, "codigo", "000", high + ".0");  // Misma consulta normalizada
+                query(other_name, "Otra tabla (repetida):  ");
+                
+                disk_manager.insertRecord(table_name, {"1", "tacna"});
+                query(table_name, "Tras insertar en tabla: ");
+                query(other_name, "Otra tabla (intacta):   ");
+                
+                disk_manager.getResultCache().displayStatistics();
+                break;
+            }
+            
+            case 28: {
+                // AVG(importe) WHERE region = 'norte': exacto frente a varias muestras
+                std::string table_name;
+                size_t num_records, budget;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                std::cout << "Presupuesto de E/S (bloques): ";
+                std::cin >> budget;
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("region", FieldType::STRING, 12),
+                    FieldDefinition("importe", FieldType::INTEGER)
+                };
+                if (!disk_manager.createTable(table_name, schema)) {
+                    break;
+                }
+                const std::vector<std::string> regiones = {"norte", "sur", "este", "oeste"};
+                std::mt19937 rng(19);
+                for (size_t i = 0; i < num_records; ++i) {
+                    disk_manager.insertRecord(table_name, {regiones[rng() % regiones.size()],
+                                                           std::to_string(100 + rng() % 900)});
+                }
+                
+                AggregateSpec average(AggregateFunction::AVG, "importe");
+                auto show = [&](const std::string& label, const SampleSpec& spec) {
+                    ApproximateAggregateReport report =
+                        disk_manager.approximateAggregate(table_name, average, spec, "region", "norte", "norte");
+                    if (!report.valid) return;
+                    std::cout << label << report.estimate.value << "  [" << report.estimate.low << ", "
+                              << report.estimate.high << "]  " << report.blocks_read << "/" << report.table_blocks
+                              << " bloques, " << report.rows_sampled << " filas, " << report.simulated_ms << " ms"
+                              << std::endl;
+                };
+                
+                std::cout << "\n=== AVG(importe) WHERE region = 'norte' (IC 95%) ===" << std::endl;
+                show("Exacto:                 ", SampleSpec());
+                show("SYSTEM(5):              ", SampleSpec::system(5));
+                show("SYSTEM(20):             ", SampleSpec::system(20));
+                SampleSpec runs = SampleSpec::system(20);
+                runs.run_blocks = 4;
+                show("SYSTEM(20) tramos de 4: ", runs);
+                show("BERNOULLI(10):          ", SampleSpec::bernoulli(10));
+                runs = SampleSpec::system(100, budget);
+                runs.run_blocks = 4;
+                show("Presupuesto de bloques: ", runs);
+                break;
+            }
+            
+            case 29: {
+                // APPROX_COUNT_DISTINCT(cliente) y percentiles de latencia frente a los valores exactos
+                std::string table_name;
+                size_t num_records, workers;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                std::cout << "Trabajadores del recorrido: ";
+                std::cin >> workers;
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("cliente", FieldType::STRING, 12),
+                    FieldDefinition("latencia", FieldType::INTEGER)
+                };
+                if (!disk_manager.createTable(table_name, schema)) {
+                    break;
+                }
+                std::mt19937 rng(29);
+                std::set<std::string> clientes;
+                std::vector<double> latencias;
+                auto insertRows = [&](size_t count) {
+                    for (size_t i = 0; i < count; ++i) {
+                        std::string cliente = "c" + std::to_string(rng() % (num_records / 2 + 1));
+                        int latencia = 5 + static_cast<int>(std::exp((rng() % 1000) / 140.0));  // Cola larga
+                        disk_manager.insertRecord(table_name, {cliente, std::to_string(latencia)});
+                        clientes.insert(cliente);
+                        latencias.push_back(latencia);
+                    }
+                };
+                insertRows(num_records);
+                
+                auto show = [&](const std::string& label, const SketchAggregateReport& distinct,
+                                const SketchAggregateReport& latency) {
+                    if (!distinct.valid || !latency.valid) return;
+                    std::vector<double> sorted = latencias;
+                    std::sort(sorted.begin(), sorted.end());
+                    auto exact = [&sorted](double q) {
+                        return sorted[std::min(sorted.size() - 1, static_cast<size_t>(std::ceil(q * sorted.size())) - 1)];
+                    };
+                    std::cout << "\n" << label << ": " << distinct.blocks_read + latency.blocks_read
+                              << " bloques leídos, " << distinct.summaries_used + latency.summaries_used
+                              << " resúmenes, " << latency.workers << " trabajadores, "
+                              << distinct.simulated_ms + latency.simulated_ms << " ms de E/S" << std::endl;
+                    std::cout << "  COUNT(DISTINCT cliente): " << static_cast<long long>(distinct.sketch.distinct.estimate())
+                              << " (exacto " << clientes.size() << ")" << std::endl;
+                    for (double q : {0.5, 0.9, 0.99}) {
+                        std::cout << "  P" << static_cast<int>(q * 100) << "(latencia): "
+                                  << latency.sketch.quantiles.quantile(q) << " (exacto " << exact(q) << ")" << std::endl;
+                    }
+                };
+                
+                SketchAggregateReport latency = disk_manager.sketchAggregate(table_name, "latencia", workers, false);
+                show("Recorrido completo", disk_manager.sketchAggregate(table_name, "cliente", workers, false), latency);
+                std::cout << "Memoria por agregado: HLL " << latency.sketch.distinct.getMemoryBytes() << " bytes, KLL "
+                          << latency.sketch.quantiles.getMemoryBytes() << " bytes (error de rango ~"
+                          << 100 * latency.sketch.quantiles.getRankError() << "%)" << std::endl;
+                
+                disk_manager.createColumnSketches(table_name, "cliente");
+                disk_manager.createColumnSketches(table_name, "latencia");
+                insertRows(num_records / 20 + 1);
+                show("Con resúmenes tras nuevas inserciones", disk_manager.sketchAggregate(table_name, "cliente", workers),
+                     disk_manager.sketchAggregate(table_name, "latencia", workers));
+                break;
+            }
+            
+            case 30: {
+                // Ventas por tienda: numeración, acumulado, media móvil y máximo de la partición
+                std::string table_name;
+                size_t num_records, memory_rows, workers;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                std::cout << "Memoria del operador (filas, 0 = sin límite): ";
+                std::cin >> memory_rows;
+                std::cout << "Trabajadores: ";
+                std::cin >> workers;
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("tienda", FieldType::STRING, 12),
+                    FieldDefinition("dia", FieldType::INTEGER),
+                    FieldDefinition("importe", FieldType::INTEGER)
+                };
+                if (!disk_manager.createTable(table_name, schema)) {
+                    break;
+                }
+                // Una tienda concentra la mitad de las ventas: su partición puede no caber en memoria
+                const std::vector<std::string> tiendas = {"centro", "centro", "centro", "norte", "sur", "playa"};
+                std::mt19937 rng(30);
+                for (size_t i = 0; i < num_records; ++i) {
+                    disk_manager.insertRecord(table_name, {tiendas[rng() % tiendas.size()], std::to_string(1 + rng() % 365),
+                                                           std::to_string(10 + rng() % 490)});
+                }
+                
+                WindowSpec window;
+                window.partition_by = {"tienda"};
+                window.order_by = {"dia"};
+                window.calls = {
+                    WindowCall(WindowFunction::ROW_NUMBER),
+                    WindowCall(WindowFunction::RANK),
+                    WindowCall(AggregateSpec(AggregateFunction::SUM, "importe")),
+                    WindowCall(AggregateSpec(AggregateFunction::AVG, "importe"), WindowFrame::sliding(3, 3)),
+                    WindowCall(AggregateSpec(AggregateFunction::MAX, "importe"), WindowFrame::wholePartition())
+                };
+                
+                size_t shown = 0;
+                std::string last_partition;
+                WindowReport report = disk_manager.windowQuery(table_name, window, memory_rows, workers,
+                    [&](const std::vector<std::string>& row) {
+                        // Las tres primeras filas de cada partición
+                        if (row[0] != last_partition) {
+                            last_partition = row[0];
+                            shown = 0;
+                        }
+                        if (shown++ >= 3) return;
+                        for (size_t i = 0; i < row.size(); ++i) std::cout << (i > 0 ? " | " : "") << row[i];
+                        std::cout << std::endl;
+                    });
+                if (!report.valid) {
+                    break;
+                }
+                std::cout << "\nColumnas:";
+                for (const auto& column : report.header) std::cout << " [" << column << "]";
+                std::cout << std::endl;
+                std::cout << report.rows << " filas en " << report.partitions << " particiones (mayor: "
+                          << report.largest_partition << " filas)" << std::endl;
+                std::cout << "Tramos de ordenación: " << report.sort_runs << " | Particiones volcadas: "
+                          << report.spilled_partitions << " | Bloques temporales: " << report.spill_blocks_written
+                          << " escritos, " << report.spill_blocks_read << " leídos" << std::endl;
+                std::cout << "E/S simulada: " << report.simulated_ms << " ms | Evaluación: " << report.compute_ms
+                          << " ms con " << report.workers << " trabajadores" << std::endl;
+                break;
+            }
+            
+            case 31: {
+                // Filtro + agregado: árbol interpretado frente al núcleo fusionado elegido en el plan
+                std::string table_name;
+                size_t num_records, repetitions;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                std::cout << "Repeticiones por consulta: ";
+                std::cin >> repetitions;
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("categoria", FieldType::STRING, 12),
+                    FieldDefinition("cantidad", FieldType::INTEGER),
+                    FieldDefinition("precio", FieldType::FLOAT)
+                };
+                if (!disk_manager.createTable(table_name, schema)) {
+                    break;
+                }
+                const std::vector<std::string> categorias = {"libros", "musica", "juegos", "hogar"};
+                std::mt19937 rng(31);
+                for (size_t i = 0; i < num_records; ++i) {
+                    disk_manager.insertRecord(table_name, {categorias[rng() % categorias.size()],
+                                                           std::to_string(1 + rng() % 100),
+                                                           std::to_string((rng() % 100000) / 100.0)});
+                }
+                
+                std::vector<FilterAggregateQuery> queries = {
+                    {"cantidad", CompareOp::LT, "50", AggregateSpec(AggregateFunction::SUM, "precio")},
+                    {"precio", CompareOp::GE, "250", AggregateSpec(AggregateFunction::SUM, "cantidad")},
+                    {"categoria", CompareOp::EQ, "juegos", AggregateSpec(AggregateFunction::AVG, "precio")},
+                    {"cantidad", CompareOp::NE, "7", AggregateSpec(AggregateFunction::MAX, "precio")},
+                    {"precio", CompareOp::LE, "10", AggregateSpec(AggregateFunction::COUNT)}
+                };
+                std::cout << "\n=== FILTRO + AGREGADO (" << repetitions << " repeticiones, mejor tiempo) ===" << std::endl;
+                for (const auto& query : queries) {
+                    FilterAggregateReport interpreted =
+                        disk_manager.filterAggregate(table_name, query, ExecutionMode::INTERPRETED, repetitions);
+                    FilterAggregateReport fused = disk_manager.filterAggregate(table_name, query, ExecutionMode::FUSED,
+                                                                               repetitions);
+                    if (!interpreted.valid || !fused.valid) continue;
+                    std::cout << "\n" << query.toString() << std::endl;
+                    std::cout << "  Resultado: " << fused.value << " (" << fused.rows_matched << " de "
+                              << fused.rows_scanned << " filas)"
+                              << (interpreted.value == fused.value ? "" : "  ¡distinto del intérprete!") << std::endl;
+                    std::cout << "  Interpretado: " << interpreted.execute_ms << " ms | Fusionado: " << fused.execute_ms
+                              << " ms | Aceleración: " << interpreted.execute_ms / std::max(fused.execute_ms, 1e-6)
+                              << "x" << std::endl;
+                    std::cout << "  Núcleo: " << fused.kernel << " | Decodificación (común): " << fused.decode_ms
+                              << " ms" << std::endl;
+                }
+                break;
+            }
+            
+            case 32: {
+                // Expresiones en SELECT, WHERE, GROUP BY y ORDER BY evaluadas por lotes
+                std::string table_name;
+                size_t num_records;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("nombre", FieldType::STRING, 16),
+                    FieldDefinition("departamento", FieldType::STRING, 12),
+                    FieldDefinition("edad", FieldType::INTEGER),
+                    FieldDefinition("salario", FieldType::FLOAT),
+                    FieldDefinition("hijos", FieldType::INTEGER)
+                };
+                if (!disk_manager.createTable(table_name, schema)) {
+                    break;
+                }
+                const std::vector<std::string> nombres = {"ana", "luis", "marta", "jorge", "lucia", "pedro"};
+                const std::vector<std::string> departamentos = {"ventas", "sistemas", "finanzas"};
+                std::mt19937 rng(32);
+                for (size_t i = 0; i < num_records; ++i) {
+                    disk_manager.insertRecord(table_name, {nombres[rng() % nombres.size()] + std::to_string(i),
+                                                           departamentos[rng() % departamentos.size()],
+                                                           std::to_string(20 + rng() % 45),
+                                                           std::to_string(1000 + (rng() % 400000) / 100.0),
+                                                           std::to_string(rng() % 4)});
+                }
+                
+                using E = VectorExpression;
+                auto salario = E::column("salario");
+                auto nivel = E::caseWhen({{E::compare(CompareOp::GE, salario, E::literal("4000", FieldType::INTEGER)),
+                                           E::literal("alto", FieldType::STRING)},
+                                          {E::compare(CompareOp::GE, salario, E::literal("2500", FieldType::INTEGER)),
+                                           E::literal("medio", FieldType::STRING)}},
+                                         E::literal("bajo", FieldType::STRING));
+                
+                VectorQuery detail;
+                detail.select = {
+                    VectorSelectItem::scalar("codigo", E::function("UPPER", {E::function("SUBSTR", {
+                        E::column("nombre"), E::literal("1", FieldType::INTEGER), E::literal("3", FieldType::INTEGER)})})),
+                    VectorSelectItem::scalar("nuevo_salario", E::arithmetic('*', salario, E::literal("1.1", FieldType::FLOAT))),
+                    VectorSelectItem::scalar("nivel", nivel),
+                    VectorSelectItem::scalar("por_hijo", E::arithmetic('/', salario, E::column("hijos")))
+                };
+                detail.where = E::logicalAnd(E::compare(CompareOp::GE, E::column("edad"), E::literal("30", FieldType::INTEGER)),
+                                             E::compare(CompareOp::EQ, E::column("departamento"),
+                                                        E::literal("sistemas", FieldType::STRING)));
+                detail.order_by = {{1, true}};
+                detail.limit = 8;
+                
+                VectorQuery summary;
+                summary.select = {
+                    VectorSelectItem::scalar("departamento", E::column("departamento")),
+                    VectorSelectItem::scalar("nivel", nivel),
+                    VectorSelectItem::aggregate("empleados", AggregateFunction::COUNT),
+                    VectorSelectItem::aggregate("media_nuevo", AggregateFunction::AVG,
+                                                E::arithmetic('*', salario, E::literal("1.1", FieldType::FLOAT))),
+                    VectorSelectItem::aggregate("hijos", AggregateFunction::SUM, E::column("hijos"))
+                };
+                summary.order_by = {{0, false}, {2, true}};
+                
+                for (const VectorQuery* query : {&detail, &summary}) {
+                    VectorQueryReport report = disk_manager.vectorQuery(table_name, *query);
+                    if (!report.valid) continue;
+                    std::cout << "\n=== " << (query == &detail ? "SELECT calculado WHERE edad >= 30 AND departamento = 'sistemas' "
+                                                                  "ORDER BY nuevo_salario DESC LIMIT 8"
+                                                                : "GROUP BY departamento, nivel ORDER BY departamento, empleados DESC")
+                              << " ===" << std::endl;
+                    for (size_t c = 0; c < report.header.size(); ++c) std::cout << (c > 0 ? " | " : "") << report.header[c];
+                    std::cout << std::endl;
+                    for (const auto& row : report.rows) {
+                        for (size_t c = 0; c < row.size(); ++c) std::cout << (c > 0 ? " | " : "") << row[c];
+                        std::cout << std::endl;
+                    }
+                    std::cout << "Filas leídas: " << report.rows_scanned << " | Seleccionadas: " << report.rows_selected
+                              << " | Lotes: " << report.batches;
+                    if (report.groups > 0) std::cout << " | Grupos: " << report.groups;
+                    std::cout << "\nE/S simulada: " << report.simulated_ms << " ms | Ejecución: " << report.execute_ms
+                              << " ms" << std::endl;
+                }
+                break;
+            }
+            
+            case 33: {
+                // Índice B+ secundario: lectura por lotes, tramos ordenados por hilo y mezcla particionada
+                std::string table_name, column;
+                size_t num_records;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                std::cin.ignore();
+                std::cout << "Columna a indexar (codigo/precio/nombre): ";
+                std::getline(std::cin, column);
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("codigo", FieldType::INTEGER),
+                    FieldDefinition("precio", FieldType::FLOAT),
+                    FieldDefinition("nombre", FieldType::STRING, 12)
+                };
+                if (!disk_manager.createTable(table_name, schema)) {
+                    break;
+                }
+                std::mt19937 rng(33);
+                for (size_t i = 0; i < num_records; ++i) {
+                    disk_manager.insertRecord(table_name, {std::to_string(rng() % 1000000),
+                                                           std::to_string((rng() % 100000) / 100.0),
+                                                           "art" + std::to_string(rng() % 50000)});
+                }
+                
+                size_t cores = std::max(1u, std::thread::hardware_concurrency());
+                std::vector<size_t> worker_counts = {1};
+                for (size_t w = 2; w < cores; w *= 2) worker_counts.push_back(w);
+                if (cores > 1) worker_counts.push_back(cores);
+                
+                std::cout << "\n=== CONSTRUCCIÓN DE " << table_name << "." << column << " (" << cores
+                          << " núcleos) ===" << std::endl;
+                double single_ms = 0.0;
+                for (size_t workers : worker_counts) {
+                    bool last = workers == worker_counts.back();
+                    IndexBuildProgress progress = [](const std::string& phase, size_t done, size_t total) {
+                        std::cout << "  [" << phase << "] " << done << "/" << total << std::endl;
+                    };
+                    IndexBuildReport report = disk_manager.createBTreeIndex(table_name, column, workers,
+                                                                            last ? progress : nullptr);
+                    if (!report.valid) break;
+                    if (workers == 1) single_ms = report.total_ms;
+                    std::cout << workers << " hilo(s): " << report.total_ms << " ms (lectura " << report.scan_ms
+                              << ", de ella ordenación " << report.sort_ms << ", mezcla " << report.merge_ms
+                              << ", carga " << report.load_ms << ") | Aceleración: "
+                              << single_ms / std::max(report.total_ms, 1e-6) << "x" << std::endl;
+                    if (last) {
+                        std::cout << report.rows << " entradas de " << report.blocks << " bloques | Altura: "
+                                  << report.height << " | Nodos: " << report.nodes << " | E/S simulada: "
+                                  << report.simulated_ms << " ms" << std::endl;
+                    }
+                }
+                if (!disk_manager.hasBTreeIndex(table_name, column)) break;
+                
+                std::string low = column == "nombre" ? "art100" : "100";
+                std::string high = column == "nombre" ? "art105" : (column == "precio" ? "105" : "5000");
+                auto rows = disk_manager.btreeRangeLookup(table_name, column, low, high);
+                std::cout << "\n" << column << " BETWEEN " << low << " AND " << high << ": " << rows.size()
+                          << " filas por el índice" << std::endl;
+                for (size_t i = 0; i < std::min<size_t>(rows.size(), 5); ++i) {
+                    rows[i]->display();
+                }
+                break;
+            }
+            
+            case 34: {
+                // Índice B+ con versiones por nodo frente a un mutex global, con mezclas de búsquedas e inserciones
+                std::string table_name;
+                size_t num_records, ops_per_thread;
+                std::cout << "Nombre de la tabla: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Registros a insertar: ";
+                std::cin >> num_records;
+                std::cout << "Operaciones por hilo: ";
+                std::cin >> ops_per_thread;
+                std::cin.ignore();
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("codigo", FieldType::INTEGER),
+                    FieldDefinition("nombre", FieldType::STRING, 12)
+                };
+                if (!disk_manager.createTable(table_name, schema)) {
+                    break;
+                }
+                std::mt19937 rng(34);
+                for (size_t i = 0; i < num_records; ++i) {
+                    disk_manager.insertRecord(table_name, {std::to_string(rng() % 1000000),
+                                                           "art" + std::to_string(rng() % 50000)});
+                }
+                
+                std::cout << "\n=== " << table_name << ".codigo (" << std::max(1u, std::thread::hardware_concurrency())
+                          << " núcleos) ===" << std::endl;
+                for (unsigned lookup_percent : {95u, 50u}) {
+                    std::cout << "\n" << lookup_percent << "% búsquedas / " << 100 - lookup_percent
+                              << "% inserciones" << std::endl;
+                    std::cout << "Hilos | Mutex global (op/s) | Optimista (op/s) | Reintentos" << std::endl;
+                    for (size_t threads : {1, 2, 4, 8, 16, 32}) {
+                        IndexConcurrencyReport global = disk_manager.benchmarkBTreeConcurrency(
+                            table_name, "codigo", threads, lookup_percent, ops_per_thread, IndexLatching::GLOBAL);
+                        IndexConcurrencyReport optimistic = disk_manager.benchmarkBTreeConcurrency(
+                            table_name, "codigo", threads, lookup_percent, ops_per_thread, IndexLatching::OPTIMISTIC);
+                        if (!global.valid || !optimistic.valid) break;
+                        std::cout << threads << " | " << static_cast<size_t>(global.ops_per_second) << " | "
+                                  << static_cast<size_t>(optimistic.ops_per_second) << " | " << optimistic.restarts
+                                  << std::endl;
+                    }
+                }
+                break;
+            }
+            
+            case 35: {
+                // Inserción de un lote con varios hilos: bloque preferido por hilo y extensiones de direcciones
+                std::string table_name;
+                size_t num_records;
+                std::cout << "Prefijo de las tablas: ";
+                std::getline(std::cin, table_name);
+                std::cout << "Filas por lote: ";
+                std::cin >> num_records;
+                std::cin.ignore();
+                
+                std::vector<FieldDefinition> schema = {
+                    FieldDefinition("codigo", FieldType::INTEGER),
+                    FieldDefinition("precio", FieldType::FLOAT),
+                    FieldDefinition("nombre", FieldType::STRING, 12)
+                };
+                std::mt19937 rng(35);
+                std::vector<std::vector<std::string>> rows;
+                for (size_t i = 0; i < num_records; ++i) {
+                    rows.push_back({std::to_string(rng() % 1000000), std::to_string((rng() % 100000) / 100.0),
+                                    "art" + std::to_string(rng() % 50000)});
+                }
+                
+                size_t cores = std::max(1u, std::thread::hardware_concurrency());
+                std::vector<size_t> worker_counts = {1};
+                for (size_t w = 2; w <= std::max<size_t>(cores, 8); w *= 2) worker_counts.push_back(w);
+                
+                std::cout << "\n=== INSERCIÓN PARALELA (" << cores << " núcleos) ===" << std::endl;
+                std::cout << "Hilos | Filas/s (total) | Filas/s (colocación) | Colocación (ms) | Cierre (ms) | "
+                          << "Bloques nuevos | E/S simulada (ms)" << std::endl;
+                for (size_t workers : worker_counts) {
+                    std::string name = table_name + "_" + std::to_string(workers);
+                    if (!disk_manager.createTable(name, schema)) break;
+                    InsertBatchReport report = disk_manager.insertRecordsParallel(name, rows, workers);
+                    if (!report.valid) break;
+                    std::cout << report.workers << " | " << static_cast<size_t>(report.rows_per_second) << " | "
+                              << static_cast<size_t>(report.placement_rows_per_second) << " | " << report.insert_ms
+                              << " | " << report.finish_ms << " | " << report.new_blocks
+                              << " (+" << report.reused_blocks << " reutilizados) | " << report.simulated_ms
+                              << std::endl;
+                }
+                break;
+            }
+            
             case 0: {
                 std::cout << "¡Gracias por usar el SGBD Físico!" << std::endl;
                 return 0;
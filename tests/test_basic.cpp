@@ -0,0 +1,1185 @@
+/**
+ * @brief Pruebas de comportamiento del SGBD físico
+ *
+ * Cada prueba trabaja en su propio directorio de disco bajo test_data/ y
+ * cuenta sus fallos; el programa termina con código distinto de cero si
+ * alguna comprobación falla.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <limits>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include "DiskManager.h"
+#include "SSDModel.h"
+#include "ReplicaFollower.h"
+#include "VolumeManager.h"
+#include "VectorExpression.h"
+#include "BPlusTree.h"
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        checks++;                                                                     \
+        if (!(condition)) {                                                           \
+            failures++;                                                               \
+            std::clog << __FILE__ << ":" << __LINE__ << ": falla " #condition << std::endl; \
+        }                                                                             \
+    } while (0)
+
+/**
+ * @brief Silencia std::cout y std::cerr mientras vive (los mensajes del gestor no interesan aquí)
+ */
+class QuietOutput {
+    std::ostringstream sink;
+    std::streambuf* previous_out;
+    std::streambuf* previous_err;
+
+public:
+    QuietOutput() : previous_out(std::cout.rdbuf(sink.rdbuf())), previous_err(std::cerr.rdbuf(sink.rdbuf())) {}
+    ~QuietOutput() {
+        std::cout.rdbuf(previous_out);
+        std::cerr.rdbuf(previous_err);
+    }
+};
+
+/**
+ * @brief Directorio vacío para el disco de una prueba
+ */
+static std::string freshDiskPath(const std::string& name) {
+    std::string path = "test_data/" + name;
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories("test_data");
+    return path;
+}
+
+static std::vector<FieldDefinition> peopleSchema() {
+    return {FieldDefinition("id", FieldType::INTEGER), FieldDefinition("nombre", FieldType::STRING, 40)};
+}
+
+static std::vector<std::string> personRow(int i) {
+    return {std::to_string(i), "persona_" + std::to_string(i)};
+}
+
+/**
+ * @brief Con el disco lleno las inserciones fallan y lo ya insertado sigue legible
+ */
+static void testDiskFull() {
+    std::string path = freshDiskPath("disk_full");
+    int inserted = 0;
+    {
+        QuietOutput quiet;
+        DiskManager disk(path);
+        CHECK(disk.initialize(DiskConfig(1, 1, 4, 8, 512)));
+        CHECK(disk.createTable("gente", peopleSchema(), false));
+        while (inserted < 10000 && disk.insertRecord("gente", personRow(inserted + 1))) inserted++;
+        CHECK(inserted > 0 && inserted < 10000);
+        CHECK(!disk.insertRecord("gente", personRow(inserted + 1)));
+
+        auto report = disk.insertRecordsParallel("gente", {personRow(1), personRow(2)}, 2);
+        CHECK(!report.valid);
+        CHECK(!disk.createTable("otra", peopleSchema(), false));
+        for (int id = 1; id <= inserted; ++id) CHECK(disk.findRecord("gente", id) != nullptr);
+    }
+    QuietOutput quiet;
+    DiskManager reopened(path);
+    CHECK(reopened.loadExistingDisk());
+    for (int id = 1; id <= inserted; ++id) CHECK(reopened.findRecord("gente", id) != nullptr);
+}
+
+/**
+ * @brief Una actualización que no cabe en ningún bloque deja la fila antigua intacta
+ */
+static void testUpdateRollback() {
+    std::string path = freshDiskPath("update_rollback");
+    QuietOutput quiet;
+    DiskManager disk(path);
+    CHECK(disk.initialize(DiskConfig(1, 1, 4, 8, 512)));
+    CHECK(disk.createTable("notas", {FieldDefinition("id", FieldType::INTEGER),
+                                     FieldDefinition("texto", FieldType::STRING, 200)}, false));
+    int inserted = 0;
+    while (inserted < 10000 && disk.insertRecord("notas", {std::to_string(inserted + 1), "p"})) inserted++;
+    CHECK(inserted > 0);
+
+    // La versión nueva no cabe en su bloque ni en otro, y no quedan bloques libres
+    CHECK(!disk.updateRecord("notas", 1, {"1", std::string(150, 'x')}));
+    auto kept = disk.findRecord("notas", 1);
+    CHECK(kept && kept->getField(1) == "p");
+
+    DiskManager reopened(path);
+    CHECK(reopened.loadExistingDisk());
+    kept = reopened.findRecord("notas", 1);
+    CHECK(kept && kept->getField(1) == "p");
+}
+
+/**
+ * @brief Una vista materializada no admite escrituras directas
+ */
+static void testViewWritesRejected() {
+    std::string path = freshDiskPath("view_writes");
+    QuietOutput quiet;
+    DiskManager disk(path);
+    CHECK(disk.initialize(DiskConfig(1, 2, 64, 32, 1024)));
+    CHECK(disk.createTable("gente", peopleSchema(), false));
+    for (int i = 1; i <= 20; ++i) CHECK(disk.insertRecord("gente", personRow(i)));
+    CHECK(disk.createMaterializedView("por_nombre", "gente", {"nombre"}, {AggregateSpec()}));
+    auto rows = disk.materializedViewRows("por_nombre");
+    CHECK(rows.size() == 20);
+
+    CHECK(!disk.insertRecord("por_nombre", {"intrusa", "1"}));
+    CHECK(!disk.insertRecordsParallel("por_nombre", {{"intrusa", "1"}}, 1).valid);
+    CHECK(!disk.updateRecord("por_nombre", 1, {"intrusa", "1"}));
+    CHECK(!disk.deleteRecord("por_nombre", 1));
+    CHECK(disk.materializedViewRows("por_nombre") == rows);
+}
+
+/**
+ * @brief Una tabla en memoria se recupera del WAL tras una caída, aunque la última línea quedara a medias
+ */
+static void testWalRecovery() {
+    std::string path = freshDiskPath("wal_recovery");
+    const int rows = 300;
+    {
+        QuietOutput quiet;
+        DiskManager disk(path);
+        CHECK(disk.initialize(DiskConfig(1, 2, 64, 32, 1024)));
+        CHECK(disk.createTable("gente", peopleSchema(), false));
+        CHECK(disk.setTableTier("gente", StorageTier::MEMORY));
+        for (int i = 1; i <= rows; ++i) CHECK(disk.insertRecord("gente", personRow(i)));
+        CHECK(disk.updateRecord("gente", 7, {"7", "actualizada"}));
+        CHECK(disk.deleteRecord("gente", 9));
+    }
+    // Sin checkpoint al cerrar: el estado solo está en el log, que termina en una línea truncada
+    std::ofstream(path + "/metadata/wal.log", std::ios::app) << "999999|gente|0|0|0";
+
+    QuietOutput quiet;
+    DiskManager reopened(path);
+    CHECK(reopened.loadExistingDisk());
+    CHECK(reopened.getTableTier("gente") == StorageTier::MEMORY);
+    int found = 0;
+    for (int id = 1; id <= rows; ++id) {
+        if (reopened.findRecord("gente", id)) found++;
+    }
+    CHECK(found == rows - 1);
+    CHECK(reopened.findRecord("gente", 9) == nullptr);
+    auto updated = reopened.findRecord("gente", 7);
+    CHECK(updated && updated->getField(1) == "actualizada");
+    CHECK(reopened.insertRecord("gente", personRow(rows + 1)));
+    CHECK(reopened.checkpointWal());
+
+    DiskManager after_checkpoint(path);
+    CHECK(after_checkpoint.loadExistingDisk());
+    CHECK(after_checkpoint.findRecord("gente", rows + 1) != nullptr);
+    CHECK(after_checkpoint.findRecord("gente", 9) == nullptr);
+}
+
+/**
+ * @brief Comprueba que una tabla LSM tenga cada fila viva con su último valor
+ */
+static void checkLSMContents(DiskManager& disk, int rows) {
+    int mismatches = 0;
+    for (int id = 1; id <= rows; ++id) {
+        auto record = disk.findRecord("eventos", id);
+        if (id % 10 == 0) {
+            if (record) mismatches++;                   // Borradas
+        } else if (!record || record->getField(1) != (id % 7 == 0 ? "v2_" : "persona_") + std::to_string(id)) {
+            mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+/**
+ * @brief La compactación LSM conserva la última versión y una instalación fallida no pierde datos
+ */
+static void testLSMCompaction() {
+    std::string path = freshDiskPath("lsm_compaction");
+    const int rows = 512;
+    LSMOptions options;
+    options.memtable_limit = 16;
+    options.size_ratio = 2;
+    {
+        QuietOutput quiet;
+        DiskManager disk(path);
+        CHECK(disk.initialize(DiskConfig(1, 2, 128, 32, 1024)));
+        CHECK(disk.createLSMTable("eventos", peopleSchema(), false, options));
+        for (int i = 1; i <= rows; ++i) CHECK(disk.insertRecord("eventos", personRow(i)));
+        for (int id = 7; id <= rows; id += 7) CHECK(disk.updateRecord("eventos", id, {std::to_string(id), "v2_" + std::to_string(id)}));
+        for (int id = 10; id <= rows; id += 10) CHECK(disk.deleteRecord("eventos", id));
+        disk.compactTable("eventos");
+        checkLSMContents(disk, rows);
+
+        // Con el manifiesto bloqueado (y la memtable recién volcada) ninguna compactación se instala
+        for (int i = rows + 1; i <= rows + 16; ++i) CHECK(disk.insertRecord("eventos", personRow(i)));
+        std::string manifest = path + "/metadata/lsm_eventos.txt";
+        std::filesystem::create_directory(manifest + ".tmp");
+        disk.compactTable("eventos");
+        checkLSMContents(disk, rows);
+        std::filesystem::remove(manifest + ".tmp");
+        disk.compactTable("eventos");
+        checkLSMContents(disk, rows);
+    }
+    QuietOutput quiet;
+    DiskManager reopened(path);
+    CHECK(reopened.loadExistingDisk());
+    checkLSMContents(reopened, rows);
+    CHECK(reopened.findRecord("eventos", rows + 16) != nullptr);
+}
+
+/**
+ * @brief Comprueba que la tabla agrupada tenga las filas no borradas
+ */
+static void checkClusteredContents(DiskManager& disk, int rows) {
+    int mismatches = 0;
+    for (int id = 1; id <= rows; ++id) {
+        auto record = disk.findRecord("ordenada", id);
+        if ((id % 3 == 0) != (record == nullptr) || (record && record->getField(1) != "persona_" + std::to_string(id))) {
+            mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+/**
+ * @brief La reorganización de una tabla agrupada escribe hojas nuevas y, si falla, deja las antiguas
+ */
+static void testClusteredReorganization() {
+    std::string path = freshDiskPath("clustered_reorg");
+    const int rows = 400;
+    {
+        QuietOutput quiet;
+        DiskManager disk(path);
+        CHECK(disk.initialize(DiskConfig(1, 2, 64, 16, 512)));
+        CHECK(disk.createClusteredTable("ordenada", peopleSchema(), "id", false));
+        for (int i = 1; i <= rows; ++i) CHECK(disk.insertRecord("ordenada", personRow(i)));
+        for (int id = 3; id <= rows; id += 3) CHECK(disk.deleteRecord("ordenada", id));
+
+        // Sin poder escribir el diario la reorganización no toca ninguna hoja
+        std::string journal = path + "/metadata/reorg_ordenada.txt";
+        std::filesystem::create_directory(journal + ".tmp");
+        disk.compactTable("ordenada");
+        checkClusteredContents(disk, rows);
+        std::filesystem::remove(journal + ".tmp");
+
+        disk.compactTable("ordenada");
+        checkClusteredContents(disk, rows);
+        CHECK(!std::filesystem::exists(journal));
+        disk.compactTable("ordenada");
+        checkClusteredContents(disk, rows);
+    }
+    QuietOutput quiet;
+    DiskManager reopened(path);
+    CHECK(reopened.loadExistingDisk());
+    checkClusteredContents(reopened, rows);
+    CHECK(reopened.insertRecord("ordenada", personRow(rows + 1)));
+    CHECK(reopened.findRecord("ordenada", rows + 1) != nullptr);
+}
+
+/**
+ * @brief La relación de las listas de trigramas no aparece ni se consulta como una tabla
+ */
+static void testInternalRelationsHidden() {
+    std::string path = freshDiskPath("internal_relations");
+    std::ostringstream listing;
+    {
+        QuietOutput quiet;
+        DiskManager disk(path);
+        CHECK(disk.initialize(DiskConfig(1, 2, 64, 32, 1024)));
+        CHECK(disk.createTable("gente", peopleSchema(), false));
+        for (int i = 1; i <= 300; ++i) CHECK(disk.insertRecord("gente", personRow(i)));
+        CHECK(disk.createTrigramIndex("gente", "nombre"));
+        CHECK(!disk.createTable("trgm_gente_nombre", peopleSchema(), false));
+        CHECK(!disk.createTable("trgm_otra", peopleSchema(), false));
+    }
+    QuietOutput quiet;
+    DiskManager reopened(path);
+    CHECK(reopened.loadExistingDisk());
+    CHECK(reopened.findRecord("trgm_gente_nombre", 1) == nullptr);
+    CHECK(!reopened.deleteRecord("trgm_gente_nombre", 1));
+    std::streambuf* previous = std::cout.rdbuf(listing.rdbuf());
+    reopened.displayStatistics();
+    std::cout.rdbuf(previous);
+    CHECK(listing.str().find("- gente:") != std::string::npos);
+    CHECK(listing.str().find("trgm_") == std::string::npos);
+}
+
+/**
+ * @brief Una réplica responde con sus índices y su caché lo que el primario le acaba de enviar
+ */
+static void testReplicaReadAfterShip() {
+    std::string primary_path = freshDiskPath("replica_primary");
+    std::string replica_path = freshDiskPath("replica");
+    std::string ship_path = freshDiskPath("replica_ship");
+    std::filesystem::remove(replica_path + "_base.arc");
+
+    QuietOutput quiet;
+    DiskManager primary(primary_path);
+    CHECK(primary.initialize(DiskConfig(1, 2, 64, 32, 1024)));
+    CHECK(primary.createTable("gente", peopleSchema(), false));
+    for (int i = 1; i <= 50; ++i) CHECK(primary.insertRecord("gente", personRow(i)));
+    CHECK(primary.createRadixIndex("gente", "nombre"));
+    CHECK(primary.createTrigramIndex("gente", "nombre"));
+    CHECK(ReplicaFollower::bootstrap(primary, ship_path, replica_path));
+
+    ReplicaFollower follower(replica_path, ship_path);
+    CHECK(follower.start());
+    auto likeCount = [](DiskManager& replica) { return replica.likeSearch("gente", "nombre", "persona_12%").records.size(); };
+    auto radixCount = [](const std::string& value) {
+        return [value](DiskManager& replica) { return replica.radixLookup("gente", "nombre", value).size(); };
+    };
+    CHECK(follower.query(likeCount) == 1);
+
+    // Suficientes filas para volcar listas de trigramas; también una actualización y un borrado
+    for (int i = 51; i <= 300; ++i) CHECK(primary.insertRecord("gente", personRow(i)));
+    CHECK(primary.updateRecord("gente", 125, {"125", "renombrada"}));
+    CHECK(primary.deleteRecord("gente", 126));
+    CHECK(follower.waitForReplay(primary.getLastPageLSN(), std::chrono::milliseconds(10000)));
+
+    CHECK(follower.query(likeCount) == 9);                       // 12 y 120..129 salvo 125 y 126
+    CHECK(follower.query(radixCount("persona_250")) == 1);
+    CHECK(follower.query(radixCount("renombrada")) == 1);
+    CHECK(follower.query(radixCount("persona_125")) == 0);
+    CHECK(follower.query(radixCount("persona_126")) == 0);
+    follower.stop();
+}
+
+/**
+ * @brief El muestreo nunca lee más bloques que su presupuesto, aunque los tramos sean más largos
+ */
+static void testSampleBudget() {
+    std::string path = freshDiskPath("sample_budget");
+    QuietOutput quiet;
+    DiskManager disk(path);
+    CHECK(disk.initialize(DiskConfig(1, 2, 64, 32, 512)));
+    CHECK(disk.createTable("gente", peopleSchema(), false));
+    for (int i = 1; i <= 400; ++i) CHECK(disk.insertRecord("gente", personRow(i)));
+
+    for (size_t budget : {1, 3, 5}) {
+        SampleSpec sample = SampleSpec::system(50.0, budget);
+        sample.run_blocks = 8;
+        auto report = disk.approximateAggregate("gente", AggregateSpec(AggregateFunction::COUNT), sample);
+        CHECK(report.valid);
+        CHECK(report.table_blocks > 8);
+        CHECK(report.blocks_read > 0 && report.blocks_read <= budget);
+    }
+}
+
+/**
+ * @brief El pipeline interpretado y el fusionado dan lo mismo recorriendo la tabla lote a lote
+ */
+static void testFilterAggregateBatches() {
+    std::string path = freshDiskPath("filter_aggregate");
+    QuietOutput quiet;
+    DiskManager disk(path);
+    CHECK(disk.initialize(DiskConfig(1, 4, 64, 64, 4096)));
+    CHECK(disk.createTable("gente", peopleSchema(), false));
+    const int rows = 2500;                              // Varios lotes de PIPELINE_BATCH_ROWS
+    for (int i = 1; i <= rows; ++i) CHECK(disk.insertRecord("gente", personRow(i)));
+
+    std::vector<FilterAggregateQuery> queries = {
+        {"id", CompareOp::GT, "100", AggregateSpec(AggregateFunction::SUM, "id")},
+        {"nombre", CompareOp::EQ, "persona_7", AggregateSpec(AggregateFunction::COUNT)},
+        {"id", CompareOp::LE, "1500", AggregateSpec(AggregateFunction::MAX, "id")}
+    };
+    const double expected[] = {static_cast<double>(rows) * (rows + 1) / 2 - 5050, 1, 1500};
+    for (size_t q = 0; q < queries.size(); ++q) {
+        auto interpreted = disk.filterAggregate("gente", queries[q], ExecutionMode::INTERPRETED, 2);
+        auto fused = disk.filterAggregate("gente", queries[q], ExecutionMode::FUSED, 2);
+        CHECK(interpreted.valid && fused.valid);
+        CHECK(interpreted.rows_scanned == static_cast<size_t>(rows));
+        CHECK(interpreted.value == expected[q]);
+        CHECK(fused.value == expected[q]);
+        CHECK(interpreted.rows_matched == fused.rows_matched);
+    }
+}
+
+/**
+ * @brief Comparaciones y funciones enlazadas: cada operador da lo esperado y los desbordamientos dan NULL
+ */
+static void testVectorExpressionEdges() {
+    const int64_t min = std::numeric_limits<int64_t>::min();
+    std::vector<FieldDefinition> schema = {FieldDefinition("a", FieldType::INTEGER), FieldDefinition("b", FieldType::INTEGER),
+                                           FieldDefinition("x", FieldType::FLOAT), FieldDefinition("s", FieldType::STRING, 10)};
+    VectorExpression::Columns columns = {std::make_shared<ColumnVector>(ColumnVector::make(FieldType::INTEGER, 4)),
+                                         std::make_shared<ColumnVector>(ColumnVector::make(FieldType::INTEGER, 4)),
+                                         std::make_shared<ColumnVector>(ColumnVector::make(FieldType::FLOAT, 4)),
+                                         std::make_shared<ColumnVector>(ColumnVector::make(FieldType::STRING, 4))};
+    columns[0]->ints = {min, 7, -3, 5};
+    columns[1]->ints = {-1, 2, 0, 5};
+    columns[2]->floats = {-1.5, 2.0, 0.0, 5.0};
+    columns[3]->strings = {"Beta", "alfa", "beta", "Gamma"};
+    columns[3]->setNull(3);
+    SelectionVector all;
+    std::vector<bool> used(schema.size(), false);
+
+    auto modulo = VectorExpression::arithmetic('%', VectorExpression::column("a"), VectorExpression::column("b"));
+    CHECK(modulo->bind(schema, used));
+    auto remainder = modulo->evaluate(columns, 4, all);
+    CHECK(remainder->isNull(0) && !remainder->isNull(1) && remainder->isNull(2) && !remainder->isNull(3));
+    CHECK(remainder->ints[1] == 1 && remainder->ints[3] == 0);
+
+    auto absolute = VectorExpression::function("ABS", {VectorExpression::column("a")});
+    CHECK(absolute->bind(schema, used));
+    auto magnitude = absolute->evaluate(columns, 4, all);
+    CHECK(magnitude->isNull(0) && magnitude->ints[1] == 7 && magnitude->ints[2] == 3 && magnitude->ints[3] == 5);
+
+    const std::vector<std::pair<CompareOp, std::vector<int64_t>>> integer_cases = {
+        {CompareOp::LT, {1, 0, 1, 0}}, {CompareOp::LE, {1, 0, 1, 1}}, {CompareOp::EQ, {0, 0, 0, 1}},
+        {CompareOp::NE, {1, 1, 1, 0}}, {CompareOp::GE, {0, 1, 0, 1}}, {CompareOp::GT, {0, 1, 0, 0}}};
+    for (const auto& entry : integer_cases) {
+        auto compare = VectorExpression::compare(entry.first, VectorExpression::column("a"), VectorExpression::column("b"));
+        CHECK(compare->bind(schema, used));
+        auto truth = compare->evaluate(columns, 4, all);
+        CHECK(truth->ints == entry.second);
+        auto mixed = VectorExpression::compare(entry.first, VectorExpression::column("a"), VectorExpression::column("x"));
+        CHECK(mixed->bind(schema, used));
+        CHECK(mixed->evaluate(columns, 4, all)->ints == entry.second);  // x ordena igual que b
+    }
+
+    auto text = VectorExpression::compare(CompareOp::GT, VectorExpression::column("s"),
+                                          VectorExpression::literal("Beta", FieldType::STRING));
+    CHECK(text->bind(schema, used));
+    SelectionVector picked = text->select(columns, 4, all);
+    CHECK(!picked.dense && picked.rows == std::vector<uint32_t>({1, 2}));
+
+    auto upper = VectorExpression::function("UPPER", {VectorExpression::column("s")});
+    CHECK(upper->bind(schema, used));
+    auto shouted = upper->evaluate(columns, 4, picked);
+    CHECK(shouted->strings[1] == "ALFA" && shouted->strings[2] == "BETA" && shouted->isNull(3));
+}
+
+/**
+ * @brief Ocho hilos insertan, borran y recorren el árbol B+ a la vez sin perder ni repetir entradas
+ */
+static void testBPlusTreeConcurrency() {
+    const int threads = 8;
+    const uint32_t per_thread = 20000;
+    BPlusTree tree(8);
+    auto keyOf = [](uint64_t value, uint8_t* key) {
+        for (int i = 0; i < 8; ++i) key[i] = static_cast<uint8_t>(value >> (8 * (7 - i)));
+    };
+    std::atomic<bool> writing{true};
+    std::atomic<int> disorder{0};
+
+    // Un lector recorre todo el rango mientras escriben: las entradas que ve deben llegar en orden
+    std::thread reader([&]() {
+        uint8_t low[8], high[8];
+        keyOf(0, low);
+        keyOf(UINT64_MAX, high);
+        while (writing.load()) {
+            uint64_t previous = 0;
+            bool first = true;
+            tree.scan(low, high, [&](const uint8_t* key, uint32_t) {
+                uint64_t value = 0;
+                for (int i = 0; i < 8; ++i) value = (value << 8) | key[i];
+                if (!first && value < previous) disorder++;
+                previous = value;
+                first = false;
+                return true;
+            });
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back([&, t]() {
+            uint8_t key[8];
+            for (uint32_t i = 0; i < per_thread; ++i) {
+                uint64_t value = static_cast<uint64_t>(i) * threads + t;    // Claves intercaladas entre hilos
+                keyOf(value, key);
+                tree.insert(key, static_cast<uint32_t>(value));
+                if (i % 4 == 3) {                                           // Borra una de cada cuatro ya insertadas
+                    keyOf(value - 2 * threads, key);
+                    tree.erase(key, static_cast<uint32_t>(value - 2 * threads));
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) writer.join();
+    writing = false;
+    reader.join();
+
+    CHECK(disorder.load() == 0);
+    CHECK(tree.size() == static_cast<size_t>(threads) * per_thread * 3 / 4);
+    uint8_t low[8], high[8];
+    keyOf(0, low);
+    keyOf(UINT64_MAX, high);
+    size_t seen = 0;
+    bool exact = true;
+    tree.scan(low, high, [&](const uint8_t* key, uint32_t rid) {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) value = (value << 8) | key[i];
+        exact = exact && value == rid && (value / threads) % 4 != 1;
+        seen++;
+        return true;
+    });
+    CHECK(exact);
+    CHECK(seen == tree.size());
+}
+
+/**
+ * @brief La inserción paralela coloca cada fila una vez y rechaza entero un lote con una fila demasiado grande
+ */
+static void testParallelInsert() {
+    std::string path = freshDiskPath("parallel_insert");
+    QuietOutput quiet;
+    DiskManager disk(path);
+    CHECK(disk.initialize(DiskConfig(1, 2, 64, 32, 512)));
+    CHECK(disk.createTable("gente", peopleSchema(), false));
+    const int rows = 3000;
+    std::vector<std::vector<std::string>> batch;
+    for (int i = 1; i <= rows; ++i) batch.push_back(personRow(i));
+
+    InsertBatchReport report = disk.insertRecordsParallel("gente", batch, 4);
+    CHECK(report.valid);
+    CHECK(report.workers == 4);
+    CHECK(report.rows == static_cast<size_t>(rows));
+    CHECK(report.total_ms >= report.insert_ms);
+    CHECK(report.rows_per_second > 0 && report.rows_per_second <= report.placement_rows_per_second);
+
+    FilterAggregateQuery all{"id", CompareOp::GE, "0", AggregateSpec(AggregateFunction::SUM, "id")};
+    auto sum = disk.filterAggregate("gente", all, ExecutionMode::FUSED);
+    CHECK(sum.rows_matched == static_cast<size_t>(rows));
+    CHECK(sum.value == static_cast<double>(rows) * (rows + 1) / 2);
+    CHECK(disk.findRecord("gente", 1) && disk.findRecord("gente", rows));
+
+    // Una fila mayor que un bloque vacío: no se inserta nada ni se gastan bloques o IDs
+    size_t blocks = disk.approximateAggregate("gente", AggregateSpec(AggregateFunction::COUNT),
+                                              SampleSpec::system(100.0, 1)).table_blocks;
+    CHECK(blocks > 0);
+    std::vector<std::vector<std::string>> oversized = {personRow(rows + 1), {"0", std::string(2000, 'x')},
+                                                       personRow(rows + 2)};
+    CHECK(!disk.insertRecordsParallel("gente", oversized, 2).valid);
+    CHECK(disk.approximateAggregate("gente", AggregateSpec(AggregateFunction::COUNT),
+                                    SampleSpec::system(100.0, 1)).table_blocks == blocks);
+    CHECK(disk.filterAggregate("gente", all, ExecutionMode::FUSED).rows_matched == static_cast<size_t>(rows));
+    CHECK(disk.insertRecord("gente", personRow(-1)));
+    auto next = disk.findRecord("gente", rows + 1);      // Recibe el primer ID que el lote no llegó a usar
+    CHECK(next && next->getField(0) == "-1");
+}
+
+/**
+ * @brief La construcción paralela del índice B+ da lo mismo que un recorrido completo, con claves repetidas
+ */
+static void testBTreeParallelBuild() {
+    std::string path = freshDiskPath("btree_build");
+    QuietOutput quiet;
+    DiskManager disk(path);
+    CHECK(disk.initialize(DiskConfig(1, 2, 64, 32, 512)));
+    std::vector<FieldDefinition> schema = {FieldDefinition("id", FieldType::INTEGER),
+                                           FieldDefinition("grupo", FieldType::INTEGER),
+                                           FieldDefinition("nombre", FieldType::STRING, 40)};
+    CHECK(disk.createTable("gente", schema, false));
+    const int rows = 2000;
+    for (int i = 1; i <= rows; ++i) {
+        CHECK(disk.insertRecord("gente", {std::to_string(i), std::to_string(i % 7), "grupo_" + std::to_string(i % 5)}));
+    }
+
+    std::map<std::string, std::vector<size_t>> progress;
+    IndexBuildReport report = disk.createBTreeIndex("gente", "grupo", 4,
+                                                    [&](const std::string& phase, size_t done, size_t total) {
+        progress[phase].push_back(done);
+        CHECK(done <= total);
+    });
+    CHECK(report.valid);
+    CHECK(report.workers == 4);
+    CHECK(report.blocks > 4 * 8);                           // Varios lotes por hilo
+    CHECK(report.rows == static_cast<size_t>(rows));
+    CHECK(progress.count("lectura") && !progress["lectura"].empty() && progress["lectura"].back() == report.blocks);
+    CHECK(progress["mezcla"].size() == 4);                  // Un aviso por partición
+    CHECK(progress["carga"] == std::vector<size_t>({1}));
+    CHECK(disk.createBTreeIndex("gente", "nombre", 4).valid);
+
+    // Cada grupo tiene unas 285 filas: sus claves repetidas cruzan los separadores de las particiones
+    auto expected = [&](int low, int high, int modulus) {
+        std::vector<int> ids;
+        for (int i = 1; i <= rows; ++i) {
+            if (i % modulus >= low && i % modulus <= high) ids.push_back(i);
+        }
+        return ids;
+    };
+    auto idsOf = [](const std::vector<std::shared_ptr<Record>>& found, size_t field, bool& ordered) {
+        std::vector<int> ids;
+        std::string previous;
+        for (const auto& row : found) {
+            ids.push_back(std::stoi(row->getField(0)));
+            ordered = ordered && (previous.empty() || previous <= row->getField(field));
+            previous = row->getField(field);
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    };
+    for (int low = 0; low < 7; ++low) {
+        bool ordered = true;
+        CHECK(idsOf(disk.btreeRangeLookup("gente", "grupo", std::to_string(low), "4"), 1, ordered) ==
+              expected(low, 4, 7));
+        CHECK(ordered);
+    }
+    bool ordered = true;
+    CHECK(idsOf(disk.btreeLookup("gente", "nombre", "grupo_3"), 2, ordered) == expected(3, 3, 5));
+}
+
+/**
+ * @brief bulkLoad con un último hijo suelto que se cuelga del padre anterior
+ */
+static void testBPlusTreeBulkLoad() {
+    BPlusTree tree(8);
+    BPlusTree::LeafWriter writer(8, 0.9);
+    // 0.9 * 64 = 57 entradas por hoja y 58 hijos por nodo interno: 59 hojas dejan una suelta
+    const uint32_t entries = 58 * 57 + 1;
+    auto keyOf = [](uint64_t value, uint8_t* key) {
+        for (int i = 0; i < 8; ++i) key[i] = static_cast<uint8_t>(value >> (8 * (7 - i)));
+    };
+    uint8_t key[8];
+    for (uint32_t i = 0; i < entries; ++i) {
+        keyOf(i / 3, key);                                  // Claves repetidas, el RID desempata
+        writer.append(key, i);
+    }
+    std::vector<BPlusTree::LeafWriter> writers;
+    writers.push_back(std::move(writer));
+    tree.bulkLoad(writers);
+    CHECK(tree.size() == entries);
+    CHECK(tree.getHeight() == 2);
+
+    keyOf(entries, key);
+    tree.insert(key, entries);
+    uint8_t low[8], high[8];
+    keyOf(0, low);
+    keyOf(UINT64_MAX, high);
+    uint32_t expected = 0;
+    bool exact = true;
+    tree.scan(low, high, [&](const uint8_t*, uint32_t rid) {
+        exact = exact && rid == expected++;
+        return true;
+    });
+    CHECK(exact && expected == entries + 1);
+
+    keyOf((entries - 1) / 3, low);                          // La última clave cargada solo tiene una entrada
+    std::vector<uint32_t> found;
+    tree.scan(low, low, [&](const uint8_t*, uint32_t rid) {
+        found.push_back(rid);
+        return true;
+    });
+    CHECK(found == std::vector<uint32_t>({entries - 1}));
+}
+
+/**
+ * @brief Lo escrito durante una instantánea va a bloques en sombra y el archivo guarda la imagen previa
+ */
+static void testSnapshotShadowWrites() {
+    std::string path = freshDiskPath("snapshot");
+    std::string restored_path = freshDiskPath("snapshot_restored");
+    std::string archive = path + ".arc";
+    std::filesystem::remove(archive);
+
+    QuietOutput quiet;
+    DiskManager disk(path);
+    CHECK(disk.initialize(DiskConfig(1, 2, 64, 32, 512)));
+    CHECK(disk.createTable("gente", peopleSchema(), false));
+    for (int i = 1; i <= 200; ++i) CHECK(disk.insertRecord("gente", personRow(i)));
+
+    CHECK(disk.beginSnapshot(archive));
+    CHECK(disk.isSnapshotActive());
+    CHECK(disk.updateRecord("gente", 1, {"1", "cambiada"}));
+    CHECK(disk.deleteRecord("gente", 200));
+    CHECK(disk.insertRecord("gente", personRow(201)));
+    SnapshotReport report = disk.finishSnapshot();
+    CHECK(report.ok && !report.incremental);
+    CHECK(report.redirected_writes > 0);
+    CHECK(report.blocks == report.total_blocks);
+    CHECK(report.copied_bytes == report.total_bytes);
+
+    // El disco vivo ve los cambios; el restaurado, el estado al congelar
+    auto live = disk.findRecord("gente", 1);
+    CHECK(live && live->getField(1) == "cambiada");
+    CHECK(disk.findRecord("gente", 200) == nullptr);
+
+    CHECK(DiskManager::restoreSnapshot(archive, restored_path));
+    DiskManager restored(restored_path);
+    CHECK(restored.loadExistingDisk());
+    for (int i = 1; i <= 200; ++i) {
+        auto row = restored.findRecord("gente", i);
+        CHECK(row && row->getField(1) == personRow(i)[1]);
+    }
+    CHECK(restored.findRecord("gente", 201) == nullptr);
+}
+
+/**
+ * @brief Un respaldo completo más un incremental restauran el disco y el incremental copia solo lo cambiado
+ */
+static void testIncrementalBackupChain() {
+    std::string path = freshDiskPath("backup_chain");
+    std::string restored_path = freshDiskPath("backup_chain_restored");
+    std::string base_archive = path + "_base.arc";
+    std::string delta_archive = path + "_delta.arc";
+    std::filesystem::remove(base_archive);
+    std::filesystem::remove(delta_archive);
+
+    QuietOutput quiet;
+    DiskManager disk(path);
+    CHECK(disk.initialize(DiskConfig(1, 2, 64, 32, 512)));
+    CHECK(disk.createTable("gente", peopleSchema(), false));
+    for (int i = 1; i <= 400; ++i) CHECK(disk.insertRecord("gente", personRow(i)));
+    CHECK(!disk.beginIncrementalBackup(delta_archive));      // Sin respaldo base no hay incremental
+    CHECK(disk.beginSnapshot(base_archive));
+    SnapshotReport base = disk.finishSnapshot();
+    CHECK(base.ok && base.copied_bytes == base.total_bytes);
+
+    CHECK(disk.updateRecord("gente", 5, {"5", "cambiada"}));
+    CHECK(disk.deleteRecord("gente", 6));
+    for (int i = 401; i <= 410; ++i) CHECK(disk.insertRecord("gente", personRow(i)));
+    CHECK(disk.beginIncrementalBackup(delta_archive));
+    SnapshotReport delta = disk.finishSnapshot();
+    CHECK(delta.ok && delta.incremental);
+    CHECK(delta.base_lsn == base.lsn);
+    CHECK(delta.blocks > 0 && delta.blocks < delta.total_blocks);
+    CHECK(delta.copied_bytes > 0 && delta.copied_bytes < delta.total_bytes);
+
+    CHECK(!DiskManager::restoreBackupChain({delta_archive}, restored_path));  // El incremental solo no basta
+    CHECK(DiskManager::restoreBackupChain({base_archive, delta_archive}, restored_path));
+    DiskManager restored(restored_path);
+    CHECK(restored.loadExistingDisk());
+    for (int i = 1; i <= 410; ++i) {
+        auto expected = disk.findRecord("gente", i);
+        auto row = restored.findRecord("gente", i);
+        CHECK((expected == nullptr) == (row == nullptr));
+        if (expected && row) CHECK(row->getField(1) == expected->getField(1));
+    }
+    CHECK(restored.findRecord("gente", 6) == nullptr);
+}
+
+/**
+ * @brief Los mapas de bits cambian de array a mapa al pasar ARRAY_LIMIT y el recorrido heap coincide con un recorrido completo
+ */
+static void testBitmapHeapScan() {
+    // Un solo contenedor que cruza el límite en los dos sentidos
+    RoaringBitmap dense, sparse;
+    for (uint32_t v = 0; v <= RoaringBitmap::ARRAY_LIMIT; ++v) dense.add(v * 2);
+    for (uint32_t v = 0; v < 3000; ++v) sparse.add(v * 3);
+    CHECK(dense.getContainers().size() == 1 && dense.getContainers()[0].is_bitmap);
+    CHECK(!sparse.getContainers()[0].is_bitmap);
+    std::set<uint32_t> dense_set, sparse_set;
+    for (uint32_t v : dense.toVector()) dense_set.insert(v);
+    for (uint32_t v : sparse.toVector()) sparse_set.insert(v);
+    std::vector<uint32_t> expected;
+    std::set_intersection(dense_set.begin(), dense_set.end(), sparse_set.begin(), sparse_set.end(),
+                          std::back_inserter(expected));
+    CHECK(RoaringBitmap::andOf(dense, sparse).toVector() == expected);
+    CHECK(RoaringBitmap::andOf(sparse, dense).toVector() == expected);
+    expected.clear();
+    std::set_union(dense_set.begin(), dense_set.end(), sparse_set.begin(), sparse_set.end(),
+                   std::back_inserter(expected));
+    CHECK(RoaringBitmap::orOf(sparse, dense).toVector() == expected);
+    expected.clear();
+    std::set_difference(dense_set.begin(), dense_set.end(), sparse_set.begin(), sparse_set.end(),
+                        std::back_inserter(expected));
+    CHECK(RoaringBitmap::andNotOf(dense, sparse).toVector() == expected);
+    expected.clear();
+    std::set_difference(sparse_set.begin(), sparse_set.end(), dense_set.begin(), dense_set.end(),
+                        std::back_inserter(expected));
+    CHECK(RoaringBitmap::andNotOf(sparse, dense).toVector() == expected);
+    dense.remove(0);
+    dense.remove(2);
+    CHECK(!dense.getContainers()[0].is_bitmap && dense.cardinality() == RoaringBitmap::ARRAY_LIMIT - 1);
+
+    // Sectores de 512 KB: el primer bloque guarda más de 4096 filas en un contenedor
+    std::string path = freshDiskPath("bitmap_scan");
+    QuietOutput quiet;
+    DiskManager disk(path);
+    CHECK(disk.initialize(DiskConfig(1, 1, 4, 4, 524288)));
+    std::vector<FieldDefinition> schema = {FieldDefinition("id", FieldType::INTEGER),
+                                           FieldDefinition("a", FieldType::INTEGER),
+                                           FieldDefinition("b", FieldType::INTEGER),
+                                           FieldDefinition("c", FieldType::INTEGER)};
+    CHECK(disk.createTable("medidas", schema, false));
+    const int rows = 12000;
+    auto valuesOf = [](int i) { return std::vector<int>{i, i % 3, i % 5, i % 2}; };
+    std::vector<std::vector<std::string>> batch;
+    for (int i = 1; i <= rows; ++i) {
+        std::vector<std::string> row;
+        for (int value : valuesOf(i)) row.push_back(std::to_string(value));
+        batch.push_back(row);
+    }
+    CHECK(disk.insertRecordsParallel("medidas", batch, 1).valid);
+    for (const char* column : {"a", "b", "c"}) CHECK(disk.createBitmapIndex("medidas", column));
+    for (int i = 7; i <= rows; i += 97) CHECK(disk.deleteRecord("medidas", i));   // Fuera del universo de la negación
+
+    // a IN (0, 1) AND b = 2 AND NOT c = 1
+    std::vector<BitmapTerm> terms = {BitmapTerm("a", {"0", "1"}), BitmapTerm("b", {"2"}),
+                                     BitmapTerm("c", {"1"}, true)};
+    BitmapScanReport report = disk.bitmapHeapScan("medidas", terms);
+    CHECK(report.table_blocks * RoaringBitmap::ARRAY_LIMIT < static_cast<size_t>(rows));   // Algún bloque pasa del límite
+    std::vector<int> found;
+    for (const auto& row : report.records) found.push_back(std::stoi(row->getField(0)));
+    std::sort(found.begin(), found.end());
+    std::vector<int> scanned;
+    for (int i = 1; i <= rows; ++i) {
+        auto values = valuesOf(i);
+        if (values[1] != 2 && values[2] == 2 && values[3] != 1 && (i < 7 || (i - 7) % 97 != 0)) scanned.push_back(i);
+    }
+    CHECK(!scanned.empty());
+    CHECK(found == scanned);
+    CHECK(report.candidate_rows == scanned.size());
+}
+
+/**
+ * @brief Los sketches combinados dan lo mismo que uno solo, caben en su memoria fija y sobreviven al texto
+ */
+static void testSketches() {
+    auto hllOf = [](int low, int high) {
+        HyperLogLog sketch;
+        for (int i = low; i < high; ++i) sketch.add("v" + std::to_string(i));
+        return sketch;
+    };
+    auto withinError = [](double estimate, double truth, double error) {
+        return std::abs(estimate - truth) <= 3.0 * error * truth;
+    };
+
+    // Disperso + disperso: sigue disperso y es el sketch del flujo entero
+    HyperLogLog left = hllOf(0, 150), right = hllOf(100, 250);
+    CHECK(left.isSparse() && right.isSparse());
+    CHECK(left.merge(right));
+    CHECK(left.isSparse());
+    CHECK(left.toString() == hllOf(0, 250).toString());
+    CHECK(withinError(left.estimate(), 250, left.getStandardError()));
+
+    // Disperso + denso, en los dos sentidos
+    const int distinct = 50000;
+    HyperLogLog dense = hllOf(200, distinct);
+    CHECK(!dense.isSparse());
+    CHECK(dense.getMemoryBytes() <= 4096);
+    HyperLogLog sparse_first = hllOf(0, 250);
+    CHECK(sparse_first.merge(dense));
+    CHECK(dense.merge(left));
+    HyperLogLog single = hllOf(0, distinct);
+    CHECK(dense.toString() == single.toString() && sparse_first.toString() == single.toString());
+    CHECK(withinError(single.estimate(), distinct, single.getStandardError()));
+    CHECK(!HyperLogLog(10).merge(single));
+
+    // Texto: los dos modos vuelven idénticos; el denso ocupa dos dígitos por registro
+    for (const HyperLogLog& sketch : {left, single}) {
+        HyperLogLog copy(4);
+        CHECK(copy.fromString(sketch.toString()));
+        CHECK(copy.toString() == sketch.toString() && copy.estimate() == sketch.estimate());
+    }
+    CHECK(single.toString().size() <= 2 * 4096 + 4);
+    CHECK(!HyperLogLog().fromString("12:S12345"));
+
+    // KLL: cuatro trabajadores con tramos del flujo frente a un solo sketch
+    const int values = 100000;
+    std::vector<int> order(values);
+    for (int i = 0; i < values; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(11));
+    QuantileSketch whole;
+    std::vector<QuantileSketch> workers(4);
+    for (int i = 0; i < values; ++i) {
+        whole.add(order[i]);
+        workers[static_cast<size_t>(i) * 4 / values].add(order[i]);
+    }
+    QuantileSketch merged;
+    for (const auto& worker : workers) CHECK(merged.merge(worker));
+    CHECK(merged.getCount() == static_cast<size_t>(values));
+    CHECK(merged.getMin() == 0 && merged.getMax() == values - 1);
+    for (const QuantileSketch* sketch : {&whole, &merged}) {
+        CHECK(sketch->getMemoryBytes() <= 3 * QuantileSketch::DEFAULT_K * sizeof(double));
+        for (double q : {0.1, 0.25, 0.5, 0.75, 0.9, 0.99}) {
+            double rank = (sketch->quantile(q) + 1) / values;
+            CHECK(std::abs(rank - q) <= 2.0 * sketch->getRankError());
+        }
+    }
+    CHECK(std::abs(merged.quantile(0.5) - whole.quantile(0.5)) <= 4.0 * whole.getRankError() * values);
+    CHECK(!QuantileSketch(100).merge(merged));
+    QuantileSketch copy;
+    CHECK(copy.fromString(merged.toString()));
+    CHECK(copy.toString() == merged.toString() && copy.quantile(0.5) == merged.quantile(0.5));
+
+    // Resúmenes por bloque: solo se relee el bloque que cambió y el HyperLogLog es el de la tabla entera
+    std::string path = freshDiskPath("sketches");
+    const int rows = 3000;
+    {
+        QuietOutput quiet;
+        DiskManager disk(path);
+        CHECK(disk.initialize(DiskConfig(1, 2, 64, 32, 512)));
+        CHECK(disk.createTable("gente", peopleSchema(), false));
+        std::vector<std::vector<std::string>> batch;
+        for (int i = 1; i <= rows; ++i) batch.push_back(personRow(i % 1000));
+        CHECK(disk.insertRecordsParallel("gente", batch, 2).valid);
+        CHECK(disk.createColumnSketches("gente", "id"));
+
+        SketchAggregateReport summarized = disk.sketchAggregate("gente", "id", 4);
+        CHECK(summarized.valid && summarized.blocks_read == 0 && summarized.summaries_used > 1);
+        CHECK(disk.insertRecord("gente", personRow(5000)));
+        summarized = disk.sketchAggregate("gente", "id", 4);
+        SketchAggregateReport scanned = disk.sketchAggregate("gente", "id", 4, false);
+        CHECK(summarized.blocks_read == 1 && scanned.blocks_read == summarized.summaries_used + 1);
+        CHECK(summarized.sketch.distinct.toString() == scanned.sketch.distinct.toString());
+        CHECK(summarized.sketch.quantiles.getCount() == static_cast<size_t>(rows) + 1);
+        CHECK(withinError(summarized.sketch.distinct.estimate(), 1001, summarized.sketch.distinct.getStandardError()));
+    }
+    QuietOutput quiet;
+    DiskManager reopened(path);
+    CHECK(reopened.loadExistingDisk());
+    SketchAggregateReport reloaded = reopened.sketchAggregate("gente", "id");
+    CHECK(reloaded.valid && reloaded.blocks_read == 0 && reloaded.summaries_used > 1);
+}
+
+/**
+ * @brief Un volumen reparte la relación entre todos sus discos y su recorrido escala con ellos
+ */
+static void testVolumeStriping() {
+    const int rows = 600;
+    auto scanWith = [&](size_t disks, std::vector<int>& ids) {
+        std::string path = freshDiskPath("volume_" + std::to_string(disks));
+        VolumeScanReport report;
+        {
+            VolumeManager volume(path, 2);
+            for (size_t d = 0; d < disks; ++d) {
+                CHECK(volume.addDisk(path + "/disco_" + std::to_string(d), DiskConfig(1, 2, 64, 32, 512)));
+            }
+            CHECK(volume.createTable("gente", peopleSchema(), false));
+            for (int i = 1; i <= rows; ++i) CHECK(volume.insertRecord("gente", personRow(i)));
+            report = volume.scanTable("gente");
+        }
+        // Reabierto desde volume.txt: mismas filas, y los IDs siguen donde se quedaron
+        VolumeManager reopened(path, 2);
+        CHECK(reopened.loadExisting());
+        CHECK(reopened.getDiskCount() == disks);
+        CHECK(reopened.insertRecord("gente", personRow(rows + 1)));
+        ids.clear();
+        for (const auto& record : reopened.scanTable("gente").records) ids.push_back(record->getId());
+        return report;
+    };
+
+    QuietOutput quiet;
+    std::vector<int> single_ids, striped_ids, expected;
+    for (int i = 1; i <= rows + 1; ++i) expected.push_back(i);
+    VolumeScanReport single = scanWith(1, single_ids);
+    VolumeScanReport striped = scanWith(4, striped_ids);
+    CHECK(single_ids == expected && striped_ids == expected);
+    CHECK(single.records.size() == static_cast<size_t>(rows) && striped.records.size() == single.records.size());
+    CHECK(striped.blocks_read == single.blocks_read && striped.blocks_read >= 4 * 2);
+
+    // Cada disco sirve una parte y el recorrido dura lo que el más cargado
+    double busiest = 0.0, total = 0.0;
+    for (double busy : striped.disk_busy_ms) {
+        CHECK(busy > 0.0);
+        busiest = std::max(busiest, busy);
+        total += busy;
+    }
+    CHECK(striped.disk_busy_ms.size() == 4);
+    CHECK(striped.makespan_ms == busiest && striped.makespan_ms < total);
+    CHECK(striped.makespan_ms < single.makespan_ms);
+    CHECK(striped.getBandwidthMBps() > 2.0 * single.getBandwidthMBps());
+}
+
+/**
+ * @brief Con un actuador por superficie la tabla se reparte entre superficies y su recorrido termina antes
+ */
+static void testIndependentActuators() {
+    auto scanOn = [](const std::string& name, bool independent) {
+        std::string path = freshDiskPath(name);
+        QuietOutput quiet;
+        DiskConfig config(2, 2, 64, 32, 512);
+        config.setIndependentActuators(independent);
+        DiskManager disk(path);
+        CHECK(disk.initialize(config));
+        CHECK(disk.createTable("gente", peopleSchema(), false));
+        for (int i = 1; i <= 400; ++i) CHECK(disk.insertRecord("gente", personRow(i)));
+        return disk.simulateTableScan("gente");
+    };
+
+    ScanTimingReport striped = scanOn("actuators_striped", true);
+    CHECK(striped.blocks >= 4 * 4);
+    CHECK(striped.surfaces_used == 4);
+    CHECK(striped.per_surface_ms < striped.single_actuator_ms / 2);
+
+    // La asignación secuencial deja la tabla en una superficie: los dos modelos coinciden
+    ScanTimingReport sequential = scanOn("actuators_sequential", false);
+    CHECK(sequential.blocks == striped.blocks);
+    CHECK(sequential.surfaces_used == 1);
+    CHECK(sequential.per_surface_ms == sequential.single_actuator_ms);
+    CHECK(striped.per_surface_ms < sequential.per_surface_ms);
+}
+
+/**
+ * @brief disk_config.txt se carga con su geometría y un archivo incompleto o con zonas inválidas no cambia nada
+ */
+static void testDiskConfigFile() {
+    std::string path = freshDiskPath("disk_config");
+    std::filesystem::create_directories(path);
+    QuietOutput quiet;
+
+    DiskConfig saved(1, 2, 64, 32, 512);
+    saved.setIndependentActuators(true);
+    CHECK(saved.setZones({DiskZone(0, 31, 32, 0.1), DiskZone(32, 63, 16, 0.2)}));
+    CHECK(saved.saveToFile(path + "/ok.txt"));
+    DiskConfig loaded;
+    CHECK(loaded.loadFromFile(path + "/ok.txt"));
+    CHECK(loaded.getTracksPerSurface() == 64 && loaded.getBytesPerSector() == 512);
+    CHECK(loaded.hasIndependentActuators() && loaded.getZoneCount() == 2);
+    CHECK(loaded.getTotalSectors() == saved.getTotalSectors());
+
+    // Cada archivo inválido deja la configuración anterior intacta
+    std::vector<std::pair<std::string, std::string>> broken = {
+        {"missing_key", "num_platters=1\nsurfaces_per_platter=2\ntracks_per_surface=64\nsectors_per_track=32\n"},
+        {"bad_zone", "num_platters=1\nsurfaces_per_platter=2\ntracks_per_surface=64\nsectors_per_track=32\n"
+                     "bytes_per_sector=512\nzone=0,31,32,0.1\nzone=40,63,16,0.2\n"},
+        {"bad_value", "num_platters=uno\nsurfaces_per_platter=2\ntracks_per_surface=64\nsectors_per_track=32\n"
+                      "bytes_per_sector=512\n"},
+        {"bad_timing", "num_platters=1\nsurfaces_per_platter=2\ntracks_per_surface=64\nsectors_per_track=32\n"
+                       "bytes_per_sector=512\ntransfer_time_ms=0\n"},
+    };
+    for (const auto& file : broken) {
+        std::ofstream(path + "/" + file.first + ".txt") << file.second;
+        DiskConfig kept = loaded;
+        CHECK(!kept.loadFromFile(path + "/" + file.first + ".txt"));
+        CHECK(kept.getTotalSectors() == loaded.getTotalSectors() && kept.getZoneCount() == 2);
+    }
+    CHECK(!loaded.loadFromFile(path + "/no_existe.txt"));
+
+    // Un disco pequeño se reabre con su propia geometría, no con la de omisión
+    std::string disk_path = path + "/disco";
+    {
+        DiskManager disk(disk_path);
+        CHECK(disk.initialize(saved));
+        CHECK(disk.createTable("gente", peopleSchema(), false));
+        CHECK(disk.insertRecord("gente", personRow(1)));
+    }
+    FileSystemSimulator files(disk_path);
+    CHECK(files.loadExisting());
+    CHECK(files.getDiskConfig().getTotalSectors() == saved.getTotalSectors());
+    CHECK(files.getDiskConfig().getZoneCount() == 2);
+    DiskManager reopened(disk_path);
+    CHECK(reopened.loadExistingDisk());
+    CHECK(reopened.findRecord("gente", 1) != nullptr);
+}
+
+/**
+ * @brief Una consulta de ventana no pasa de memory_rows filas y sus temporales no sobreviven a una caída
+ */
+static void testWindowSpill() {
+    std::string path = freshDiskPath("window_spill");
+    const int rows = 600;
+    const size_t memory_rows = 64;
+    WindowSpec spec;
+    spec.partition_by = {"grupo"};
+    spec.order_by = {"id"};
+    spec.calls = {WindowCall(WindowFunction::ROW_NUMBER)};
+    std::vector<FieldDefinition> schema = {FieldDefinition("id", FieldType::INTEGER),
+                                           FieldDefinition("grupo", FieldType::INTEGER)};
+    {
+        QuietOutput quiet;
+        DiskManager disk(path);
+        CHECK(disk.initialize(DiskConfig(1, 2, 64, 32, 1024)));
+        CHECK(disk.createTable("medidas", schema, false));
+        // Particiones de tamaños muy distintos: muchas pequeñas y una mayor que la memoria
+        for (int i = 1; i <= rows; ++i) {
+            int group = i <= 200 ? i % 40 : 99;
+            CHECK(disk.insertRecord("medidas", {std::to_string(i), std::to_string(group)}));
+        }
+        size_t emitted = 0;
+        auto report = disk.windowQuery("medidas", spec, memory_rows, 2,
+                                       [&emitted](const std::vector<std::string>&) { emitted++; });
+        CHECK(report.valid);
+        CHECK(report.sort_runs > 1);
+        CHECK(report.spilled_partitions == 1);
+        CHECK(emitted == static_cast<size_t>(rows));
+        CHECK(report.peak_rows > 0 && report.peak_rows <= memory_rows);
+
+        // La consulta se corta con los bloques temporales aún en disco
+        bool interrupted = false;
+        try {
+            disk.windowQuery("medidas", spec, memory_rows, 1,
+                             [](const std::vector<std::string>&) { throw std::runtime_error("caída"); });
+        } catch (const std::runtime_error&) {
+            interrupted = true;
+        }
+        CHECK(interrupted);
+    }
+    QuietOutput quiet;
+    DiskManager reopened(path);
+    CHECK(reopened.loadExistingDisk());
+    std::ostringstream listing;
+    std::streambuf* previous = std::cout.rdbuf(listing.rdbuf());
+    reopened.displayStatistics();
+    std::cout.rdbuf(previous);
+    CHECK(listing.str().find("sort_tmp") == std::string::npos);
+    CHECK(!reopened.createTable("sort_tmp", schema, false));
+    auto report = reopened.windowQuery("medidas", spec, memory_rows, 1, [](const std::vector<std::string>&) {});
+    CHECK(report.valid && report.rows == static_cast<size_t>(rows));
+}
+
+/**
+ * @brief La GC del SSD copia las páginas válidas antes de borrar y no pierde ninguna
+ */
+static void testSSDGarbageCollection() {
+    DiskConfig addressing;
+    const long long logical_pages = 4096;
+    SSDConfig config = SSDConfig::sizedFor(logical_pages);
+    CHECK(config.isValid());
+
+    SSDModel ssd(config, addressing);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<long long> page(0, logical_pages - 1);
+    for (long long i = 0; i < logical_pages; ++i) {
+        ssd.service(ssd.unitFor(IOType::WRITE, addressing.blockToAddress(i)), IOType::WRITE,
+                    addressing.blockToAddress(i));
+    }
+    for (long long i = 0; i < 4 * logical_pages; ++i) {
+        PhysicalAddress address = addressing.blockToAddress(page(rng));
+        ssd.service(ssd.unitFor(IOType::WRITE, address), IOType::WRITE, address);
+    }
+
+    CHECK(ssd.getEraseCount() > 0);
+    CHECK(ssd.getWriteAmplification() > 1.0);
+    CHECK(ssd.getFailedWrites() == 0);
+    CHECK(ssd.getMappedPages() == static_cast<size_t>(logical_pages));
+}
+
+int main() {
+    const std::vector<std::pair<const char*, void (*)()>> tests = {
+        {"GC del SSD", testSSDGarbageCollection},
+        {"Disco lleno", testDiskFull},
+        {"Actualización sin espacio", testUpdateRollback},
+        {"Escrituras en vistas", testViewWritesRejected},
+        {"Recuperación del WAL", testWalRecovery},
+        {"Compactación LSM", testLSMCompaction},
+        {"Reorganización agrupada", testClusteredReorganization},
+        {"Relaciones internas ocultas", testInternalRelationsHidden},
+        {"Lectura en réplica tras el envío", testReplicaReadAfterShip},
+        {"Presupuesto del muestreo", testSampleBudget},
+        {"Filtro y agregado por lotes", testFilterAggregateBatches},
+        {"Expresiones vectoriales en los bordes", testVectorExpressionEdges},
+        {"Árbol B+ con ocho hilos", testBPlusTreeConcurrency},
+        {"Inserción paralela", testParallelInsert},
+        {"Construcción paralela del índice B+", testBTreeParallelBuild},
+        {"Carga masiva del árbol B+", testBPlusTreeBulkLoad},
+        {"Escrituras durante una instantánea", testSnapshotShadowWrites},
+        {"Cadena de respaldos incrementales", testIncrementalBackupChain},
+        {"Recorrido heap por mapas de bits", testBitmapHeapScan},
+        {"Sketches combinados", testSketches},
+        {"Volumen con striping", testVolumeStriping},
+        {"Actuadores independientes", testIndependentActuators},
+        {"Archivo de configuración del disco", testDiskConfigFile},
+        {"Volcados de la consulta de ventana", testWindowSpill},
+    };
+
+    for (const auto& test : tests) {
+        int before = failures;
+        test.second();
+        std::cout << (failures == before ? "[OK]    " : "[FALLA] ") << test.first << std::endl;
+    }
+    std::cout << checks << " comprobaciones, " << failures << " fallos" << std::endl;
+    return failures == 0 ? 0 : 1;
+}